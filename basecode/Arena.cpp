@@ -0,0 +1,116 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2014 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include <new>
+#include "header.h"
+
+Arena::Arena( size_t objSize, size_t align, size_t chunkBytes )
+	: objSize_( objSize ),
+	  header_( max( align, sizeof( unsigned long long ) ) ),
+	  chunkBytes_( chunkBytes ),
+	  bigBytes_( chunkBytes / 8 ),
+	  next_( 0 ),
+	  end_( 0 ),
+	  reserved_( 0 ),
+	  live_( 0 )
+{
+	// Memory from operator new is only aligned this far.
+	assert( align <= __STDCPP_DEFAULT_NEW_ALIGNMENT__ );
+	assert( header_ % align == 0 );
+}
+
+/**
+ * Elements may outlive the static Dinfo holding the arena at exit, so
+ * the chunks are only let go if nothing is left in them.
+ */
+Arena::~Arena()
+{
+	if ( live_ == 0 )
+		releaseChunks();
+}
+
+char* Arena::allocChunk( size_t bytes )
+{
+	char* ret = static_cast< char* >( ::operator new( bytes, nothrow ) );
+	if ( ret ) {
+		chunks_.push_back( ret );
+		reserved_ += bytes;
+	}
+	return ret;
+}
+
+void Arena::releaseChunks()
+{
+	for ( vector< char* >::iterator i = chunks_.begin();
+			i != chunks_.end(); ++i )
+		::operator delete( *i );
+	chunks_.clear();
+	freeBlocks_.clear();
+	next_ = end_ = 0;
+	reserved_ = 0;
+}
+
+char* Arena::alloc( unsigned int numData )
+{
+	// Round up so that the next block stays aligned.
+	size_t bytes = header_ + objSize_ * numData;
+	bytes = ( ( bytes + header_ - 1 ) / header_ ) * header_;
+	char* block = 0;
+	if ( bytes >= bigBytes_ ) {
+		block = static_cast< char* >( ::operator new( bytes, nothrow ) );
+	} else {
+		map< unsigned int, vector< char* > >::iterator i =
+			freeBlocks_.find( numData );
+		if ( i != freeBlocks_.end() && !i->second.empty() ) {
+			block = i->second.back();
+			i->second.pop_back();
+		} else {
+			if ( next_ == 0 || next_ + bytes > end_ ) {
+				next_ = allocChunk( chunkBytes_ );
+				end_ = next_ ? next_ + chunkBytes_ : 0;
+			}
+			if ( next_ ) {
+				block = next_;
+				next_ += bytes;
+			}
+		}
+	}
+	if ( !block )
+		return 0;
+	*reinterpret_cast< unsigned int* >( block ) = numData;
+	++live_;
+	return block + header_;
+}
+
+void Arena::free( char* data )
+{
+	if ( !data )
+		return;
+	char* block = data - header_;
+	unsigned int numData = *reinterpret_cast< unsigned int* >( block );
+	size_t bytes = header_ + objSize_ * numData;
+	bytes = ( ( bytes + header_ - 1 ) / header_ ) * header_;
+	if ( bytes >= bigBytes_ )
+		::operator delete( block );
+	else
+		freeBlocks_[ numData ].push_back( block );
+	assert( live_ > 0 );
+	if ( --live_ == 0 )
+		releaseChunks();
+}
+
+unsigned int Arena::numData( const char* data ) const
+{
+	return *reinterpret_cast< const unsigned int* >( data - header_ );
+}
+
+size_t Arena::reserved() const
+{
+	return reserved_;
+}
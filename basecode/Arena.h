@@ -0,0 +1,68 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2014 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+#ifndef _ARENA_H
+#define _ARENA_H
+
+/**
+ * Memory for the data blocks of all Elements of one class.
+ * Models built from morphologies or network generators make one Element
+ * per compartment, channel or neuron, so their data entries would each
+ * be a separate small heap block scattered over memory. An Arena carves
+ * them out of large chunks in the order they are made, so the Elements
+ * that a Tick goes through one after another also lie one after another
+ * in memory.
+ * Freed blocks are kept on a free list for their number of entries and
+ * reused; the chunks are released once every block of the class is gone.
+ * Blocks too big to share a chunk get memory of their own.
+ * Each block has a small header in front holding its number of entries,
+ * as DinfoBase::destroyData is only given the pointer.
+ */
+class Arena
+{
+	public:
+		/**
+		 * objSize and align are those of the class. Chunks are
+		 * chunkBytes long.
+		 */
+		Arena( size_t objSize, size_t align, size_t chunkBytes = 1 << 18 );
+		~Arena();
+
+		/// Uninitialized memory for numData entries.
+		char* alloc( unsigned int numData );
+
+		/// Returns memory from alloc. The entries must be destroyed.
+		void free( char* data );
+
+		/// Number of entries in a block from alloc.
+		unsigned int numData( const char* data ) const;
+
+		/// Bytes held in chunks, in use or not.
+		size_t reserved() const;
+
+	private:
+		char* allocChunk( size_t bytes );
+		void releaseChunks();
+
+		size_t objSize_;
+		size_t header_;		/// Bytes in front of each block.
+		size_t chunkBytes_;
+		size_t bigBytes_;	/// Blocks at least this big get their own.
+
+		vector< char* > chunks_;
+		char* next_;		/// Free memory in the newest chunk...
+		char* end_;			/// ... up to here.
+		size_t reserved_;
+
+		/// Freed blocks, by number of entries.
+		map< unsigned int, vector< char* > > freeBlocks_;
+		/// Blocks handed out and not yet freed, in chunks or not.
+		unsigned long live_;
+};
+
+#endif // _ARENA_H
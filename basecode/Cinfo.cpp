@@ -308,6 +308,11 @@ unsigned int Cinfo::numBindIndex() const
     return numBindIndex_;
 }
 
+unsigned int Cinfo::numPostCreationFinfos() const
+{
+    return postCreationFinfos_.size();
+}
+
 const map<string, Finfo*>& Cinfo::finfoMap() const
 {
     return finfoMap_;
@@ -146,6 +146,12 @@ public:
      */
     unsigned int numBindIndex() const;
 
+    /**
+     * Number of Finfos that act when an Element of this class is
+     * created, each of which makes one FieldElement child.
+     */
+    unsigned int numPostCreationFinfos() const;
+
     /**
      * Returns the map between name and field info
      */
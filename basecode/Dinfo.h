@@ -185,4 +185,59 @@ template< class D > class ZeroSizeDinfo: public Dinfo< D >
 		}
 };
 
+/**
+ * Dinfo for classes of which models have many small Elements, such as
+ * compartments, channels and point neurons. The data blocks of all its
+ * Elements come from one Arena, so that they lie together in memory in
+ * the order they were made rather than all over the heap. A class opts
+ * in by using ArenaDinfo< D > in place of Dinfo< D > in its initCinfo.
+ */
+template< class D > class ArenaDinfo: public Dinfo< D >
+{
+	public:
+		ArenaDinfo()
+			: arena_( sizeof( D ), alignof( D ) )
+		{;}
+
+		char* allocData( unsigned int numData ) const {
+			if ( numData == 0 )
+				return 0;
+			D* ret = reinterpret_cast< D* >( arena_.alloc( numData ) );
+			if ( !ret )
+				return 0;
+			for ( unsigned int i = 0; i < numData; ++i )
+				new( ret + i ) D();
+			return reinterpret_cast< char* >( ret );
+		}
+
+		char* copyData( const char* orig, unsigned int origEntries,
+			unsigned int copyEntries, unsigned int startEntry ) const
+		{
+			if ( origEntries == 0 )
+				return 0;
+			char* ret = allocData( copyEntries );
+			if ( !ret )
+				return 0;
+			const D* origData = reinterpret_cast< const D* >( orig );
+			D* tgt = reinterpret_cast< D* >( ret );
+			for ( unsigned int i = 0; i < copyEntries; ++i ) {
+				tgt[ i ] = origData[ ( i + startEntry ) % origEntries ];
+			}
+			return ret;
+		}
+
+		void destroyData( char* d ) const {
+			if ( !d )
+				return;
+			unsigned int n = arena_.numData( d );
+			D* data = reinterpret_cast< D* >( d );
+			for ( unsigned int i = 0; i < n; ++i )
+				data[ i ].~D();
+			arena_.free( d );
+		}
+
+	private:
+		mutable Arena arena_;
+};
+
 #endif // _DINFO_H
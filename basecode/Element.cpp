@@ -292,6 +292,11 @@ const vector< MsgDigest >& Element::msgDigest( unsigned int index )
     {
         digestMessages();
         isRewired_ = false;
+        rewiredMsgs_.clear();
+    }
+    else if ( rewiredMsgs_.size() > 0 )
+    {
+        redigestMessages();
     }
     assert( index < msgDigest_.size() );
     return msgDigest_[ index ];
@@ -470,6 +475,31 @@ void Element::putTargetsInDigest(
 // targetNodes[srcDataId][node]
 {
     const Msg* msg = Msg::getMsg( mfb.mid );
+
+    // Messages that keep their targets in suitable storage are referenced
+    // in place, rather than copied out as Erefs. Off-node filtering
+    // needs the Erefs, so this is only done on a single node.
+    vector< TargetSpan > spans;
+    if ( msg->e1() == this && Shell::numNodes() == 1 &&
+            msg->targetSpans( spans ) )
+    {
+        for ( unsigned int j = 0; j < spans.size(); ++j )
+        {
+            if ( spans[j].num == 0 )
+                continue;
+            vector< MsgDigest >& md =
+                msgDigest_[ msgBinding_.size() * j + srcNum ];
+            // A digest holding Erefs would visit them before the spans,
+            // out of binding order, so spans start a digest of their own.
+            if ( md.size() == 0 || md.back().func != fo.func() ||
+                    md.back().targets.size() > 0 )
+                md.push_back( MsgDigest( fo.func(), spans[j] ) );
+            else
+                md.back().spans.push_back( spans[j] );
+        }
+        return;
+    }
+
     vector< vector < Eref > > erefs;
     if ( msg->e1() == this )
         msg->targets( erefs );
@@ -490,7 +520,8 @@ void Element::putTargetsInDigest(
         vector< MsgDigest >& md =
             msgDigest_[ msgBinding_.size() * j + srcNum ];
         // k->func(); erefs[ j ];
-        if ( md.size() == 0 || md.back().func != fo.func() )
+        if ( md.size() == 0 || md.back().func != fo.func() ||
+                md.back().spans.size() > 0 )
         {
             md.push_back( MsgDigest( fo.func(), erefs[j] ) );
             /*
@@ -568,7 +599,6 @@ unsigned int findNumDigest( const vector< vector< MsgDigest > > & md,
 
 void Element::digestMessages()
 {
-    bool report = 0; // for debugging
     msgDigest_.clear();
     msgDigest_.resize( msgBinding_.size() * numData() );
     vector< bool > temp( Shell::numNodes(), false );
@@ -577,42 +607,80 @@ void Element::digestMessages()
     // a target off-node, it should flag the entry here so that it can
     // send the message request to the proxy on that node.
     for ( unsigned int i = 0; i < msgBinding_.size(); ++i )
+        digestSrcMsg( i, targetNodes );
+}
+
+void Element::redigestMessages()
+{
+    if ( Shell::numNodes() > 1 ||
+            msgDigest_.size() != msgBinding_.size() * numData() )
     {
-        // Go through and identify functions with the same ptr.
-        vector< FuncOrder > fo = putFuncsInOrder( this, msgBinding_[i] );
-        for ( vector< FuncOrder >::const_iterator
-                k = fo.begin(); k != fo.end(); ++k )
+        digestMessages();
+        rewiredMsgs_.clear();
+        return;
+    }
+    vector< vector< bool > > targetNodes(
+        numData(), vector< bool >( 1, false ) );
+    for ( unsigned int i = 0; i < msgBinding_.size(); ++i )
+    {
+        bool isChanged = false;
+        for ( vector< MsgFuncBinding >::const_iterator
+                j = msgBinding_[i].begin(); j != msgBinding_[i].end(); ++j )
         {
-            const MsgFuncBinding& mfb = msgBinding_[i][ k->index() ];
-            putTargetsInDigest( i, mfb, *k, targetNodes );
+            if ( find( rewiredMsgs_.begin(), rewiredMsgs_.end(), j->mid )
+                    != rewiredMsgs_.end() )
+            {
+                isChanged = true;
+                break;
+            }
         }
-        if ( Shell::numNodes() > 1 )
+        if ( !isChanged )
+            continue;
+        for ( unsigned int j = 0; j < numData(); ++j )
+            msgDigest_[ msgBinding_.size() * j + i ].clear();
+        digestSrcMsg( i, targetNodes );
+    }
+    rewiredMsgs_.clear();
+}
+
+void Element::digestSrcMsg( unsigned int i,
+                            vector< vector< bool > >& targetNodes )
+{
+    bool report = 0; // for debugging
+    // Go through and identify functions with the same ptr.
+    vector< FuncOrder > fo = putFuncsInOrder( this, msgBinding_[i] );
+    for ( vector< FuncOrder >::const_iterator
+            k = fo.begin(); k != fo.end(); ++k )
+    {
+        const MsgFuncBinding& mfb = msgBinding_[i][ k->index() ];
+        putTargetsInDigest( i, mfb, *k, targetNodes );
+    }
+    if ( Shell::numNodes() > 1 )
+    {
+        if ( report )
         {
-            if ( report )
+            unsigned int numPre = findNumDigest( msgDigest_,
+                                                 msgBinding_.size(), numData(), i );
+            putOffNodeTargetsInDigest( i, targetNodes );
+            unsigned int numPost = findNumDigest( msgDigest_,
+                                                  msgBinding_.size(), numData(), i );
+            cout << "\nfor Element " << name_;
+            cout << ", Func: " << i << ", numFunc = " << fo.size() <<
+                 ", numPre= " << numPre <<
+                 ", numPost= " << numPost << endl;
+            for ( unsigned int j = 0; j < numData(); ++j )
             {
-                unsigned int numPre = findNumDigest( msgDigest_,
-                                                     msgBinding_.size(), numData(), i );
-                putOffNodeTargetsInDigest( i, targetNodes );
-                unsigned int numPost = findNumDigest( msgDigest_,
-                                                      msgBinding_.size(), numData(), i );
-                cout << "\nfor Element " << name_;
-                cout << ", Func: " << i << ", numFunc = " << fo.size() <<
-                     ", numPre= " << numPre <<
-                     ", numPost= " << numPost << endl;
-                for ( unsigned int j = 0; j < numData(); ++j )
+                cout << endl << j << "	";
+                for ( unsigned int node = 0; node < Shell::numNodes(); ++node)
                 {
-                    cout << endl << j << "	";
-                    for ( unsigned int node = 0; node < Shell::numNodes(); ++node)
-                    {
-                        cout << (int)targetNodes[j][node];
-                    }
+                    cout << (int)targetNodes[j][node];
                 }
-                cout << endl;
-            }
-            else
-            {
-                putOffNodeTargetsInDigest( i, targetNodes );
             }
+            cout << endl;
+        }
+        else
+        {
+            putOffNodeTargetsInDigest( i, targetNodes );
         }
     }
 }
@@ -708,6 +776,15 @@ void Element::markRewired( )
     isRewired_ = true;
 }
 
+void Element::markRewired( ObjId mid )
+{
+    if ( isRewired_ )
+        return;
+    if ( find( rewiredMsgs_.begin(), rewiredMsgs_.end(), mid ) ==
+            rewiredMsgs_.end() )
+        rewiredMsgs_.push_back( mid );
+}
+
 void Element::printMsgDigest( unsigned int srcIndex, unsigned int dataId ) const
 {
     unsigned int numSrcMsgs = msgBinding_.size();
@@ -726,11 +803,11 @@ void Element::printMsgDigest( unsigned int srcIndex, unsigned int dataId ) const
         for ( unsigned int j = 0; j < md.size(); ++j )
         {
             cout << j << ":	";
-            for ( unsigned int k = 0; k < md[j].targets.size(); ++k )
+            for ( MsgDigest::const_iterator
+                    k = md[j].begin(); k != md[j].end(); ++k )
             {
                 cout << "	" <<
-                     md[j].targets[k].dataIndex() << "," <<
-                     md[j].targets[k].fieldIndex();
+                     k->dataIndex() << "," << k->fieldIndex();
             }
         }
         cout << endl;
@@ -866,8 +943,8 @@ vector< ObjId > Element::getMsgTargets( DataId srcDataId,
     for ( vector< MsgDigest >::const_iterator
             i = md.begin(); i != md.end(); ++i )
     {
-        for ( vector< Eref >::const_iterator
-                j = i->targets.begin(); j != i->targets.end(); ++j )
+        for ( MsgDigest::const_iterator
+                j = i->begin(); j != i->end(); ++j )
         {
             if ( j->dataIndex() == ALLDATA )
             {
@@ -216,6 +216,19 @@ public:
      */
     void digestMessages();
 
+    /**
+     * Rebuild only the digests of SrcFinfos bound to the Msgs listed in
+     * rewiredMsgs_. Falls back to digestMessages if the digest array
+     * itself needs to change shape.
+     */
+    void redigestMessages();
+
+    /**
+     * Digest all the messages bound to a single SrcFinfo.
+     */
+    void digestSrcMsg( unsigned int srcNum,
+        vector< vector< bool > >& targetNodes );
+
     /**
      * Inner function that adds targets to a single function in the
      * MsgDigest
@@ -258,6 +271,13 @@ public:
      */
     void markRewired();
 
+    /**
+     * Flags a single Msg as changed. Only the digests of the SrcFinfos
+     * bound to that Msg are rebuilt, rather than all the messages on
+     * this Element.
+     */
+    void markRewired( ObjId mid );
+
     /**
      * Utility function for debugging
      */
@@ -442,6 +462,9 @@ private:
     /// True if messages have been changed and need to digestMessages.
     bool isRewired_;
 
+    /// Msgs changed since the last digest, if isRewired_ is not set.
+    vector< ObjId > rewiredMsgs_;
+
     /// True if the element is marked for destruction.
     bool isDoomed_;
 };
@@ -15,9 +15,16 @@ class Eref
 public:
 
     friend ostream& operator <<( ostream& s, const Eref& e );
-    Eref();
-	Eref( const Eref& other );
-    Eref( Element* e, unsigned int index, unsigned int field = 0 );
+    /// Constructors are inline as Erefs are built per target in send.
+    Eref()
+        : e_( 0 ), i_( 0 ), f_( 0 )
+    {;}
+    Eref( const Eref& other )
+        : e_( other.e_ ), i_( other.i_ ), f_( other.f_ )
+    {;}
+    Eref( Element* e, unsigned int index, unsigned int field = 0 )
+        : e_( e ), i_( index ), f_( field )
+    {;}
 
     /**
      * Returns data entry.
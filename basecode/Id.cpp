@@ -17,12 +17,13 @@
 
 Id::Id()
     // : id_( 0 ), index_( 0 )
-    : id_(0)
+    : id_(0), gen_(0)
 {
     ;
 }
 
-Id::Id(unsigned int id) : id_(id)
+Id::Id(unsigned int id)
+    : id_(id), gen_(id < generations().size() ? generations()[id] : 0)
 {
     ;
 }
@@ -31,10 +32,10 @@ Id::Id(const string& path)
 {
     Shell* shell = reinterpret_cast<Shell*>(Id().eref().data());
     assert(shell);
-    id_ = shell->doFind(path).id.id_;
+    *this = shell->doFind(path).id;
 }
 
-Id::Id(const ObjId& oi) : id_(oi.id.id_)
+Id::Id(const ObjId& oi) : id_(oi.id.id_), gen_(oi.id.gen_)
 {
     ;
 }
@@ -60,6 +61,79 @@ vector<Element*>& Id::elements()
     return e;
 }
 
+vector<unsigned int>& Id::generations()
+{
+    static vector<unsigned int> g;
+    return g;
+}
+
+//////////////////////////////////////////////////////////////
+//	Slot bookkeeping for recycling. Private to this file.
+//////////////////////////////////////////////////////////////
+
+/// Slots handed out by nextId that have not yet been bound to an Element.
+static vector<bool>& pendingSlots()
+{
+    static vector<bool> p;
+    return p;
+}
+
+/**
+ * Runs of free slots below the end of the Element table, as
+ * start -> length. Adjacent runs are always merged. Free slots at the
+ * end of the table are not kept here: the table is trimmed instead.
+ */
+static map<unsigned int, unsigned int>& freeRuns()
+{
+    static map<unsigned int, unsigned int> f;
+    return f;
+}
+
+/// Slots set aside by Id::reserveIds and not yet handed out.
+static unsigned int windowStart = 0;
+static unsigned int windowLeft = 0;
+
+/// Turned off while tearing down, when slots no longer matter.
+static bool recycleSlots = true;
+
+static void addFreeRun(unsigned int start, unsigned int len)
+{
+    map<unsigned int, unsigned int>& runs = freeRuns();
+    map<unsigned int, unsigned int>::iterator next = runs.lower_bound(start);
+    if (next != runs.end() && start + len == next->first) {
+        len += next->second;
+        runs.erase(next++);
+    }
+    if (next != runs.begin()) {
+        map<unsigned int, unsigned int>::iterator prev = next;
+        --prev;
+        if (prev->first + prev->second == start) {
+            prev->second += len;
+            return;
+        }
+    }
+    runs[start] = len;
+}
+
+/// Removes a slot that is being bound directly from the free runs.
+static void takeFromFreeRuns(unsigned int slot)
+{
+    map<unsigned int, unsigned int>& runs = freeRuns();
+    map<unsigned int, unsigned int>::iterator i = runs.upper_bound(slot);
+    if (i == runs.begin())
+        return;
+    --i;
+    unsigned int start = i->first;
+    unsigned int len = i->second;
+    if (slot >= start + len)
+        return;
+    runs.erase(i);
+    if (slot > start)
+        runs[start] = slot - start;
+    if (slot + 1 < start + len)
+        runs[slot + 1] = start + len - slot - 1;
+}
+
 //////////////////////////////////////////////////////////////
 //	Id info
 //////////////////////////////////////////////////////////////
@@ -73,6 +147,9 @@ string Id::id2str(Id id)
 // Function to convert it into its fully separated path.
 string Id::path() const
 {
+    // Deleted, or a stale id whose slot has been reused.
+    if (!element())
+        return "";
     string ret = Neutral::path(eref());
 
     // FIXME: Monday 09 March 2020 12:30:27 PM IST, Dilawar Singh
@@ -114,7 +191,10 @@ Element* Id::operator()() const
 /// Synonym for Id::operator()()
 Element* Id::element() const
 {
-    return elements()[id_];
+    unsigned int slot = value();
+    if (slot >= elements().size() || generations()[slot] != generation())
+        return 0;
+    return elements()[slot];
 }
 
 /*
@@ -126,41 +206,104 @@ unsigned int Id::index() const
 
 Eref Id::eref() const
 {
-    return Eref(elements()[id_], 0);
+    return Eref(element(), 0);
     // return Eref( elements()[ id_ ], index_ );
 }
 
 // Static func.
 Id Id::nextId()
 {
-    // Should really look up 'available' list.
-    // Should really put the returned value onto the 'reserved' list
-    // so they don't go dangling.
-    Id ret(elements().size());
-    elements().push_back(0);
+    unsigned int slot;
+    if (windowLeft > 0) {
+        slot = windowStart++;
+        --windowLeft;
+    } else {
+        slot = elements().size();
+        elements().push_back(0);
+        pendingSlots().push_back(false);
+        if (generations().size() <= slot)
+            generations().push_back(0);
+    }
+    pendingSlots()[slot] = true;
+    Id ret;
+    ret.id_ = slot;
+    ret.gen_ = generations()[slot];
     return ret;
 }
 
+// Static func.
+void Id::reserveIds(unsigned int num)
+{
+    // Give back whatever is left over from the last reservation.
+    if (windowLeft > 0) {
+        addFreeRun(windowStart, windowLeft);
+        windowLeft = 0;
+    }
+    map<unsigned int, unsigned int>& runs = freeRuns();
+    for (map<unsigned int, unsigned int>::iterator i = runs.begin();
+         i != runs.end(); ++i) {
+        if (i->second >= num) {
+            windowStart = i->first;
+            windowLeft = num;
+            if (i->second > num)
+                runs[i->first + num] = i->second - num;
+            runs.erase(i);
+            return;
+        }
+    }
+}
+
 // Static func.
 unsigned int Id::numIds()
 {
     return elements().size();
 }
 
+// Static func.
+unsigned int Id::numFreeIds()
+{
+    unsigned int ret = windowLeft;
+    for (map<unsigned int, unsigned int>::const_iterator i =
+             freeRuns().begin();
+         i != freeRuns().end(); ++i)
+        ret += i->second;
+    return ret;
+}
+
+bool Id::isValid(Id id)
+{
+    unsigned int slot = id.value();
+    return (slot < elements().size()) && (elements()[slot] != 0) &&
+           (generations()[slot] == id.generation());
+}
+
+bool Id::isValid(unsigned int id)
+{
+    return (id < elements().size()) && (elements()[id] != 0);
+}
+
 void Id::bindIdToElement(Element* e)
 {
-    if (elements().size() <= id_) {
+    unsigned int slot = value();
+    if (elements().size() <= slot) {
         if (elements().size() % 1000 == 0) {
             elements().reserve(elements().size() + 1000);
         }
-        elements().resize(id_ + 1, 0);
+        elements().resize(slot + 1, 0);
+        pendingSlots().resize(slot + 1, false);
+        if (generations().size() <= slot)
+            generations().resize(slot + 1, 0);
+    } else if (!pendingSlots()[slot]) {
+        // Bound without going through nextId.
+        takeFromFreeRuns(slot);
     }
-    assert(elements()[id_] == 0);
+    assert(elements()[slot] == 0);
     /*
     if ( elements()[ id_ ] != 0 )
         cout << "Warning: assigning Element to existing id " << id_ << "\n";
         */
-    elements()[id_] = e;
+    elements()[slot] = e;
+    pendingSlots()[slot] = false;
     // cout << "Id::bindIdToElement '" << e->getName() << "' = " << id_ << endl;
 }
 
@@ -175,30 +318,61 @@ Id Id::create( Element* e )
 
 void Id::destroy() const
 {
-    if (elements()[id_]) {
+    Element* e = element();
+    if (e) {
         // cout << "Id::destroy '" << elements()[ id_ ]->getName() << "' = " <<
         // id_ << endl;
-        delete elements()[id_];
-        elements()[id_] = 0;
-        // Put id_ on 'available' list
+        // The Element destructor zeroes out the slot and frees it.
+        delete e;
     } else {
-        cout << "Warning: Id::destroy: " << id_ << " already zeroed\n";
+        cout << "Warning: Id::destroy: " << value() << " already zeroed\n";
     }
 }
 
+/**
+ * Frees the slot for reuse. The generation is bumped so that any Ids
+ * still held for the old Element fail to find the next occupant. A slot
+ * whose generation has run out is retired instead of being reused.
+ * Free slots at the end of the table are trimmed off, and the table
+ * storage is released once it is mostly unused.
+ */
 void Id::zeroOut() const
 {
-    assert(id_ < elements().size());
-    elements()[id_] = 0;
-}
+    unsigned int slot = value();
+    assert(slot < elements().size());
+    if (elements()[slot] == 0)
+        return;
+    elements()[slot] = 0;
+    if (!recycleSlots)
+        return;
+    if (++generations()[slot] == RETIRED)
+        return;
 
-unsigned int Id::value() const
-{
-    return id_;
+    if (slot + 1 < elements().size()) {
+        addFreeRun(slot, 1);
+        return;
+    }
+    unsigned int size = slot;
+    map<unsigned int, unsigned int>& runs = freeRuns();
+    if (!runs.empty()) {
+        map<unsigned int, unsigned int>::iterator last = runs.end();
+        --last;
+        if (last->first + last->second == size) {
+            size = last->first;
+            runs.erase(last);
+        }
+    }
+    elements().resize(size);
+    pendingSlots().resize(size);
+    if (elements().capacity() > 2 * size + 1000) {
+        elements().shrink_to_fit();
+        pendingSlots().shrink_to_fit();
+    }
 }
 
 void Id::clearAllElements()
 {
+    recycleSlots = false;
     for (vector<Element*>::iterator i = elements().begin();
          i != elements().end(); ++i) {
         if (*i) {
@@ -214,7 +388,7 @@ void Id::clearAllElements()
 
 ostream& operator<<(ostream& s, const Id& i)
 {
-    s << i.id_;
+    s << i.value();
     /*
     if ( i.index_ == 0 )
         s << i.id_;
@@ -226,7 +400,9 @@ ostream& operator<<(ostream& s, const Id& i)
 
 istream& operator>>(istream& s, Id& i)
 {
-    s >> i.id_;
+    unsigned int value;
+    s >> value;
+    i = Id(value);
     return s;
 }
 
@@ -29,7 +29,8 @@ public:
     Id();
 
     /**
-     * Creates an id with the specified Element number
+     * Creates an id with the specified Element number. The id refers
+     * to whichever Element currently occupies that slot.
      */
     Id(unsigned int id);
 
@@ -53,15 +54,31 @@ public:
     /**
      * Reserves an id for assigning to an Element. Each time it is
      * called a new id is reserved, even if previous ones have not been
-     * used yet.
+     * used yet. Successive calls return consecutive ids, which is
+     * relied upon for FieldElements (parent + 1, + 2 ...). Ids are
+     * normally appended to the table; after reserveIds( n ) the next n
+     * come from a run of recycled slots instead.
      */
     static Id nextId();
 
     /**
-     * Returns the number of Ids in use.
+     * Arranges for the next 'num' calls to nextId to be served from a
+     * run of freed slots, if one is long enough. Used when the number of
+     * Elements about to be made is known, as in create and copy.
+     */
+    static void reserveIds(unsigned int num);
+
+    /**
+     * Returns the size of the Element table, including free slots.
      */
     static unsigned int numIds();
 
+    /**
+     * Returns the number of free slots in the Element table that are
+     * available for reuse.
+     */
+    static unsigned int numFreeIds();
+
     /**
      * The specified element is placed into current id.
      */
@@ -119,7 +136,10 @@ public:
      */
     static std::string id2str(Id id);
 
-    unsigned int value() const;
+    unsigned int value() const
+    {
+        return id_;
+    }
 
     //////////////////////////////////////////////////////////////
     //	Comparisons between ids
@@ -127,34 +147,28 @@ public:
     bool operator==(const Id& other) const
     {
         // return id_ == other.id_ && index_ == other.index_;
-        return id_ == other.id_;
+        return id_ == other.id_ && gen_ == other.gen_;
     }
 
     bool operator!=(const Id& other) const
     {
         // return id_ != other.id_ || index_ != other.index_;
-        return id_ != other.id_;
+        return id_ != other.id_ || gen_ != other.gen_;
     }
 
     bool operator<(const Id& other) const
     {
         //	return ( id_ < other.id_ ) ||
         //		( id_ == other.id_ && index_ < other.index_ );
-        return (id_ < other.id_);
+        return (id_ < other.id_) || (id_ == other.id_ && gen_ < other.gen_);
     }
 
     // The follwoing two functions check if the Id is associated with
     // an existing element. Needed for handling objects that have been
-    // destroyed.
-    static bool isValid(Id id)
-    {
-        return (id.id_ < elements().size()) && (elements()[id.id_] != 0);
-    }
+    // destroyed. The first also fails if the slot has since been reused.
+    static bool isValid(Id id);
 
-    static bool isValid(unsigned int id)
-    {
-        return (id < elements().size()) && (elements()[id] != 0);
-    }
+    static bool isValid(unsigned int id);
 
     //////////////////////////////////////////////////////////////
     /**
@@ -171,11 +185,30 @@ public:
     friend ostream& operator<<(ostream& s, const Id& i);
     friend istream& operator>>(istream& s, Id& i);
 
+    /**
+     * Each slot of the Element table has a generation, which is bumped
+     * every time the slot is freed, so that stale ids held over from
+     * deleted Elements do not find the Element that reuses the slot.
+     * A slot whose generation reaches RETIRED is never handed out
+     * again, so generations cannot wrap around.
+     */
+    static const unsigned int RETIRED = ~0U;
+
+    /// Generation of the slot when this id was issued.
+    unsigned int generation() const
+    {
+        return gen_;
+    }
+
+    friend void testIdGenerations();
+
 private:
     // static void setManager( Manager* m );
     unsigned int id_;  // Unique identifier for Element*
+    unsigned int gen_; // Generation of the slot id_ when this was issued.
     //		unsigned int index_; // Index of array entry within element.
     static vector<Element*>& elements();
+    static vector<unsigned int>& generations();
 };
 
 // User defined hash function.
@@ -10,6 +10,33 @@
 #ifndef _MSG_DIGEST_H
 #define _MSG_DIGEST_H
 
+/**
+ * A run of targets on a single Element, referenced in place from the
+ * row storage of a Msg (for example the CSR arrays of a SparseMsg)
+ * rather than copied out as Erefs. The Msg owns the storage, and it must
+ * flag its Elements as rewired whenever that storage changes, so that the
+ * span is rebuilt before it is next used.
+ */
+class TargetSpan
+{
+	public:
+		TargetSpan()
+				: e( 0 ), dataIndex( 0 ), fieldIndex( 0 ), num( 0 )
+		{;}
+		TargetSpan( Element* elm, const unsigned int* d,
+				const unsigned int* f, unsigned int n )
+				: e( elm ), dataIndex( d ), fieldIndex( f ), num( n )
+		{;}
+		Eref operator[]( unsigned int i ) const
+		{
+			return Eref( e, dataIndex[i], fieldIndex[i] );
+		}
+		Element* e;
+		const unsigned int* dataIndex;
+		const unsigned int* fieldIndex;
+		unsigned int num;
+};
+
 /**
  * This class manages digested Messages. Each entry is boiled down to the
  * function, and an array of targets. The targets are actually stored
@@ -17,6 +44,11 @@
  * As a further refinement, if the target DataIndex is ALLDATA, then it
  * means that all data entries in the target are to be iterated over. Note
  * that this does not extend to Field targets.
+ * Targets come either as explicit Erefs, or as TargetSpans that point
+ * into the Msg's own storage. The const_iterator walks over the Erefs
+ * first and then over each span, yielding an Eref for every target.
+ * A digest holds only one of the two kinds, so that targets are visited
+ * in the order their Msgs were bound.
  */
 class MsgDigest
 {
@@ -24,8 +56,97 @@ class MsgDigest
 		MsgDigest( const OpFunc* f, const vector< Eref >& t )
 				: func( f ), targets( t )
 		{;}
+		MsgDigest( const OpFunc* f, const TargetSpan& s )
+				: func( f ), spans( 1, s )
+		{;}
+
+		class const_iterator
+		{
+			public:
+				const_iterator( const MsgDigest* md, unsigned int seg,
+						unsigned int k )
+						: md_( md ), seg_( seg ), k_( k )
+				{
+					normalize();
+				}
+				const Eref& operator*() const
+				{
+					return cur_;
+				}
+				const Eref* operator->() const
+				{
+					return &cur_;
+				}
+				const_iterator& operator++()
+				{
+					++k_;
+					if ( seg_ > 0 && seg_ <= md_->spans.size() ) {
+						const TargetSpan& s = md_->spans[ seg_ - 1 ];
+						if ( k_ < s.num ) {
+							cur_ = s[ k_ ];
+							return *this;
+						}
+					}
+					normalize();
+					return *this;
+				}
+				bool operator==( const const_iterator& other ) const
+				{
+					return seg_ == other.seg_ && k_ == other.k_;
+				}
+				bool operator!=( const const_iterator& other ) const
+				{
+					return !( *this == other );
+				}
+			private:
+				/// Skips empty segments and loads the current target.
+				void normalize()
+				{
+					if ( seg_ == 0 ) {
+						if ( k_ < md_->targets.size() ) {
+							cur_ = md_->targets[ k_ ];
+							return;
+						}
+						seg_ = 1;
+						k_ = 0;
+					}
+					while ( seg_ <= md_->spans.size() ) {
+						const TargetSpan& s = md_->spans[ seg_ - 1 ];
+						if ( k_ < s.num ) {
+							cur_ = s[ k_ ];
+							return;
+						}
+						++seg_;
+						k_ = 0;
+					}
+				}
+				const MsgDigest* md_;
+				unsigned int seg_; /// 0 is targets, i > 0 is spans[i-1]
+				unsigned int k_;
+				Eref cur_;
+		};
+
+		const_iterator begin() const
+		{
+			return const_iterator( this, 0, 0 );
+		}
+		const_iterator end() const
+		{
+			return const_iterator( this, spans.size() + 1, 0 );
+		}
+		/// Total number of targets, explicit and in spans.
+		unsigned int numTargets() const
+		{
+			unsigned int ret = targets.size();
+			for ( vector< TargetSpan >::const_iterator
+				i = spans.begin(); i != spans.end(); ++i )
+				ret += i->num;
+			return ret;
+		}
+
 		const OpFunc* func;
 		vector< Eref > targets;
+		vector< TargetSpan > spans;
 };
 
 #endif // _MSG_DIGEST_H
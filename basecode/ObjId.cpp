@@ -119,6 +119,8 @@ char* ObjId::data() const
 
 string ObjId::path() const
 {
+    if ( !id.element() )
+        return "";
     return Neutral::path( eref() );
 }
 
@@ -110,6 +110,18 @@ public:
 
     virtual void op( const Eref& e, A arg ) const = 0;
 
+    /**
+     * Calls op on data entries start to end - 1 of the Element, as a
+     * message to all its entries does. Classes that can update all the
+     * entries of an Element in one pass override this.
+     */
+    virtual void opAll( Element* e, unsigned int start, unsigned int end,
+                        A arg ) const
+    {
+        for ( unsigned int k = start; k < end; ++k )
+            op( Eref( e, k ), arg );
+    }
+
     const OpFunc* makeHopFunc( HopIndex hopIndex) const;
 
     void opBuffer( const Eref& e, double* buf ) const
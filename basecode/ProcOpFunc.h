@@ -82,4 +82,29 @@ template< class T > class ProcOpFunc: public EpFunc1< T, ProcPtr >
 		}
 };
 
+/**
+ * A ProcOpFunc that also has a function to update all the data entries
+ * of an Element at once. The Clock sends process to whole Elements, and
+ * the batch function gets the first entry and the number of entries, so
+ * a class can go through its entries in a tight loop instead of being
+ * called once for each of them.
+ */
+template< class T > class BatchProcOpFunc: public ProcOpFunc< T >
+{
+	public:
+		BatchProcOpFunc( void ( T::*func )( const Eref& e, ProcPtr ),
+			void ( *batch )( const Eref& e, unsigned int n, ProcPtr ) )
+			: ProcOpFunc< T >( func ), batch_( batch )
+			{;}
+
+		void opAll( Element* e, unsigned int start, unsigned int end,
+			ProcPtr p ) const {
+			if ( start < end )
+				batch_( Eref( e, start ), end - start, p );
+		}
+
+	private:
+		void ( *batch_ )( const Eref& e, unsigned int n, ProcPtr );
+};
+
 #endif //_PROC_OPFUNC_H
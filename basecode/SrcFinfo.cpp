@@ -74,8 +74,8 @@ void SrcFinfo0::send( const Eref& e ) const {
 		const OpFunc0Base* f =
 			dynamic_cast< const OpFunc0Base* >( i->func );
 		assert( f );
-		for ( vector< Eref >::const_iterator
-			j = i->targets.begin(); j != i->targets.end(); ++j ) {
+		for ( MsgDigest::const_iterator
+			j = i->begin(); j != i->end(); ++j ) {
 			if ( j->dataIndex() == ALLDATA ) {
 				Element* e = j->element();
 				unsigned int start = e->localDataStart();
@@ -104,14 +104,12 @@ template < class T > class SrcFinfo1: public SrcFinfo
 				const OpFunc1Base< T >* f =
 					dynamic_cast< const OpFunc1Base< T >* >( i->func );
 				assert( f );
-				for ( vector< Eref >::const_iterator
-					j = i->targets.begin(); j != i->targets.end(); ++j ) {
+				for ( MsgDigest::const_iterator
+					j = i->begin(); j != i->end(); ++j ) {
 					if ( j->dataIndex() == ALLDATA ) {
 						Element* e = j->element();
 						unsigned int start = e->localDataStart();
-						unsigned int end = start + e->numLocalData();
-						for ( unsigned int k = start; k < end; ++k )
-							f->op( Eref( e, k ), arg );
+						f->opAll( e, start, start + e->numLocalData(), arg );
 					} else  {
 						f->op( *j, arg );
 						// Need to send stuff offnode too here. The
@@ -132,16 +130,14 @@ template < class T > class SrcFinfo1: public SrcFinfo
 				const OpFunc1Base< T >* f =
 					dynamic_cast< const OpFunc1Base< T >* >( i->func );
 				assert( f );
-				for ( vector< Eref >::const_iterator
-					j = i->targets.begin(); j != i->targets.end(); ++j ) {
+				for ( MsgDigest::const_iterator
+					j = i->begin(); j != i->end(); ++j ) {
 					if ( j->element() != tgt.element() )
 						continue; // Wasteful unless very few dests.
 					if ( j->dataIndex() == ALLDATA ) {
 						Element* e = j->element();
 						unsigned int start = e->localDataStart();
-						unsigned int end = start + e->numLocalData();
-						for ( unsigned int k = start; k < end; ++k )
-							f->op( Eref( e, k ), arg );
+						f->opAll( e, start, start + e->numLocalData(), arg );
 					} else  {
 						f->op( *j, arg );
 						// Need to send stuff offnode too here. The
@@ -170,8 +166,8 @@ template < class T > class SrcFinfo1: public SrcFinfo
 				const OpFunc1Base< T >* f =
 					dynamic_cast< const OpFunc1Base< T >* >( i->func );
 				assert( f );
-				for ( vector< Eref >::const_iterator
-					j = i->targets.begin(); j != i->targets.end(); ++j ) {
+				for ( MsgDigest::const_iterator
+					j = i->begin(); j != i->end(); ++j ) {
 					if ( j->dataIndex() == ALLDATA ) {
 						Element* e = j->element();
 						unsigned int start = e->localDataStart();
@@ -226,8 +222,8 @@ template < class T1, class T2 > class SrcFinfo2: public SrcFinfo
 				const OpFunc2Base< T1, T2 >* f =
 					dynamic_cast< const OpFunc2Base< T1, T2 >* >( i->func );
 				assert( f );
-				for ( vector< Eref >::const_iterator
-					j = i->targets.begin(); j != i->targets.end(); ++j ) {
+				for ( MsgDigest::const_iterator
+					j = i->begin(); j != i->end(); ++j ) {
 					if ( j->dataIndex() == ALLDATA ) {
 						Element* e = j->element();
 						unsigned int start = e->localDataStart();
@@ -250,8 +246,8 @@ template < class T1, class T2 > class SrcFinfo2: public SrcFinfo
 				const OpFunc2Base< T1, T2 >* f =
 					dynamic_cast< const OpFunc2Base< T1, T2 >* >( i->func );
 				assert( f );
-				for ( vector< Eref >::const_iterator
-					j = i->targets.begin(); j != i->targets.end(); ++j ) {
+				for ( MsgDigest::const_iterator
+					j = i->begin(); j != i->end(); ++j ) {
 					if ( j->element() != tgt.element() )
 						continue; // Wasteful unless very few dests.
 					if ( j->dataIndex() == ALLDATA ) {
@@ -305,8 +301,8 @@ template < class T1, class T2, class T3 > class SrcFinfo3: public SrcFinfo
 					dynamic_cast< const OpFunc3Base< T1, T2, T3 >* >(
 									i->func );
 				assert( f );
-				for ( vector< Eref >::const_iterator
-					j = i->targets.begin(); j != i->targets.end(); ++j ) {
+				for ( MsgDigest::const_iterator
+					j = i->begin(); j != i->end(); ++j ) {
 					if ( j->dataIndex() == ALLDATA ) {
 						Element* e = j->element();
 						unsigned int start = e->localDataStart();
@@ -357,8 +353,8 @@ template < class T1, class T2, class T3, class T4 > class SrcFinfo4: public SrcF
 					dynamic_cast< const OpFunc4Base< T1, T2, T3, T4 >* >(
 									i->func );
 				assert( f );
-				for ( vector< Eref >::const_iterator
-					j = i->targets.begin(); j != i->targets.end(); ++j ) {
+				for ( MsgDigest::const_iterator
+					j = i->begin(); j != i->end(); ++j ) {
 					if ( j->dataIndex() == ALLDATA ) {
 						Element* e = j->element();
 						unsigned int start = e->localDataStart();
@@ -411,8 +407,8 @@ template < class T1, class T2, class T3, class T4, class T5 > class SrcFinfo5: p
 					dynamic_cast<
 					const OpFunc5Base< T1, T2, T3, T4, T5 >* >( i->func );
 				assert( f );
-				for ( vector< Eref >::const_iterator
-					j = i->targets.begin(); j != i->targets.end(); ++j ) {
+				for ( MsgDigest::const_iterator
+					j = i->begin(); j != i->end(); ++j ) {
 					if ( j->dataIndex() == ALLDATA ) {
 						Element* e = j->element();
 						unsigned int start = e->localDataStart();
@@ -469,8 +465,8 @@ template < class T1, class T2, class T3, class T4, class T5, class T6 > class Sr
 					const OpFunc6Base< T1, T2, T3, T4, T5, T6 >* >(
 									i->func );
 				assert( f );
-				for ( vector< Eref >::const_iterator
-					j = i->targets.begin(); j != i->targets.end(); ++j ) {
+				for ( MsgDigest::const_iterator
+					j = i->begin(); j != i->end(); ++j ) {
 					if ( j->dataIndex() == ALLDATA ) {
 						Element* e = j->element();
 						unsigned int start = e->localDataStart();
@@ -59,13 +59,15 @@ const unsigned int BADINDEX = ~1U;
 #include "ProcInfo.h"
 #include "MsgFuncBinding.h"
 #include "../msg/Msg.h"
+#include "Arena.h"
 #include "Dinfo.h"
-#include "MsgDigest.h"
+class MsgDigest;
 #include "Element.h"
 #include "DataElement.h"
 #include "GlobalDataElement.h"
 #include "LocalDataElement.h"
 #include "Eref.h"
+#include "MsgDigest.h"
 #include "Conv.h"
 #include "SrcFinfo.h"
 
@@ -110,6 +110,51 @@ void testSendMsg()
 
 // This used to use parent/child msg, but that has other implications
 // as it causes deletion of elements.
+/**
+ * Eref and span targets bound to the same function must be visited in
+ * binding order.
+ */
+void testDigestOrder()
+{
+    const Cinfo* ac = Arith::initCinfo();
+    const DestFinfo* df =
+        dynamic_cast<const DestFinfo*>(ac->findFinfo("setOutputValue"));
+    assert(df != 0);
+    FuncId fid = df->getFid();
+
+    Id i1 = Id::nextId();
+    Element* e1 = new GlobalDataElement(i1, ac, "src", 1);
+    Id i2 = Id::nextId();
+    Element* e2 = new GlobalDataElement(i2, ac, "dest", 5);
+
+    SrcFinfo1<double> s("test", "");
+    s.setBindIndex(0);
+    Msg* m = new SingleMsg(Eref(e1, 0), Eref(e2, 0), 0);
+    e1->addMsgAndFunc(m->mid(), fid, s.getBindIndex());
+    SparseMsg* sm = new SparseMsg(e1, e2, 0);
+    sm->setEntry(0, 1, 0);
+    sm->setEntry(0, 2, 0);
+    e1->addMsgAndFunc(sm->mid(), fid, s.getBindIndex());
+    m = new SingleMsg(Eref(e1, 0), Eref(e2, 3), 0);
+    e1->addMsgAndFunc(m->mid(), fid, s.getBindIndex());
+    sm = new SparseMsg(e1, e2, 0);
+    sm->setEntry(0, 4, 0);
+    e1->addMsgAndFunc(sm->mid(), fid, s.getBindIndex());
+
+    const vector<MsgDigest>& md = e1->msgDigest(0);
+    assert(md.size() == 4);
+    unsigned int k = 0;
+    for(unsigned int i = 0; i < md.size(); ++i)
+        for(MsgDigest::const_iterator j = md[i].begin(); j != md[i].end();
+                ++j)
+            assert(j->dataIndex() == k++);
+    assert(k == 5);
+    cout << "." << flush;
+
+    delete e1;
+    delete e2;
+}
+
 void testCreateMsg()
 {
     const Cinfo* ac = Arith::initCinfo();
@@ -1807,11 +1852,71 @@ void testHopFunc()
     cout << "." << flush;
 }
 
+/**
+ * Cycles one slot of the Element table past the point where an 8-bit
+ * generation would have wrapped, and on until the slot is retired.
+ */
+void testIdGenerations()
+{
+    const Cinfo* nc = Neutral::initCinfo();
+    // Use up the free slots so that the next reservation is ours.
+    vector<Id> held;
+    while (Id::numFreeIds() > 0) {
+        Id::reserveIds(1);
+        Id i = Id::nextId();
+        new GlobalDataElement(i, nc, "held", 1);
+        held.push_back(i);
+    }
+    Id a = Id::nextId();
+    new GlobalDataElement(a, nc, "a", 1);
+    Id b = Id::nextId();  // Keeps a's slot off the end of the table.
+    new GlobalDataElement(b, nc, "b", 1);
+    unsigned int slot = a.value();
+
+    Id::generations()[slot] = 250;
+    a = Id(slot);
+    vector<Id> stale;
+    for (unsigned int k = 0; k < 10; ++k) {
+        a.destroy();
+        stale.push_back(a);
+        Id::reserveIds(1);
+        a = Id::nextId();
+        assert(a.value() == slot);
+        assert(a.generation() == 251 + k);
+        new GlobalDataElement(a, nc, "a", 1);
+        for (unsigned int j = 0; j < stale.size(); ++j) {
+            assert(!Id::isValid(stale[j]));
+            assert(stale[j].element() == 0);
+            assert(stale[j] != a);
+        }
+        assert(a.element()->getName() == "a");
+    }
+
+    // A saturated slot is retired rather than wrapped.
+    Id::generations()[slot] = Id::RETIRED - 1;
+    a = Id(slot);
+    a.destroy();
+    assert(Id::generations()[slot] == Id::RETIRED);
+    assert(Id(slot).element() == 0);
+    Id::reserveIds(1);
+    Id c = Id::nextId();
+    assert(c.value() != slot);
+    new GlobalDataElement(c, nc, "c", 1);
+    assert(!Id::isValid(a));
+
+    c.destroy();
+    b.destroy();
+    for (unsigned int j = 0; j < held.size(); ++j)
+        held[j].destroy();
+    cout << "." << flush;
+}
+
 void testAsync()
 {
     showFields();
 #ifdef DO_UNIT_TESTS
     testSendMsg();
+    testDigestOrder();
     testCreateMsg();
     testSetGet();
     testSetGetDouble();
@@ -1839,5 +1944,6 @@ void testAsync()
     testCinfoElements();
     testMsgSrcDestFields();
     testHopFunc();
+    testIdGenerations();
 #endif
 }
@@ -10,6 +10,7 @@
 #include "../basecode/header.h"
 #include "CaConcBase.h"
 #include "CaConc.h"
+#include "../shell/Checkpoint.h"
 
 
 const Cinfo* CaConc::initCinfo()
@@ -40,6 +41,7 @@ const Cinfo* CaConc::initCinfo()
 ///////////////////////////////////////////////////
 
 static const Cinfo* caConcCinfo = CaConc::initCinfo();
+static CheckpointHandler< CaConc > caConcCheckpoint( "CaConc" );
 
 CaConc::CaConc()
 	: CaConcBase(),
@@ -157,6 +159,24 @@ void CaConc::vDecrease( const Eref& e, double I )
 	activation_ -= fabs( I );
 }
 
+///////////////////////////////////////////////////
+// Checkpoints
+///////////////////////////////////////////////////
+
+void CaConc::saveState( CheckpointWriter& w ) const
+{
+	w.addValue( "Ca", Ca_ );
+	w.addValue( "c", c_ );
+	w.addValue( "activation", activation_ );
+}
+
+void CaConc::loadState( CheckpointReader& r )
+{
+	r.getValue( "Ca", Ca_ );
+	r.getValue( "c", c_ );
+	r.getValue( "activation", activation_ );
+}
+
 ///////////////////////////////////////////////////
 // Unit tests
 ///////////////////////////////////////////////////
@@ -33,6 +33,9 @@
  * be taken as an absolute value of B, without scaling.
  */
 
+class CheckpointWriter;
+class CheckpointReader;
+
 class CaConc: public CaConcBase
 {
 	public:
@@ -63,6 +66,10 @@ class CaConc: public CaConcBase
         void vSetFloor( const Eref& e, double val );
         double vGetFloor( const Eref& e ) const;
 
+		/// Checkpoint support, see shell/Checkpoint.h
+		void saveState( CheckpointWriter& w ) const;
+		void loadState( CheckpointReader& r );
+
 		static const Cinfo* initCinfo();
 	private:
 		double Ca_;
@@ -40,7 +40,8 @@ const Cinfo* ChanBase::initCinfo()
 	/////////////////////////////////////////////////////////////////////
 	static DestFinfo process( "process",
 		"Handles process call",
-		new ProcOpFunc< ChanBase >( &ChanBase::process ) );
+		new BatchProcOpFunc< ChanBase >( &ChanBase::process,
+			&ChanBase::processAll ) );
 	static DestFinfo reinit( "reinit",
 		"Handles reinit call",
 		new ProcOpFunc< ChanBase >( &ChanBase::reinit ) );
@@ -251,6 +252,22 @@ void ChanBase::process(  const Eref& e, const ProcPtr info )
 }
 
 
+void ChanBase::processAll( const Eref& e, unsigned int n,
+				const ProcPtr info )
+{
+	reinterpret_cast< ChanBase* >( e.data() )->vProcessAll( e, n, info );
+}
+
+void ChanBase::vProcessAll( const Eref& e, unsigned int n,
+				const ProcPtr info )
+{
+	Element* elm = e.element();
+	for ( unsigned int i = 0; i < n; ++i ) {
+		Eref er( elm, e.dataIndex() + i );
+		reinterpret_cast< ChanBase* >( er.data() )->vProcess( er, info );
+	}
+}
+
 void ChanBase::reinit(  const Eref& e, const ProcPtr info )
 {
 	vReinit( e, info );
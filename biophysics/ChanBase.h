@@ -69,6 +69,17 @@ class ChanBase
 		virtual void vProcess( const Eref& e, const ProcPtr info ) = 0;
 		virtual void vReinit( const Eref& e, const ProcPtr info ) = 0;
 
+		/**
+		 * Does process for the n entries of an Element starting at e,
+		 * when the Clock sends process to the whole Element. This calls
+		 * vProcessAll on the first entry, which by default calls
+		 * vProcess on each one.
+		 */
+		static void processAll( const Eref& e, unsigned int n,
+						const ProcPtr info );
+		virtual void vProcessAll( const Eref& e, unsigned int n,
+						const ProcPtr info );
+
 		/////////////////////////////////////////////////////////////
 		static SrcFinfo1< double >* permeability();
 		static SrcFinfo2< double, double >* channelOut();
@@ -9,6 +9,7 @@
 // #include "../basecode/header.h"
 // #include "ChanBase.h"
 #include "ChanCommon.h"
+#include "../shell/Checkpoint.h"
 
 
 ///////////////////////////////////////////////////
@@ -132,3 +133,17 @@ double ChanCommon::getGbar() const
 {
     return Gbar_;
 }
+
+void ChanCommon::saveState( CheckpointWriter& w ) const
+{
+    w.addValue( "Vm", Vm_ );
+    w.addValue( "Gk", Gk_ );
+    w.addValue( "Ik", Ik_ );
+}
+
+void ChanCommon::loadState( CheckpointReader& r )
+{
+    r.getValue( "Vm", Vm_ );
+    r.getValue( "Gk", Gk_ );
+    r.getValue( "Ik", Ik_ );
+}
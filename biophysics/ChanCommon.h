@@ -22,6 +22,9 @@
  * being zombified by the solver.
  */
 
+class CheckpointWriter;
+class CheckpointReader;
+
 class ChanCommon: public ChanBase
 {
 public:
@@ -75,6 +78,14 @@ public:
     /// Utility function to acces Gbar
     double getGbar() const;
 
+    /**
+     * Checkpoint support for the derived classes. ChanCommon is not
+     * registered itself, so that channels which do not save their gate
+     * states are left alone rather than half restored.
+     */
+    void saveState( CheckpointWriter& w ) const;
+    void loadState( CheckpointReader& r );
+
     /// Specify the Class Info static variable for initialization.
     static const Cinfo* initCinfo();
 protected:
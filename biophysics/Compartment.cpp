@@ -11,6 +11,7 @@
 #include "../randnum/randnum.h"
 #include "CompartmentBase.h"
 #include "Compartment.h"
+#include "../shell/Checkpoint.h"
 
 using namespace moose;
 const double Compartment::EPSILON = 1.0e-15;
@@ -34,7 +35,7 @@ const Cinfo* Compartment::initCinfo()
         "Author", "Upi Bhalla",
         "Description", "Compartment object, for branching neuron models.",
     };
-    static Dinfo< Compartment > dinfo;
+    static ArenaDinfo< Compartment > dinfo;
     static Cinfo compartmentCinfo(
         "Compartment",
         CompartmentBase::initCinfo(),
@@ -51,6 +52,7 @@ const Cinfo* Compartment::initCinfo()
 }
 
 static const Cinfo* compartmentCinfo = Compartment::initCinfo();
+static CheckpointHandler< Compartment > compartmentCheckpoint( "Compartment" );
 
 
 /*
@@ -180,22 +182,7 @@ double Compartment::vGetInitVm( const Eref& e ) const
 
 void Compartment::vProcess( const Eref& e, ProcPtr p )
 {
-    //cout << "Compartment " << e.id().path() << ":: process: A = " << A_ << ", B = " << B_ << endl;
-    A_ += inject_ + sumInject_ + Em_ * invRm_;
-    if ( B_ > EPSILON )
-    {
-        double x = exp( -B_ * p->dt / Cm_ );
-        Vm_ = Vm_ * x + ( A_ / B_ )  * ( 1.0 - x );
-    }
-    else
-    {
-        Vm_ += ( A_ - Vm_ * B_ ) * p->dt / Cm_;
-    }
-    A_ = 0.0;
-    B_ = invRm_;
-    lastIm_ = Im_;
-    Im_ = 0.0;
-    sumInject_ = 0.0;
+    integrate( p->dt );
     // Send out Vm to channels, SpikeGens, etc.
     VmOut()->send( e, Vm_ );
 
@@ -264,6 +251,31 @@ void Compartment::vRandInject( const Eref& e, double prob, double current)
     }
 }
 
+/////////////////////////////////////////////////////////////////////
+// Checkpoints. A_, B_ and the currents hold the inputs already
+// received for the next step.
+/////////////////////////////////////////////////////////////////////
+
+void Compartment::saveState( CheckpointWriter& w ) const
+{
+    w.addValue( "Vm", Vm_ );
+    w.addValue( "Im", Im_ );
+    w.addValue( "lastIm", lastIm_ );
+    w.addValue( "A", A_ );
+    w.addValue( "B", B_ );
+    w.addValue( "sumInject", sumInject_ );
+}
+
+void Compartment::loadState( CheckpointReader& r )
+{
+    r.getValue( "Vm", Vm_ );
+    r.getValue( "Im", Im_ );
+    r.getValue( "lastIm", lastIm_ );
+    r.getValue( "A", A_ );
+    r.getValue( "B", B_ );
+    r.getValue( "sumInject", sumInject_ );
+}
+
 /////////////////////////////////////////////////////////////////////
 
 #ifdef DO_UNIT_TESTS
@@ -11,6 +11,9 @@
 #ifndef _COMPARTMENT_H
 #define _COMPARTMENT_H
 
+class CheckpointWriter;
+class CheckpointReader;
+
 /**
  * The Compartment class sets up an asymmetric compartment for
  * branched nerve calculations. Handles electronic structure and
@@ -110,12 +113,39 @@ public:
     void cable();
 
 
+    /// Checkpoint support, see shell/Checkpoint.h
+    void saveState( CheckpointWriter& w ) const;
+    void loadState( CheckpointReader& r );
+
     /**
      * Initializes the class info.
      */
     static const Cinfo* initCinfo();
 
 protected:
+    /**
+     * Advances Vm_ by dt from the currents gathered since the last step,
+     * and clears them. This is vProcess without the outgoing message.
+     */
+    void integrate( double dt )
+    {
+        A_ += inject_ + sumInject_ + Em_ * invRm_;
+        if ( B_ > EPSILON )
+        {
+            double x = exp( -B_ * dt / Cm_ );
+            Vm_ = Vm_ * x + ( A_ / B_ )  * ( 1.0 - x );
+        }
+        else
+        {
+            Vm_ += ( A_ - Vm_ * B_ ) * dt / Cm_;
+        }
+        A_ = 0.0;
+        B_ = invRm_;
+        lastIm_ = Im_;
+        Im_ = 0.0;
+        sumInject_ = 0.0;
+    }
+
     double Vm_;
     double initVm_;
     double Em_;
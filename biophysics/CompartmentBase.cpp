@@ -63,7 +63,8 @@ const Cinfo* CompartmentBase::initCinfo()
 	///////////////////////////////////////////////////////////////////
 	static DestFinfo process( "process",
 		"Handles 'process' call",
-		new ProcOpFunc< CompartmentBase >( &CompartmentBase::process ) );
+		new BatchProcOpFunc< CompartmentBase >( &CompartmentBase::process,
+			&CompartmentBase::processAll ) );
 
 	static DestFinfo reinit( "reinit",
 		"Handles 'reinit' call",
@@ -608,6 +609,22 @@ void CompartmentBase::process( const Eref& e, ProcPtr p )
 	vProcess( e, p );
 }
 
+void CompartmentBase::processAll( const Eref& e, unsigned int n,
+				ProcPtr p )
+{
+	reinterpret_cast< CompartmentBase* >( e.data() )->vProcessAll( e, n, p );
+}
+
+void CompartmentBase::vProcessAll( const Eref& e, unsigned int n,
+				ProcPtr p )
+{
+	Element* elm = e.element();
+	for ( unsigned int i = 0; i < n; ++i ) {
+		Eref er( elm, e.dataIndex() + i );
+		reinterpret_cast< CompartmentBase* >( er.data() )->vProcess( er, p );
+	}
+}
+
 void CompartmentBase::reinit(  const Eref& e, ProcPtr p )
 {
 	vReinit( e, p );
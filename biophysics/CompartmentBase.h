@@ -67,6 +67,13 @@ class CompartmentBase
 			 */
 			void process( const Eref& e, ProcPtr p );
 
+			/**
+			 * Does process for the n entries of an Element starting at e,
+			 * when the Clock sends process to the whole Element.
+			 */
+			static void processAll( const Eref& e, unsigned int n,
+							ProcPtr p );
+
 			/**
 			 * The reinit function reinitializes all fields.
 			 */
@@ -161,6 +168,13 @@ class CompartmentBase
 			 */
 			virtual void vProcess( const Eref& e, ProcPtr p ) = 0;
 
+			/**
+			 * Called on the first of n entries of an Element to process
+			 * all of them. By default it calls vProcess on each one.
+			 */
+			virtual void vProcessAll( const Eref& e, unsigned int n,
+							ProcPtr p );
+
 			/**
 			 * The reinit function reinitializes all fields.
 			 */
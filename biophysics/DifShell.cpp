@@ -373,6 +373,15 @@ void DifShell::vProcess( const Eref & e, ProcPtr p )
   concentrationOut()->send( e, C_ );
 
 }
+
+void DifShell::takeRates( double& A, double& B )
+{
+  A = dCbyDt_;
+  B = Cmultiplier_;
+  dCbyDt_ = leak_;
+  Cmultiplier_ = 0;
+}
+
 void DifShell::vBuffer(const Eref& e,
 			   double kf,
 			   double kb,
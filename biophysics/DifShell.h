@@ -76,6 +76,13 @@ class DifShell: public DifShellBase{
 
   void calculateVolumeArea(const Eref& e);
 
+  /**
+   * Used by DifShellSolver: hands over the rate terms accumulated from
+   * incoming messages since the last step (dC/dt = A - B*C, with the
+   * leak folded into A) and clears them, as vProcess would have.
+   */
+  void takeRates( double& A, double& B );
+
   static const Cinfo * initCinfo();
 
 
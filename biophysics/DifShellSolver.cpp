@@ -0,0 +1,669 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Multiscale Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2016 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include "../basecode/header.h"
+#include "../basecode/ElementValueFinfo.h"
+#include "../shell/Wildcard.h"
+#include <set>
+#include "DifShellBase.h"
+#include "DifShell.h"
+#include "DifBufferBase.h"
+#include "MMPump.h"
+#include "DifShellSolver.h"
+
+const Cinfo* DifShellSolver::initCinfo()
+{
+    ///////////////////////////////////////////////////////
+    // Field definitions
+    ///////////////////////////////////////////////////////
+    static ElementValueFinfo< DifShellSolver, string > path(
+        "path",
+        "Wildcard path of the DifShells to be solved. The DifBuffers "
+        "and MMPumps connected to these shells are taken over too. "
+        "Shells must form unbranched radial chains, connected through "
+        "their fluxFromOut and fluxFromIn messages.",
+        &DifShellSolver::setPath,
+        &DifShellSolver::getPath
+    );
+    static ReadOnlyValueFinfo< DifShellSolver, unsigned int > numShells(
+        "numShells",
+        "Number of DifShells handled by the solver.",
+        &DifShellSolver::getNumShells
+    );
+    static ReadOnlyValueFinfo< DifShellSolver, unsigned int > numChains(
+        "numChains",
+        "Number of independent radial chains of shells, typically one "
+        "per compartment.",
+        &DifShellSolver::getNumChains
+    );
+    static ReadOnlyValueFinfo< DifShellSolver, unsigned int > numBuffers(
+        "numBuffers",
+        "Number of DifBuffers handled by the solver.",
+        &DifShellSolver::getNumBuffers
+    );
+    static ReadOnlyValueFinfo< DifShellSolver, unsigned int > numPumps(
+        "numPumps",
+        "Number of MMPumps handled by the solver.",
+        &DifShellSolver::getNumPumps
+    );
+
+    ///////////////////////////////////////////////////////
+    // MsgDest definitions
+    ///////////////////////////////////////////////////////
+    static DestFinfo process( "process",
+        "Handles process call",
+        new ProcOpFunc< DifShellSolver >( &DifShellSolver::process ) );
+    static DestFinfo reinit( "reinit",
+        "Handles reinit call",
+        new ProcOpFunc< DifShellSolver >( &DifShellSolver::reinit ) );
+
+    ///////////////////////////////////////////////////////
+    // SharedMsg definitions
+    ///////////////////////////////////////////////////////
+    static Finfo* procShared[] =
+    {
+        &process, &reinit
+    };
+    static SharedFinfo proc( "proc",
+        "Shared message for process and reinit",
+        procShared, sizeof( procShared ) / sizeof( const Finfo* )
+    );
+
+    static Finfo* difShellSolverFinfos[] =
+    {
+        &path,              // Value
+        &numShells,         // ReadOnlyValue
+        &numChains,         // ReadOnlyValue
+        &numBuffers,        // ReadOnlyValue
+        &numPumps,          // ReadOnlyValue
+        &proc,              // SharedFinfo
+    };
+
+    static string doc[] =
+    {
+        "Name", "DifShellSolver",
+        "Description",
+        "Implicit solver for radial calcium diffusion. Takes over the "
+        "DifShells on its path along with their DifBuffers and MMPumps, "
+        "and advances each chain of shells with one tridiagonal "
+        "backward Euler solve per step. Buffer binding is eliminated "
+        "locally in each shell and the pumps are linearised about the "
+        "current concentration, so the system stays stable at the "
+        "timesteps used for the electrical model. "
+        "Runs alongside HSolve: influx from channels and other external "
+        "messages to the shells are still delivered and are picked up "
+        "by the solver every step.",
+    };
+
+    static Dinfo< DifShellSolver > dinfo;
+    static Cinfo difShellSolverCinfo(
+        "DifShellSolver",
+        Neutral::initCinfo(),
+        difShellSolverFinfos,
+        sizeof( difShellSolverFinfos ) / sizeof( Finfo* ),
+        &dinfo,
+        doc,
+        sizeof( doc ) / sizeof( string )
+    );
+
+    return &difShellSolverCinfo;
+}
+
+static const Cinfo* difShellSolverCinfo = DifShellSolver::initCinfo();
+
+static const unsigned int NONE = ~0U;
+
+DifShellSolver::DifShellSolver()
+    : numChains_( 0 )
+{;}
+
+///////////////////////////////////////////////////
+// Field function definitions
+///////////////////////////////////////////////////
+
+string DifShellSolver::getPath( const Eref& e ) const
+{
+    return path_;
+}
+
+unsigned int DifShellSolver::getNumShells() const
+{
+    return shell_.size();
+}
+
+unsigned int DifShellSolver::getNumChains() const
+{
+    return numChains_;
+}
+
+unsigned int DifShellSolver::getNumBuffers() const
+{
+    return buffer_.size();
+}
+
+unsigned int DifShellSolver::getNumPumps() const
+{
+    return pump_.size();
+}
+
+void DifShellSolver::setPath( const Eref& e, string path )
+{
+    unzombify();
+    path_ = path;
+
+    vector< ObjId > found;
+    vector< ObjId > shells;
+    wildcardFind( path, found );
+    for ( vector< ObjId >::iterator i = found.begin(); i != found.end(); ++i )
+        if ( i->element()->cinfo()->isA( "DifShell" ) )
+            shells.push_back( *i );
+
+    if ( !build( shells ) || !resolve() ) {
+        clear();
+        return;
+    }
+
+    for ( vector< pair< Id, int > >::iterator
+            i = zombies_.begin(); i != zombies_.end(); ++i ) {
+        i->second = i->first.element()->getTick();
+        i->first.element()->setTick( -1 );
+    }
+    setupCoupling();
+}
+
+void DifShellSolver::clear()
+{
+    shell_.clear();
+    buffer_.clear();
+    pump_.clear();
+    shellEr_.clear();
+    bufferEr_.clear();
+    pumpEr_.clear();
+    zombies_.clear();
+    numChains_ = 0;
+}
+
+///////////////////////////////////////////////////
+// Setup
+///////////////////////////////////////////////////
+
+/**
+ * Returns the entry of a neighbour element that pairs with entry 'index'
+ * of the current one: the element itself if it has a single entry,
+ * otherwise the matching entry of an array of the same shape.
+ */
+static ObjId pairedEntry( Id nbr, unsigned int index )
+{
+    if ( nbr.element()->numData() == 1 )
+        return ObjId( nbr, 0 );
+    return ObjId( nbr, index );
+}
+
+static void findInputs( const Eref& er, const Finfo* finfo,
+                        const string& className, vector< ObjId >& ret )
+{
+    vector< Id > nbrs;
+    ret.clear();
+    er.element()->getNeighbors( nbrs, finfo );
+    for ( vector< Id >::iterator i = nbrs.begin(); i != nbrs.end(); ++i ) {
+        if ( !i->element()->cinfo()->isA( className ) )
+            continue;
+        ObjId oid = pairedEntry( *i, er.dataIndex() );
+        if ( oid.dataIndex < i->element()->numData() )
+            ret.push_back( oid );
+    }
+}
+
+bool DifShellSolver::build( const vector< ObjId >& shells )
+{
+    const Cinfo* shellCinfo = DifShellBase::initCinfo();
+    const Cinfo* bufCinfo = DifBufferBase::initCinfo();
+    const Finfo* fromOut = shellCinfo->findFinfo( "fluxFromOut" );
+    const Finfo* fromIn = shellCinfo->findFinfo( "fluxFromIn" );
+    const Finfo* reaction = shellCinfo->findFinfo( "reaction" );
+    const Finfo* mmPump = shellCinfo->findFinfo( "mmPump" );
+    const Finfo* bufFromOut = bufCinfo->findFinfo( "fluxFromOut" );
+
+    map< ObjId, unsigned int > index;
+    vector< ObjId > unique;
+    for ( vector< ObjId >::const_iterator
+            i = shells.begin(); i != shells.end(); ++i ) {
+        if ( index.find( *i ) == index.end() ) {
+            index[ *i ] = unique.size();
+            unique.push_back( *i );
+        }
+    }
+    unsigned int num = unique.size();
+
+    // Neighbours in the original ordering. A shell hears from its outer
+    // neighbour through fluxFromOut and from its inner one through
+    // fluxFromIn.
+    vector< unsigned int > outer( num, NONE );
+    vector< unsigned int > inner( num, NONE );
+    vector< bool > sendsOut( num, false );
+    vector< bool > sendsIn( num, false );
+    vector< ObjId > nbrs;
+    for ( unsigned int i = 0; i < num; ++i ) {
+        Eref er = unique[i].eref();
+        findInputs( er, fromOut, "DifShellBase", nbrs );
+        for ( vector< ObjId >::iterator
+                j = nbrs.begin(); j != nbrs.end(); ++j ) {
+            map< ObjId, unsigned int >::iterator k = index.find( *j );
+            if ( k == index.end() ) {
+                sendsIn[i] = true;
+            } else if ( outer[i] == NONE ) {
+                outer[i] = k->second;
+            } else if ( outer[i] != k->second ) {
+                cout << "Warning: DifShellSolver::setPath: " <<
+                     unique[i].path() << " has more than one outer shell. "
+                     "Only unbranched chains can be solved.\n";
+                return false;
+            }
+        }
+        findInputs( er, fromIn, "DifShellBase", nbrs );
+        for ( vector< ObjId >::iterator
+                j = nbrs.begin(); j != nbrs.end(); ++j ) {
+            map< ObjId, unsigned int >::iterator k = index.find( *j );
+            if ( k == index.end() ) {
+                sendsOut[i] = true;
+            } else if ( inner[i] == NONE ) {
+                inner[i] = k->second;
+            } else if ( inner[i] != k->second ) {
+                cout << "Warning: DifShellSolver::setPath: " <<
+                     unique[i].path() << " has more than one inner shell. "
+                     "Only unbranched chains can be solved.\n";
+                return false;
+            }
+        }
+    }
+
+    // Order the shells chain by chain, outermost first.
+    vector< unsigned int > order;
+    vector< unsigned int > newIndex( num, NONE );
+    numChains_ = 0;
+    for ( unsigned int i = 0; i < num; ++i ) {
+        if ( outer[i] != NONE )
+            continue;
+        ++numChains_;
+        for ( unsigned int j = i; j != NONE; j = inner[j] ) {
+            if ( newIndex[j] != NONE )
+                break;
+            newIndex[j] = order.size();
+            order.push_back( j );
+        }
+    }
+    if ( order.size() != num ) {
+        cout << "Warning: DifShellSolver::setPath: the shells on '" <<
+             path_ << "' do not form simple outer-to-inner chains.\n";
+        return false;
+    }
+
+    shell_.clear();
+    shellOuter_.assign( num, NONE );
+    shellInner_.assign( num, NONE );
+    shellSendsOut_.assign( num, false );
+    shellSendsIn_.assign( num, false );
+    zombies_.clear();
+    set< Id > zombieIds;
+    for ( unsigned int i = 0; i < num; ++i ) {
+        unsigned int j = order[i];
+        shell_.push_back( unique[j] );
+        if ( outer[j] != NONE )
+            shellOuter_[i] = newIndex[ outer[j] ];
+        if ( inner[j] != NONE )
+            shellInner_[i] = newIndex[ inner[j] ];
+        shellSendsOut_[i] = sendsOut[j];
+        shellSendsIn_[i] = sendsIn[j];
+        zombieIds.insert( unique[j].id );
+    }
+
+    // Buffers and pumps, gathered in shell order so that buffer chains
+    // are also ordered outermost first.
+    buffer_.clear();
+    bufferShell_.clear();
+    pump_.clear();
+    pumpShell_.clear();
+    map< ObjId, unsigned int > bufIndex;
+    for ( unsigned int i = 0; i < num; ++i ) {
+        Eref er = shell_[i].eref();
+        findInputs( er, reaction, "DifBufferBase", nbrs );
+        for ( vector< ObjId >::iterator
+                j = nbrs.begin(); j != nbrs.end(); ++j ) {
+            if ( bufIndex.find( *j ) != bufIndex.end() )
+                continue;
+            bufIndex[ *j ] = buffer_.size();
+            buffer_.push_back( *j );
+            bufferShell_.push_back( i );
+            zombieIds.insert( j->id );
+        }
+        findInputs( er, mmPump, "MMPump", nbrs );
+        for ( vector< ObjId >::iterator
+                j = nbrs.begin(); j != nbrs.end(); ++j ) {
+            pump_.push_back( *j );
+            pumpShell_.push_back( i );
+            zombieIds.insert( j->id );
+        }
+    }
+
+    unsigned int numBuf = buffer_.size();
+    bufferOuter_.assign( numBuf, NONE );
+    bufferInner_.assign( numBuf, NONE );
+    for ( unsigned int i = 0; i < numBuf; ++i ) {
+        findInputs( buffer_[i].eref(), bufFromOut, "DifBufferBase", nbrs );
+        for ( vector< ObjId >::iterator
+                j = nbrs.begin(); j != nbrs.end(); ++j ) {
+            map< ObjId, unsigned int >::iterator k = bufIndex.find( *j );
+            if ( k == bufIndex.end() )
+                continue;
+            unsigned int o = k->second;
+            if ( o >= i || bufferOuter_[i] != NONE ||
+                    bufferInner_[o] != NONE ) {
+                cout << "Warning: DifShellSolver::setPath: ignoring "
+                     "diffusion of " << buffer_[i].path() <<
+                     " from " << j->path() <<
+                     ", which does not follow the shell chain.\n";
+                continue;
+            }
+            bufferOuter_[i] = o;
+            bufferInner_[o] = i;
+        }
+    }
+
+    // Objects are taken off the clock a whole Element at a time, so
+    // every entry of an array Element has to be solved.
+    map< Id, unsigned int > numSolved;
+    for ( unsigned int i = 0; i < num; ++i )
+        ++numSolved[ shell_[i].id ];
+    for ( unsigned int i = 0; i < numBuf; ++i )
+        ++numSolved[ buffer_[i].id ];
+    set< ObjId > pumps( pump_.begin(), pump_.end() );
+    for ( set< ObjId >::iterator i = pumps.begin(); i != pumps.end(); ++i )
+        ++numSolved[ i->id ];
+    for ( map< Id, unsigned int >::iterator
+            i = numSolved.begin(); i != numSolved.end(); ++i ) {
+        if ( i->second != i->first.element()->numData() ) {
+            cout << "Warning: DifShellSolver::setPath: '" << path_ <<
+                 "' takes only " << i->second << " of the " <<
+                 i->first.element()->numData() << " entries of " <<
+                 i->first.path() << ". All entries of an array must be "
+                 "solved together.\n";
+            return false;
+        }
+    }
+
+    for ( set< Id >::iterator i = zombieIds.begin();
+            i != zombieIds.end(); ++i )
+        zombies_.push_back( pair< Id, int >( *i, -1 ) );
+
+    shellDOut_.assign( num, 0.0 );
+    shellDIn_.assign( num, 0.0 );
+    bufferDOut_.assign( numBuf, 0.0 );
+    bufferDIn_.assign( numBuf, 0.0 );
+    A_.resize( max( num, numBuf ) );
+    B_.resize( max( num, numBuf ) );
+    diag_.resize( max( num, numBuf ) );
+    rhs_.resize( max( num, numBuf ) );
+
+    return true;
+}
+
+bool DifShellSolver::resolve()
+{
+    shellEr_.clear();
+    bufferEr_.clear();
+    pumpEr_.clear();
+    for ( unsigned int i = 0; i < shell_.size(); ++i ) {
+        if ( shell_[i].bad() )
+            return false;
+        shellEr_.push_back( shell_[i].eref() );
+    }
+    for ( unsigned int i = 0; i < buffer_.size(); ++i ) {
+        if ( buffer_[i].bad() )
+            return false;
+        bufferEr_.push_back( buffer_[i].eref() );
+    }
+    for ( unsigned int i = 0; i < pump_.size(); ++i ) {
+        if ( pump_[i].bad() )
+            return false;
+        pumpEr_.push_back( pump_[i].eref() );
+    }
+    return true;
+}
+
+void DifShellSolver::unzombify()
+{
+    for ( vector< pair< Id, int > >::iterator
+            i = zombies_.begin(); i != zombies_.end(); ++i )
+        if ( Id::isValid( i->first ) )
+            i->first.element()->setTick( i->second );
+    zombies_.clear();
+}
+
+/**
+ * The coupling rates are exactly those the shells and buffers compute
+ * for themselves in their fluxFromOut and fluxFromIn handlers.
+ */
+void DifShellSolver::setupCoupling()
+{
+    for ( unsigned int i = 0; i < shellEr_.size(); ++i ) {
+        const DifShellBase* ds =
+            reinterpret_cast< const DifShellBase* >( shellEr_[i].data() );
+        double vol = ds->getVolume( shellEr_[i] );
+        double th = ds->getThickness( shellEr_[i] );
+        double D = ds->getD( shellEr_[i] );
+        shellDOut_[i] = shellDIn_[i] = 0.0;
+        if ( vol <= 0.0 )
+            continue;
+        if ( shellOuter_[i] != NONE ) {
+            const Eref& o = shellEr_[ shellOuter_[i] ];
+            double oth = reinterpret_cast< const DifShellBase* >(
+                             o.data() )->getThickness( o );
+            shellDOut_[i] = 2 * D / vol * ds->getOuterArea( shellEr_[i] ) /
+                            ( th + oth );
+        }
+        if ( shellInner_[i] != NONE ) {
+            const Eref& in = shellEr_[ shellInner_[i] ];
+            double ith = reinterpret_cast< const DifShellBase* >(
+                             in.data() )->getThickness( in );
+            shellDIn_[i] = 2 * D / vol * ds->getInnerArea( shellEr_[i] ) /
+                           ( th + ith );
+        }
+    }
+
+    for ( unsigned int i = 0; i < bufferEr_.size(); ++i ) {
+        const DifBufferBase* db =
+            reinterpret_cast< const DifBufferBase* >( bufferEr_[i].data() );
+        double vol = db->getVolume( bufferEr_[i] );
+        double th = db->getThickness( bufferEr_[i] );
+        double D = db->getD( bufferEr_[i] );
+        bufferDOut_[i] = bufferDIn_[i] = 0.0;
+        if ( vol <= 0.0 )
+            continue;
+        if ( bufferOuter_[i] != NONE ) {
+            const Eref& o = bufferEr_[ bufferOuter_[i] ];
+            double oth = reinterpret_cast< const DifBufferBase* >(
+                             o.data() )->getThickness( o );
+            bufferDOut_[i] = 2 * D / vol * db->getOuterArea( bufferEr_[i] ) /
+                             ( th + oth );
+        }
+        if ( bufferInner_[i] != NONE ) {
+            const Eref& in = bufferEr_[ bufferInner_[i] ];
+            double ith = reinterpret_cast< const DifBufferBase* >(
+                             in.data() )->getThickness( in );
+            bufferDIn_[i] = 2 * D / vol * db->getInnerArea( bufferEr_[i] ) /
+                            ( th + ith );
+        }
+    }
+}
+
+///////////////////////////////////////////////////
+// Dest function definitions
+///////////////////////////////////////////////////
+
+/**
+ * Thomas algorithm over a set of chains stored back to back. On entry
+ * diag and rhs hold the diagonal and right hand side, and the coupling
+ * of entry i to its outer and inner neighbours is -dt * dOut[i] and
+ * -dt * dIn[i]. Neighbours always precede their inner partners, so one
+ * forward and one backward sweep solve all chains at once. On exit rhs
+ * holds the solution.
+ */
+static void solveChains( double dt,
+                         const vector< unsigned int >& outer,
+                         const vector< unsigned int >& inner,
+                         const vector< double >& dOut,
+                         const vector< double >& dIn,
+                         vector< double >& diag, vector< double >& rhs,
+                         unsigned int num )
+{
+    for ( unsigned int i = 0; i < num; ++i ) {
+        unsigned int o = outer[i];
+        if ( o == NONE )
+            continue;
+        double w = -dt * dOut[i] / diag[o];
+        diag[i] -= w * ( -dt * dIn[o] );
+        rhs[i] -= w * rhs[o];
+    }
+    for ( unsigned int i = num; i > 0; --i ) {
+        unsigned int j = i - 1;
+        double x = rhs[j];
+        if ( inner[j] != NONE )
+            x += dt * dIn[j] * rhs[ inner[j] ];
+        rhs[j] = x / diag[j];
+    }
+}
+
+void DifShellSolver::process( const Eref& e, ProcPtr p )
+{
+    unsigned int num = shellEr_.size();
+    if ( num == 0 )
+        return;
+    double dt = p->dt;
+
+    // Rates delivered by messages: influx, outflux, leak, tau pumps and
+    // flux from any neighbours outside the solver.
+    for ( unsigned int i = 0; i < num; ++i )
+        reinterpret_cast< DifShell* >( shellEr_[i].data() )->takeRates(
+            A_[i], B_[i] );
+
+    // Buffer binding, with the bound buffer advanced by backward Euler
+    // using the current free buffer: bB' = ( bB + dt kf bF C' ) / ( 1 +
+    // dt kb ). Substituting this in kb bB' - kf bF C' leaves terms that
+    // are linear in C'.
+    for ( unsigned int i = 0; i < bufferEr_.size(); ++i ) {
+        const DifBufferBase* db =
+            reinterpret_cast< const DifBufferBase* >( bufferEr_[i].data() );
+        double kf = db->getKf( bufferEr_[i] );
+        double kb = db->getKb( bufferEr_[i] );
+        double scale = 1.0 / ( 1.0 + dt * kb );
+        unsigned int s = bufferShell_[i];
+        A_[s] += kb * db->getBBound( bufferEr_[i] ) * scale;
+        B_[s] += kf * db->getBFree( bufferEr_[i] ) * scale;
+    }
+
+    for ( unsigned int i = 0; i < pumpEr_.size(); ++i ) {
+        const MMPump* mp =
+            reinterpret_cast< const MMPump* >( pumpEr_[i].data() );
+        const Eref& se = shellEr_[ pumpShell_[i] ];
+        const DifShellBase* ds =
+            reinterpret_cast< const DifShellBase* >( se.data() );
+        double vol = ds->getVolume( se );
+        if ( vol > 0.0 )
+            B_[ pumpShell_[i] ] += ( mp->getVmax( pumpEr_[i] ) / vol ) /
+                                   ( ds->getC( se ) + mp->getKd( pumpEr_[i] ) );
+    }
+
+    for ( unsigned int i = 0; i < num; ++i ) {
+        const DifShellBase* ds =
+            reinterpret_cast< const DifShellBase* >( shellEr_[i].data() );
+        diag_[i] = 1.0 + dt * ( B_[i] + shellDOut_[i] + shellDIn_[i] );
+        rhs_[i] = ds->getC( shellEr_[i] ) + dt * A_[i];
+    }
+    solveChains( dt, shellOuter_, shellInner_, shellDOut_, shellDIn_,
+                 diag_, rhs_, num );
+    for ( unsigned int i = 0; i < num; ++i ) {
+        if ( rhs_[i] < 0.0 )
+            rhs_[i] = 0.0;
+        reinterpret_cast< DifShellBase* >( shellEr_[i].data() )->setC(
+            shellEr_[i], rhs_[i] );
+    }
+
+    unsigned int numBuf = bufferEr_.size();
+    if ( numBuf > 0 ) {
+        // rhs_ holds the new shell concentrations. Take each buffer
+        // through the same reaction step, then let the free buffer
+        // diffuse along its own chain.
+        for ( unsigned int i = 0; i < numBuf; ++i ) {
+            const DifBufferBase* db =
+                reinterpret_cast< const DifBufferBase* >( bufferEr_[i].data() );
+            double kf = db->getKf( bufferEr_[i] );
+            double kb = db->getKb( bufferEr_[i] );
+            double bFree = db->getBFree( bufferEr_[i] );
+            double bBound = ( db->getBBound( bufferEr_[i] ) +
+                              dt * kf * bFree * rhs_[ bufferShell_[i] ] ) /
+                            ( 1.0 + dt * kb );
+            B_[i] = db->getBTot( bufferEr_[i] ) - bBound;
+        }
+        for ( unsigned int i = 0; i < numBuf; ++i ) {
+            diag_[i] = 1.0 + dt * ( bufferDOut_[i] + bufferDIn_[i] );
+            rhs_[i] = B_[i];
+        }
+        solveChains( dt, bufferOuter_, bufferInner_,
+                     bufferDOut_, bufferDIn_, diag_, rhs_, numBuf );
+        for ( unsigned int i = 0; i < numBuf; ++i ) {
+            DifBufferBase* db =
+                reinterpret_cast< DifBufferBase* >( bufferEr_[i].data() );
+            double bTot = db->getBTot( bufferEr_[i] );
+            double bFree = rhs_[i];
+            if ( bFree < 0.0 )
+                bFree = 0.0;
+            else if ( bFree > bTot )
+                bFree = bTot;
+            db->setBBound( bufferEr_[i], bTot - bFree );
+        }
+    }
+
+    for ( unsigned int i = 0; i < num; ++i ) {
+        const DifShellBase* ds =
+            reinterpret_cast< const DifShellBase* >( shellEr_[i].data() );
+        double C = ds->getC( shellEr_[i] );
+        DifShellBase::concentrationOut()->send( shellEr_[i], C );
+        if ( shellSendsIn_[i] )
+            DifShellBase::innerDifSourceOut()->send( shellEr_[i], C,
+                    ds->getThickness( shellEr_[i] ) );
+        if ( shellSendsOut_[i] )
+            DifShellBase::outerDifSourceOut()->send( shellEr_[i], C,
+                    ds->getThickness( shellEr_[i] ) );
+    }
+}
+
+void DifShellSolver::reinit( const Eref& e, ProcPtr p )
+{
+    if ( !resolve() ) {
+        cout << "Warning: DifShellSolver::reinit: objects on '" << path_ <<
+             "' have been deleted. Set the path again.\n";
+        unzombify();
+        clear();
+        return;
+    }
+    // The solved objects are off the clock, so reinit them here: shells
+    // first, so that buffers see the resting concentration.
+    for ( unsigned int i = 0; i < shellEr_.size(); ++i )
+        reinterpret_cast< DifShellBase* >( shellEr_[i].data() )->reinit(
+            shellEr_[i], p );
+    for ( unsigned int i = 0; i < bufferEr_.size(); ++i )
+        reinterpret_cast< DifBufferBase* >( bufferEr_[i].data() )->reinit(
+            bufferEr_[i], p );
+    setupCoupling();
+
+    // Discard the neighbour fluxes the shells sent each other on reinit.
+    double A, B;
+    for ( unsigned int i = 0; i < shellEr_.size(); ++i )
+        reinterpret_cast< DifShell* >( shellEr_[i].data() )->takeRates( A, B );
+}
@@ -0,0 +1,107 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Multiscale Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2016 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _DIF_SHELL_SOLVER_H
+#define _DIF_SHELL_SOLVER_H
+
+/**
+ * Takes over a set of DifShells, together with the DifBuffers and MMPumps
+ * attached to them, and advances each radial chain of shells as a single
+ * implicit system. Every step the shell concentrations are found from one
+ * tridiagonal (backward Euler) solve per chain, with the buffer reactions
+ * eliminated locally and the pumps linearised about the current
+ * concentration; buffer diffusion is then a second tridiagonal solve.
+ * This is stable at electrical-scale timesteps, where the exponential
+ * Euler update of the individual shells needs a far smaller dt.
+ *
+ * The solved objects are taken off the clock. They keep receiving
+ * influx, outflux and other external messages, which the solver collects
+ * each step, and the shells still send out their concentration.
+ */
+class DifShellSolver
+{
+public:
+    DifShellSolver();
+
+    //////////////////////////////////////////////////////////////////
+    // Field assignment stuff
+    //////////////////////////////////////////////////////////////////
+    void setPath( const Eref& e, string path );
+    string getPath( const Eref& e ) const;
+    unsigned int getNumShells() const;
+    unsigned int getNumChains() const;
+    unsigned int getNumBuffers() const;
+    unsigned int getNumPumps() const;
+
+    //////////////////////////////////////////////////////////////////
+    // Dest funcs
+    //////////////////////////////////////////////////////////////////
+    void process( const Eref& e, ProcPtr p );
+    void reinit( const Eref& e, ProcPtr p );
+
+    static const Cinfo* initCinfo();
+
+private:
+    /// Puts previously solved objects back on their own clock ticks.
+    void unzombify();
+    /// Sets up the shell chains, buffers and pumps found on path_.
+    bool build( const vector< ObjId >& shells );
+    /// Looks up the Erefs of the solved objects; false if any is gone.
+    bool resolve();
+    /// Forgets all the solved objects.
+    void clear();
+    /// Reads geometry and diffusion terms; needs the shells reinited.
+    void setupCoupling();
+
+    string path_;
+
+    /**
+     * Shells, ordered so that each outer neighbour precedes its inner.
+     * The solved objects are held as ObjIds, and looked up as Erefs in
+     * shellEr_, bufferEr_ and pumpEr_ on reinit. An Eref kept from
+     * setting the path would dangle if an Element was deleted since.
+     */
+    vector< ObjId > shell_;
+    vector< Eref > shellEr_;
+    /// Index of outer and inner neighbour in shell_, ~0U if none.
+    vector< unsigned int > shellOuter_;
+    vector< unsigned int > shellInner_;
+    /// Coupling rates (1/sec) to outer and inner neighbour of each shell.
+    vector< double > shellDOut_;
+    vector< double > shellDIn_;
+    /// Flags shells whose neighbour is outside the solver, so that it
+    /// still has to be told the concentration through messages.
+    vector< bool > shellSendsOut_;
+    vector< bool > shellSendsIn_;
+    unsigned int numChains_;
+
+    vector< ObjId > buffer_;
+    vector< Eref > bufferEr_;
+    /// Shell that each buffer reacts with, as index into shell_.
+    vector< unsigned int > bufferShell_;
+    vector< unsigned int > bufferOuter_;
+    vector< unsigned int > bufferInner_;
+    vector< double > bufferDOut_;
+    vector< double > bufferDIn_;
+
+    vector< ObjId > pump_;
+    vector< Eref > pumpEr_;
+    vector< unsigned int > pumpShell_;
+
+    /// Elements taken off the clock, with the tick they were on.
+    vector< pair< Id, int > > zombies_;
+
+    /// Scratch space for the tridiagonal solves.
+    vector< double > A_;
+    vector< double > B_;
+    vector< double > diag_;
+    vector< double > rhs_;
+};
+
+#endif // _DIF_SHELL_SOLVER_H
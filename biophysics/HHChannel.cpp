@@ -14,6 +14,7 @@
 #include "HHChannelBase.h"
 #include "HHChannel.h"
 #include "HHGate.h"
+#include "../shell/Checkpoint.h"
 
 // const double HHChannel::EPSILON = 1.0e-10;
 // const int HHChannel::INSTANT_X = 1;
@@ -56,7 +57,7 @@ const Cinfo* HHChannel::initCinfo() {
         "a similar interface as hhchan from GENESIS. ",
     };
 
-    static Dinfo<HHChannel> dinfo;
+    static ArenaDinfo< HHChannel > dinfo;
 
     static Cinfo HHChannelCinfo("HHChannel", HHChannelBase::initCinfo(),
                                 HHChannelFinfos,
@@ -67,6 +68,7 @@ const Cinfo* HHChannel::initCinfo() {
 }
 
 static const Cinfo* hhChannelCinfo = HHChannel::initCinfo();
+static CheckpointHandler<HHChannel> hhChannelCheckpoint("HHChannel");
 //////////////////////////////////////////////////////////////////////
 
 ///////////////////////////////////////////////////
@@ -352,3 +354,30 @@ void HHChannel::vReinit(const Eref& er, ProcPtr info) {
 
 void HHChannel::vHandleConc(const Eref& e, double conc) { conc_ = conc; }
 
+void HHChannel::saveState(CheckpointWriter& w) const
+{
+    ChanCommon::saveState(w);
+    double gates[] = {X_, Y_, Z_, g_, conc_};
+    w.add("gates", gates, sizeof(gates));
+    unsigned char inited[] = {xInited_, yInited_, zInited_};
+    w.add("inited", inited, sizeof(inited));
+}
+
+void HHChannel::loadState(CheckpointReader& r)
+{
+    ChanCommon::loadState(r);
+    double gates[5];
+    if(r.get("gates", gates, 5)) {
+        X_ = gates[0];
+        Y_ = gates[1];
+        Z_ = gates[2];
+        g_ = gates[3];
+        conc_ = gates[4];
+    }
+    unsigned char inited[3];
+    if(r.get("inited", inited, 3)) {
+        xInited_ = inited[0];
+        yInited_ = inited[1];
+        zInited_ = inited[2];
+    }
+}
@@ -177,6 +177,10 @@ class HHChannel : public HHChannelBase {
     // bool setGatePower(const Eref& e, double power, double* assignee,
     //                   const string& gateType);
 
+    /// Checkpoint support, see shell/Checkpoint.h
+    void saveState(CheckpointWriter& w) const;
+    void loadState(CheckpointReader& r);
+
     /////////////////////////////////////////////////////////////
     static const Cinfo* initCinfo();
 
@@ -10,6 +10,7 @@
 #include <queue>
 #include "../basecode/header.h"
 #include "IntFire.h"
+#include "../shell/Checkpoint.h"
 
 static SrcFinfo1< double > *spikeOut() {
 	static SrcFinfo1< double > spikeOut(
@@ -86,7 +87,7 @@ const Cinfo* IntFire::initCinfo()
 		spikeOut(), 		// MsgSrc
 	};
 
-	static Dinfo< IntFire > dinfo;
+	static ArenaDinfo< IntFire > dinfo;
 	static Cinfo intFireCinfo (
 		"IntFire",
 		Neutral::initCinfo(),
@@ -99,6 +100,7 @@ const Cinfo* IntFire::initCinfo()
 }
 
 static const Cinfo* intFireCinfo = IntFire::initCinfo();
+static CheckpointHandler< IntFire > intFireCheckpoint( "IntFire" );
 
 IntFire::IntFire()
 	: Vm_( 0.0 ), thresh_( 0.0 ), tau_( 1.0 ),
@@ -138,6 +140,20 @@ void IntFire::reinit( const Eref& e, ProcPtr p )
 	activation_ = 0.0;
 }
 
+void IntFire::saveState( CheckpointWriter& w ) const
+{
+	w.addValue( "Vm", Vm_ );
+	w.addValue( "lastSpike", lastSpike_ );
+	w.addValue( "activation", activation_ );
+}
+
+void IntFire::loadState( CheckpointReader& r )
+{
+	r.getValue( "Vm", Vm_ );
+	r.getValue( "lastSpike", lastSpike_ );
+	r.getValue( "activation", activation_ );
+}
+
 void IntFire::setVm( const double v )
 {
 	Vm_ = v;
@@ -10,6 +10,8 @@
 #ifndef _INT_FIRE_H
 #define _INT_FIRE_H
 
+class CheckpointWriter;
+class CheckpointReader;
 
 class IntFire
 {
@@ -45,6 +47,10 @@ class IntFire
 		void process( const Eref& e, ProcPtr p );
 		void reinit( const Eref&  e, ProcPtr p );
 
+		/// Checkpoint support, see shell/Checkpoint.h
+		void saveState( CheckpointWriter& w ) const;
+		void loadState( CheckpointReader& r );
+
 		static const Cinfo* initCinfo();
 	private:
 		double Vm_; // State variable: Membrane potential. Resting pot is 0.
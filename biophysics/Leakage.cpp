@@ -49,6 +49,7 @@
 #include "ChanBase.h"
 #include "ChanCommon.h"
 #include "Leakage.h"
+#include "../shell/Checkpoint.h"
 
 const Cinfo* Leakage::initCinfo()
 {
@@ -74,6 +75,7 @@ const Cinfo* Leakage::initCinfo()
 }
 
 static const Cinfo* leakageCinfo = Leakage::initCinfo();
+static CheckpointNoState leakageCheckpoint( "Leakage" );
 
 
 Leakage::Leakage()
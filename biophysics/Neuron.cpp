@@ -639,32 +639,90 @@ bool parseDistrib( vector< vector < string > >& lines,
     return true;
 }
 
-static void doClassSpecificMessaging( Shell* shell, Id obj, ObjId compt )
+/**
+ * Returns true if the proto has legacy GENESIS 'addmsg' children, which
+ * ReadCell::addChannelMessage would have to parse on every copy.
+ */
+static bool protoHasAddmsg( Id proto )
 {
-    if ( obj.element()->cinfo()->isA( "ChanBase" ) )
+    vector< Id > kids;
+    Neutral::children( proto.eref(), kids );
+    for ( vector< Id >::const_iterator
+            i = kids.begin(); i != kids.end(); ++i )
+        if ( i->element()->getName().find( "addmsg", 0 ) == 0 )
+            return true;
+    return false;
+}
+
+/**
+ * Returns the CaConcBase child of compt, or Id() if there is none. This
+ * is the first match of compt/#[ISA=CaConcBase], without building the
+ * path and parsing the wildcard for every channel.
+ */
+static Id findCaConc( ObjId compt )
+{
+    vector< Id > kids;
+    Neutral::children( compt.eref(), kids );
+    Id ret;
+    for ( vector< Id >::const_iterator i = kids.begin(); i != kids.end(); ++i )
     {
-        shell->doAddMsg( "Single", compt, "channel", obj, "channel" );
-        // Add the message to the Ca pool if our obj has 'Ca' in its name.
-        if ( obj.element()->getName().find( "Ca" ) != string::npos )
+        if ( i->element()->cinfo()->isA( "CaConcBase" ) &&
+                ( ret == Id() || *i < ret ) )
+            ret = *i;
+    }
+    return ret;
+}
+
+/**
+ * Copies the proto onto each of the compartments compts[index[i]], and
+ * sets up the messages between each copy and its compartment: channel
+ * to compartment, Ca channels to the CaConc pool in the compartment,
+ * and any legacy GENESIS addmsgs. Everything that depends only on the proto (the
+ * name checks, whether it is a channel, whether it talks to Ca pools,
+ * whether it has GENESIS addmsgs) is worked out once. The copies and
+ * messages are then made directly through the Shell inner functions,
+ * without a round of Shell dispatch per compartment. Like the
+ * construction of HSolve, this is done locally on this node.
+ */
+static void instanceProto( Shell* shell, Id proto, const string& name,
+                           const vector< ObjId >& compts, vector< ObjId >& mech,
+                           const vector< unsigned int >& index )
+{
+    bool isChan = proto.element()->cinfo()->isA( "ChanBase" );
+    bool hasAddmsg = protoHasAddmsg( proto );
+    bool isCaChan = isChan && !hasAddmsg &&
+                    name.find( "Ca" ) != string::npos;
+    vector< ObjId > args( 3 );
+    args[0] = proto;
+    for ( vector< unsigned int >::const_iterator
+            i = index.begin(); i != index.end(); ++i )
+    {
+        const ObjId& compt = compts[*i];
+        args[1] = compt;
+        Shell::reserveCopyIds( proto );
+        args[2] = Id::nextId();
+        if ( !shell->innerCopy( args, name, 1, false, false ) )
+        {
+            cout << "Warning: Neuron::buildFromProto: failed to copy '"
+                 << name << "' onto " << compt.path() << endl;
+            continue;
+        }
+        Id obj = args[2].id;
+        mech[*i] = obj;
+        if ( isChan )
         {
-            // Don't do it if we have the legacy GENESIS format
-            if ( Neutral::child( obj.eref(), "addmsg1" ) == Id() )
+            shell->innerAddMsg( "Single", compt, "channel", obj, "channel", 0 );
+            if ( isCaChan )
             {
-                vector< ObjId > elist;
-                string path = Neutral::parent( obj ).path() + "/#[ISA=CaConcBase]";
-                // cout << "OK2 to Add Ca Msg for " << path << endl;
-                wildcardFind( path, elist );
-                if ( elist.size() > 0 )
-                {
-                    // cout << "Added Ca Msg for " << obj.path() << ", name = " << obj.element()->getName() << endl;
-                    ObjId mid = shell->doAddMsg(
-                                    "single", obj, "IkOut", elist[0], "current" );
-                    assert( !mid.bad());
-                }
+                Id pool = findCaConc( compt );
+                if ( pool != Id() )
+                    shell->innerAddMsg(
+                        "single", obj, "IkOut", pool, "current", 0 );
             }
         }
+        if ( hasAddmsg )
+            ReadCell::addChannelMessage( obj );
     }
-    ReadCell::addChannelMessage( obj );
 }
 
 static bool buildFromProto(
@@ -682,48 +740,91 @@ static bool buildFromProto(
     }
     mech.clear();
     mech.resize( elist.size() );
+    const string& protoName = proto.element()->getName();
+    vector< unsigned int > toCopy;
     for ( unsigned int i = 0; i < elist.size(); ++i )
     {
         unsigned int j = i * nuParser::numVal;
         if ( val[ j + nuParser::EXPR ] > 0 )
         {
-            string name = proto.element()->getName();
-            Id obj = Neutral::child( elist[i].eref(), name );
+            Id obj = Neutral::child( elist[i].eref(), protoName );
             if ( obj == Id() )   // Need to copy it in from proto.
-            {
-                obj = shell->doCopy( proto, elist[i], name, 1, false, false );
-                doClassSpecificMessaging( shell, obj, elist[i] );
-            }
-            mech[i] = obj;
+                toCopy.push_back( i );
+            else
+                mech[i] = obj;
         }
     }
+    if ( toCopy.size() > 0 )
+        instanceProto( shell, proto, protoName, elist, mech, toCopy );
     return true;
 }
 
-static void assignParam( Id obj, const string& field,
-                         double val, double len, double dia )
+/**
+ * Sets a double field on a set of objects of the same class, looking up
+ * the set function once rather than once per object.
+ */
+static void setFieldOnAll( const vector< ObjId >& obj, const string& field,
+                           const vector< double >& v )
 {
-    if ( obj.element()->cinfo()->isA( "ChanBase" ) )
+    assert( obj.size() == v.size() );
+    if ( obj.size() == 0 )
+        return;
+    string setField = "set" + field;
+    setField[3] = std::toupper( setField[3] );
+    FuncId fid;
+    ObjId tgt( obj[0] );
+    const OpFunc1Base< double >* op =
+        dynamic_cast< const OpFunc1Base< double >* >(
+            SetGet::checkSet( setField, tgt, fid ) );
+    if ( !op || tgt != obj[0] )
+    {
+        for ( unsigned int i = 0; i < obj.size(); ++i )
+            Field< double >::set( obj[i], field, v[i] );
+        return;
+    }
+    for ( unsigned int i = 0; i < obj.size(); ++i )
+        op->op( obj[i].eref(), v[i] );
+}
+
+/**
+ * Assigns a parameter to all the mechanisms built from one proto. All
+ * the objs must be of the same class.
+ */
+static void assignParams( const vector< ObjId >& obj, const string& field,
+                          const vector< double >& val,
+                          const vector< double >& len,
+                          const vector< double >& dia )
+{
+    const Cinfo* cinfo = obj[0].element()->cinfo();
+    if ( cinfo->isA( "ChanBase" ) )
     {
         if ( field == "Gbar" )
         {
-            if ( val > 0 )
-                Field< double >::set( obj, "Gbar", val * len * dia * PI );
+            vector< ObjId > o;
+            vector< double > v;
+            for ( unsigned int i = 0; i < obj.size(); ++i )
+            {
+                if ( val[i] > 0 )
+                {
+                    o.push_back( obj[i] );
+                    v.push_back( val[i] * len[i] * dia[i] * PI );
+                }
+            }
+            setFieldOnAll( o, "Gbar", v );
         }
         else if ( field == "Ek" )
         {
-            Field< double >::set( obj, "Ek", val );
+            setFieldOnAll( obj, "Ek", val );
         }
     }
-    else if ( obj.element()->cinfo()->isA( "CaConcBase" ) )
+    else if ( cinfo->isA( "CaConcBase" ) )
     {
-        Field< double >::set( obj, "length", len );
-        Field< double >::set( obj, "diameter", dia );
-        // cout << "len, dia = " << len << ", " << dia << endl;
+        setFieldOnAll( obj, "length", len );
+        setFieldOnAll( obj, "diameter", dia );
         if ( field == "CaBasal" || field == "tau" || field == "thick" ||
                 field == "floor" || field == "ceiling" )
         {
-            Field< double >::set( obj, field, val );
+            setFieldOnAll( obj, field, val );
         }
         else if ( field == "B" )
         {
@@ -733,8 +834,11 @@ static void assignParam( Id obj, const string& field,
             // to be thought of in terms of buffering. Small B is more
             // buffering. This field is deprecated but used in legacy
             // GENESIS scripts.
-            Field< double >::set( obj, "B", val /
-                                  ( FaradayConst * len * dia * dia * PI / 4.0 ) );
+            vector< double > v( obj.size() );
+            for ( unsigned int i = 0; i < obj.size(); ++i )
+                v[i] = val[i] /
+                       ( FaradayConst * len[i] * dia[i] * dia[i] * PI / 4.0 );
+            setFieldOnAll( obj, "B", v );
         }
     }
 }
@@ -806,19 +910,36 @@ static void setMechParams(
     const vector< ObjId >& elist, const vector< double >& val,
     const string& field, const string& expr )
 {
+    // Mechanisms are grouped by class, so that each group can be
+    // assigned with a single lookup of the set function. Normally they
+    // are all copies of one proto and form a single group.
+    map< const Cinfo*, vector< unsigned int > > groups;
+    for ( unsigned int i = 0; i < elist.size(); ++i )
+    {
+        unsigned int j = i * nuParser::numVal;
+        if ( val[ j + nuParser::EXPR ] > 0 && mech[i] != ObjId() )
+            groups[ mech[i].element()->cinfo() ].push_back( i );
+    }
     try
     {
         nuParser parser ( expr );
-        for ( unsigned int i = 0; i < elist.size(); ++i )
+        for ( map< const Cinfo*, vector< unsigned int > >::const_iterator
+                g = groups.begin(); g != groups.end(); ++g )
         {
-            unsigned int j = i * nuParser::numVal;
-            if ( val[ j + nuParser::EXPR ] > 0 )
+            const vector< unsigned int >& index = g->second;
+            vector< ObjId > obj( index.size() );
+            vector< double > x( index.size() );
+            vector< double > len( index.size() );
+            vector< double > dia( index.size() );
+            for ( unsigned int k = 0; k < index.size(); ++k )
             {
-                double len = val[j + nuParser::LEN ];
-                double dia = val[j + nuParser::DIA ];
-                double x = parser.eval( val.begin() + j );
-                assignParam( mech[i], field, x, len, dia );
+                unsigned int j = index[k] * nuParser::numVal;
+                obj[k] = mech[ index[k] ];
+                len[k] = val[j + nuParser::LEN ];
+                dia[k] = val[j + nuParser::DIA ];
+                x[k] = parser.eval( val.begin() + j );
             }
+            assignParams( obj, field, x, len, dia );
         }
     }
     catch ( moose::Parser::exception_type& err )
@@ -1521,68 +1642,126 @@ void Neuron::setSpineAndPsdDsolve( ObjId spineDsolve, ObjId psdDsolve )
 /////////////////////////////////////////////////////////////////////////
 
 /**
- * Evaluates expn for every CompartmentBase entry in elist. Pushes
- * value, length and dia for each elist entry into the 'val' vector.
+ * Looks up the get function for a double field on a class, so that it
+ * can be applied to many objects without a name lookup each time.
+ */
+static const GetOpFuncBase< double >* lookupDoubleGetter(
+    const Cinfo* cinfo, const string& field )
+{
+    string name = "get" + field;
+    name[3] = std::toupper( name[3] );
+    const DestFinfo* df =
+        dynamic_cast< const DestFinfo* >( cinfo->findFinfo( name ) );
+    if ( !df )
+        return 0;
+    return dynamic_cast< const GetOpFuncBase< double >* >( df->getOpFunc() );
+}
+
+/**
+ * Fills in the argument columns of val for each compartment in elist,
+ * and returns the indices of the compartments in 'rows'. The
+ * expression is evaluated over these afterwards in a separate pass.
+ * Distances and coords come from segs_. Length and diameter are read
+ * from the compartments themselves, through getters looked up once per
+ * class.
+ */
+void Neuron::gatherExprArgs( const vector< ObjId >& elist,
+                             vector< double >& val,
+                             vector< unsigned int >& rows ) const
+{
+    const Cinfo* lastCinfo = 0;
+    const GetOpFuncBase< double >* getDia = 0;
+    const GetOpFuncBase< double >* getLen = 0;
+    bool haveSomaCoords = false;
+    double somaX0 = 0.0;
+    double somaY0 = 0.0;
+    double somaZ0 = 0.0;
+    rows.clear();
+    rows.reserve( elist.size() );
+    for ( unsigned int k = 0; k < elist.size(); ++k )
+    {
+        const ObjId& compt = elist[k];
+        const Cinfo* cinfo = compt.element()->cinfo();
+        if ( cinfo != lastCinfo )
+        {
+            if ( !cinfo->isA( "CompartmentBase" ) )
+                continue;
+            lastCinfo = cinfo;
+            getDia = lookupDoubleGetter( cinfo, "diameter" );
+            getLen = lookupDoubleGetter( cinfo, "length" );
+        }
+        unsigned int valIndex = k * nuParser::numVal;
+        double* v = &val[valIndex];
+        map< Id, unsigned int >:: const_iterator j = segIndex_.find( compt );
+        if ( j != segIndex_.end() )
+        {
+            assert( j->second < segs_.size() );
+            const SwcSegment& seg = segs_[j->second];
+            v[nuParser::P] = seg.getPathDistFromSoma();
+            v[nuParser::G] = seg.getGeomDistFromSoma();
+            v[nuParser::EL] = seg.getElecDistFromSoma();
+            v[nuParser::X] = seg.vec().a0();
+            v[nuParser::Y] = seg.vec().a1();
+            v[nuParser::Z] = seg.vec().a2();
+        }
+        else
+        {
+            if ( !haveSomaCoords )
+            {
+                somaX0 = Field<double>::get( soma_, "x0" );
+                somaY0 = Field<double>::get( soma_, "y0" );
+                somaZ0 = Field<double>::get( soma_, "z0" );
+                haveSomaCoords = true;
+            }
+            double comptX0 = Field<double>::get( compt, "x0" );
+            double comptY0 = Field<double>::get( compt, "y0" );
+            double comptZ0 = Field<double>::get( compt, "z0" );
+            Vec temp( somaX0-comptX0, somaY0-comptY0, somaZ0-comptZ0 );
+            double geomDistFromSoma = temp.length();
+            v[nuParser::G] = geomDistFromSoma;
+            v[nuParser::P] = geomDistFromSoma; //dummy
+            // Dummy, using typical lambda of 0.5 mm
+            v[nuParser::EL] = geomDistFromSoma * 2e3;
+            v[nuParser::X] = Field<double>::get( compt, "x" );
+            v[nuParser::Y] = Field<double>::get( compt, "y" );
+            v[nuParser::Z] = Field<double>::get( compt, "z" );
+        }
+        v[nuParser::LEN] = getLen ? getLen->returnOp( compt.eref() ) :
+                           Field< double >::get( compt, "length" );
+        v[nuParser::DIA] = getDia ? getDia->returnOp( compt.eref() ) :
+                           Field< double >::get( compt, "diameter" );
+        v[nuParser::MAXP] = maxP_;
+        v[nuParser::MAXG] = maxG_;
+        v[nuParser::MAXL] = maxL_;
+        // Can't assign oldVal on first arg
+        v[nuParser::OLDVAL] = 0.0;
+        rows.push_back( k );
+    }
+}
+
+/**
+ * Evaluates expn for every CompartmentBase entry in elist. Fills in
+ * the arguments and the value for each elist entry in the 'val' vector.
  */
 void Neuron::evalExprForElist( const vector< ObjId >& elist,
                                const string& expn, vector< double >& val ) const
 {
     val.clear();
     val.resize( elist.size() * nuParser::numVal );
-    // Build the function
-    double len = 0; // Length of compt in metres
-    double dia = 0; // Diameter of compt in metres
-    unsigned int valIndex = 0;
+    vector< unsigned int > rows;
+    gatherExprArgs( elist, val, rows );
+    if ( rows.size() == 0 )
+        return;
     try
     {
+        // The parser is built once, and then run over all the rows.
         nuParser parser( expn );
-        for ( vector< ObjId >::const_iterator
-                i = elist.begin(); i != elist.end(); ++i )
+        for ( vector< unsigned int >::const_iterator
+                i = rows.begin(); i != rows.end(); ++i )
         {
-            if ( i->element()->cinfo()->isA( "CompartmentBase" ) )
-            {
-                map< Id, unsigned int >:: const_iterator j =
-                    segIndex_.find( *i );
-                if ( j != segIndex_.end() )
-                {
-                    assert( j->second < segs_.size() );
-                    val[valIndex + nuParser::P] =
-                        segs_[j->second].getPathDistFromSoma();
-                    val[valIndex + nuParser::G] =
-                        segs_[j->second].getGeomDistFromSoma();
-                    val[valIndex + nuParser::EL] =
-                        segs_[j->second].getElecDistFromSoma();
-                } else {
-					double somaX0 = Field<double>::get( soma_, "x0" );
-					double somaY0 = Field<double>::get( soma_, "y0" );
-					double somaZ0 = Field<double>::get( soma_, "z0" );
-					double comptX0 = Field<double>::get( *i, "x0" );
-					double comptY0 = Field<double>::get( *i, "y0" );
-					double comptZ0 = Field<double>::get( *i, "z0" );
-					Vec temp( somaX0-comptX0, somaY0-comptY0, somaZ0-comptZ0 );
-					double geomDistFromSoma = temp.length();
-                    val[valIndex + nuParser::G] = geomDistFromSoma;
-                    val[valIndex + nuParser::P] = geomDistFromSoma; //dummy
-					// Dummy, using typical lambda of 0.5 mm
-                    val[valIndex + nuParser::EL] = geomDistFromSoma * 2e3;
-				}
-                dia = Field< double >::get( *i, "diameter" );
-                len = Field< double >::get( *i, "length" );
-                val[valIndex + nuParser::LEN] = len;
-                val[valIndex + nuParser::DIA] = dia;
-                val[valIndex + nuParser::MAXP] = maxP_;
-                val[valIndex + nuParser::MAXG] = maxG_;
-                val[valIndex + nuParser::MAXL] = maxL_;
-                val[valIndex + nuParser::X] = segs_[j->second].vec().a0();
-                val[valIndex + nuParser::Y] = segs_[j->second].vec().a1();
-                val[valIndex + nuParser::Z] = segs_[j->second].vec().a2();
-                // Can't assign oldVal on first arg
-                val[valIndex + nuParser::OLDVAL] = 0.0;
-
-                val[valIndex + nuParser::EXPR] = parser.eval(
-                                             val.begin() + valIndex );
-            }
-            valIndex += nuParser::numVal;
+            unsigned int valIndex = *i * nuParser::numVal;
+            val[valIndex + nuParser::EXPR] = parser.eval(
+                                                 val.begin() + valIndex );
         }
     }
     catch ( moose::Parser::exception_type& err )
@@ -88,6 +88,9 @@ public:
 
     void evalExprForElist( const vector< ObjId >& elist,
                            const string& expn, vector< double >& val ) const;
+    void gatherExprArgs( const vector< ObjId >& elist,
+                         vector< double >& val,
+                         vector< unsigned int >& rows ) const;
 
     ///////////////////////////////////////////////////////////////////
     // Interface for Spine class, used mostly in resizing spines.
@@ -0,0 +1,358 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2026 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include "../basecode/header.h"
+#include "../basecode/ElementValueFinfo.h"
+#include "../randnum/randnum.h"
+#include "../randnum/CounterRNG.h"
+
+#include "PoissonSource.h"
+#include "../shell/Checkpoint.h"
+
+#include <limits>
+
+///////////////////////////////////////////////////////
+// MsgSrc definitions
+///////////////////////////////////////////////////////
+static SrcFinfo1< double > *spikeOut()
+{
+    static SrcFinfo1< double > spikeOut( "spikeOut",
+            "Sends out a trigger for an event. The argument is the "
+            "sampled spike time, which lies within the current timestep.");
+    return &spikeOut;
+}
+
+const Cinfo* PoissonSource::initCinfo()
+{
+    ///////////////////////////////////////////////////////
+    // Shared message definitions
+    ///////////////////////////////////////////////////////
+    static DestFinfo process( "process",
+            "Handles process call",
+            new ProcOpFunc< PoissonSource >( &PoissonSource::process ) );
+    static DestFinfo reinit( "reinit",
+            "Handles reinit call",
+            new ProcOpFunc< PoissonSource >( &PoissonSource::reinit ) );
+
+    static Finfo* processShared[] =
+    {
+        &process, &reinit
+    };
+
+    static SharedFinfo proc( "proc",
+            "Shared message to receive Process message from scheduler",
+            processShared, sizeof( processShared ) / sizeof( Finfo* ) );
+
+    //////////////////////////////////////////////////////////////////
+    // Value Finfos.
+    //////////////////////////////////////////////////////////////////
+
+    static ElementValueFinfo< PoissonSource, double > rate( "rate",
+            "Instantaneous firing rate. May be changed by message at any "
+            "time; candidate spikes drawn at maxRate are thinned to this "
+            "rate. If it goes above maxRate the envelope is raised.",
+            &PoissonSource::setRate,
+            &PoissonSource::getRate
+            );
+    static ElementValueFinfo< PoissonSource, double > maxRate( "maxRate",
+            "Envelope rate for thinning. Should be at least the largest "
+            "rate expected. If zero, the current rate is used, which is "
+            "exact and cheapest when the rate is constant.",
+            &PoissonSource::setMaxRate,
+            &PoissonSource::getMaxRate
+            );
+    static ElementValueFinfo< PoissonSource, double > refractT( "refractT",
+            "Refractory time. No spike is sent within this time of the "
+            "last one. The candidate rate is raised to compensate, so "
+            "that the mean rate is still the specified rate.",
+            &PoissonSource::setRefractT,
+            &PoissonSource::getRefractT
+            );
+    static ReadOnlyElementValueFinfo< PoissonSource, double > lastEventT(
+            "lastEventT",
+            "Time of last spike.",
+            &PoissonSource::getLastEvent
+            );
+    static ReadOnlyElementValueFinfo< PoissonSource, double > nextEventT(
+            "nextEventT",
+            "Time of the next candidate spike.",
+            &PoissonSource::getNextEvent
+            );
+    static ReadOnlyElementValueFinfo< PoissonSource, unsigned int >
+        numSpikes( "numSpikes",
+            "Number of spikes sent since reinit.",
+            &PoissonSource::getNumSpikes
+            );
+    static ElementValueFinfo< PoissonSource, unsigned int > seed( "seed",
+            "Selects the spike train of this source, together with the "
+            "global seed set by moose.seed(). Entries of an array with "
+            "the same seed still get trains of their own. When zero "
+            "(default), the train is selected by the path of the source, "
+            "so a model that is built again gives the same spikes. Takes "
+            "effect on reinit.",
+            &PoissonSource::setSeed,
+            &PoissonSource::getSeed
+            );
+    static ReadOnlyElementValueFinfo< PoissonSource, bool > hasFired(
+            "hasFired",
+            "True if the source fired on the last timestep.",
+            &PoissonSource::getFired
+            );
+
+    static Finfo* poissonSourceFinfos[] =
+    {
+        spikeOut(),	    // SrcFinfo
+        &proc,		    // Shared
+        &rate,		    // ElementValue
+        &maxRate,	    // ElementValue
+        &refractT,	    // ElementValue
+        &lastEventT,	// ReadOnlyElementValue
+        &nextEventT,	// ReadOnlyElementValue
+        &numSpikes,	    // ReadOnlyElementValue
+        &seed,		    // ElementValue
+        &hasFired,	    // ReadOnlyElementValue
+    };
+
+    static string doc[] =
+    {
+        "Name", "PoissonSource",
+        "Description", "Event-driven Poisson spike source. Replacement "
+        "for RandSpike in large background populations: the time of the "
+        "next spike is sampled ahead, so no random number is drawn on "
+        "timesteps without a spike. Rate modulation is by thinning "
+        "against maxRate."
+    };
+    static Dinfo< PoissonSource > dinfo;
+    static Cinfo poissonSourceCinfo(
+        "PoissonSource",
+        Neutral::initCinfo(),
+        poissonSourceFinfos,
+        sizeof( poissonSourceFinfos ) / sizeof( Finfo* ),
+        &dinfo,
+        doc,
+        sizeof(doc)/sizeof(string)
+    );
+
+    return &poissonSourceCinfo;
+}
+
+static const Cinfo* poissonSourceCinfo = PoissonSource::initCinfo();
+static CheckpointHandler< PoissonSource > poissonSourceCheckpoint(
+    "PoissonSource" );
+
+PoissonSource::PoissonSource()
+    :
+    rate_( 0.0 ),
+    maxRate_( 0.0 ),
+    refractT_( 0.0 ),
+    lastEvent_( 0.0 ),
+    nextEvent_( numeric_limits< double >::infinity() ),
+    candidateEnvelope_( 0.0 ),
+    currTime_( 0.0 ),
+    numDraws_( 0 ),
+    numSpikes_( 0 ),
+    fired_( false ),
+    seed_( 0 ),
+    rngKey_( 0 )
+{
+    ;
+}
+
+//////////////////////////////////////////////////////////////////
+// Field access function definitions.
+//////////////////////////////////////////////////////////////////
+
+/**
+ * A rise of the rate above the envelope of the pending candidate makes
+ * that candidate too sparse, so it is redrawn from the current time.
+ * This is exact since the process is memoryless.
+ */
+void PoissonSource::setRate( const Eref& e, double rate )
+{
+    if ( rate < 0.0 )
+    {
+        cout <<"Warning: PoissonSource::setRate: Rate must be >= 0. Using 0.\n";
+        rate = 0.0;
+    }
+    rate_ = rate;
+    if ( hazard( rate_ ) > candidateEnvelope_ )
+        drawCandidate( std::max( currTime_, lastEvent_ + refractT_ ) );
+}
+
+double PoissonSource::getRate( const Eref& e ) const
+{
+    return rate_;
+}
+
+void PoissonSource::setMaxRate( const Eref& e, double rate )
+{
+    if ( rate < 0.0 )
+    {
+        cout <<"Warning: PoissonSource::setMaxRate: Rate must be >= 0. Using 0.\n";
+        rate = 0.0;
+    }
+    maxRate_ = rate;
+}
+
+double PoissonSource::getMaxRate( const Eref& e ) const
+{
+    return maxRate_;
+}
+
+void PoissonSource::setRefractT( const Eref& e, double val )
+{
+    refractT_ = val;
+}
+
+double PoissonSource::getRefractT( const Eref& e ) const
+{
+    return refractT_;
+}
+
+double PoissonSource::getLastEvent( const Eref& e ) const
+{
+    return lastEvent_;
+}
+
+double PoissonSource::getNextEvent( const Eref& e ) const
+{
+    return nextEvent_;
+}
+
+unsigned int PoissonSource::getNumSpikes( const Eref& e ) const
+{
+    return numSpikes_;
+}
+
+bool PoissonSource::getFired( const Eref& e ) const
+{
+    return fired_;
+}
+
+void PoissonSource::setSeed( const Eref& e, unsigned int val )
+{
+    seed_ = val;
+}
+
+unsigned int PoissonSource::getSeed( const Eref& e ) const
+{
+    return seed_;
+}
+
+//////////////////////////////////////////////////////////////////
+// Utility functions
+//////////////////////////////////////////////////////////////////
+
+double PoissonSource::hazard( double rate ) const
+{
+    double prob = 1.0 - rate * refractT_;
+    if ( prob <= 0.0 )
+        return rate;
+    return rate / prob;
+}
+
+double PoissonSource::envelope() const
+{
+    return hazard( std::max( rate_, maxRate_ ) );
+}
+
+void PoissonSource::drawCandidate( double t )
+{
+    candidateEnvelope_ = envelope();
+    if ( candidateEnvelope_ <= 0.0 )
+    {
+        nextEvent_ = numeric_limits< double >::infinity();
+        return;
+    }
+    moose::CounterRNG rng( rngKey_, numDraws_, 2 );
+    ++numDraws_;
+    nextEvent_ = t - log( rng.uniform() ) / candidateEnvelope_;
+}
+
+//////////////////////////////////////////////////////////////////
+// PoissonSource::Dest function definitions.
+//////////////////////////////////////////////////////////////////
+
+void PoissonSource::process( const Eref& e, ProcPtr p )
+{
+    fired_ = false;
+    currTime_ = p->currTime;
+    // The common case: no spike due on this step, nothing is drawn.
+    while ( nextEvent_ <= p->currTime )
+    {
+        double t = nextEvent_;
+        double h = hazard( rate_ );
+        bool accept = true;
+        if ( h < candidateEnvelope_ )
+        {
+            // Thinning. The acceptance draw uses its own stream.
+            moose::CounterRNG rng( rngKey_, numDraws_, 3 );
+            accept = rng.uniform() * candidateEnvelope_ < h;
+        }
+        if ( accept )
+        {
+            lastEvent_ = t;
+            ++numSpikes_;
+            fired_ = true;
+            spikeOut()->send( e, t );
+            // Nothing can fire inside the refractory period.
+            drawCandidate( t + refractT_ );
+        }
+        else
+        {
+            drawCandidate( t );
+        }
+    }
+}
+
+void PoissonSource::reinit( const Eref& e, ProcPtr p )
+{
+    lastEvent_ = 0.0;
+    numDraws_ = 0;
+    numSpikes_ = 0;
+    fired_ = false;
+    currTime_ = p->currTime;
+    // Keyed by seed or path rather than by Id, which depends on what
+    // else has been created and deleted.
+    if ( seed_ != 0 )
+        rngKey_ = moose::objectKey( seed_, e.dataIndex() );
+    else
+        rngKey_ = moose::pathKey( e.id().path(), e.dataIndex() );
+    drawCandidate( p->currTime );
+}
+
+/**
+ * The draws depend only on the key and the draw count, so this is all
+ * the state. The rate is included as it is usually set by message.
+ */
+void PoissonSource::saveState( CheckpointWriter& w ) const
+{
+    w.addValue( "rate", rate_ );
+    w.addValue( "lastEvent", lastEvent_ );
+    w.addValue( "nextEvent", nextEvent_ );
+    w.addValue( "candidateEnvelope", candidateEnvelope_ );
+    w.addValue( "currTime", currTime_ );
+    w.addValue( "numDraws", numDraws_ );
+    w.addValue( "numSpikes", numSpikes_ );
+    w.addValue( "fired", fired_ );
+    w.addValue( "rngKey", rngKey_ );
+}
+
+void PoissonSource::loadState( CheckpointReader& r )
+{
+    r.getValue( "rate", rate_ );
+    r.getValue( "lastEvent", lastEvent_ );
+    r.getValue( "nextEvent", nextEvent_ );
+    r.getValue( "candidateEnvelope", candidateEnvelope_ );
+    r.getValue( "currTime", currTime_ );
+    r.getValue( "numDraws", numDraws_ );
+    r.getValue( "numSpikes", numSpikes_ );
+    r.getValue( "fired", fired_ );
+    r.getValue( "rngKey", rngKey_ );
+}
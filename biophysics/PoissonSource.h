@@ -0,0 +1,103 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2026 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _POISSON_SOURCE_H
+#define _POISSON_SOURCE_H
+
+class CheckpointWriter;
+class CheckpointReader;
+
+/**
+ * Event-driven Poisson spike source. Rather than drawing a random number
+ * on every timestep as RandSpike does, each source pre-samples the time
+ * of its next candidate spike from an exponential interval, so on most
+ * timesteps process() is only a comparison. Time-varying rates are
+ * handled by thinning (Lewis and Shedler 1979): candidates are drawn at
+ * the envelope rate maxRate, and each is accepted with probability
+ * rate / maxRate.
+ */
+class PoissonSource
+{
+public:
+    PoissonSource();
+
+    //////////////////////////////////////////////////////////////////
+    // Field functions.
+    //////////////////////////////////////////////////////////////////
+    void setRate( const Eref& e, double rate );
+    double getRate( const Eref& e ) const;
+
+    void setMaxRate( const Eref& e, double rate );
+    double getMaxRate( const Eref& e ) const;
+
+    void setRefractT( const Eref& e, double val );
+    double getRefractT( const Eref& e ) const;
+
+    double getLastEvent( const Eref& e ) const;
+    double getNextEvent( const Eref& e ) const;
+    unsigned int getNumSpikes( const Eref& e ) const;
+    bool getFired( const Eref& e ) const;
+
+    void setSeed( const Eref& e, unsigned int val );
+    unsigned int getSeed( const Eref& e ) const;
+
+    //////////////////////////////////////////////////////////////////
+    // Message dest functions.
+    //////////////////////////////////////////////////////////////////
+
+    void process( const Eref& e, ProcPtr p );
+    void reinit( const Eref& e, ProcPtr p );
+
+    /// Checkpoint support, see shell/Checkpoint.h
+    void saveState( CheckpointWriter& w ) const;
+    void loadState( CheckpointReader& r );
+
+    //////////////////////////////////////////////////////////////////
+    static const Cinfo* initCinfo();
+private:
+    /**
+     * Rate of candidates outside the refractory period, such that the
+     * mean firing rate including refractory time is the given rate.
+     */
+    double hazard( double rate ) const;
+
+    /// Envelope rate used to draw candidates.
+    double envelope() const;
+
+    /**
+     * Draws the next candidate time after t. Uses a counter-based
+     * stream indexed by the number of candidates drawn so far, so the
+     * spike train is independent of dt and of the thread count.
+     */
+    void drawCandidate( double t );
+
+    double rate_;
+    double maxRate_;
+    double refractT_;
+    double lastEvent_;
+    double nextEvent_;
+
+    /// Envelope at which the pending candidate was drawn.
+    double candidateEnvelope_;
+
+    /// Time of the last process call, used when the rate is raised.
+    double currTime_;
+
+    /// Number of candidates drawn since reinit; the RNG step counter.
+    unsigned int numDraws_;
+    unsigned int numSpikes_;
+    bool fired_;
+
+    /// User-assigned key of the random stream, 0 to key it by path.
+    unsigned int seed_;
+    /// Object key of the random stream, fixed at reinit.
+    uint64_t rngKey_;
+};
+
+#endif // _POISSON_SOURCE_H
@@ -9,8 +9,10 @@
 
 #include "../basecode/header.h"
 #include "../randnum/randnum.h"
+#include "../randnum/CounterRNG.h"
 
 #include "RandSpike.h"
+#include "../shell/Checkpoint.h"
 
 ///////////////////////////////////////////////////////
 // MsgSrc definitions
@@ -82,6 +84,16 @@ const Cinfo* RandSpike::initCinfo()
             &RandSpike::setDoPeriodic,
             &RandSpike::getDoPeriodic
                                                    );
+    static ValueFinfo< RandSpike, unsigned int > seed( "seed",
+            "Selects the random spike train of this object, together with "
+            "the global seed set by moose.seed(). Entries of an array "
+            "with the same seed still get trains of their own. "
+            "When zero (default), the train is selected by the path of "
+            "the object, so a model that is built again gives the same "
+            "spikes.",
+            &RandSpike::setSeed,
+            &RandSpike::getSeed
+                                                   );
     static ReadOnlyValueFinfo< RandSpike, bool > hasFired( "hasFired",
             "True if RandSpike has just fired",
             &RandSpike::getFired
@@ -96,6 +108,7 @@ const Cinfo* RandSpike::initCinfo()
         &lastEventT,	// Value
         &absRefract,	// Value
         &doPeriodic,	// Value
+        &seed,		// Value
         &hasFired,	// ReadOnlyValue
     };
 
@@ -121,6 +134,7 @@ const Cinfo* RandSpike::initCinfo()
 }
 
 static const Cinfo* spikeGenCinfo = RandSpike::initCinfo();
+static CheckpointHandler< RandSpike > randSpikeCheckpoint( "RandSpike" );
 
 RandSpike::RandSpike()
     :
@@ -130,7 +144,9 @@ RandSpike::RandSpike()
     lastEvent_(0.0),
     threshold_(0.0),
     fired_( false ),
-    doPeriodic_( false )
+    doPeriodic_( false ),
+    seed_( 0 ),
+    rngKey_( 0 )
 {
     ;
 }
@@ -196,6 +212,16 @@ bool RandSpike::getDoPeriodic() const
     return doPeriodic_;
 }
 
+void RandSpike::setSeed( unsigned int val )
+{
+    seed_ = val;
+}
+
+unsigned int RandSpike::getSeed() const
+{
+    return seed_;
+}
+
 
 //////////////////////////////////////////////////////////////////
 // RandSpike::Dest function definitions.
@@ -218,8 +244,13 @@ void RandSpike::process( const Eref& e, ProcPtr p )
     }
     else
     {
+        // Draw from a counter-based stream addressed by object and
+        // step, so the spike train does not depend on the number of
+        // threads or on the order in which objects are processed.
+        uint64_t step = static_cast< uint64_t >( p->currTime / p->dt + 0.5 );
+        moose::CounterRNG rng( rngKey_, step );
         double prob = realRate_ * p->dt;
-        if ( prob >= 1.0 || prob >= moose::mtrand() )
+        if ( prob >= 1.0 || prob >= rng.uniform() )
         {
             lastEvent_ = p->currTime;
             spikeOut()->send( e, p->currTime );
@@ -231,6 +262,12 @@ void RandSpike::process( const Eref& e, ProcPtr p )
 // Set it so that first spike is allowed.
 void RandSpike::reinit( const Eref& e, ProcPtr p )
 {
+    // Keyed by seed or path rather than by Id, which depends on what
+    // else has been created and deleted.
+    if ( seed_ != 0 )
+        rngKey_ = moose::objectKey( seed_, e.dataIndex() );
+    else
+        rngKey_ = moose::pathKey( e.id().path(), e.dataIndex() );
     if ( rate_ <= 0.0 )
     {
         lastEvent_ = 0.0;
@@ -238,8 +275,29 @@ void RandSpike::reinit( const Eref& e, ProcPtr p )
     }
     else
     {
-        double prob = moose::mtrand();
+        // Stream 1 at step 0 is kept for the reinit draw.
+        moose::CounterRNG rng( rngKey_, 0, 1 );
+        double prob = rng.uniform();
         double m = 1.0 / rate_;
         lastEvent_ = m * log( prob );
     }
 }
+
+/**
+ * The spike draws depend only on the key and the time, so this is all
+ * the state. The key is kept so that a model rebuilt under another path
+ * still continues the same spike train.
+ */
+void RandSpike::saveState( CheckpointWriter& w ) const
+{
+    w.addValue( "lastEvent", lastEvent_ );
+    w.addValue( "fired", fired_ );
+    w.addValue( "rngKey", rngKey_ );
+}
+
+void RandSpike::loadState( CheckpointReader& r )
+{
+    r.getValue( "lastEvent", lastEvent_ );
+    r.getValue( "fired", fired_ );
+    r.getValue( "rngKey", rngKey_ );
+}
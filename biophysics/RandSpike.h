@@ -10,6 +10,9 @@
 #ifndef _RANDSPIKE_H
 #define _RANDSPIKE_H
 
+class CheckpointWriter;
+class CheckpointReader;
+
 class RandSpike
 {
 public:
@@ -30,6 +33,9 @@ public:
     void setDoPeriodic( bool val );
     bool getDoPeriodic() const;
 
+    void setSeed( unsigned int val );
+    unsigned int getSeed() const;
+
     bool getFired() const;
 
     //////////////////////////////////////////////////////////////////
@@ -39,6 +45,10 @@ public:
     void process( const Eref& e, ProcPtr p );
     void reinit( const Eref& e, ProcPtr p );
 
+    /// Checkpoint support, see shell/Checkpoint.h
+    void saveState( CheckpointWriter& w ) const;
+    void loadState( CheckpointReader& r );
+
     //////////////////////////////////////////////////////////////////
     static const Cinfo* initCinfo();
 private:
@@ -49,6 +59,10 @@ private:
     double threshold_;
     bool fired_;
     bool doPeriodic_;
+    /// User-assigned key of the random stream, 0 to key it by path.
+    unsigned int seed_;
+    /// Object key of the random stream, fixed at reinit.
+    uint64_t rngKey_;
 
 };
 
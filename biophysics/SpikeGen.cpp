@@ -9,6 +9,7 @@
 
 #include "../basecode/header.h"
 #include "SpikeGen.h"
+#include "../shell/Checkpoint.h"
 
 	///////////////////////////////////////////////////////
 	// MsgSrc definitions
@@ -123,6 +124,7 @@ const Cinfo* SpikeGen::initCinfo()
 }
 
 static const Cinfo* spikeGenCinfo = SpikeGen::initCinfo();
+static CheckpointHandler< SpikeGen > spikeGenCheckpoint( "SpikeGen" );
 
 SpikeGen::SpikeGen()
 	: threshold_(0.0),
@@ -226,6 +228,20 @@ void SpikeGen::handleVm( double val )
 	V_ = val;
 }
 
+void SpikeGen::saveState( CheckpointWriter& w ) const
+{
+	w.addValue( "lastEvent", lastEvent_ );
+	w.addValue( "V", V_ );
+	w.addValue( "fired", fired_ );
+}
+
+void SpikeGen::loadState( CheckpointReader& r )
+{
+	r.getValue( "lastEvent", lastEvent_ );
+	r.getValue( "V", V_ );
+	r.getValue( "fired", fired_ );
+}
+
 /////////////////////////////////////////////////////////////////////
 
 #ifdef DO_UNIT_TESTS
@@ -10,6 +10,9 @@
 #ifndef _SpikeGen_h
 #define _SpikeGen_h
 
+class CheckpointWriter;
+class CheckpointReader;
+
 class SpikeGen
 {
   public:
@@ -45,6 +48,10 @@ class SpikeGen
 		void reinit( const Eref& e, ProcPtr p );
 		void handleVm( double val );
 
+		/// Checkpoint support, see shell/Checkpoint.h
+		void saveState( CheckpointWriter& w ) const;
+		void loadState( CheckpointReader& r );
+
 		static const Cinfo* initCinfo();
 	private:
 		double threshold_;
@@ -260,7 +260,7 @@ const Cinfo* SymCompartment::initCinfo()
                 "coefficient for computing equivalent resistances in the mesh is done\n"
                 "at reinit.",
 	};
-        static Dinfo< SymCompartment > dinfo;
+        static ArenaDinfo< SymCompartment > dinfo;
 
 	static Cinfo symCompartmentCinfo(
 			"SymCompartment",
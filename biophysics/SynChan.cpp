@@ -11,6 +11,7 @@
 #include "ChanBase.h"
 #include "ChanCommon.h"
 #include "SynChan.h"
+#include "../shell/Checkpoint.h"
 
 const double& SynE() {
 	static const double SynE = exp(1.0);
@@ -43,6 +44,25 @@ const Cinfo* SynChan::initCinfo()
         &SynChan::setNormalizeWeights,
 		&SynChan::getNormalizeWeights
 	);
+	static ValueFinfo< SynChan, double > gkThreshold( "gkThreshold",
+		"Conductance below which a SynChan with no incoming activation "
+		"goes to sleep. A sleeping channel is not integrated until "
+		"activation arrives, when its conductance is brought up to "
+		"date in one step. It only sleeps once its conductance can no "
+		"longer rise above this value without new input, and counts "
+		"as zero while asleep: Gk and Ik are zero, and zeros go out on "
+		"its messages for as long as anything is connected. The "
+		"default of zero "
+		"only lets channels with no conductance at all sleep, which "
+		"does not change results. A negative value keeps the channel "
+		"awake.",
+        &SynChan::setGkThreshold,
+		&SynChan::getGkThreshold
+	);
+	static ReadOnlyValueFinfo< SynChan, bool > isActive( "isActive",
+		"False while the channel is asleep, see gkThreshold.",
+		&SynChan::getIsActive
+	);
 
 	///////////////////////////////////////////////////////
 	// MsgDest definitions
@@ -57,6 +77,8 @@ const Cinfo* SynChan::initCinfo()
 		&tau1,			// Value
 		&tau2,			// Value
 		&normalizeWeights,	// Value
+		&gkThreshold,	// Value
+		&isActive,		// ReadOnlyValue
 		&activation,	// Dest
 	};
 
@@ -75,7 +97,7 @@ const Cinfo* SynChan::initCinfo()
 		"the handlers can be fixed weight or have a learning rule. "
 	};
 
-        static Dinfo< SynChan > dinfo;
+        static ArenaDinfo< SynChan > dinfo;
 
 	static Cinfo SynChanCinfo(
 		"SynChan",
@@ -91,6 +113,7 @@ const Cinfo* SynChan::initCinfo()
 }
 
 static const Cinfo* synChanCinfo = SynChan::initCinfo();
+static CheckpointHandler< SynChan > synChanCheckpoint( "SynChan" );
 
 SynChan::SynChan()
 	:
@@ -104,7 +127,11 @@ SynChan::SynChan()
         activation_(0.0),
         X_(0.0),
         Y_(0.0),
-		dt_( 25.0e-6 )
+		dt_( 25.0e-6 ),
+		gkThreshold_( 0.0 ),
+		asleep_( false ),
+		recheck_( false ),
+		sleptAt_( 0.0 )
 { ; }
 
 SynChan::~SynChan()
@@ -120,6 +147,12 @@ void SynChan::vSetGbar( const Eref& e, double Gbar )
 	normalizeGbar();
 }
 
+void SynChan::vSetModulation( const Eref& e, double modulation )
+{
+	ChanCommon::vSetModulation( e, modulation );
+	recheck_ = asleep_;
+}
+
 void SynChan::setTau1( double tau1 )
 {
 	tau1_ = tau1;
@@ -168,6 +201,21 @@ bool SynChan::getNormalizeWeights() const
 	return normalizeWeights_;
 }
 
+void SynChan::setGkThreshold( double value )
+{
+	gkThreshold_ = value;
+}
+
+double SynChan::getGkThreshold() const
+{
+	return gkThreshold_;
+}
+
+bool SynChan::getIsActive() const
+{
+	return !asleep_;
+}
+
 void SynChan::normalizeGbar()
 {
         if ( doubleEq( tau2_, 0.0 ) ) {
@@ -185,6 +233,8 @@ void SynChan::normalizeGbar()
                                                 ));
                 }
         }
+	// The sleep bound was taken with the old scale.
+	recheck_ = asleep_;
 		/*
 		 * Can't handle at this time. Simple but tedious to implement.
 	if ( normalizeWeights_ && getNumSynapses() > 0 )
@@ -218,11 +268,92 @@ void SynChan::vProcess( const Eref& e, ProcPtr info )
     //      is sent from SynHandler-s for one dt
     // For continuous activation in a graded synapse,
     //      send activation for continous dt-s.
+	if ( asleep_ ) {
+		if ( activation_ == 0.0 && !recheck_ ) {
+			// Gk_ and Ik_ stay at zero. The compartment got the zero
+			// conductance on the step the channel fell asleep, and it
+			// adds nothing, so only sampled outputs are sent.
+			if ( hasSampledOutputs( e ) ) {
+				IkOut()->send( e, 0.0 );
+				permeability()->send( e, 0.0 );
+			}
+			return;
+		}
+		wake( info->currTime );
+	}
+	recheck_ = false;
+	bool input = ( activation_ != 0.0 );
 	setGk( e, calcGk() );
 	updateIk();
+	if ( !input && canSleep() ) {
+		// The conductance counts as zero until activation comes in.
+		asleep_ = true;
+		sleptAt_ = info->currTime;
+		ChanBase::setGk( e, 0.0 );
+		ChanBase::setIk( e, 0.0 );
+	}
 	sendProcessMsgs( e, info ); // Sends out messages for channel.
 }
 
+void SynChan::vProcessAll( const Eref& e, unsigned int n, ProcPtr info )
+{
+	Element* elm = e.element();
+	// Unless something samples IkOut or permeability, sleeping entries
+	// need not be visited.
+	bool send = hasSampledOutputs( e );
+	for ( unsigned int i = 0; i < n; ++i ) {
+		Eref er( elm, e.dataIndex() + i );
+		SynChan* chan = reinterpret_cast< SynChan* >( er.data() );
+		if ( send || !chan->asleep_ || chan->activation_ != 0.0 ||
+				chan->recheck_ )
+			chan->vProcess( er, info );
+	}
+}
+
+bool SynChan::hasSampledOutputs( const Eref& e )
+{
+	const Element* elm = e.element();
+	return elm->hasMsgs( ChanBase::IkOut()->getBindIndex() ) ||
+		elm->hasMsgs( ChanBase::permeability()->getBindIndex() );
+}
+
+/**
+ * Without activation, X_ decays by xconst2_ each step, and Y_ after m
+ * steps is Y_ yconst2_^m plus yconst1_ X_ times the sum over j = 1..m of
+ * xconst2_^j yconst2_^(m-j). That sum is below xconst2_ / ( 1 - the
+ * smaller of the two decay factors ), which bounds the conductance the
+ * channel can still reach. At a threshold of zero only X_ and Y_ count,
+ * so that a channel with Gbar or modulation at zero for the moment does
+ * not sleep through its input.
+ */
+bool SynChan::canSleep() const
+{
+	double a = xconst2_;
+	double b = yconst2_;
+	double slowest = 1.0 - ( a < b ? a : b );
+	double bound = fabs( Y_ ) * slowest + yconst1_ * fabs( X_ ) * a;
+	if ( gkThreshold_ <= 0.0 )
+		return bound == 0.0 && gkThreshold_ == 0.0;
+	return bound * fabs( norm_ * getModulation() ) <=
+		gkThreshold_ * slowest;
+}
+
+void SynChan::wake( double currTime )
+{
+	asleep_ = false;
+	// Steps skipped between the one at sleptAt_ and this one.
+	double m = floor( ( currTime - sleptAt_ ) / dt_ + 0.5 ) - 1.0;
+	if ( m < 1.0 )
+		return;
+	double a = xconst2_;
+	double b = yconst2_;
+	double am = pow( a, m );
+	double bm = pow( b, m );
+	double sum = doubleEq( a, b ) ? m * am : a * ( am - bm ) / ( a - b );
+	Y_ = Y_ * bm + X_ * yconst1_ * sum;
+	X_ *= am;
+}
+
 /*
  * Note that this causes issues if we have variable dt.
  */
@@ -234,6 +365,8 @@ void SynChan::vReinit( const Eref& e, ProcPtr info )
 	ChanBase::setIk( e, 0.0 );
 	X_ = 0.0;
 	Y_ = 0.0;
+	asleep_ = false;
+	recheck_ = false;
     // These below statements are also called when setting tau1 and tau2
     // (required when changing tau1 and tau2 during a simulation).
 	xconst1_ = tau1_ * ( 1.0 - exp( -dt_ / tau1_ ) );
@@ -254,3 +387,25 @@ void SynChan::activation( double val )
 {
 	activation_ += val;
 }
+
+void SynChan::saveState( CheckpointWriter& w ) const
+{
+	ChanCommon::saveState( w );
+	w.addValue( "X", X_ );
+	w.addValue( "Y", Y_ );
+	w.addValue( "activation", activation_ );
+	w.addValue( "asleep", asleep_ );
+	w.addValue( "recheck", recheck_ );
+	w.addValue( "sleptAt", sleptAt_ );
+}
+
+void SynChan::loadState( CheckpointReader& r )
+{
+	ChanCommon::loadState( r );
+	r.getValue( "X", X_ );
+	r.getValue( "Y", Y_ );
+	r.getValue( "activation", activation_ );
+	r.getValue( "asleep", asleep_ );
+	r.getValue( "recheck", recheck_ );
+	r.getValue( "sleptAt", sleptAt_ );
+}
@@ -10,6 +10,9 @@
 #ifndef _SynChan_h
 #define _SynChan_h
 
+class CheckpointWriter;
+class CheckpointReader;
+
 class SynChan: public ChanCommon
 {
 	public:
@@ -29,8 +32,13 @@ class SynChan: public ChanCommon
 		void setNormalizeWeights( bool value );
 		bool getNormalizeWeights() const;
 
+		void setGkThreshold( double value );
+		double getGkThreshold() const;
+		bool getIsActive() const;
+
 		// override virtual func from ChanBase
 		void vSetGbar( const Eref& e, double Gbar );
+		void vSetModulation( const Eref& e, double modulation );
 
 		/////////////////////////////////////////////////////////////////
 		// Utility function for any time Gbar changes
@@ -56,6 +64,10 @@ class SynChan: public ChanCommon
 		void vProcess( const Eref& e, ProcPtr p );
 		void vReinit( const Eref& e, ProcPtr p );
 
+		/// Process for the n entries of an Element, passing over the
+		/// ones that are asleep and have had no activation.
+		void vProcessAll( const Eref& e, unsigned int n, ProcPtr p );
+
 		void activation( double val );
 ///////////////////////////////////////////////////
 		/**
@@ -63,6 +75,10 @@ class SynChan: public ChanCommon
 		 */
 		/* void innerAddSpike( unsigned int synIndex, const double time ); */
 
+		/// Checkpoint support, see shell/Checkpoint.h
+		void saveState( CheckpointWriter& w ) const;
+		void loadState( CheckpointReader& r );
+
 		static const Cinfo* initCinfo();
 	protected: // Used by NMDAChan
 
@@ -71,6 +87,19 @@ class SynChan: public ChanCommon
 ///////////////////////////////////////////////////
     // virtual unsigned int updateNumSynapse( Eref e );
 
+		/**
+		 * True if, without further activation, the conductance cannot
+		 * get above gkThreshold_ again.
+		 */
+		bool canSleep() const;
+
+		/// Brings X_ and Y_ up to the step before currTime after a sleep.
+		void wake( double currTime );
+
+		/// True if the Element has anything on IkOut or permeability,
+		/// which a sleeping channel still feeds zeros on every step.
+		static bool hasSampledOutputs( const Eref& e );
+
 		double tau1_;
 		double tau2_;
 		int normalizeWeights_;
@@ -83,6 +112,12 @@ class SynChan: public ChanCommon
 		double X_;
 		double Y_;
 		double dt_; /// Tracks the timestep assigned at reinit.
+		double gkThreshold_;
+		bool asleep_;
+		/// Gbar, tau or modulation changed during a sleep, so the next
+		/// step wakes the channel and tests the bound again.
+		bool recheck_;
+		double sleptAt_; /// Time of the last step done before sleeping.
 };
 
 
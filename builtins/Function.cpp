@@ -21,6 +21,7 @@
 
 #include "Variable.h"
 #include "Function.h"
+#include "../shell/Checkpoint.h"
 
 #include "../ksolve/RateTerm.h"
 #include "../basecode/SparseMatrix.h"
@@ -403,6 +404,7 @@ constant 'pi'.
 }
 
 static const Cinfo * functionCinfo = Function::initCinfo();
+static CheckpointHandler<Function> functionCheckpoint("Function");
 
 Function::Function()
     : valid_(true),
@@ -887,6 +889,38 @@ void Function::reinit(const Eref &e, ProcPtr p)
     }
 }
 
+void Function::saveState(CheckpointWriter& w) const
+{
+    w.addValue("lastValue", lastValue_);
+    w.addValue("value", value_);
+    w.addValue("rate", rate_);
+    w.addValue("t", t_);
+    // The inputs last received and pulled.
+    vector<double> v;
+    for (auto *xx : xs_)
+        v.push_back(xx->getValue());
+    w.add("xs", v);
+    v.clear();
+    for (auto *yy : ys_)
+        v.push_back(*yy);
+    w.add("ys", v);
+}
+
+void Function::loadState(CheckpointReader& r)
+{
+    r.getValue("lastValue", lastValue_);
+    r.getValue("value", value_);
+    r.getValue("rate", rate_);
+    r.getValue("t", t_);
+    vector<double> v(xs_.size());
+    if (r.get("xs", v.data(), v.size()))
+        for (size_t ii = 0; ii < v.size(); ++ii)
+            xs_[ii]->setValue(v[ii]);
+    v.resize(ys_.size());
+    if (r.get("ys", v.data(), v.size()))
+        for (size_t ii = 0; ii < v.size(); ++ii)
+            *ys_[ii] = v[ii];
+}
 
 void Function::clearVariables()
 {
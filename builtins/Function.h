@@ -11,6 +11,8 @@
 class Variable;
 class Eref;
 class Cinfo;
+class CheckpointWriter;
+class CheckpointReader;
 
 namespace moose { 
     class MooseParser;
@@ -89,6 +91,10 @@ public:
     void process(const Eref& e, ProcPtr p);
     void reinit(const Eref& e, ProcPtr p);
 
+    /// Checkpoint support, see shell/Checkpoint.h
+    void saveState(CheckpointWriter& w) const;
+    void loadState(CheckpointReader& r);
+
     // // This is also used as callback.
     // void addVariable(const string& name);
 
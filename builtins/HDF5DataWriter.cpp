@@ -12,12 +12,138 @@
 
 #include "hdf5.h"
 
+#include <thread>
+#include <condition_variable>
+#include <deque>
+
 #include "../basecode/header.h"
 #include "../utility/utility.h"
 #include "../utility/strutil.h"
 
 #include "HDF5DataWriter.h"
 
+/**
+   A single writer thread with a bounded queue of jobs. Each job runs
+   under the HDF5 library lock. push() blocks while the queue is full,
+   so a slow disk slows the simulation down rather than letting the
+   buffered data grow without bound.
+ */
+class HDF5WriteQueue
+{
+  public:
+    HDF5WriteQueue(unsigned int maxLength)
+        : maxLength_(maxLength), busy_(false), done_(false),
+          thread_(&HDF5WriteQueue::run, this)
+    {
+    }
+
+    ~HDF5WriteQueue()
+    {
+        {
+            std::lock_guard< std::mutex > lock(mutex_);
+            done_ = true;
+        }
+        ready_.notify_all();
+        thread_.join();
+    }
+
+    void push(std::function< void() > job)
+    {
+        std::unique_lock< std::mutex > lock(mutex_);
+        idle_.wait(lock, [this]{ return jobs_.size() < maxLength_; });
+        jobs_.push_back(std::move(job));
+        ready_.notify_one();
+    }
+
+    /// Returns once every job pushed so far has been written.
+    void wait()
+    {
+        std::unique_lock< std::mutex > lock(mutex_);
+        idle_.wait(lock, [this]{ return jobs_.empty() && !busy_; });
+    }
+
+  private:
+    void run()
+    {
+        std::unique_lock< std::mutex > lock(mutex_);
+        while (true){
+            ready_.wait(lock, [this]{ return done_ || !jobs_.empty(); });
+            if (jobs_.empty()){
+                return;
+            }
+            std::function< void() > job = std::move(jobs_.front());
+            jobs_.pop_front();
+            busy_ = true;
+            lock.unlock();
+            {
+                std::lock_guard< std::recursive_mutex > h5lock(
+                    HDF5WriterBase::libraryMutex());
+                job();
+            }
+            lock.lock();
+            busy_ = false;
+            idle_.notify_all();
+        }
+    }
+
+    unsigned int maxLength_;
+    bool busy_;
+    bool done_;
+    std::deque< std::function< void() > > jobs_;
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::condition_variable idle_;
+    std::thread thread_;
+};
+
+/**
+   Append a block of steps to a 2-D dataset of rows x time. The block
+   holds one value per row for each step, step by step, and is
+   transposed here so the simulation thread only ever appends to it.
+ */
+static herr_t appendColumns(hid_t dataset, unsigned int rows,
+                            const vector< double >& block)
+{
+    if (dataset < 0 || rows == 0 || block.empty()){
+        return 0;
+    }
+    hsize_t cols = block.size() / rows;
+    vector< double > buf(block.size());
+    // Transpose in tiles, so that neither side is walked with a
+    // stride of a whole row.
+    const unsigned int tile = 64;
+    for (unsigned int i0 = 0; i0 < rows; i0 += tile){
+        unsigned int i1 = min(rows, i0 + tile);
+        for (hsize_t jj = 0; jj < cols; ++jj){
+            for (unsigned int ii = i0; ii < i1; ++ii){
+                buf[ii * cols + jj] = block[jj * rows + ii];
+            }
+        }
+    }
+    hid_t filespace = H5Dget_space(dataset);
+    if (filespace < 0){
+        return -1;
+    }
+    hsize_t dims[2];
+    H5Sget_simple_extent_dims(filespace, dims, NULL);
+    H5Sclose(filespace);
+    hsize_t newdims[2] = {dims[0], dims[1] + cols};
+    herr_t status = H5Dset_extent(dataset, newdims);
+    if (status < 0){
+        return status;
+    }
+    filespace = H5Dget_space(dataset);
+    hsize_t start[2] = {0, dims[1]};
+    hsize_t count[2] = {dims[0], cols};
+    hid_t memspace = H5Screate_simple(2, count, NULL);
+    H5Sselect_hyperslab(filespace, H5S_SELECT_SET, start, NULL, count, NULL);
+    status = H5Dwrite(dataset, H5T_NATIVE_DOUBLE, memspace, filespace,
+                      H5P_DEFAULT, &buf[0]);
+    H5Sclose(memspace);
+    H5Sclose(filespace);
+    return status;
+}
+
 static SrcFinfo1< vector < double > * > *requestOut() {
     static SrcFinfo1< vector < double > * > requestOut(
         "requestOut",
@@ -57,9 +183,30 @@ const Cinfo * HDF5DataWriter::initCinfo()
       &HDF5DataWriter::setFlushLimit,
       &HDF5DataWriter::getFlushLimit);
 
+    static ValueFinfo< HDF5DataWriter, string> layout(
+      "layout",
+      "How the recorded data are laid out in the file. `perSource`"
+      " (default) puts each source in its own 1-D dataset at a path that"
+      " replicates the MOOSE element tree. `uniform2D` puts all the"
+      " sources in a single 2-D dataset `/data` of sources x time, with"
+      " the source paths in `/sources` and the sampling interval in the"
+      " `dt` attribute of `/data`. Takes effect at reinit.",
+      &HDF5DataWriter::setLayout,
+      &HDF5DataWriter::getLayout);
+
+    static ValueFinfo< HDF5DataWriter, unsigned int> ioQueueLength(
+      "ioQueueLength",
+      "Number of pending writes that may be queued for the writer thread"
+      " before the simulation waits for it. 0 writes on the simulation"
+      " thread. Default is 4. Takes effect at reinit.",
+      &HDF5DataWriter::setIoQueueLength,
+      &HDF5DataWriter::getIoQueueLength);
+
     static Finfo * finfos[] = {
         requestOut(),
         &flushLimit,
+        &layout,
+        &ioQueueLength,
         &proc,
     };
 
@@ -84,6 +231,12 @@ const Cinfo * HDF5DataWriter::initCinfo()
         " `/model[0]/neuron[0]/soma[0], the dataset path will be"
         " `/model[0]/neuron[0]/soma[0]/vm`"
         "\n"
+        "\nWith `layout` set to `uniform2D` all sources go into one 2-D"
+        " dataset instead, which is written a slab of steps at a time and"
+        " is much cheaper when there are many sources. In either layout"
+        " the writes are done by a separate thread unless `ioQueueLength`"
+        " is 0."
+        "\n"
         "\n"
         "NOTE: The output file remains open until this object is destroyed, or"
         " `close()` is called explicitly."
@@ -102,7 +255,9 @@ const Cinfo * HDF5DataWriter::initCinfo()
 
 static const Cinfo * hdf5dataWriterCinfo = HDF5DataWriter::initCinfo();
 
-HDF5DataWriter::HDF5DataWriter(): flushLimit_(4*1024*1024), steps_(0)
+HDF5DataWriter::HDF5DataWriter(): flushLimit_(4*1024*1024), steps_(0),
+                                  layout_("perSource"), ioQueueLength_(4),
+                                  uniform_(-1), slabSteps_(1)
 {
 }
 
@@ -119,6 +274,8 @@ HDF5DataWriter& HDF5DataWriter::operator=(const HDF5DataWriter& other)
     HDF5WriterBase::operator=(other);
     flushLimit_ = other.flushLimit_;
     steps_ = other.steps_;
+    layout_ = other.layout_;
+    ioQueueLength_ = other.ioQueueLength_;
 
     // These are rebuilt at reinit based on connections
     src_.clear();
@@ -134,6 +291,16 @@ void HDF5DataWriter::close()
         return;
     }
     this->flush();
+    io_.reset();
+    std::lock_guard< std::recursive_mutex > lock(libraryMutex());
+    if (uniform_ >= 0){
+        H5Dclose(uniform_);
+        uniform_ = -1;
+    }
+    for (unsigned int ii = 0; ii < datasets_.size(); ++ii){
+        H5Dclose(datasets_[ii]);
+    }
+    datasets_.clear();
     for (map < string, hid_t >::iterator ii = nodemap_.begin();
          ii != nodemap_.end(); ++ii){
         if (ii->second >= 0){
@@ -156,18 +323,72 @@ void HDF5DataWriter::flush()
         return;
     }
 
-    for (unsigned int ii = 0; ii < datasets_.size(); ++ii){
-        herr_t status = appendToDataset(datasets_[ii], data_[ii]);
-        data_[ii].clear();
-        if (status < 0){
-            cerr << "Warning: appending data for object " << src_[ii]
-                 << " returned status " << status << endl;
-        }
+    writeBuffers();
+    if (io_){
+        io_->wait();
     }
+    std::lock_guard< std::recursive_mutex > lock(libraryMutex());
     HDF5WriterBase::flush();
     H5Fflush(filehandle_, H5F_SCOPE_LOCAL);
 }
 
+void HDF5DataWriter::submit(std::function< void() > job)
+{
+    if (io_){
+        io_->push(std::move(job));
+    } else {
+        std::lock_guard< std::recursive_mutex > lock(libraryMutex());
+        job();
+    }
+}
+
+/**
+   Pass the buffered data on to the writer and start new buffers. The
+   buffers are moved into the job, so the simulation goes on filling
+   fresh ones while the old ones are written.
+ */
+void HDF5DataWriter::writeBuffers()
+{
+    steps_ = 0;
+    if (uniform_ >= 0){
+        if (slab_.empty()){
+            return;
+        }
+        std::shared_ptr< vector< double > > block =
+                std::make_shared< vector< double > >();
+        block->swap(slab_);
+        slab_.reserve(block->size());
+        hid_t dataset = uniform_;
+        unsigned int rows = src_.size();
+        submit([dataset, rows, block]() {
+                herr_t status = appendColumns(dataset, rows, *block);
+                if (status < 0){
+                    cerr << "Warning: HDF5DataWriter: appending to /data"
+                         << " returned status " << status << endl;
+                }
+            });
+        return;
+    }
+    if (data_.empty() || data_[0].empty()){
+        return;
+    }
+    std::shared_ptr< vector< vector< double > > > block =
+            std::make_shared< vector< vector < double > > >(data_.size());
+    block->swap(data_);
+    for (unsigned int ii = 0; ii < data_.size(); ++ii){
+        data_[ii].reserve((*block)[ii].size());
+    }
+    submit([this, block]() {
+            for (unsigned int ii = 0; ii < datasets_.size(); ++ii){
+                herr_t status = appendToDataset(datasets_[ii], (*block)[ii]);
+                if (status < 0){
+                    cerr << "Warning: appending data for object " << src_[ii]
+                         << " returned status " << status << endl;
+                }
+            }
+        });
+}
+
 /**
    Write data to datasets in HDF5 file. Clear all data in the table
    objects associated with this object. */
@@ -179,20 +400,20 @@ void HDF5DataWriter::process(const Eref & e, ProcPtr p)
 
     vector <double> dataBuf;
         requestOut()->send(e, &dataBuf);
+    if (uniform_ >= 0){
+        dataBuf.resize(src_.size());
+        slab_.insert(slab_.end(), dataBuf.begin(), dataBuf.end());
+        if (++steps_ >= slabSteps_){
+            writeBuffers();
+        }
+        return;
+    }
     for (unsigned int ii = 0; ii < dataBuf.size(); ++ii){
         data_[ii].push_back(dataBuf[ii]);
     }
     ++steps_;
     if (steps_ >= flushLimit_){
-        steps_ = 0;
-        for (unsigned int ii = 0; ii < datasets_.size(); ++ii){
-            herr_t status = appendToDataset(datasets_[ii], data_[ii]);
-            data_[ii].clear();
-            if (status < 0){
-                cerr << "Warning: appending data for object " << src_[ii]
-                     << " returned status " << status << endl;
-            }
-        }
+        writeBuffers();
     }
 }
 
@@ -202,10 +423,13 @@ void HDF5DataWriter::reinit(const Eref & e, ProcPtr p)
         throw invalid_argument("HDF5DataWriter::reinit: filename is empty.");
     }
 
-    steps_ = 0;
-    for (unsigned int ii = 0; ii < data_.size(); ++ii){
-        H5Dclose(datasets_[ii]);
+    // Closing writes out what is still buffered, using the datasets
+    // of the previous run, so it has to come first.
+    if (filehandle_ > 0 ){
+        close();
     }
+    steps_ = 0;
+    slab_.clear();
     data_.clear();
     src_.clear();
     func_.clear();
@@ -218,13 +442,14 @@ void HDF5DataWriter::reinit(const Eref & e, ProcPtr p)
     // TODO: what to do when reinit is called? Close the existing file
     // and open a new one in append mode? Or keep adding to the
     // current file?
-    if (filehandle_ > 0 ){
-        close();
-    }
     if (numTgt == 0){
         return;
     }
     openFile();
+    if (ioQueueLength_ > 0){
+        io_.reset(new HDF5WriteQueue(ioQueueLength_));
+    }
+    vector< string > names;
     for (unsigned int ii = 0; ii < src_.size(); ++ii){
         string varname = func_[ii];
         unsigned int found = varname.find("get");
@@ -242,10 +467,82 @@ void HDF5DataWriter::reinit(const Eref & e, ProcPtr p)
         }
         assert(varname.length() > 0);
         string path = src_[ii].path() + "/" + varname;
+        if (layout_ == "uniform2D"){
+            names.push_back(path);
+            continue;
+        }
         hid_t dataset_id = getDataset(path);
         datasets_.push_back(dataset_id);
     }
-    data_.resize(src_.size());
+    if (layout_ == "uniform2D"){
+        openUniform(names, p->dt);
+    } else {
+        data_.resize(src_.size());
+    }
+}
+
+/**
+   Create the 2-D dataset for the uniform2D layout, or reopen it when
+   appending to a file that has one with the same number of sources.
+
+   A slab of steps is buffered before each write. It is kept under
+   16 MiB and, so that every write fills whole chunks along the time
+   axis, the chunks are one slab long. Chunks span as many sources as
+   make about 1 MiB, which is large enough for the file and small
+   enough for the chunk cache.
+ */
+void HDF5DataWriter::openUniform(const vector< string >& names, double dt)
+{
+    std::lock_guard< std::recursive_mutex > lock(libraryMutex());
+    unsigned int rows = names.size();
+    unsigned long maxSteps = (16ul << 20) / (sizeof(double) * rows);
+    slabSteps_ = max(1ul, min(maxSteps, (unsigned long)flushLimit_));
+    unsigned int chunkRows = max(1ul, (128ul << 10) / slabSteps_);
+    slab_.reserve(slabSteps_ * rows);
+
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+    htri_t exists = H5Lexists(filehandle_, "data", H5P_DEFAULT);
+    if (exists > 0){
+        uniform_ = H5Dopen2(filehandle_, "data", H5P_DEFAULT);
+        hid_t space = H5Dget_space(uniform_);
+        hsize_t dims[2] = {0, 0};
+        if (H5Sget_simple_extent_ndims(space) == 2){
+            H5Sget_simple_extent_dims(space, dims, NULL);
+        }
+        H5Sclose(space);
+        if (dims[0] != rows){
+            cout << "Warning: HDF5DataWriter::openUniform: /data in "
+                 << filename_ << " has " << dims[0] << " rows, but "
+                 << rows << " sources are connected. Not recording.\n";
+            H5Dclose(uniform_);
+            uniform_ = -1;
+        }
+        return;
+    }
+    unsigned int chunkSize = chunkSize_;
+    chunkSize_ = slabSteps_;
+    uniform_ = createDataset2D(filehandle_, "data", rows, chunkRows);
+    chunkSize_ = chunkSize;
+    if (uniform_ < 0){
+        cerr << "Error: HDF5DataWriter::openUniform: could not create /data"
+             << " in " << filename_ << endl;
+        uniform_ = -1;
+        return;
+    }
+    writeScalarAttr< double >(uniform_, "dt", dt);
+
+    hid_t sources = createStringDataset(filehandle_, "sources", rows, rows);
+    if (sources >= 0){
+        vector< const char* > buf(rows);
+        for (unsigned int ii = 0; ii < rows; ++ii){
+            buf[ii] = names[ii].c_str();
+        }
+        hid_t dtype = H5Tcopy(H5T_C_S1);
+        H5Tset_size(dtype, H5T_VARIABLE);
+        H5Dwrite(sources, dtype, H5S_ALL, H5S_ALL, H5P_DEFAULT, &buf[0]);
+        H5Tclose(dtype);
+        H5Dclose(sources);
+    }
 }
 
 /**
@@ -256,6 +553,7 @@ hid_t HDF5DataWriter::getDataset(string path)
     if (filehandle_ < 0){
         return -1;
     }
+    std::lock_guard< std::recursive_mutex > lock(libraryMutex());
     herr_t status = H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
     // Create the groups corresponding to this path
     // string::unsigned intype lastslash = path.find_last_of("/");
@@ -319,6 +617,31 @@ unsigned int HDF5DataWriter::getFlushLimit() const
     return flushLimit_;
 }
 
+void HDF5DataWriter::setLayout(string layout)
+{
+    if (layout != "perSource" && layout != "uniform2D"){
+        cout << "Warning: HDF5DataWriter::setLayout: unknown layout '"
+             << layout << "'. Use 'perSource' or 'uniform2D'.\n";
+        return;
+    }
+    layout_ = layout;
+}
+
+string HDF5DataWriter::getLayout() const
+{
+    return layout_;
+}
+
+void HDF5DataWriter::setIoQueueLength(unsigned int length)
+{
+    ioQueueLength_ = length;
+}
+
+unsigned int HDF5DataWriter::getIoQueueLength() const
+{
+    return ioQueueLength_;
+}
+
 #endif // USE_HDF5
 //
 // HDF5DataWriter.cpp ends here
@@ -37,8 +37,12 @@
 #ifndef _HDF5DATAWRITER_H
 #define _HDF5DATAWRITER_H
 
+#include <memory>
+#include <functional>
 #include "HDF5WriterBase.h"
 
+class HDF5WriteQueue;
+
 class HDF5DataWriter: public HDF5WriterBase
 {
   public:
@@ -47,6 +51,10 @@ class HDF5DataWriter: public HDF5WriterBase
     HDF5DataWriter& operator=(const HDF5DataWriter& other);
     void setFlushLimit(unsigned int limit);
     unsigned int getFlushLimit() const;
+    void setLayout(string layout);
+    string getLayout() const;
+    void setIoQueueLength(unsigned int length);
+    unsigned int getIoQueueLength() const;
     // void flush();
     void process(const Eref &e, ProcPtr p);
     void reinit(const Eref &e, ProcPtr p);
@@ -63,6 +71,25 @@ class HDF5DataWriter: public HDF5WriterBase
     vector <hid_t> datasets_;
     unsigned long steps_;
     hid_t getDataset(string path);
+
+    /// Hands the buffered data over to be written to the file.
+    void writeBuffers();
+    /// Runs job on the writer thread, or right away if there is none.
+    void submit(std::function< void() > job);
+    /// Creates or opens the 2-D dataset for the uniform2D layout.
+    void openUniform(const vector< string >& names, double dt);
+
+    /// "perSource" or "uniform2D".
+    string layout_;
+    /// Most writes that may wait for the writer thread. 0: no thread.
+    unsigned int ioQueueLength_;
+    std::unique_ptr< HDF5WriteQueue > io_;
+    /// The 2-D dataset, sources x time, in the uniform2D layout.
+    hid_t uniform_;
+    /// Steps buffered before a write in the uniform2D layout.
+    unsigned int slabSteps_;
+    /// Values of the current slab, one row of all sources per step.
+    vector< double > slab_;
 };
 #endif // _HDF5DATAWRITER_H
 #endif // USE_HDF5
@@ -218,16 +218,21 @@ herr_t HDF5WriterBase::appendToDataset(hid_t dataset_id, const vector< double >&
 
 /**
    Create a 2D dataset under parent with name. It will have specified
-   number of rows and unlimited columns.
+   number of rows and unlimited columns. Each chunk spans chunkRows
+   rows, or all of them if chunkRows is 0, and chunkSize_ columns.
  */
-hid_t HDF5WriterBase::createDataset2D(hid_t parent, string name, unsigned int rows)
+hid_t HDF5WriterBase::createDataset2D(hid_t parent, string name, unsigned int rows,
+                                      unsigned int chunkRows)
 {
     if (parent < 0){
         return 0;
     }
     herr_t status;
+    if (chunkRows == 0 || chunkRows > rows){
+        chunkRows = rows;
+    }
     // we need chunking here to allow extensibility
-    hsize_t chunkdims[] = {rows, chunkSize_};
+    hsize_t chunkdims[] = {chunkRows, chunkSize_};
     hid_t chunk_params = H5Pcreate(H5P_DATASET_CREATE);
     status = H5Pset_chunk(chunk_params, 2, chunkdims);
     assert(status >= 0);
@@ -587,8 +592,15 @@ bool HDF5WriterBase::isOpen() const
     return filehandle_ >= 0;
 }
 
+std::recursive_mutex& HDF5WriterBase::libraryMutex()
+{
+    static std::recursive_mutex m;
+    return m;
+}
+
 herr_t HDF5WriterBase::openFile()
 {
+    std::lock_guard< std::recursive_mutex > lock(libraryMutex());
     herr_t status = 0;
     if (filehandle_ >= 0){
         cout << "Warning: closing already open file and opening " << filename_ <<  endl;
@@ -688,6 +700,7 @@ void HDF5WriterBase::flushAttributes()
     if (filehandle_ < 0){
         return;
     }
+    std::lock_guard< std::recursive_mutex > lock(libraryMutex());
     // Write all scalar attributes
     writeScalarAttributesFromMap< string >(filehandle_, sattr_);
     writeScalarAttributesFromMap< double >(filehandle_, dattr_);
@@ -704,6 +717,7 @@ void HDF5WriterBase::close()
         return;
     }
     flush();
+    std::lock_guard< std::recursive_mutex > lock(libraryMutex());
     herr_t status = H5Fclose(filehandle_);
     filehandle_ = -1;
     if (status < 0){
@@ -32,6 +32,7 @@
 #ifndef _HDF5IO_H
 #define _HDF5IO_H
 #include <typeinfo>
+#include <mutex>
 
 hid_t require_attribute(hid_t file_id, string path,
                         hid_t data_type, hid_t data_id);
@@ -76,6 +77,12 @@ class HDF5WriterBase
 
     static const Cinfo* initCinfo();
 
+    /**
+     * The HDF5 library is not thread safe. Anything that calls it while
+     * a writer thread may be running holds this lock.
+     */
+    static std::recursive_mutex& libraryMutex();
+
   protected:
     friend void testCreateStringDataset();
 
@@ -85,7 +92,8 @@ class HDF5WriterBase
     hid_t createStringDataset(hid_t parent, std::string name, hsize_t size=0, hsize_t maxsize=H5S_UNLIMITED);
 
     herr_t appendToDataset(hid_t dataset, const vector<double>& data);
-    hid_t createDataset2D(hid_t parent, string name, unsigned int rows);
+    hid_t createDataset2D(hid_t parent, string name, unsigned int rows,
+                          unsigned int chunkRows=0);
 
     /// map from element path to nodes in hdf5file.  Multiple MOOSE
     /// tables can be written to the single file corresponding to a
@@ -118,6 +126,13 @@ template <typename A> herr_t writeScalarAttr(hid_t file_id, string path, A value
     return -1;
 }
 
+// The specializations are defined in HDF5WriterBase.cpp. Declaring them
+// here keeps other files from instantiating the generic version.
+template <> herr_t writeScalarAttr(hid_t file_id, string path, string value);
+template <> herr_t writeScalarAttr(hid_t file_id, string path, double value);
+template <> herr_t writeScalarAttr(hid_t file_id, string path, long value);
+template <> herr_t writeScalarAttr(hid_t file_id, string path, int value);
+
 
 ////////////////////////////////////////////////////////////
 // Write vector attributes
@@ -131,6 +146,13 @@ template <typename A> herr_t writeVectorAttr(hid_t file_id, string path,
     return -1;
 }
 
+template <> herr_t writeVectorAttr(hid_t file_id, string path,
+                                   vector < string > value);
+template <> herr_t writeVectorAttr(hid_t file_id, string path,
+                                   vector < double > value);
+template <> herr_t writeVectorAttr(hid_t file_id, string path,
+                                   vector < long > value);
+
 #endif // _HDF5IO_H
 #endif // USE_HDF5
 
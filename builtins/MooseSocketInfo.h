@@ -13,7 +13,7 @@ class MooseSocketInfo
 {
 public:
     MooseSocketInfo( const string& addr = "" )
-        : address(addr), valid(false)
+        : type(UNIX_DOMAIN_SOCKET), address(addr), valid(false), port(0)
     {
         if( addr.size() > 0 )
             init();
@@ -39,7 +39,7 @@ public:
         {
             type = TCP_SOCKET;
             auto colPos = address.find_last_of(':');
-            if( colPos == string::npos )
+            if( colPos == string::npos || colPos < 7 )
             {
                 port = 0;
                 host = address;
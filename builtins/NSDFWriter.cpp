@@ -174,6 +174,7 @@ void NSDFWriter::close()
     if (filehandle_ < 0){
         return;
     }
+    std::lock_guard< std::recursive_mutex > lock(libraryMutex());
     flush();
     closeUniformData();
     if (uniformGroup_ >= 0){
@@ -475,6 +476,7 @@ hid_t NSDFWriter::getEventDataset(string srcPath, string srcField)
 
 void NSDFWriter::flush()
 {
+    std::lock_guard< std::recursive_mutex > lock(libraryMutex());
     // We need to update the tend on each write since we do not know
     // when the simulation is getting over and when it is just paused.
     writeScalarAttr<string>(filehandle_, "tend", iso_time(NULL));
@@ -533,6 +535,8 @@ void NSDFWriter::flush()
 
 void NSDFWriter::reinit(const Eref& eref, const ProcPtr proc)
 {
+    // Everything below creates and writes HDF5 objects.
+    std::lock_guard< std::recursive_mutex > lock(libraryMutex());
     // write environment
     // write model
     // write map
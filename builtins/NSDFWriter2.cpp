@@ -188,6 +188,7 @@ void NSDFWriter2::close()
     if (filehandle_ < 0){
         return;
     }
+    std::lock_guard< std::recursive_mutex > lock(libraryMutex());
     flush();
     closeUniformData();
     if (uniformGroup_ >= 0){
@@ -516,6 +517,7 @@ hid_t NSDFWriter2::getEventDataset(string srcPath, string srcField)
 
 void NSDFWriter2::flush()
 {
+    std::lock_guard< std::recursive_mutex > lock(libraryMutex());
     // We need to update the tend on each write since we do not know
     // when the simulation is getting over and when it is just paused.
     writeScalarAttr<string>(filehandle_, "tend", iso_time(NULL));
@@ -574,6 +576,8 @@ void NSDFWriter2::flush()
 
 void NSDFWriter2::reinit(const Eref& eref, const ProcPtr proc)
 {
+    // Everything below creates and writes HDF5 objects.
+    std::lock_guard< std::recursive_mutex > lock(libraryMutex());
     // write environment
     // write model
     // write map
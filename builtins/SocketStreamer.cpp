@@ -4,7 +4,7 @@
  * Description:  TCP and Unix Domain Socket to stream data.
  *
  * Author:  Dilawar Singh <dilawar.s.rajput@gmail.com>
- * Updated: 2024-07-17 by subha 
+ * Updated: 2024-07-17 by subha
  * Organization:  NCBS Bangalore
  *
  * License:  See MOOSE licence.
@@ -14,6 +14,7 @@
 #include <sstream>
 #include <chrono>
 #include <thread>
+#include <cstring>
 
 #ifdef _WIN32
 #include <io.h>
@@ -21,12 +22,15 @@
 #define access _access
 #else
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
 #endif
 
 #include "../basecode/global.h"
 #include "../basecode/header.h"
 #include "../scheduling/Clock.h"
 #include "../utility/utility.h"
+#include "../utility/strutil.h"
 #include "../shell/Shell.h"
 #include "SocketStreamer.h"
 
@@ -37,7 +41,8 @@ const Cinfo* SocketStreamer::initCinfo()
      *-----------------------------------------------------------------------------*/
     static ValueFinfo< SocketStreamer, unsigned int > port(
         "port"
-        , "Set port number for streaming. Valid only of TCP socket."
+        , "Set port number for streaming. Valid only of TCP socket. It is used "
+        "for the TCP addresses which do not give a port."
         , &SocketStreamer::setPort
         , &SocketStreamer::getPort
     );
@@ -45,17 +50,63 @@ const Cinfo* SocketStreamer::initCinfo()
     static ValueFinfo< SocketStreamer, string > address(
         "address"
         , "Set adresss for socket e.g. http://localhost:31416 (host:port for TCP SOCKET) "
-        ", or file:///tmp/MOOSE_SOCK for UNIX domain socket."
+        ", or file:///tmp/MOOSE_SOCK for UNIX domain socket. Several addresses "
+        "separated by commas are all served, e.g. "
+        "file:///tmp/MOOSE_SOCK,http://localhost:31416"
         , &SocketStreamer::setAddress
         , &SocketStreamer::getAddress
     );
 
+    static ValueFinfo< SocketStreamer, string > dataType(
+        "dataType"
+        , "Type of the values sent, 'float64' (default) or 'float32'."
+        , &SocketStreamer::setDataType
+        , &SocketStreamer::getDataType
+    );
+
+    static ValueFinfo< SocketStreamer, string > policy(
+        "policy"
+        , "What to do when a subscriber falls behind and its buffer is full. "
+        "'drop' (default) discards the new frame for that subscriber, so that "
+        "the simulation never waits. 'block' makes the simulation wait until "
+        "the subscriber has taken enough data."
+        , &SocketStreamer::setPolicy
+        , &SocketStreamer::getPolicy
+    );
+
+    static ValueFinfo< SocketStreamer, unsigned int > bufferSize(
+        "bufferSize"
+        , "Size in bytes of the buffer held for each subscriber. Default 4 MB."
+        , &SocketStreamer::setBufferSize
+        , &SocketStreamer::getBufferSize
+    );
+
+    static ValueFinfo< SocketStreamer, unsigned int > maxClients(
+        "maxClients"
+        , "Largest number of subscribers at a time. Default 64."
+        , &SocketStreamer::setMaxClients
+        , &SocketStreamer::getMaxClients
+    );
+
     static ReadOnlyValueFinfo< SocketStreamer, unsigned int > numTables (
         "numTables"
         , "Number of Tables handled by SocketStreamer "
         , &SocketStreamer::getNumTables
     );
 
+    static ReadOnlyValueFinfo< SocketStreamer, unsigned int > numClients (
+        "numClients"
+        , "Number of subscribers connected now."
+        , &SocketStreamer::getNumClients
+    );
+
+    static ReadOnlyValueFinfo< SocketStreamer, unsigned long > numDroppedFrames (
+        "numDroppedFrames"
+        , "Number of frames dropped, summed over the subscribers, because "
+        "their buffers were full."
+        , &SocketStreamer::getNumDroppedFrames
+    );
+
     /*-----------------------------------------------------------------------------
      *
      *-----------------------------------------------------------------------------*/
@@ -111,7 +162,8 @@ const Cinfo* SocketStreamer::initCinfo()
 
     static Finfo * socketStreamFinfo[] =
     {
-        &port, &address, &proc, &numTables
+        &port, &address, &dataType, &policy, &bufferSize, &maxClients,
+        &proc, &numTables, &numClients, &numDroppedFrames
     };
 
     static string doc[] =
@@ -119,6 +171,20 @@ const Cinfo* SocketStreamer::initCinfo()
         "Name", "SocketStreamer",
         "Author", "Dilawar Singh (@dilawar, github), 2018",
         "Description", "SocketStreamer: Stream moose.Table data to a socket.\n"
+        "Any number of subscribers may connect, over Unix domain and TCP "
+        "sockets, at any time. A separate thread does all the socket I/O, "
+        "so slow subscribers do not slow down the simulation unless the "
+        "'block' policy is chosen.\n"
+        "Each subscriber first gets a header frame, and again whenever the "
+        "tables change or on reinit:\n"
+        "    'MSH1' uint32 valueSize uint32 numColumns\n"
+        "    numColumns x ( uint32 nameLength, name bytes )\n"
+        "followed by data frames holding the entries added since the last "
+        "frame:\n"
+        "    'MSD1' uint32 numColumns uint32 count[ numColumns ]\n"
+        "    numColumns x ( count times, count values )\n"
+        "The times and values are float64 or float32 as set by dataType. "
+        "All integers and values are in the byte order of the host.\n"
     };
 
     static Dinfo< SocketStreamer > dinfo;
@@ -138,19 +204,99 @@ const Cinfo* SocketStreamer::initCinfo()
 
 static const Cinfo* tableStreamCinfo = SocketStreamer::initCinfo();
 
+/*-----------------------------------------------------------------------------
+ *  SocketSubscriber
+ *-----------------------------------------------------------------------------*/
+SocketSubscriber::SocketSubscriber( int sockfd, size_t capacity ) :
+    fd( sockfd )
+    , numDropped( 0 )
+    , needsHeader( false )
+    , ring_( capacity )
+    , head_( 0 )
+    , size_( 0 )
+{
+    ;
+}
+
+SocketSubscriber::~SocketSubscriber()
+{
+    shutdown( fd, SHUT_RDWR );
+    close( fd );
+}
+
+size_t SocketSubscriber::space() const
+{
+    return ring_.size() - size_;
+}
+
+size_t SocketSubscriber::pending() const
+{
+    return size_;
+}
+
+bool SocketSubscriber::push( const char* data, size_t n )
+{
+    if( n > space() )
+        return false;
+    size_t tail = ( head_ + size_ ) % ring_.size();
+    size_t first = std::min( n, ring_.size() - tail );
+    memcpy( &ring_[tail], data, first );
+    memcpy( &ring_[0], data + first, n - first );
+    size_ += n;
+    return true;
+}
+
+bool SocketSubscriber::flush()
+{
+    while( size_ > 0 )
+    {
+        size_t chunk = std::min( size_, ring_.size() - head_ );
+        ssize_t sent = send( fd, &ring_[head_], chunk, MSG_NOSIGNAL );
+        if( sent < 0 )
+            return ( errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR );
+        head_ = ( head_ + sent ) % ring_.size();
+        size_ -= sent;
+        if( (size_t) sent < chunk )
+            break;
+    }
+    return true;
+}
+
+/*-----------------------------------------------------------------------------
+ *  SocketStreamer
+ *-----------------------------------------------------------------------------*/
+
+// Appends the raw bytes of x to buf.
+template< class T > static void appendRaw( vector< char >& buf, T x )
+{
+    const char* p = reinterpret_cast< const char* >( &x );
+    buf.insert( buf.end(), p, p + sizeof( T ) );
+}
+
+static void setNonBlocking( int fd )
+{
+    fcntl( fd, F_SETFL, fcntl( fd, F_GETFL, 0 ) | O_NONBLOCK );
+}
+
 // Constructor
 SocketStreamer::SocketStreamer() :
      currTime_(0.0)
-    , numMaxClients_(1)
-    , sockfd_(-1)
-    , clientfd_(-1)
+    , numMaxClients_(64)
+    , numDropped_(0)
+    , all_done_(false)
+    , thisDt_(1.0)
+    , useFloat_(false)
+    , block_(false)
+    , bufferSize_(4 << 20)
     , sockInfo_( MooseSocketInfo( "file://MOOSE" ) )
+    , address_( "file://MOOSE" )
 {
     clk_ = reinterpret_cast<Clock*>( Id(1).eref().data() );
+    sockInfo_.port = TCP_SOCKET_PORT;
+    wakefds_[0] = wakefds_[1] = -1;
 
     // Not all compilers allow initialization during the declaration of class
     // methods.
-    columns_.push_back( "time" );               /* First column is time. */
     tables_.resize(0);
     tableIds_.resize(0);
     tableTick_.resize(0);
@@ -166,269 +312,425 @@ SocketStreamer& SocketStreamer::operator=( const SocketStreamer& st )
 // Deconstructor
 SocketStreamer::~SocketStreamer()
 {
-    // Now cleanup the socket as well.
-    all_done_ = true;
-    if(sockfd_ > 0)
-    {
-        LOG(moose::debug, "Closing socket " << sockfd_ );
-        shutdown(sockfd_, SHUT_RDWR);
-        close(sockfd_);
-
-        if( sockInfo_.type == UNIX_DOMAIN_SOCKET )
-            ::unlink( sockInfo_.filepath.c_str() );
-    }
-
-    if( processThread_.joinable())
-        processThread_.join();
-
-    // Close the client as well.
-    if( clientfd_ > -1 )
-    {
-        shutdown(clientfd_, SHUT_RDWR);
-        close(clientfd_);
-    }
-}
-
-void SocketStreamer::addStringToDoubleVec(vector<double>&res, const string s)
-{
-    for(char c : s)
-        res.push_back((double)c);
+    cleanUp();
 }
 
 /* --------------------------------------------------------------------------*/
 /**
- * @Synopsis  Connect to a client. If already connected to one, then do not make
- * any more connections.
+ * @Synopsis  Stop the I/O thread, and close the subscribers and the server
+ * sockets.
  */
 /* ----------------------------------------------------------------------------*/
-void SocketStreamer::listenToClients(unsigned int numMaxClients)
+void SocketStreamer::cleanUp( void )
 {
-    assert(0 < sockfd_ );
-    assert( numMaxClients > 0 );
-    numMaxClients_ = numMaxClients;
-    if(-1 == listen(sockfd_, numMaxClients_))
-        LOG(moose::error, "Failed listen() on socket " << sockfd_
-                << ". Error was: " << strerror(errno) );
+    all_done_ = true;
+    if( processThread_.joinable() )
+    {
+        wake();
+        spaceAvailable_.notify_all();
+        processThread_.join();
+    }
 
+    {
+        std::lock_guard< std::mutex > lock( mutex_ );
+        clients_.clear();
+    }
+
+    for( unsigned int i = 0; i < listenfds_.size(); i++ )
+    {
+        LOG(moose::debug, "Closing socket " << listenfds_[i] );
+        shutdown(listenfds_[i], SHUT_RDWR);
+        close(listenfds_[i]);
+        if( endpoints_[i].type == UNIX_DOMAIN_SOCKET )
+            ::unlink( endpoints_[i].filepath.c_str() );
+    }
+    listenfds_.clear();
+    endpoints_.clear();
+
+    for( int i = 0; i < 2; i++ )
+        if( wakefds_[i] > -1 )
+        {
+            close( wakefds_[i] );
+            wakefds_[i] = -1;
+        }
 }
 
 void SocketStreamer::initServer( void )
 {
-    if( sockInfo_.type == UNIX_DOMAIN_SOCKET )
-        initUDSServer();
-    else
-        initTCPServer();
+    stringstream ss( address_ );
+    string addr;
+    while( std::getline( ss, addr, ',' ) )
+    {
+        addr = moose::trim( addr );
+        if( addr.empty() )
+            continue;
+        MooseSocketInfo info( addr );
+        if( ! info.valid )
+        {
+            LOG( moose::warning, "Unsupported address " << addr );
+            continue;
+        }
+        int fd;
+        if( info.type == UNIX_DOMAIN_SOCKET )
+            fd = initUDSServer( info );
+        else
+        {
+            if( info.port == 0 )
+                info.port = sockInfo_.port;
+            fd = initTCPServer( info );
+        }
+        if( fd < 0 )
+            continue;
 
-    LOG(moose::info,  "Successfully initialized streamer socket: " << sockfd_);
+        setNonBlocking( fd );
+        if(-1 == listen(fd, SOMAXCONN))
+        {
+            LOG(moose::error, "Failed listen() on socket " << fd
+                << ". Error was: " << strerror(errno) );
+            close( fd );
+            continue;
+        }
+        listenfds_.push_back( fd );
+        endpoints_.push_back( info );
+        LOG(moose::info,  "Successfully initialized streamer socket: " << info );
+    }
 
-    //  Listen for incoming clients. This function does nothing if connection is
-    //  already made.
-    listenToClients(1);
+    isValid_ = ( listenfds_.size() > 0 && 0 == pipe( wakefds_ ) );
+    if( isValid_ )
+    {
+        setNonBlocking( wakefds_[0] );
+        setNonBlocking( wakefds_[1] );
+    }
 }
 
-void SocketStreamer::configureSocketServer( )
+void SocketStreamer::configureSocketServer( int fd )
 {
     // One can set socket option using setsockopt function. See manual page
     // for details. We are making it 'reusable'.
     int on = 1;
 
 #ifdef SO_REUSEPORT
-    if(0 > setsockopt(sockfd_, SOL_SOCKET, SO_REUSEPORT, (const char *)&on, sizeof(on)))
+    if(0 > setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, (const char *)&on, sizeof(on)))
         LOG(moose::warning, "Warn: setsockopt() failed");
 #endif
 
-    if(0 > setsockopt(sockfd_, SOL_SOCKET, SO_REUSEADDR, (const char *)&on, sizeof(on)))
+    if(0 > setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, (const char *)&on, sizeof(on)))
         LOG(moose::warning, "Warn: setsockopt() failed");
 }
 
-void SocketStreamer::initUDSServer( void )
+int SocketStreamer::initUDSServer( const MooseSocketInfo& info )
 {
     // PF_UNIX means that sockets are local.
-    sockfd_ = socket(PF_UNIX, SOCK_STREAM, 0);
-    if( ! sockfd_)
+    int fd = socket(PF_UNIX, SOCK_STREAM, 0);
+    if( fd < 0 )
     {
-        isValid_ = false;
         perror( "Socket" );
+        return -1;
     }
 
-    if( sockfd_ > 0 )
-    {
-        bzero(&sockAddrUDS_, sizeof(sockAddrUDS_));
-        sockAddrUDS_.sun_family = AF_UNIX;
-        strncpy(sockAddrUDS_.sun_path, sockInfo_.filepath.c_str(), sizeof(sockAddrUDS_.sun_path)-1);
-        configureSocketServer();
+    struct sockaddr_un sockAddrUDS;
+    bzero(&sockAddrUDS, sizeof(sockAddrUDS));
+    sockAddrUDS.sun_family = AF_UNIX;
+    strncpy(sockAddrUDS.sun_path, info.filepath.c_str(), sizeof(sockAddrUDS.sun_path)-1);
+    configureSocketServer( fd );
 
-        // Bind. Make sure bind is not std::bind
-        if(0 > ::bind(sockfd_, (struct sockaddr*) &sockAddrUDS_, sizeof(sockAddrUDS_)))
-        {
-            isValid_ = false;
-            LOG(moose::warning, "Warn: Failed to create socket at " << sockInfo_.filepath
-                << ". File descriptor: " << sockfd_
-                << ". Erorr: " << strerror(errno)
-               );
-        }
+    // A stale socket file from an earlier run would make bind fail. Only
+    // a socket is removed: any other file at this path is left alone and
+    // bind reports the clash.
+    struct stat st;
+    if( 0 == ::lstat( info.filepath.c_str(), &st ) && S_ISSOCK( st.st_mode ) )
+        ::unlink( info.filepath.c_str() );
 
-        if(access(sockInfo_.filepath.c_str(), F_OK) != 0)
-        {
-            LOG( moose::warning, "No file " << sockInfo_.filepath << " exists." );
-            isValid_ = false;
-        }
-    }
-
-    if( (! isValid_) || (sockfd_ < 0) )
+    // Bind. Make sure bind is not std::bind
+    if(0 > ::bind(fd, (struct sockaddr*) &sockAddrUDS, sizeof(sockAddrUDS)))
     {
-        LOG( moose::warning, "Failed to create socket : " << sockInfo_ );
-        ::unlink( sockInfo_.filepath.c_str() );
+        LOG(moose::warning, "Warn: Failed to create socket at " << info.filepath
+            << ". File descriptor: " << fd
+            << ". Erorr: " << strerror(errno)
+           );
+        close( fd );
+        return -1;
     }
+    return fd;
 }
 
-void SocketStreamer::initTCPServer( void )
+int SocketStreamer::initTCPServer( const MooseSocketInfo& info )
 {
-    // Create a blocking socket.
-    LOG( moose::debug, "Creating TCP socket on port: "  << sockInfo_.port );
-    sockfd_ = socket(AF_INET, SOCK_STREAM, 0);
-    if( 0 > sockfd_ )
+    LOG( moose::debug, "Creating TCP socket on port: "  << info.port );
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if( 0 > fd )
     {
         perror("socket");
-        isValid_ = false;
-        return;
+        return -1;
     }
 
-    configureSocketServer();
-    bzero((char*) &sockAddrTCP_, sizeof(sockAddrTCP_));
-    sockAddrTCP_.sin_family = AF_INET;
-    sockAddrTCP_.sin_addr.s_addr = INADDR_ANY;
-    sockAddrTCP_.sin_port = htons( sockInfo_.port );
+    configureSocketServer( fd );
+    struct sockaddr_in sockAddrTCP;
+    bzero((char*) &sockAddrTCP, sizeof(sockAddrTCP));
+    sockAddrTCP.sin_family = AF_INET;
+    sockAddrTCP.sin_addr.s_addr = INADDR_ANY;
+    sockAddrTCP.sin_port = htons( info.port );
 
     // Bind. Make sure bind is not std::bind
-    if(0 > ::bind(sockfd_, (struct sockaddr*) &sockAddrTCP_, sizeof(sockAddrTCP_)))
+    if(0 > ::bind(fd, (struct sockaddr*) &sockAddrTCP, sizeof(sockAddrTCP)))
     {
-        isValid_ = false;
         LOG(moose::warning, "Warn: Failed to create server at "
-                << sockInfo_.host << ":" << sockInfo_.port
-                << ". File descriptor: " << sockfd_
+                << info.host << ":" << info.port
+                << ". File descriptor: " << fd
                 << ". Erorr: " << strerror(errno)
            );
-        return;
+        close( fd );
+        return -1;
     }
+    return fd;
 }
 
 /* --------------------------------------------------------------------------*/
 /**
- * @Synopsis  Convert data to JSON.
- *
- * @Returns JSON representation.
+ * @Synopsis  Build the header frame which names the columns, and queue it
+ * for the subscribers already connected.
  */
 /* ----------------------------------------------------------------------------*/
-void SocketStreamer::dataToStream(map<string, vector<double>>& data)
+void SocketStreamer::makeHeader( void )
 {
-    for( unsigned int i = 0; i < tables_.size(); i++)
+    vector< char > header;
+    header.insert( header.end(), { 'M', 'S', 'H', '1' } );
+    appendRaw< uint32_t >( header, useFloat_ ? sizeof( float ) : sizeof( double ) );
+    appendRaw< uint32_t >( header, columns_.size() );
+    for( const string& c : columns_ )
     {
-        vector<double> vec;
-        tables_[i]->collectData(vec, true, false);
-        if( ! vec.empty() )
-            data[columns_[i+1]] = vec;
+        appendRaw< uint32_t >( header, c.size() );
+        header.insert( header.end(), c.begin(), c.end() );
     }
+
+    std::lock_guard< std::mutex > lock( mutex_ );
+    header_.swap( header );
+    // A subscriber that misses the header would read later frames with
+    // the old columns. So it gets no frames until the I/O thread has made
+    // room for the header.
+    for( auto& c : clients_ )
+        c->needsHeader = ! c->push( &header_[0], header_.size() );
+    wake();
 }
 
 /* --------------------------------------------------------------------------*/
 /**
- * @Synopsis  Stream data over socket.
+ * @Synopsis  Serialize the entries added to the tables since the last call.
  *
- * @Returns True of success, false otherwise. It is callee job to clean up data_
- *          on a successful return from this function.
+ * @Returns True if there were any.
  */
 /* ----------------------------------------------------------------------------*/
-int SocketStreamer::streamData( )
+bool SocketStreamer::dataToStream( vector< char >& frame )
 {
-    map<string, vector<double>> data;
-    dataToStream(data);
-
-    if(data.empty())
+    size_t valueSize = useFloat_ ? sizeof( float ) : sizeof( double );
+    frame.clear();
+    frame.insert( frame.end(), { 'M', 'S', 'D', '1' } );
+    appendRaw< uint32_t >( frame, tables_.size() );
+    size_t countPos = frame.size();
+    frame.resize( countPos + tables_.size() * sizeof( uint32_t ) );
+
+    size_t total = 0;
+    for( unsigned int i = 0; i < tables_.size(); i++)
     {
-        LOG(moose::debug, "No data in tables.");
-        return 0;
+        vec_.clear();
+        tables_[i]->collectData( vec_, true, false );
+        uint32_t num = vec_.size() / 2;
+        memcpy( &frame[ countPos + i * sizeof( uint32_t ) ], &num, sizeof( num ) );
+        total += num;
+
+        // vec_ interleaves times and values.
+        size_t pos = frame.size();
+        frame.resize( pos + 2 * num * valueSize );
+        char* t = &frame[pos];
+        char* v = t + num * valueSize;
+        for( uint32_t k = 0; k < num; k++ )
+        {
+            if( useFloat_ )
+            {
+                float x[2] = { (float) vec_[2*k], (float) vec_[2*k+1] };
+                memcpy( t + k * valueSize, &x[0], valueSize );
+                memcpy( v + k * valueSize, &x[1], valueSize );
+            }
+            else
+            {
+                memcpy( t + k * valueSize, &vec_[2*k], valueSize );
+                memcpy( v + k * valueSize, &vec_[2*k+1], valueSize );
+            }
+        }
     }
+    return total > 0;
+}
 
-    // Construct a void* array to send over the socket. Serialize the data.
-    // e.g. H 10 / a / t a b l e / a V 4 0.1 0.2 0.3 0.2
-    // H => Header start (chars)
-    // V => Value starts (double)
-    for(auto v: data)
-    {
-        // First header.
-        vecToStream_.push_back((double)'H');
-        vecToStream_.push_back(v.first.size());
-        addStringToDoubleVec(vecToStream_, v.first);
-
-        // Now data.
-        vecToStream_.push_back((double)'V');
-        vecToStream_.push_back(v.second.size());
-        vecToStream_.insert(vecToStream_.end(), v.second.begin(), v.second.end());
-    }
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  Queue a frame for each subscriber. The I/O thread sends it.
+ * Under the 'block' policy this waits for room in the buffers.
+ */
+/* ----------------------------------------------------------------------------*/
+void SocketStreamer::streamData( const vector< char >& frame )
+{
+    std::unique_lock< std::mutex > lock( mutex_ );
+    if( clients_.empty() )
+        return;
 
-    unsigned int dtypeSize = sizeof(double);
-    int sent = send(clientfd_, (void*) &vecToStream_[0], dtypeSize*vecToStream_.size(), MSG_MORE);
-    LOG(moose::debug, "Sent " << sent << " bytes." );
-    if( sent < 0 )
-        return errno;
+    // Subscribers may come and go while we wait, so go by their sockets.
+    vector< int > fds;
+    for( auto& c : clients_ )
+        fds.push_back( c->fd );
 
-    vecToStream_.erase(vecToStream_.begin(), vecToStream_.begin()+(sent/dtypeSize));
-    return 0;
+    for( int fd : fds )
+    {
+        while( true )
+        {
+            auto c = std::find_if( clients_.begin(), clients_.end(),
+                    [fd]( const unique_ptr< SocketSubscriber >& s ) {
+                        return s->fd == fd;
+                    } );
+            if( c == clients_.end() )
+                break;
+            if( ! (*c)->needsHeader && (*c)->push( &frame[0], frame.size() ) )
+                break;
+            if( ! block_ || frame.size() > bufferSize_ || all_done_ )
+            {
+                (*c)->numDropped++;
+                numDropped_++;
+                break;
+            }
+            wake();
+            spaceAvailable_.wait_for( lock, std::chrono::milliseconds( 100 ) );
+        }
+    }
+    wake();
 }
 
-
-bool SocketStreamer::enoughDataToStream(unsigned int minsize)
+void SocketStreamer::wake( void )
 {
-    for( unsigned int i = 0; i < tables_.size(); i++)
-        if(tables_[i]->getVector().size() >= minsize)
-            return true;
-    return false;
+    if( wakefds_[1] > -1 )
+    {
+        char c = 0;
+        // If the pipe is full, the I/O thread is awake anyway.
+        if( write( wakefds_[1], &c, 1 ) < 0 && errno != EAGAIN
+                && errno != EWOULDBLOCK )
+            LOG( moose::warning, "Could not wake the I/O thread: "
+                    << strerror( errno ) );
+    }
 }
 
-void SocketStreamer::connect( )
+void SocketStreamer::acceptClients( int listenfd )
 {
-    // If server was invalid then there is no point.
-    if( ! isValid_ )
-        return;
-
-    struct sockaddr_storage clientAddr;
-    socklen_t addrLen = sizeof(clientAddr);
-    clientfd_ = ::accept(sockfd_,(struct sockaddr*) &clientAddr, &addrLen);
-    assert( clientfd_ );
-
-    char ipstr[INET6_ADDRSTRLEN];
-    int port = -1;
-    // deal with both IPv4 and IPv6:
-    if (clientAddr.ss_family == AF_INET)
+    while( true )
     {
-        struct sockaddr_in *s = (struct sockaddr_in *)&clientAddr;
-        port = ntohs(s->sin_port);
-        inet_ntop(AF_INET, &s->sin_addr, ipstr, sizeof ipstr);
-    }
-    else
-    { // AF_INET6
-        struct sockaddr_in6 *s = (struct sockaddr_in6 *)&clientAddr;
-        port = ntohs(s->sin6_port);
-        inet_ntop(AF_INET6, &s->sin6_addr, ipstr, sizeof ipstr);
-    }
+        struct sockaddr_storage clientAddr;
+        socklen_t addrLen = sizeof(clientAddr);
+        int fd = ::accept(listenfd, (struct sockaddr*) &clientAddr, &addrLen);
+        if( fd < 0 )
+            return;
+        setNonBlocking( fd );
+#ifdef SO_NOSIGPIPE
+        int on = 1;
+        setsockopt( fd, SOL_SOCKET, SO_NOSIGPIPE, (const char *)&on, sizeof(on) );
+#endif
 
-    LOG(moose::info, "Connected to " << ipstr << ':' << port);
-    return;
+        std::lock_guard< std::mutex > lock( mutex_ );
+        if( clients_.size() >= numMaxClients_ )
+        {
+            LOG( moose::warning, "Too many clients. Refusing a new one." );
+            close( fd );
+            continue;
+        }
+        clients_.emplace_back( new SocketSubscriber( fd, bufferSize_ ) );
+        if( ! header_.empty() )
+            clients_.back()->needsHeader =
+                ! clients_.back()->push( &header_[0], header_.size() );
+        LOG( moose::info, "Connected to a new client. Total "
+                << clients_.size() );
+    }
 }
 
-void SocketStreamer::stream( void )
+/* --------------------------------------------------------------------------*/
+/**
+ * @Synopsis  The event loop of the I/O thread. Waits on the server sockets,
+ * the subscribers with data to send, and the wake pipe written by process.
+ */
+/* ----------------------------------------------------------------------------*/
+void SocketStreamer::ioLoop( void )
 {
-    if(clientfd_ > 0)
+    vector< struct pollfd > fds;
+    char buf[256];
+    while( ! all_done_ )
     {
-        if( EPIPE == streamData() )
+        fds.clear();
+        fds.push_back( { wakefds_[0], POLLIN, 0 } );
+        for( int fd : listenfds_ )
+            fds.push_back( { fd, POLLIN, 0 } );
+        size_t numListen = listenfds_.size();
+        size_t numClients = 0;
         {
-            LOG( moose::warning, "Broken pipe. Couldn't stream." );
-            return;
+            std::lock_guard< std::mutex > lock( mutex_ );
+            for( auto& c : clients_ )
+            {
+                short events = POLLIN;
+                if( c->pending() > 0 )
+                    events |= POLLOUT;
+                fds.push_back( { c->fd, events, 0 } );
+            }
+            numClients = clients_.size();
+        }
+
+        if( poll( &fds[0], fds.size(), 200 ) < 0 )
+        {
+            if( errno == EINTR )
+                continue;
+            LOG( moose::error, "poll() failed: " << strerror( errno ) );
+            break;
+        }
+
+        if( fds[0].revents & POLLIN )
+            while( read( wakefds_[0], buf, sizeof( buf ) ) > 0 )
+                ;
+
+        for( size_t i = 0; i < numListen; i++ )
+            if( fds[i + 1].revents & POLLIN )
+                acceptClients( listenfds_[i] );
+
+        {
+            // Only this thread adds or removes subscribers, and new ones
+            // go at the end, so the first numClients are those polled.
+            std::lock_guard< std::mutex > lock( mutex_ );
+            vector< bool > alive( numClients, true );
+            for( size_t i = 0; i < numClients; i++ )
+            {
+                short revents = fds[i + 1 + numListen].revents;
+                if( revents & POLLIN )
+                {
+                    // Subscribers have nothing to say. Read to see if they
+                    // have hung up.
+                    ssize_t n = recv( clients_[i]->fd, buf, sizeof( buf ), 0 );
+                    if( n == 0 || ( n < 0 && errno != EAGAIN && errno != EWOULDBLOCK ) )
+                        alive[i] = false;
+                }
+                if( revents & ( POLLERR | POLLHUP | POLLNVAL ) )
+                    alive[i] = false;
+                if( alive[i] && ( revents & POLLOUT ) )
+                    alive[i] = clients_[i]->flush();
+                if( alive[i] && clients_[i]->needsHeader )
+                {
+                    if( header_.size() > bufferSize_ )
+                        alive[i] = false;   // It can never catch up.
+                    else if( clients_[i]->push( &header_[0], header_.size() ) )
+                        clients_[i]->needsHeader = false;
+                }
+            }
+            for( size_t i = numClients; i-- > 0; )
+                if( ! alive[i] )
+                {
+                    LOG( moose::info, "Client on socket " << clients_[i]->fd
+                            << " is gone." );
+                    clients_.erase( clients_.begin() + i );
+                }
         }
+        spaceAvailable_.notify_all();
     }
-    else
-        LOG( moose::warning, "No client." );
 }
 
 /**
@@ -451,6 +753,7 @@ void SocketStreamer::reinit(const Eref& e, ProcPtr p)
     thisDt_ = clk_->getTickDt( e.element()->getTick() );
 
     // Push each table dt_ into vector of dt
+    tableDt_.clear();
     for( unsigned int i = 0; i < tables_.size(); i++)
     {
         Id tId = tableIds_[i];
@@ -458,15 +761,24 @@ void SocketStreamer::reinit(const Eref& e, ProcPtr p)
         tableDt_.push_back( clk_->getTickDt( tickNum ) );
     }
 
-    // This should only be called once.
-    initServer();
+    // Subscribers see a fresh header at the start of each run.
+    makeHeader();
+
+    // The server outlives reinit, and keeps its subscribers.
+    if( processThread_.joinable() )
+        return;
 
-    // Launch a thread in background which monitors the any client trying to
-    // make connection to server.
-    processThread_ = std::thread(&SocketStreamer::connect, this);
+    initServer();
+    if( ! isValid_ )
+    {
+        LOG( moose::warning, "Could not serve any of " << address_ );
+        return;
+    }
 
-    // NOw introduce some delay.
-    timeStamp_ = std::chrono::high_resolution_clock::now();
+    // All socket I/O happens in this thread, so that subscribers can come,
+    // go or stall without holding up process.
+    all_done_ = false;
+    processThread_ = std::thread(&SocketStreamer::ioLoop, this);
 }
 
 /**
@@ -477,10 +789,10 @@ void SocketStreamer::reinit(const Eref& e, ProcPtr p)
  */
 void SocketStreamer::process(const Eref& e, ProcPtr p)
 {
-    // processTickMicroSec = std::chrono::duration_cast<std::chrono::microseconds>(
-            // std::chrono::high_resolution_clock::now() - timeStamp_).count();
-    // timeStamp_ = std::chrono::high_resolution_clock::now();
-    stream();
+    if( ! processThread_.joinable() )
+        return;
+    if( dataToStream( frame_ ) )
+        streamData( frame_ );
 }
 
 /**
@@ -506,6 +818,7 @@ void SocketStreamer::addTable( ObjId table )
         columns_.push_back( t->getColumnName( ) );
     else
         columns_.push_back( moose::moosePathToUserPath( table.path() ) );
+    makeHeader();
 }
 
 /**
@@ -543,7 +856,9 @@ void SocketStreamer::removeTable( ObjId table )
     {
         tableIds_.erase( tableIds_.begin() + matchIndex );
         tables_.erase( tables_.begin() + matchIndex );
+        tableTick_.erase( tableTick_.begin() + matchIndex );
         columns_.erase( columns_.begin() + matchIndex );
+        makeHeader();
     }
 }
 
@@ -567,6 +882,17 @@ unsigned int SocketStreamer::getNumTables( void ) const
     return tables_.size();
 }
 
+unsigned int SocketStreamer::getNumClients( void ) const
+{
+    std::lock_guard< std::mutex > lock( mutex_ );
+    return clients_.size();
+}
+
+unsigned long SocketStreamer::getNumDroppedFrames( void ) const
+{
+    std::lock_guard< std::mutex > lock( mutex_ );
+    return numDropped_;
+}
 
 void SocketStreamer::setPort( const unsigned int port )
 {
@@ -580,10 +906,78 @@ unsigned int SocketStreamer::getPort( void ) const
 
 void SocketStreamer::setAddress( const string addr )
 {
-    sockInfo_.setAddress(addr);
+    // sockInfo_ keeps the first address, and with it the default port.
+    unsigned int port = sockInfo_.port;
+    address_ = addr;
+    sockInfo_.setAddress( moose::trim( addr.substr( 0, addr.find( ',' ) ) ) );
+    if( sockInfo_.type != TCP_SOCKET || sockInfo_.port == 0 )
+        sockInfo_.port = port;
 }
 
 string SocketStreamer::getAddress( void ) const
 {
-    return sockInfo_.address;
+    return address_;
+}
+
+void SocketStreamer::setDataType( string dtype )
+{
+    if( dtype == "float32" )
+        useFloat_ = true;
+    else if( dtype == "float64" )
+        useFloat_ = false;
+    else
+    {
+        cout << "Warning: SocketStreamer::setDataType: '" << dtype
+             << "' is not one of float64, float32\n";
+        return;
+    }
+    makeHeader();
+}
+
+string SocketStreamer::getDataType( void ) const
+{
+    return useFloat_ ? "float32" : "float64";
+}
+
+void SocketStreamer::setPolicy( string policy )
+{
+    if( policy == "block" )
+        block_ = true;
+    else if( policy == "drop" )
+        block_ = false;
+    else
+        cout << "Warning: SocketStreamer::setPolicy: '" << policy
+             << "' is not one of drop, block\n";
+}
+
+string SocketStreamer::getPolicy( void ) const
+{
+    return block_ ? "block" : "drop";
+}
+
+void SocketStreamer::setBufferSize( unsigned int size )
+{
+    // Subscribers that are already connected keep their buffers.
+    if( size < 1024 )
+    {
+        cout << "Warning: SocketStreamer::setBufferSize: " << size
+             << " is too small, using 1024\n";
+        size = 1024;
+    }
+    bufferSize_ = size;
+}
+
+unsigned int SocketStreamer::getBufferSize( void ) const
+{
+    return bufferSize_;
+}
+
+void SocketStreamer::setMaxClients( unsigned int num )
+{
+    numMaxClients_ = num;
+}
+
+unsigned int SocketStreamer::getMaxClients( void ) const
+{
+    return numMaxClients_;
 }
@@ -1,5 +1,5 @@
 /***
- *    Stream table data to a TCP socket.
+ *    Stream table data to TCP and Unix domain socket subscribers.
  */
 
 #ifndef  SocketStreamer_INC
@@ -13,6 +13,9 @@
 #include <sstream>
 #include <thread>
 #include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
 
 #include "StreamerBase.h"
 #include "MooseSocketInfo.h"
@@ -44,11 +47,47 @@
 #define MSG_MORE 0
 #endif
 
+// Neither is MSG_NOSIGNAL. A vanished subscriber must not kill us.
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
 using namespace std;
 
 
 class Clock;
 
+/**
+ * A connected client, with the bytes queued for it. The queue is a ring
+ * buffer of fixed capacity which only ever holds whole frames, so that
+ * dropping a frame leaves the stream decodable.
+ */
+class SocketSubscriber
+{
+public:
+    SocketSubscriber( int fd, size_t capacity );
+    ~SocketSubscriber();
+
+    size_t space() const;
+    size_t pending() const;
+
+    /// Queues a frame. Returns false, queueing nothing, if it does not fit.
+    bool push( const char* data, size_t n );
+
+    /// Sends as much as the socket takes. Returns false if it is closed.
+    bool flush();
+
+    int fd;
+    unsigned long numDropped;
+
+    /// The current header did not fit. No frames go in until it does.
+    bool needsHeader;
+
+private:
+    vector< char > ring_;
+    size_t head_;
+    size_t size_;
+};
 
 class SocketStreamer : public StreamerBase
 {
@@ -59,25 +98,16 @@ public:
 
     SocketStreamer& operator=( const SocketStreamer& st );
 
-    string getFormat( void ) const;
-    void setFormat( string format );
-
     /*-----------------------------------------------------------------------------
      *  Socket Server
      *-----------------------------------------------------------------------------*/
-    // Initialize server.
+    // Initialize server on all the endpoints in address.
     void initServer( void );
-    void initTCPServer( void );
-    void initUDSServer( void );
+    int initTCPServer( const MooseSocketInfo& info );
+    int initUDSServer( const MooseSocketInfo& info );
 
     /* common configuration options */
-    void configureSocketServer( void );
-
-    // Make connection to client
-    void listenToClients(unsigned int numMaxClients);
-
-    // Find minimum number of elements in tables.
-    pair<unsigned int, unsigned int> minMaxNumberOfElemementsInTables( );
+    void configureSocketServer( int fd );
 
     /* Cleaup before quitting */
     void cleanUp( void );
@@ -88,14 +118,34 @@ public:
     unsigned int getPort( void ) const;
     void setPort( const unsigned int port );
 
+    string getDataType( void ) const;
+    void setDataType( string dtype );
+
+    string getPolicy( void ) const;
+    void setPolicy( string policy );
+
+    unsigned int getBufferSize( void ) const;
+    void setBufferSize( unsigned int size );
+
+    unsigned int getMaxClients( void ) const;
+    void setMaxClients( unsigned int num );
+
+    unsigned int getNumClients( void ) const;
+    unsigned long getNumDroppedFrames( void ) const;
+
     /*-----------------------------------------------------------------------------
      *  Streaming data.
      *-----------------------------------------------------------------------------*/
-    bool enoughDataToStream(unsigned int minsize=10);
-    int streamData();
-    // connect is monitored in a thread.
-    void connect( void );
-    void stream(void);
+    // Serializes the new table entries into a data frame.
+    bool dataToStream( vector< char >& frame );
+    void makeHeader( void );
+    // Queues a frame for every subscriber.
+    void streamData( const vector< char >& frame );
+
+    // Event loop of the I/O thread. Accepts and feeds the subscribers.
+    void ioLoop( void );
+    void acceptClients( int listenfd );
+    void wake( void );
 
     unsigned int getNumTables( void ) const;
 
@@ -105,10 +155,6 @@ public:
     void removeTable( ObjId table );
     void removeTables( vector<ObjId> table );
 
-    void dataToStream(map<string, vector<double>>& vec);
-
-    static void addStringToDoubleVec(vector<double>&res, const string s);
-
     /** Dest functions.
      * The process function called by scheduler on every tick
      */
@@ -135,31 +181,35 @@ private:
     vector<string> columns_;
 
     /* Socket related */
-    int numMaxClients_;
-    int sockfd_;                                      // socket file descriptor.
-    int clientfd_;                                    // client file descriptor
-
-    // address holdder for TCP and UDS sockets.
-    struct sockaddr_in sockAddrTCP_;
-    struct sockaddr_un sockAddrUDS_;
+    unsigned int numMaxClients_;
+    vector< int > listenfds_;                         // one per endpoint.
+    vector< MooseSocketInfo > endpoints_;
+    int wakefds_[2];                                  // self pipe for poll.
+
+    /* Subscribers, shared with the I/O thread under mutex_ */
+    vector< unique_ptr< SocketSubscriber > > clients_;
+    mutable std::mutex mutex_;
+    std::condition_variable spaceAvailable_;
+    vector< char > header_;
+    unsigned long numDropped_;
 
     /* For data handling */
-    bool all_done_ = false;
+    std::atomic<bool> all_done_;
     bool isValid_ = true;
     std::thread processThread_;
-    string buffer_;
-    vector<double> vecToStream_;
+    vector< char > frame_;
+    vector< double > vec_;
     double thisDt_;
+    bool useFloat_;
+    bool block_;
+    unsigned int bufferSize_;
 
     // We need clk_ pointer for handling
     Clock* clk_ = nullptr;
 
     // Socket Info
     MooseSocketInfo sockInfo_;
-
-    // How long it takes between process calls.
-    unsigned int processTickMicroSec;
-    std::chrono::high_resolution_clock::time_point timeStamp_;
+    string address_;
 };
 
 #endif   /* ----- #ifndef SocketStreamer_INC  ----- */
@@ -16,6 +16,7 @@
 #include "Table.h"
 #include "../scheduling/Clock.h"
 #include "StreamerBase.h"
+#include "../shell/Checkpoint.h"
 
 static SrcFinfo1< vector< double >* > *requestOut()
 {
@@ -215,6 +216,7 @@ const Cinfo* Table::initCinfo()
 //////////////////////////////////////////////////////////////
 
 static const Cinfo* tableCinfo = Table::initCinfo();
+static CheckpointHandler< Table > tableCheckpoint( "Table" );
 
 Table::Table() :
     threshold_( 0.0 ),
@@ -326,6 +328,8 @@ void Table::reinit( const Eref& e, ProcPtr p )
 
     input_ = 0.0;
     vec().resize( 0 );
+    tvec_.clear();
+    lastN_ = 0;
     lastTime_ = 0;
     vector< double > ret;
     requestOut()->send( e, &ret );
@@ -375,6 +379,22 @@ void Table::spike( double v )
     }
 }
 
+void Table::saveState( CheckpointWriter& w ) const
+{
+    w.add( "vec", getVector() );
+    w.add( "tvec", tvec_ );
+    w.addValue( "lastTime", lastTime_ );
+    w.addValue( "fired", fired_ );
+}
+
+void Table::loadState( CheckpointReader& r )
+{
+    r.get( "vec", vec() );
+    r.get( "tvec", tvec_ );
+    r.getValue( "lastTime", lastTime_ );
+    r.getValue( "fired", fired_ );
+}
+
 //////////////////////////////////////////////////////////////
 // Field Definitions
 void Table::setThreshold( double v )
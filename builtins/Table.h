@@ -15,6 +15,9 @@ using namespace std;
 /**
  * Receives and records inputs. Handles plot and spiking data in batch mode.
  */
+class CheckpointWriter;
+class CheckpointReader;
+
 class Table: public TableBase
 {
 public:
@@ -68,6 +71,10 @@ public:
     void input ( double v );
     void spike ( double v );
 
+    /// Checkpoint support: the recorded data, see shell/Checkpoint.h
+    void saveState( CheckpointWriter& w ) const;
+    void loadState( CheckpointReader& r );
+
     //////////////////////////////////////////////////////////////////
     // Lookup funcs for table
     //////////////////////////////////////////////////////////////////
@@ -13,6 +13,7 @@
 #include <fstream>
 #include "TableBase.h"
 #include "TimeTable.h"
+#include "../scheduling/Clock.h"
 
 static SrcFinfo1< double > *eventOut() {
     static SrcFinfo1< double > eventOut(
@@ -76,7 +77,10 @@ const Cinfo* TimeTable::initCinfo()
         "Name", "TimeTable",
         "Author", "Johannes Hjorth, 2008, KTH, Stockholm. Ported to buildQ branch using new API by Subhasis Ray, NCBS, Bangalore, 2013.",
         "Description", "TimeTable: Read in spike times from file and send out eventOut messages\n"
-        "at the specified times.",
+        "at the specified times.\n"
+        "If it is taken off its tick with the Clock's schedule function "
+        "and a period of zero, it is only processed at the steps "
+        "holding its spike times.",
     };
 
 	static Dinfo< TimeTable > dinfo;
@@ -182,6 +186,8 @@ void TimeTable::reinit(const Eref& e, ProcPtr p)
 {
   curPos_ = 0;
   state_ = 0;
+  if ( vec().size() > 0 )
+      Clock::wake( e, vec()[0] );
 }
 
 void TimeTable::process(const Eref& e, ProcPtr p)
@@ -202,4 +208,11 @@ void TimeTable::process(const Eref& e, ProcPtr p)
       curPos_++;
       state_ = 1;
   }
+
+  // When the Clock runs us event driven, come back for the next spike,
+  // or on the next step to clear the state.
+  if ( state_ > 0 )
+      Clock::wake( e, p->currTime );
+  else if ( curPos_ < vec().size() )
+      Clock::wake( e, vec()[curPos_] );
 }
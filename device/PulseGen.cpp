@@ -31,6 +31,7 @@
 
 #include "../basecode/header.h"
 #include "PulseGen.h"
+#include "../shell/Checkpoint.h"
 
 static SrcFinfo1<double>* outputOut()
 {
@@ -144,6 +145,7 @@ const Cinfo* PulseGen::initCinfo()
 }
 
 static const Cinfo* pulseGenCinfo = PulseGen::initCinfo();
+static CheckpointHandler<PulseGen> pulseGenCheckpoint("PulseGen");
 
 PulseGen::PulseGen()
 {
@@ -432,5 +434,22 @@ void PulseGen::reinit(const Eref& e, ProcPtr p)
     outputOut()->send(e, output_);
 }
 
+void PulseGen::saveState(CheckpointWriter& w) const
+{
+    double state[] = {output_, trigTime_, prevInput_, input_};
+    w.add("state", state, sizeof(state));
+}
+
+void PulseGen::loadState(CheckpointReader& r)
+{
+    double state[4];
+    if(r.get("state", state, 4)) {
+        output_ = state[0];
+        trigTime_ = state[1];
+        prevInput_ = state[2];
+        input_ = state[3];
+    }
+}
+
 //
 // PulseGen.cpp ends here
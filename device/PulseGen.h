@@ -31,6 +31,10 @@
 
 #ifndef _PULSEGEN_H
 #define _PULSEGEN_H
+
+class CheckpointWriter;
+class CheckpointReader;
+
 /**
  * PulseGen acts as a pulse generator. It generates square pulses of
  * specified duration and amplitude. Two consecutive pulses are
@@ -115,6 +119,10 @@ public:
 
     void reinit(const Eref& e, ProcPtr p);
 
+    /// Checkpoint support, see shell/Checkpoint.h
+    void saveState(CheckpointWriter& w) const;
+    void loadState(CheckpointReader& r);
+
     /////////////////////////////////////////////////////////////
     static const Cinfo* initCinfo();
 
@@ -10,6 +10,7 @@
 #include <vector>
 #include <map>
 #include <cassert>
+#include <cmath>
 #include <string>
 #include <iostream>
 using namespace std;
@@ -24,7 +25,7 @@ using namespace std;
  */
 DiffPoolVec::DiffPoolVec()
     : id_( 0 ), n_( 1, 0.0 ), concInit_( 1, 0.0 ),
-      diffConst_( 1.0e-12 ), motorConst_( 0.0 )
+      diffConst_( 1.0e-12 ), motorConst_( 0.0 ), quietCount_( 0 )
 {
     ;
 }
@@ -84,6 +85,34 @@ void DiffPoolVec::setPrevVec()
     prev_ = n_;
 }
 
+const vector< double >& DiffPoolVec::getPrevVec() const
+{
+    return prev_;
+}
+
+void DiffPoolVec::setPrevVec( const vector< double >& prev )
+{
+    assert( prev.size() == prev_.size() );
+    prev_ = prev;
+}
+
+unsigned int DiffPoolVec::getQuietCount() const
+{
+    return quietCount_;
+}
+
+const vector< double >& DiffPoolVec::getRestVec() const
+{
+    return rest_;
+}
+
+void DiffPoolVec::setActivity( unsigned int quietCount,
+        const vector< double >& rest )
+{
+    quietCount_ = quietCount;
+    rest_ = rest;
+}
+
 double DiffPoolVec::getDiffConst() const
 {
     return diffConst_;
@@ -92,6 +121,7 @@ double DiffPoolVec::getDiffConst() const
 void DiffPoolVec::setDiffConst( double v )
 {
     diffConst_ = v;
+    quietCount_ = 0;
 }
 
 double DiffPoolVec::getMotorConst() const
@@ -102,6 +132,7 @@ double DiffPoolVec::getMotorConst() const
 void DiffPoolVec::setMotorConst( double v )
 {
     motorConst_ = v;
+    quietCount_ = 0;
 }
 
 void DiffPoolVec::setNumVoxels( unsigned int num )
@@ -139,6 +170,7 @@ void DiffPoolVec::setOps(const vector< Triplet< double > >& ops,
         ops_.clear();
         diagVal_.clear();
     }
+    quietCount_ = 0;
 }
 
 void DiffPoolVec::advance( double dt )
@@ -155,6 +187,39 @@ void DiffPoolVec::advance( double dt )
         *iy++ *= *i;
 }
 
+/// Steps a pool must stay steady for before it stops.
+static const unsigned int numSteadySteps = 3;
+
+static bool isSteady( const vector< double >& n, const vector< double >& ref,
+        double tol )
+{
+    for ( size_t i = 0; i < n.size(); ++i )
+        if ( fabs( n[i] - ref[i] ) > tol * fabs( ref[i] ) )
+            return false;
+    return true;
+}
+
+void DiffPoolVec::advanceUnlessQuiescent( double dt, double tol )
+{
+    if ( quietCount_ >= numSteadySteps )
+    {
+        if ( isSteady( n_, rest_, tol ) )
+            return;
+        quietCount_ = 0;
+    }
+    rest_ = n_;
+    advance( dt );
+    if ( !isSteady( n_, rest_, tol ) )
+        quietCount_ = 0;
+    else if ( ++quietCount_ >= numSteadySteps )
+        rest_ = n_;
+}
+
+bool DiffPoolVec::isQuiescent() const
+{
+    return quietCount_ >= numSteadySteps;
+}
+
 void DiffPoolVec::reinit( const vector< double >& vols ) // Not called by the clock, but by parent.
 {
 	const double NA_ = 6.0221415e23;
@@ -164,5 +229,6 @@ void DiffPoolVec::reinit( const vector< double >& vols ) // Not called by the cl
 	for ( size_t i = 0; i < concInit_.size(); ++i )
 		nInit[i] = concInit_[i] * NA_ * vols[i];
 
-    prev_ = n_ = nInit;
+    rest_ = prev_ = n_ = nInit;
+    quietCount_ = 0;
 }
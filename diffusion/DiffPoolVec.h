@@ -22,6 +22,14 @@ public:
     void process();
     void reinit( const vector< double >& vols );
     void advance( double dt );
+    /**
+     * As advance, but stops once no voxel has moved by more than tol
+     * times its size for a few steps, and starts again when the
+     * reactions or a field assignment move it that far from where it
+     * stopped.
+     */
+    void advanceUnlessQuiescent( double dt, double tol );
+    bool isQuiescent() const;
     double getConcInit( unsigned int vox ) const;
     void setConcInit( unsigned int vox, double value );
     double getN( unsigned int vox ) const;
@@ -48,6 +56,12 @@ public:
     void setNvec( unsigned int start, unsigned int num,
                   vector< double >::const_iterator q );
     void setPrevVec(); /// Assigns prev_ = n_
+    /// Used for checkpoints.
+    const vector< double >& getPrevVec() const;
+    void setPrevVec( const vector< double >& prev );
+    unsigned int getQuietCount() const;
+    const vector< double >& getRestVec() const;
+    void setActivity( unsigned int quietCount, const vector< double >& rest );
     void setOps( const vector< Triplet< double > >& ops_,
                  const vector< double >& diagVal_ ); /// Assign operations.
 
@@ -61,6 +75,10 @@ private:
     double motorConst_; /// Motor const, ie, transport rate.
     vector< Triplet< double > > ops_;
     vector< double > diagVal_;
+    /// n_ at the start of the last step, or when the pool stopped.
+    vector< double > rest_;
+    /// Number of consecutive steady steps.
+    unsigned int quietCount_;
 };
 
 #endif // _DIFF_POOL_VEC_H
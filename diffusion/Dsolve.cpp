@@ -28,6 +28,7 @@
 #include "../shell/Wildcard.h"
 #include "../kinetics/PoolBase.h"
 #include "Dsolve.h"
+#include "../shell/Checkpoint.h"
 
 #include <thread>
 
@@ -115,6 +116,23 @@ const Cinfo* Dsolve::initCinfo()
             &Dsolve::getDiffScale
             );
 
+    static ValueFinfo< Dsolve, double > quiescentTol (
+            "quiescentTol",
+            "Relative rate of change, in 1/s, below which a pool species "
+            "is taken to be at steady state. The diffusion of a species "
+            "that has stayed below this in every voxel for a few steps "
+            "is skipped, until the reactions or a field assignment move "
+            "it. Zero, the default, diffuses every species on every step.",
+            &Dsolve::setQuiescentTol,
+            &Dsolve::getQuiescentTol
+            );
+
+    static ReadOnlyValueFinfo< Dsolve, unsigned int > numActivePools(
+            "numActivePools",
+            "Number of pool species that were diffused on the last step.",
+            &Dsolve::getNumActivePools
+            );
+
     // DestFinfo definitions
     static DestFinfo process( "process",
             "Handles process call",
@@ -162,6 +180,8 @@ const Cinfo* Dsolve::initCinfo()
         &diffVol1,                  // LookupValue
         &diffVol2,                  // LookupValue
         &diffScale,                 // LookupValue
+        &quiescentTol,              // Value
+        &numActivePools,            // ReadOnlyValue
         &buildMeshJunctions,        // DestFinfo
         &buildNeuroMeshJunctions,   // DestFinfo
         &proc,                      // SharedFinfo
@@ -180,6 +200,7 @@ const Cinfo* Dsolve::initCinfo()
 }
 
 static const Cinfo* dsolveCinfo = Dsolve::initCinfo();
+static CheckpointHandler< Dsolve > dsolveCheckpoint( "Dsolve" );
 
 // Class definitions
 Dsolve::Dsolve() :
@@ -187,7 +208,9 @@ Dsolve::Dsolve() :
     numTotPools_( 0 ),
     numLocalPools_( 0 ),
     poolStartIndex_( 0 ),
-    numVoxels_( 0 )
+    numVoxels_( 0 ),
+    useJumpDiffusion_( false ),
+    quiescentTol_( 0.0 )
 {;}
 
 Dsolve::~Dsolve()
@@ -197,6 +220,26 @@ Dsolve::~Dsolve()
 // Field access functions
 //////////////////////////////////////////////////////////////
 
+double Dsolve::getQuiescentTol() const
+{
+    return quiescentTol_;
+}
+
+void Dsolve::setQuiescentTol( double tol )
+{
+    quiescentTol_ = tol > 0.0 ? tol : 0.0;
+    for ( auto i = pools_.begin(); i != pools_.end(); ++i )
+        i->setActivity( 0, i->getNvec() );
+}
+
+unsigned int Dsolve::getNumActivePools() const
+{
+    unsigned int ret = 0;
+    for ( auto i = pools_.cbegin(); i != pools_.cend(); ++i )
+        ret += !i->isQuiescent();
+    return ret;
+}
+
 void Dsolve::setNvec( unsigned int pool, vector< double > vec )
 {
     if ( pool < pools_.size() )
@@ -550,6 +593,14 @@ void Dsolve::calcJunction( const DiffJunction& jn, double dt )
 
 void Dsolve::process( const Eref& e, ProcPtr p )
 {
+    if ( useJumpDiffusion_ ) // Reac solver moves the molecules.
+        return;
+    if ( quiescentTol_ > 0.0 )
+    {
+        for ( auto i = pools_.begin(); i != pools_.end(); ++i )
+            i->advanceUnlessQuiescent( p->dt, quiescentTol_ * p->dt );
+        return;
+    }
     for ( auto i = pools_.begin(); i != pools_.end(); ++i )
         i->advance( p->dt );
 }
@@ -578,6 +629,71 @@ void Dsolve::calcJunction_chunk( const size_t begin, const size_t end, double dt
 
 }
 
+//////////////////////////////////////////////////////////////
+// Checkpoints
+//////////////////////////////////////////////////////////////
+/// Counts, and those of the previous step, of all pools in one record.
+void Dsolve::saveState( CheckpointWriter& w ) const
+{
+    vector< double > n;
+    vector< double > prev;
+    for ( auto i = pools_.cbegin(); i != pools_.cend(); ++i )
+    {
+        n.insert( n.end(), i->getNvec().begin(), i->getNvec().end() );
+        prev.insert( prev.end(), i->getPrevVec().begin(),
+                     i->getPrevVec().end() );
+    }
+    w.add( "n", n );
+    w.add( "prev", prev );
+    if ( quiescentTol_ > 0.0 )
+    {
+        vector< unsigned int > count;
+        vector< double > rest;
+        for ( auto i = pools_.cbegin(); i != pools_.cend(); ++i )
+        {
+            count.push_back( i->getQuietCount() );
+            rest.insert( rest.end(), i->getRestVec().begin(),
+                         i->getRestVec().end() );
+        }
+        w.add( "quietCount", count );
+        w.add( "rest", rest );
+    }
+}
+
+void Dsolve::loadState( CheckpointReader& r )
+{
+    unsigned int tot = 0;
+    for ( auto i = pools_.cbegin(); i != pools_.cend(); ++i )
+        tot += i->getNvec().size();
+    vector< double > n( tot );
+    vector< double > prev( tot );
+    if ( !r.get( "n", n.data(), tot ) || !r.get( "prev", prev.data(), tot ) )
+        return;
+    auto q = n.cbegin();
+    auto p = prev.cbegin();
+    for ( auto i = pools_.begin(); i != pools_.end(); ++i )
+    {
+        unsigned int num = i->getNvec().size();
+        i->setNvec( 0, num, q );
+        i->setPrevVec( vector< double >( p, p + num ) );
+        q += num;
+        p += num;
+    }
+    vector< unsigned int > count( pools_.size() );
+    if ( quiescentTol_ > 0.0 &&
+            r.get( "quietCount", count.data(), count.size() ) &&
+            r.get( "rest", n.data(), tot ) )
+    {
+        q = n.cbegin();
+        for ( unsigned int i = 0; i < pools_.size(); ++i )
+        {
+            unsigned int num = pools_[i].getNvec().size();
+            pools_[i].setActivity( count[i], vector< double >( q, q + num ) );
+            q += num;
+        }
+    }
+}
+
 
 //////////////////////////////////////////////////////////////
 // Solver coordination and setup functions
@@ -1083,6 +1199,17 @@ void Dsolve::innerBuildMeshJunctions( ObjId self, ObjId other, bool selfIsMembra
 
     // printJunction( self, other, jn );
     dself->junctions_.push_back( jn );
+
+    // The cross-compartment transfers read either Dsolve at either
+    // index of a VoxelJunction, so both go on both lists.
+    Dsolve* dother = reinterpret_cast< Dsolve* >( other.data() );
+    for ( auto j = jn.vj.cbegin(); j != jn.vj.cend(); ++j )
+    {
+        dself->junctionVoxels_.push_back( j->first );
+        dself->junctionVoxels_.push_back( j->second );
+        dother->junctionVoxels_.push_back( j->first );
+        dother->junctionVoxels_.push_back( j->second );
+    }
 }
 
 /////////////////////////////////////////////////////////////
@@ -1289,6 +1416,71 @@ void Dsolve::getBlock( vector< double >& values ) const
     }
 }
 
+double Dsolve::getPoolDiffConst( unsigned int poolIndex ) const
+{
+    if ( poolIndex < poolStartIndex_ ||
+            poolIndex >= poolStartIndex_ + numLocalPools_ )
+        return 0.0;
+    return pools_[ poolIndex - poolStartIndex_ ].getDiffConst();
+}
+
+void Dsolve::setJumpDiffusion( bool val )
+{
+    useJumpDiffusion_ = val;
+}
+
+void Dsolve::getJunctionVoxels( vector< unsigned int >& voxels ) const
+{
+    voxels.clear();
+    for ( auto ch = channels_.cbegin(); ch != channels_.cend(); ++ch )
+    {
+        if ( ch->isLocal ) // calcLocalChan goes through every voxel.
+        {
+            for ( unsigned int i = 0; i < numVoxels_; ++i )
+                voxels.push_back( i );
+            return;
+        }
+    }
+    for ( auto i = junctionVoxels_.cbegin(); i != junctionVoxels_.cend(); ++i )
+        if ( *i < numVoxels_ )
+            voxels.push_back( *i );
+    sort( voxels.begin(), voxels.end() );
+    voxels.erase( unique( voxels.begin(), voxels.end() ), voxels.end() );
+}
+
+void Dsolve::getVoxels( const vector< unsigned int >& voxels,
+                        unsigned int startPool, unsigned int numPools,
+                        vector< double >& values ) const
+{
+    assert( startPool >= poolStartIndex_ );
+    assert( numPools + startPool <= numLocalPools_ );
+    values.resize( numPools * voxels.size() );
+    auto v = values.begin();
+    for ( unsigned int i = 0; i < numPools; ++i )
+    {
+        const vector< double >& n =
+            pools_[ i + startPool - poolStartIndex_ ].getNvec();
+        for ( auto j = voxels.cbegin(); j != voxels.cend(); ++j )
+            *v++ = n[ *j ];
+    }
+}
+
+void Dsolve::setVoxels( const vector< unsigned int >& voxels,
+                        unsigned int startPool, unsigned int numPools,
+                        const vector< double >& values )
+{
+    assert( startPool >= poolStartIndex_ );
+    assert( numPools + startPool <= numLocalPools_ );
+    assert( values.size() == numPools * voxels.size() );
+    auto v = values.cbegin();
+    for ( unsigned int i = 0; i < numPools; ++i )
+    {
+        DiffPoolVec& dv = pools_[ i + startPool - poolStartIndex_ ];
+        for ( auto j = voxels.cbegin(); j != voxels.cend(); ++j )
+            dv.setN( *j, *v++ );
+    }
+}
+
 // Inefficient but easy to set up. Optimize later.
 void Dsolve::setPrev()
 {
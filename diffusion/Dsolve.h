@@ -10,6 +10,9 @@
 #ifndef _DSOLVE_H
 #define _DSOLVE_H
 
+class CheckpointWriter;
+class CheckpointReader;
+
 /**
  * The Dsolve manages a large number of pools, each inhabiting a large
  * number of voxels that are shared for all the pools.
@@ -61,6 +64,14 @@ public:
     double getDiffScale( unsigned int voxel ) const;
     void setDiffScale( unsigned int voxel, double scale );
 
+    /**
+     * Relative rate of change (1/s) below which a pool species is at
+     * steady state and its diffusion step is skipped. Zero turns it off.
+     */
+    double getQuiescentTol() const;
+    void setQuiescentTol( double tol );
+    unsigned int getNumActivePools() const;
+
     //////////////////////////////////////////////////////////////////
     // Dest Finfos
     //////////////////////////////////////////////////////////////////
@@ -147,6 +158,15 @@ public:
     void getBlock( vector< double >& values ) const;
     void setBlock( const vector< double >& values );
     void setPrev();
+    double getPoolDiffConst( unsigned int poolIndex ) const;
+    void setJumpDiffusion( bool val );
+    void getJunctionVoxels( vector< unsigned int >& voxels ) const;
+    void getVoxels( const vector< unsigned int >& voxels,
+                    unsigned int startPool, unsigned int numPools,
+                    vector< double >& values ) const;
+    void setVoxels( const vector< unsigned int >& voxels,
+                    unsigned int startPool, unsigned int numPools,
+                    const vector< double >& values );
 
     // This one isn't used in Dsolve, but is defined as a dummy.
     void setupCrossSolverReacs(
@@ -197,6 +217,11 @@ public:
      */
     void print() const;
 
+    //////////////////////////////////////////////////////////////////
+    // Checkpoint support, see shell/Checkpoint.h
+    void saveState( CheckpointWriter& w ) const;
+    void loadState( CheckpointReader& r );
+
     //////////////////////////////////////////////////////////////////
     static const Cinfo* initCinfo();
 private:
@@ -229,6 +254,22 @@ private:
      * numerical integration for flux between the Dsolves.
      */
     vector< DiffJunction > junctions_;
+
+    /**
+     * Voxels of this Dsolve at any junction, whichever Dsolve holds it.
+     * These are the only voxels that junction fluxes touch.
+     */
+    vector< unsigned int > junctionVoxels_;
+
+    /**
+     * Flag: True when the reac solver does diffusion within the
+     * compartment by stochastic jumps. The Dsolve then skips its own
+     * diffusion step and only handles the junctions.
+     */
+    bool useJumpDiffusion_;
+
+    /// Relative rate of change below which a pool is at steady state.
+    double quiescentTol_;
 };
 
 
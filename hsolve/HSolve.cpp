@@ -27,6 +27,7 @@
 #include "../biophysics/CaConc.h"
 #include "ZombieHHChannel.h"
 #include "../shell/Shell.h"
+#include "../shell/Checkpoint.h"
 
 #include <chrono>
 using namespace std::chrono;
@@ -155,6 +156,24 @@ const Cinfo* HSolve::initCinfo()
         &HSolve::getCaMax
     );
 
+    static ValueFinfo< HSolve, double > quiescentTol(
+        "quiescentTol",
+        "Relative rate of change, in 1/s, below which the cell is taken "
+        "to be at rest. Once the membrane potential, every gate and every "
+        "calcium pool has stayed below this for a few steps, the solver "
+        "stops stepping the cell, until a synaptic or injected current, "
+        "a calcium input or a field assignment perturbs it. Zero, the "
+        "default, steps the cell every time.",
+        &HSolve::setQuiescentTol,
+        &HSolve::getQuiescentTol
+    );
+
+    static ReadOnlyValueFinfo< HSolve, bool > isQuiescent(
+        "isQuiescent",
+        "True if the cell is at rest and its steps are being skipped.",
+        &HSolve::getIsQuiescent
+    );
+
     static Finfo* hsolveFinfos[] =
     {
         &seed,              // Value
@@ -167,6 +186,8 @@ const Cinfo* HSolve::initCinfo()
         &caDiv,             // Value
         &caMin,             // Value
         &caMax,             // Value
+        &quiescentTol,      // Value
+        &isQuiescent,       // ReadOnlyValue
         &proc,              // Shared
     };
 
@@ -193,9 +214,10 @@ const Cinfo* HSolve::initCinfo()
 }
 
 static const Cinfo* hsolveCinfo = HSolve::initCinfo();
+static CheckpointHandler< HSolve > hsolveCheckpoint( "HSolve" );
 
 HSolve::HSolve()
-    : dt_( 50e-6 )
+    : dt_( 50e-6 ), quiescentTol_( 0.0 ), quietCount_( 0 )
 {
 }
 
@@ -221,7 +243,10 @@ HSolve::~HSolve()
 void HSolve::process( const Eref& hsolve, ProcPtr p )
 {
     t0_ = high_resolution_clock::now();
-    this->HSolveActive::step( p );
+    if ( quiescentTol_ > 0.0 )
+        stepUnlessQuiescent( p );
+    else
+        this->HSolveActive::step( p );
     t1_ = high_resolution_clock::now();
     addSolverProf( "HSolve", duration_cast<duration<double>>(t1_ - t0_).count(), 1 );
 }
@@ -230,6 +255,125 @@ void HSolve::reinit( const Eref& hsolve, ProcPtr p )
 {
     dt_ = p->dt;
     this->HSolveActive::reinit( p );
+    wake();
+}
+
+/// Steps the cell must stay steady for before it is skipped.
+static const unsigned int numSteadySteps = 3;
+
+static bool isSteady( const vector< double >& x, const vector< double >& ref,
+                      double tol )
+{
+    for ( size_t i = 0; i < x.size(); ++i )
+        if ( fabs( x[i] - ref[i] ) > tol * fabs( ref[i] ) )
+            return false;
+    return true;
+}
+
+void HSolve::getInputs( vector< double >& in ) const
+{
+    in.assign( externalCurrent_.begin(), externalCurrent_.end() );
+    in.insert( in.end(), externalCalcium_.begin(), externalCalcium_.end() );
+    in.insert( in.end(), caActivation_.begin(), caActivation_.end() );
+    for ( auto i = inject_.cbegin(); i != inject_.cend(); ++i )
+        in.push_back( i->second.injectVarying );
+}
+
+/**
+ * A cell at rest stays put for as long as its inputs are the same as
+ * on the last step taken. Synaptic channels and injection messages send
+ * on every step, so a steady input does not wake the cell, but any
+ * change in it does.
+ */
+void HSolve::stepUnlessQuiescent( ProcPtr p )
+{
+    getInputs( inputs_ );
+    if ( quietCount_ >= numSteadySteps )
+    {
+        if ( inputs_ == restInputs_ )
+        {
+            idle( p );
+            return;
+        }
+        quietCount_ = 0;
+    }
+    restInputs_.swap( inputs_ );
+    restV_ = V_;
+    restState_ = state_;
+    restCa_ = ca_;
+    this->HSolveActive::step( p );
+    double tol = quiescentTol_ * p->dt;
+    if ( isSteady( V_, restV_, tol ) && isSteady( state_, restState_, tol )
+            && isSteady( ca_, restCa_, tol ) )
+        ++quietCount_;
+    else
+        quietCount_ = 0;
+}
+
+void HSolve::wake()
+{
+    quietCount_ = 0;
+}
+
+/**
+ * The zombified compartments, channels and Ca pools keep their state
+ * here. Inputs that arrived by message after the last step are saved as
+ * well, since the next step uses them.
+ */
+void HSolve::saveState( CheckpointWriter& w ) const
+{
+    w.add( "V", V_ );
+    w.add( "state", state_ );
+    w.add( "ca", ca_ );
+    w.add( "caActivation", caActivation_ );
+    w.add( "externalCalcium", externalCalcium_ );
+    w.add( "current", current_ );
+    w.add( "externalCurrent", externalCurrent_ );
+    w.add( "prevExtCurr", prevExtCurr_ );
+    vector< double > c;
+    for ( auto i = caConc_.cbegin(); i != caConc_.cend(); ++i )
+        c.push_back( i->c_ );
+    w.add( "caConc", c );
+    vector< double > inject;
+    for ( auto i = inject_.cbegin(); i != inject_.cend(); ++i )
+        inject.push_back( i->second.injectVarying );
+    w.add( "injectVarying", inject );
+    if ( quiescentTol_ > 0.0 )
+    {
+        w.addValue( "quietCount", quietCount_ );
+        w.add( "restInputs", restInputs_ );
+    }
+}
+
+void HSolve::loadState( CheckpointReader& r )
+{
+    r.get( "V", V_.data(), V_.size() );
+    r.get( "state", state_.data(), state_.size() );
+    r.get( "ca", ca_.data(), ca_.size() );
+    r.get( "caActivation", caActivation_.data(), caActivation_.size() );
+    r.get( "externalCalcium", externalCalcium_.data(),
+           externalCalcium_.size() );
+    // current_ is only sized on the first step.
+    r.get( "current", current_ );
+    r.get( "externalCurrent", externalCurrent_.data(),
+           externalCurrent_.size() );
+    r.get( "prevExtCurr", prevExtCurr_ );
+    vector< double > c( caConc_.size() );
+    if ( r.get( "caConc", c.data(), c.size() ) )
+        for ( unsigned int i = 0; i < c.size(); ++i )
+            caConc_[i].c_ = c[i];
+    vector< double > inject( inject_.size() );
+    if ( r.get( "injectVarying", inject.data(), inject.size() ) )
+    {
+        auto k = inject.cbegin();
+        for ( auto i = inject_.begin(); i != inject_.end(); ++i )
+            i->second.injectVarying = *k++;
+    }
+    if ( quiescentTol_ > 0.0 )
+    {
+        r.getValue( "quietCount", quietCount_ );
+        r.get( "restInputs", restInputs_ );
+    }
 }
 
 void HSolve::zombify( Eref hsolve ) const
@@ -498,6 +642,22 @@ double HSolve::getCaMax() const
     return caMax_;
 }
 
+void HSolve::setQuiescentTol( double tol )
+{
+    quiescentTol_ = tol > 0.0 ? tol : 0.0;
+    wake();
+}
+
+double HSolve::getQuiescentTol() const
+{
+    return quiescentTol_;
+}
+
+bool HSolve::getIsQuiescent() const
+{
+    return quiescentTol_ > 0.0 && quietCount_ >= numSteadySteps;
+}
+
 const set<string>& HSolve::handledClasses()
 {
     static set<string> classes;
@@ -17,6 +17,9 @@ using namespace std::chrono;
 /**
  * HSolve adapts the integrator HSolveActive into a MOOSE class.
  */
+class CheckpointWriter;
+class CheckpointReader;
+
 class HSolve: public HSolveActive
 {
 public:
@@ -26,6 +29,10 @@ public:
     void process( const Eref& hsolve, ProcPtr p );
     void reinit( const Eref& hsolve, ProcPtr p );
 
+    /// Checkpoint support, see shell/Checkpoint.h
+    void saveState( CheckpointWriter& w ) const;
+    void loadState( CheckpointReader& r );
+
     void setSeed( Id seed );
     Id getSeed() const; 		/**< For searching for compartments:
 								 *   seed is the starting compt.     */
@@ -58,6 +65,14 @@ public:
     void setCaMax( double caMax );
     double getCaMax() const;
 
+    /**
+     * Relative rate of change (1/s) below which the cell is at rest and
+     * its steps are skipped. Zero turns it off.
+     */
+    void setQuiescentTol( double tol );
+    double getQuiescentTol() const;
+    bool getIsQuiescent() const;
+
     // Interface functions defined in HSolveInterface.cpp
     double getInitVm( Id id ) const;
     void setInitVm( Id id, double value );
@@ -170,10 +185,29 @@ private:
     unsigned int localIndex( Id id ) const;
     map< Id, unsigned int > localIndex_;
 
+    /// Steps the cell, unless it is at rest and nothing has perturbed it.
+    void stepUnlessQuiescent( ProcPtr p );
+    /// Collects what has arrived by message for the next step.
+    void getInputs( vector< double >& in ) const;
+    /// Makes the cell start stepping again, after a field assignment.
+    void wake();
+
     double dt_;
     string path_;
     Id seed_;
 
+    /// Relative rate of change below which the cell is at rest.
+    double quiescentTol_;
+    /// Number of consecutive steady steps.
+    unsigned int quietCount_;
+    /// Inputs for this step, and for the last step taken.
+    vector< double > inputs_;
+    vector< double > restInputs_;
+    /// State at the start of the last step.
+    vector< double > restV_;
+    vector< double > restState_;
+    vector< double > restCa_;
+
     double totalTime_ = 0.0;
     high_resolution_clock::time_point t0_, t1_;
 };
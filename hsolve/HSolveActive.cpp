@@ -65,6 +65,17 @@ void HSolveActive::step( ProcPtr info )
     externalCurrent_.assign( externalCurrent_.size(), 0.0 );
 }
 
+void HSolveActive::idle( ProcPtr info )
+{
+    for ( auto i = inject_.begin(); i != inject_.end(); ++i )
+        i->second.injectVarying = 0.0;
+    caActivation_.assign( caActivation_.size(), 0.0 );
+    sendValues( info );
+    sendSpikes( info );
+    prevExtCurr_ = externalCurrent_;
+    externalCurrent_.assign( externalCurrent_.size(), 0.0 );
+}
+
 void HSolveActive::calculateChannelCurrents()
 {
     vector< ChannelStruct >::iterator ichan;
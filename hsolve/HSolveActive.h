@@ -35,6 +35,8 @@ public:
 
     void setup( Id seed, double dt );
     void step( ProcPtr info );			///< Equivalent to process
+    /// A step that leaves the cell as it is: clears inputs, sends outputs.
+    void idle( ProcPtr info );
     void reinit( ProcPtr info );
 
 protected:
@@ -76,6 +76,7 @@ void HSolve::setVm( Id id, double value )
     unsigned int index = localIndex( id );
     assert( index < V_.size() );
     V_[ index ] = value;
+    wake();
 }
 
 double HSolve::getCm( Id id ) const
@@ -93,6 +94,7 @@ void HSolve::setCm( Id id, double value )
     // Also update data structures used for calculations.
 	assert( tree_.size() == compartment_.size() );
 	compartment_[index].CmByDt = 2.0 * value / dt_;
+    wake();
 }
 
 double HSolve::getEm( Id id ) const
@@ -110,6 +112,7 @@ void HSolve::setEm( Id id, double value )
     // Also update data structures used for calculations.
 	assert( tree_.size() == compartment_.size() );
 	compartment_[index].EmByRm = value / tree_[index].Rm;
+    wake();
 }
 
 double HSolve::getRm( Id id ) const
@@ -127,6 +130,7 @@ void HSolve::setRm( Id id, double value )
     // Also update data structures used for calculations.
 	assert( tree_.size() == compartment_.size() );
 	compartment_[index].EmByRm = tree_[index].Em / value;
+    wake();
 }
 
 double HSolve::getRa( Id id ) const
@@ -141,6 +145,7 @@ void HSolve::setRa( Id id, double value )
     unsigned int index = localIndex( id );
     assert( index < tree_.size() );
     tree_[ index ].Ra = value;
+    wake();
 }
 
 double HSolve::getInitVm( Id id ) const
@@ -208,6 +213,7 @@ void HSolve::setInject( Id id, double value )
     // Not assert( index < inject_.size() ), because inject_ is a map.
     assert( index < nCompt_ );
     inject_[ index ].injectBasal = value;
+    wake();
 }
 
 void HSolve::addInject( Id id, double value )
@@ -268,6 +274,7 @@ void HSolve::setPowers(
     unsigned int index = localIndex( id );
     assert( index < channel_.size() );
     channel_[ index ].setPowers( Xpower, Ypower, Zpower );
+    wake();
 }
 
 int HSolve::getInstant( Id id ) const
@@ -282,6 +289,7 @@ void HSolve::setInstant( Id id, int instant )
     unsigned int index = localIndex( id );
     assert( index < channel_.size() );
     channel_[ index ].instant_ = instant;
+    wake();
 }
 
 double HSolve::getHHChannelGbar( Id id ) const
@@ -296,7 +304,7 @@ void HSolve::setHHChannelGbar( Id id, double value )
     unsigned int index = localIndex( id );
     assert( index < channel_.size() );
     channel_[ index ].Gbar_ = value;
-
+    wake();
 }
 
 double HSolve::getEk( Id id ) const
@@ -311,6 +319,7 @@ void HSolve::setEk( Id id, double value )
     unsigned int index = localIndex( id );
     assert( index < current_.size() );
     current_[ index ].Ek = value;
+    wake();
 }
 
 double HSolve::getGk( Id id ) const
@@ -325,6 +334,7 @@ void HSolve::setGk( Id id, double value )
     unsigned int index = localIndex( id );
     assert( index < current_.size() );
     current_[ index ].Gk = value;
+    wake();
 }
 
 double HSolve::getIk( Id id ) const
@@ -364,6 +374,7 @@ void HSolve::setX( Id id, double value )
     assert( stateIndex < state_.size() );
 
     state_[ stateIndex ] = value;
+    wake();
 }
 
 double HSolve::getY( Id id ) const
@@ -400,6 +411,7 @@ void HSolve::setY( Id id, double value )
     assert( stateIndex < state_.size() );
 
     state_[ stateIndex ] = value;
+    wake();
 }
 
 double HSolve::getZ( Id id ) const
@@ -440,6 +452,7 @@ void HSolve::setZ( Id id, double value )
     assert( stateIndex < state_.size() );
 
     state_[ stateIndex ] = value;
+    wake();
 }
 
 void HSolve::setHHmodulation( Id id, double value )
@@ -448,6 +461,7 @@ void HSolve::setHHmodulation( Id id, double value )
     assert( index < channel_.size() );
 	if ( value > 0.0 )
 			channel_[index].modulation_ = value;
+    wake();
 }
 
 double HSolve::getCa( Id id ) const
@@ -464,6 +478,7 @@ void HSolve::setCa( Id id, double Ca )
 
     ca_[ index ] = Ca;
     caConc_[ index ].setCa( Ca );
+    wake();
 }
 
 void HSolve::iCa( Id id, double iCa )
@@ -492,6 +507,7 @@ void HSolve::setCaBasal( Id id, double CaBasal )
     assert( index < caConc_.size() );
 
     caConc_[ index ].setCaBasal( CaBasal );
+    wake();
 }
 
 void HSolve::setTauB( Id id, double tau, double B )
@@ -500,6 +516,7 @@ void HSolve::setTauB( Id id, double tau, double B )
     assert( index < caConc_.size() );
 
     caConc_[ index ].setTauB( tau, B, dt_ );
+    wake();
 }
 
 double HSolve::getCaCeiling( Id id ) const
@@ -515,6 +532,7 @@ void HSolve::setCaCeiling( Id id, double ceiling )
     assert( index < caConc_.size() );
 
     caConc_[ index ].ceiling_ = ceiling;
+    wake();
 }
 
 double HSolve::getCaFloor( Id id ) const
@@ -530,4 +548,5 @@ void HSolve::setCaFloor( Id id, double floor )
     assert( index < caConc_.size() );
 
     caConc_[ index ].floor_ = floor;
+    wake();
 }
@@ -14,6 +14,7 @@
 #include "IntFireBase.h"
 #include "ExIF.h"
 #include "AdExIF.h"
+#include "../shell/Checkpoint.h"
 
 using namespace moose;
 
@@ -66,7 +67,7 @@ const Cinfo* AdExIF::initCinfo()
         &b0,       // Value
 	};
 
-    static Dinfo< AdExIF > dinfo;
+    static ArenaDinfo< AdExIF > dinfo;
 	static Cinfo AdExIFCinfo(
 				"AdExIF",
 				ExIF::initCinfo(),
@@ -99,7 +100,7 @@ AdExIF::~AdExIF()
 // AdExIF::Dest function definitions.
 //////////////////////////////////////////////////////////////////
 
-void AdExIF::vProcess( const Eref& e, ProcPtr p )
+bool AdExIF::advance( ProcPtr p )
 {
 	fired_ = false;
 	if ( p->currTime < lastEvent_ + refractT_ ) {
@@ -107,30 +108,39 @@ void AdExIF::vProcess( const Eref& e, ProcPtr p )
 		A_ = 0.0;
 		B_ = 1.0 / Rm_;
 		sumInject_ = 0.0;
-		VmOut()->send( e, Vm_ );
-	} else {
-        // activation can be a continous variable (graded synapse).
-        // So integrate it at every time step, thus *dt.
-        // For a delta-fn synapse, SynHandler-s divide by dt and send activation.
-        // See: http://www.genesis-sim.org/GENESIS/Hyperdoc/Manual-26.html#synchan
-        //          for this continuous definition of activation.
-		Vm_ += activation_ * p->dt;
-		activation_ = 0.0;
-		if ( Vm_ >= vPeak_ ) {
-			Vm_ = vReset_;
-            w_ += b0_;
-			lastEvent_ = p->currTime;
-			fired_ = true;
-			spikeOut()->send( e, p->currTime );
-			VmOut()->send( e, Vm_ );
-		} else {
-            Vm_ += ( deltaThresh_ * exp((Vm_-threshold_)/deltaThresh_) - Rm_*w_ )
-                            *p->dt/Rm_/Cm_;
-            w_ += (-w_ + a0_*(Vm_-Em_)) * p->dt/tauW_;
-			Compartment::vProcess( e, p );  // this sends out Vm message also,
-                                            // so do calculations before
-		}
+		return false;
 	}
+	// activation can be a continous variable (graded synapse).
+	// So integrate it at every time step, thus *dt.
+	// For a delta-fn synapse, SynHandler-s divide by dt and send activation.
+	// See: http://www.genesis-sim.org/GENESIS/Hyperdoc/Manual-26.html#synchan
+	//          for this continuous definition of activation.
+	Vm_ += activation_ * p->dt;
+	activation_ = 0.0;
+	if ( Vm_ >= vPeak_ ) {
+		Vm_ = vReset_;
+		w_ += b0_;
+		lastEvent_ = p->currTime;
+		fired_ = true;
+		return true;
+	}
+	Vm_ += ( deltaThresh_ * exp((Vm_-threshold_)/deltaThresh_) - Rm_*w_ )
+			*p->dt/Rm_/Cm_;
+	w_ += (-w_ + a0_*(Vm_-Em_)) * p->dt/tauW_;
+	integrate( p->dt );
+	return false;
+}
+
+void AdExIF::vProcess( const Eref& e, ProcPtr p )
+{
+	if ( advance( p ) )
+		spikeOut()->send( e, p->currTime );
+	VmOut()->send( e, Vm_ );
+}
+
+void AdExIF::vProcessAll( const Eref& e, unsigned int n, ProcPtr p )
+{
+	processBatch< AdExIF >( e, n, p );
 }
 
 void AdExIF::vReinit(  const Eref& e, ProcPtr p )
@@ -142,6 +152,18 @@ void AdExIF::vReinit(  const Eref& e, ProcPtr p )
 	Compartment::vReinit( e, p );
 }
 
+void AdExIF::saveState( CheckpointWriter& w ) const
+{
+	IntFireBase::saveState( w );
+	w.addValue( "w", w_ );
+}
+
+void AdExIF::loadState( CheckpointReader& r )
+{
+	IntFireBase::loadState( r );
+	r.getValue( "w", w_ );
+}
+
 void AdExIF::setW( const Eref& e, double val )
 {
 	w_ = val;
@@ -13,6 +13,7 @@
 #include "../biophysics/Compartment.h"
 #include "IntFireBase.h"
 #include "AdThreshIF.h"
+#include "../shell/Checkpoint.h"
 
 using namespace moose;
 
@@ -66,7 +67,7 @@ const Cinfo* AdThreshIF::initCinfo()
         &threshJump     // Value
 	};
 
-    static Dinfo< AdThreshIF > dinfo;
+    static ArenaDinfo< AdThreshIF > dinfo;
 	static Cinfo AdThreshIFCinfo(
 				"AdThreshIF",
 				IntFireBase::initCinfo(),
@@ -99,7 +100,7 @@ AdThreshIF::~AdThreshIF()
 // AdThreshIF::Dest function definitions.
 //////////////////////////////////////////////////////////////////
 
-void AdThreshIF::vProcess( const Eref& e, ProcPtr p )
+bool AdThreshIF::advance( ProcPtr p )
 {
 	fired_ = false;
 	if ( p->currTime < lastEvent_ + refractT_ ) {
@@ -107,28 +108,37 @@ void AdThreshIF::vProcess( const Eref& e, ProcPtr p )
 		A_ = 0.0;
 		B_ = 1.0 / Rm_;
 		sumInject_ = 0.0;
-		VmOut()->send( e, Vm_ );
-	} else {
-        // activation can be a continous variable (graded synapse).
-        // So integrate it at every time step, thus *dt.
-        // For a delta-fn synapse, SynHandler-s divide by dt and send activation.
-        // See: http://www.genesis-sim.org/GENESIS/Hyperdoc/Manual-26.html#synchan
-        //          for this continuous definition of activation.
-		Vm_ += activation_ * p->dt;
-		activation_ = 0.0;
-		if ( Vm_ > (threshold_+threshAdaptive_) ) {
-			Vm_ = vReset_;
-            threshAdaptive_ += threshJump_;
-			lastEvent_ = p->currTime;
-			fired_ = true;
-			spikeOut()->send( e, p->currTime );
-			VmOut()->send( e, Vm_ );
-		} else {
-            threshAdaptive_ += (-threshAdaptive_ + a0_*(Vm_-Em_)) * p->dt/tauThresh_;
-			Compartment::vProcess( e, p );  // this sends out Vm message also,
-                                            // so do Vm_ calculations before
-		}
+		return false;
 	}
+	// activation can be a continous variable (graded synapse).
+	// So integrate it at every time step, thus *dt.
+	// For a delta-fn synapse, SynHandler-s divide by dt and send activation.
+	// See: http://www.genesis-sim.org/GENESIS/Hyperdoc/Manual-26.html#synchan
+	//          for this continuous definition of activation.
+	Vm_ += activation_ * p->dt;
+	activation_ = 0.0;
+	if ( Vm_ > (threshold_+threshAdaptive_) ) {
+		Vm_ = vReset_;
+		threshAdaptive_ += threshJump_;
+		lastEvent_ = p->currTime;
+		fired_ = true;
+		return true;
+	}
+	threshAdaptive_ += (-threshAdaptive_ + a0_*(Vm_-Em_)) * p->dt/tauThresh_;
+	integrate( p->dt );
+	return false;
+}
+
+void AdThreshIF::vProcess( const Eref& e, ProcPtr p )
+{
+	if ( advance( p ) )
+		spikeOut()->send( e, p->currTime );
+	VmOut()->send( e, Vm_ );
+}
+
+void AdThreshIF::vProcessAll( const Eref& e, unsigned int n, ProcPtr p )
+{
+	processBatch< AdThreshIF >( e, n, p );
 }
 
 void AdThreshIF::vReinit(  const Eref& e, ProcPtr p )
@@ -140,6 +150,18 @@ void AdThreshIF::vReinit(  const Eref& e, ProcPtr p )
 	Compartment::vReinit( e, p );
 }
 
+void AdThreshIF::saveState( CheckpointWriter& w ) const
+{
+	IntFireBase::saveState( w );
+	w.addValue( "threshAdaptive", threshAdaptive_ );
+}
+
+void AdThreshIF::loadState( CheckpointReader& r )
+{
+	IntFireBase::loadState( r );
+	r.getValue( "threshAdaptive", threshAdaptive_ );
+}
+
 void AdThreshIF::setThreshAdaptive( const Eref& e, double val )
 {
 	threshAdaptive_ = val;
@@ -47,7 +47,7 @@ const Cinfo* ExIF::initCinfo()
         &vPeak,             // Value
 	};
 
-    static Dinfo< ExIF > dinfo;
+    static ArenaDinfo< ExIF > dinfo;
 	static Cinfo ExIFCinfo(
 				"ExIF",
 				IntFireBase::initCinfo(),
@@ -78,7 +78,7 @@ ExIF::~ExIF()
 // ExIF::Dest function definitions.
 //////////////////////////////////////////////////////////////////
 
-void ExIF::vProcess( const Eref& e, ProcPtr p )
+bool ExIF::advance( ProcPtr p )
 {
 	fired_ = false;
 	if ( p->currTime < lastEvent_ + refractT_ ) {
@@ -86,27 +86,36 @@ void ExIF::vProcess( const Eref& e, ProcPtr p )
 		A_ = 0.0;
 		B_ = 1.0 / Rm_;
 		sumInject_ = 0.0;
-		VmOut()->send( e, Vm_ );
-	} else {
-        // activation can be a continous variable (graded synapse).
-        // So integrate it at every time step, thus *dt.
-        // For a delta-fn synapse, SynHandler-s divide by dt and send activation.
-        // See: http://www.genesis-sim.org/GENESIS/Hyperdoc/Manual-26.html#synchan
-        //          for this continuous definition of activation.
-		Vm_ += activation_ * p->dt;
-		activation_ = 0.0;
-		if ( Vm_ >= vPeak_ ) {
-			Vm_ = vReset_;
-			lastEvent_ = p->currTime;
-			fired_ = true;
-			spikeOut()->send( e, p->currTime );
-			VmOut()->send( e, Vm_ );
-		} else {
-            Vm_ += deltaThresh_ * exp((Vm_-threshold_)/deltaThresh_) *p->dt/Rm_/Cm_;
-			Compartment::vProcess( e, p );  // this sends out Vm message also,
-                                            // so do calculations before
-		}
+		return false;
+	}
+	// activation can be a continous variable (graded synapse).
+	// So integrate it at every time step, thus *dt.
+	// For a delta-fn synapse, SynHandler-s divide by dt and send activation.
+	// See: http://www.genesis-sim.org/GENESIS/Hyperdoc/Manual-26.html#synchan
+	//          for this continuous definition of activation.
+	Vm_ += activation_ * p->dt;
+	activation_ = 0.0;
+	if ( Vm_ >= vPeak_ ) {
+		Vm_ = vReset_;
+		lastEvent_ = p->currTime;
+		fired_ = true;
+		return true;
 	}
+	Vm_ += deltaThresh_ * exp((Vm_-threshold_)/deltaThresh_) *p->dt/Rm_/Cm_;
+	integrate( p->dt );
+	return false;
+}
+
+void ExIF::vProcess( const Eref& e, ProcPtr p )
+{
+	if ( advance( p ) )
+		spikeOut()->send( e, p->currTime );
+	VmOut()->send( e, Vm_ );
+}
+
+void ExIF::vProcessAll( const Eref& e, unsigned int n, ProcPtr p )
+{
+	processBatch< ExIF >( e, n, p );
 }
 
 void ExIF::vReinit(  const Eref& e, ProcPtr p )
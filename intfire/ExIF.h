@@ -33,6 +33,15 @@ class ExIF: public IntFireBase
 			 */
 			void vProcess( const Eref& e, ProcPtr p );
 
+			/**
+			 * Updates the neuron by one step without sending anything, and
+			 * returns true if it fired.
+			 */
+			bool advance( ProcPtr p );
+
+			/// Process for all n entries of an Element in one pass.
+			void vProcessAll( const Eref& e, unsigned int n, ProcPtr p );
+
 			/**
 			 * The reinit function reinitializes all fields.
 			 */
@@ -12,6 +12,7 @@
 #include "../biophysics/CompartmentBase.h"
 #include "../biophysics/Compartment.h"
 #include "IntFireBase.h"
+#include "../shell/Checkpoint.h"
 
 using namespace moose;
 SrcFinfo1< double >* IntFireBase::spikeOut()
@@ -103,6 +104,8 @@ const Cinfo* IntFireBase::initCinfo()
 }
 
 static const Cinfo* intFireBaseCinfo = IntFireBase::initCinfo();
+static CheckpointHandler< IntFireBase > intFireBaseCheckpoint(
+    "IntFireBase" );
 
 //////////////////////////////////////////////////////////////////
 // Here we put the Compartment class functions.
@@ -123,6 +126,22 @@ IntFireBase::~IntFireBase()
     ;
 }
 
+void IntFireBase::saveState( CheckpointWriter& w ) const
+{
+    Compartment::saveState( w );
+    w.addValue( "activation", activation_ );
+    w.addValue( "lastEvent", lastEvent_ );
+    w.addValue( "fired", fired_ );
+}
+
+void IntFireBase::loadState( CheckpointReader& r )
+{
+    Compartment::loadState( r );
+    r.getValue( "activation", activation_ );
+    r.getValue( "lastEvent", lastEvent_ );
+    r.getValue( "fired", fired_ );
+}
+
 // Value Field access function definitions.
 void IntFireBase::setThresh( const Eref& e, double val )
 {
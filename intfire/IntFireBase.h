@@ -53,11 +53,28 @@ public:
     /// Message src for outgoing spikes.
     static SrcFinfo1< double >* spikeOut();
 
+    /**
+     * Checkpoint support, see shell/Checkpoint.h. One handler serves the
+     * whole family; classes with more state extend these.
+     */
+    virtual void saveState( CheckpointWriter& w ) const;
+    virtual void loadState( CheckpointReader& r );
+
     /**
      * Initializes the class info.
      */
     static const Cinfo* initCinfo();
 protected:
+    /**
+     * Process for the n entries of an Element of class T starting at e.
+     * T::advance updates every entry in one loop over the data array,
+     * noting the ones that fired. Only Elements of class T exactly are
+     * done this way. Spikes then go out from those, and Vm
+     * goes out only if the Element has anything on VmOut.
+     */
+    template< class T > static void processBatch(
+            const Eref& e, unsigned int n, ProcPtr p );
+
     double threshold_;
     double vReset_;
     double activation_;
@@ -65,6 +82,35 @@ protected:
     double lastEvent_;
     bool fired_;
 };
+
+template< class T > void IntFireBase::processBatch(
+        const Eref& e, unsigned int n, ProcPtr p )
+{
+    Element* elm = e.element();
+    T* data = reinterpret_cast< T* >( e.data() );
+    // The data array is walked as an array of T, so a class derived
+    // from T that inherits this without doing its own batch goes entry
+    // by entry.
+    if ( elm->cinfo() != T::initCinfo() )
+    {
+        data->CompartmentBase::vProcessAll( e, n, p );
+        return;
+    }
+    vector< unsigned int > fired;
+    for ( unsigned int i = 0; i < n; ++i )
+        if ( data[i].advance( p ) )
+            fired.push_back( i );
+
+    unsigned int start = e.dataIndex();
+    for ( vector< unsigned int >::const_iterator
+            i = fired.begin(); i != fired.end(); ++i )
+        spikeOut()->send( Eref( elm, start + *i ), p->currTime );
+    if ( elm->hasMsgs( VmOut()->getBindIndex() ) )
+    {
+        for ( unsigned int i = 0; i < n; ++i )
+            VmOut()->send( Eref( elm, start + i ), data[i].Vm_ );
+    }
+}
 } // namespace
 
 #endif // _INT_FIRE_BASE_H
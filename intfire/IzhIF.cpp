@@ -13,6 +13,7 @@
 #include "../biophysics/Compartment.h"
 #include "IntFireBase.h"
 #include "IzhIF.h"
+#include "../shell/Checkpoint.h"
 
 using namespace moose;
 
@@ -111,7 +112,7 @@ const Cinfo* IzhIF::initCinfo()
         &vPeak,         // Value
 	};
 
-    static Dinfo< IzhIF > dinfo;
+    static ArenaDinfo< IzhIF > dinfo;
 	static Cinfo IzhIFCinfo(
 				"IzhIF",
 				IntFireBase::initCinfo(),
@@ -154,41 +155,49 @@ IzhIF::~IzhIF()
 // IzhIF::Dest function definitions.
 //////////////////////////////////////////////////////////////////
 
-void IzhIF::vProcess( const Eref& e, ProcPtr p )
+bool IzhIF::advance( ProcPtr p )
 {
-    // fully taking over Compartment's vProcess due to quadratic term in Vm
-    // we no longer care about A and B
 	fired_ = false;
 	if ( p->currTime < lastEvent_ + refractT_ ) {
 		Vm_ = vReset_;
 		sumInject_ = 0.0;
-		VmOut()->send( e, Vm_ );
-	} else {
-        // activation can be a continous variable (graded synapse).
-        // So integrate it at every time step, thus *dt.
-        // For a delta-fn synapse, SynHandler-s divide by dt and send activation.
-        // See: http://www.genesis-sim.org/GENESIS/Hyperdoc/Manual-26.html#synchan
-        //          for this continuous definition of activation.
-		Vm_ += activation_ * p->dt;
-		activation_ = 0.0;
-		if ( Vm_ > vPeak_ ) {
-			Vm_ = vReset_;
-            u_ += d_;
-			lastEvent_ = p->currTime;
-			fired_ = true;
-			spikeOut()->send( e, p->currTime );
-			VmOut()->send( e, Vm_ );
-		} else {
-            Vm_ += ( (inject_+sumInject_) / Cm_
-                    + a0_*pow(Vm_,2.0) + b0_*Vm_ + c0_ - u_ ) * p->dt;
-            u_ += a_ * (b_*Vm_ - u_) * p->dt;
-            lastIm_ = Im_;
-            Im_ = 0.0;
-            sumInject_ = 0.0;
-            // Send out Vm to channels, SpikeGens, etc.
-            VmOut()->send( e, Vm_ );
-		}
+		return false;
 	}
+	// activation can be a continous variable (graded synapse).
+	// So integrate it at every time step, thus *dt.
+	// For a delta-fn synapse, SynHandler-s divide by dt and send activation.
+	// See: http://www.genesis-sim.org/GENESIS/Hyperdoc/Manual-26.html#synchan
+	//          for this continuous definition of activation.
+	Vm_ += activation_ * p->dt;
+	activation_ = 0.0;
+	if ( Vm_ > vPeak_ ) {
+		Vm_ = vReset_;
+		u_ += d_;
+		lastEvent_ = p->currTime;
+		fired_ = true;
+		return true;
+	}
+	// fully taking over Compartment's integration due to quadratic term
+	// in Vm: we no longer care about A and B
+	Vm_ += ( (inject_+sumInject_) / Cm_
+			+ a0_*pow(Vm_,2.0) + b0_*Vm_ + c0_ - u_ ) * p->dt;
+	u_ += a_ * (b_*Vm_ - u_) * p->dt;
+	lastIm_ = Im_;
+	Im_ = 0.0;
+	sumInject_ = 0.0;
+	return false;
+}
+
+void IzhIF::vProcess( const Eref& e, ProcPtr p )
+{
+	if ( advance( p ) )
+		spikeOut()->send( e, p->currTime );
+	VmOut()->send( e, Vm_ );
+}
+
+void IzhIF::vProcessAll( const Eref& e, unsigned int n, ProcPtr p )
+{
+	processBatch< IzhIF >( e, n, p );
 }
 
 void IzhIF::vReinit(  const Eref& e, ProcPtr p )
@@ -200,6 +209,18 @@ void IzhIF::vReinit(  const Eref& e, ProcPtr p )
 	Compartment::vReinit( e, p );
 }
 
+void IzhIF::saveState( CheckpointWriter& w ) const
+{
+	IntFireBase::saveState( w );
+	w.addValue( "u", u_ );
+}
+
+void IzhIF::loadState( CheckpointReader& r )
+{
+	IntFireBase::loadState( r );
+	r.getValue( "u", u_ );
+}
+
 void IzhIF::setA0( const Eref& e, double val )
 {
 	a0_ = val;
@@ -47,11 +47,24 @@ class IzhIF: public IntFireBase
 			 */
 			void vProcess( const Eref& e, ProcPtr p );
 
+			/**
+			 * Updates the neuron by one step without sending anything, and
+			 * returns true if it fired.
+			 */
+			bool advance( ProcPtr p );
+
+			/// Process for all n entries of an Element in one pass.
+			void vProcessAll( const Eref& e, unsigned int n, ProcPtr p );
+
 			/**
 			 * The reinit function reinitializes all fields.
 			 */
 			void vReinit( const Eref& e, ProcPtr p );
 
+			/// Checkpoint support, adds the adaptation state.
+			void saveState( CheckpointWriter& w ) const;
+			void loadState( CheckpointReader& r );
+
 			/**
 			 * Initializes the class info.
 			 */
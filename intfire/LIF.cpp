@@ -24,7 +24,7 @@ const Cinfo* LIF::initCinfo()
         "Author", "Upi Bhalla",
         "Description", "Leaky Integrate-and-Fire neuron"
     };
-    static Dinfo< LIF > dinfo;
+    static ArenaDinfo< LIF > dinfo;
     static Cinfo lifCinfo(
         "LIF",
         IntFireBase::initCinfo(),
@@ -57,7 +57,7 @@ LIF::~LIF()
 // LIF::Dest function definitions.
 //////////////////////////////////////////////////////////////////
 
-void LIF::vProcess( const Eref& e, ProcPtr p )
+bool LIF::advance( ProcPtr p )
 {
     fired_ = false;
     if ( p->currTime < lastEvent_ + refractT_ )
@@ -66,30 +66,36 @@ void LIF::vProcess( const Eref& e, ProcPtr p )
         A_ = 0.0;
         B_ = 1.0 / Rm_;
         sumInject_ = 0.0;
-        VmOut()->send( e, Vm_ );
+        return false;
     }
-    else
+    // activation can be a continous variable (graded synapse).
+    // So integrate it at every time step, thus *dt.
+    // For a delta-fn synapse, SynHandler-s divide by dt and send activation.
+    // See: http://www.genesis-sim.org/GENESIS/Hyperdoc/Manual-26.html#synchan
+    //          for this continuous definition of activation.
+    Vm_ += activation_ * p->dt;
+    activation_ = 0.0;
+    if ( Vm_ > threshold_ )
     {
-        // activation can be a continous variable (graded synapse).
-        // So integrate it at every time step, thus *dt.
-        // For a delta-fn synapse, SynHandler-s divide by dt and send activation.
-        // See: http://www.genesis-sim.org/GENESIS/Hyperdoc/Manual-26.html#synchan
-        //          for this continuous definition of activation.
-        Vm_ += activation_ * p->dt;
-        activation_ = 0.0;
-        if ( Vm_ > threshold_ )
-        {
-            Vm_ = vReset_;
-            lastEvent_ = p->currTime;
-            fired_ = true;
-            spikeOut()->send( e, p->currTime );
-            VmOut()->send( e, Vm_ );
-        }
-        else
-        {
-            Compartment::vProcess( e, p );
-        }
+        Vm_ = vReset_;
+        lastEvent_ = p->currTime;
+        fired_ = true;
+        return true;
     }
+    integrate( p->dt );
+    return false;
+}
+
+void LIF::vProcess( const Eref& e, ProcPtr p )
+{
+    if ( advance( p ) )
+        spikeOut()->send( e, p->currTime );
+    VmOut()->send( e, Vm_ );
+}
+
+void LIF::vProcessAll( const Eref& e, unsigned int n, ProcPtr p )
+{
+    processBatch< LIF >( e, n, p );
 }
 
 void LIF::vReinit(  const Eref& e, ProcPtr p )
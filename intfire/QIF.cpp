@@ -47,7 +47,7 @@ const Cinfo* QIF::initCinfo()
         &a0             // Value
 	};
 
-    static Dinfo< QIF > dinfo;
+    static ArenaDinfo< QIF > dinfo;
 	static Cinfo QIFCinfo(
 				"QIF",
 				IntFireBase::initCinfo(), // this is the initCinfo of the parent class
@@ -78,39 +78,47 @@ QIF::~QIF()
 // QIF::Dest function definitions.
 //////////////////////////////////////////////////////////////////
 
-void QIF::vProcess( const Eref& e, ProcPtr p )
+bool QIF::advance( ProcPtr p )
 {
-    // fully taking over Compartment's vProcess due to quadratic term in Vm
-    // we no longer care about A and B
 	fired_ = false;
 	if ( p->currTime < lastEvent_ + refractT_ ) {
 		Vm_ = vReset_;
 		sumInject_ = 0.0;
-		VmOut()->send( e, Vm_ );
-	} else {
-        // activation can be a continous variable (graded synapse).
-        // So integrate it at every time step, thus *dt.
-        // For a delta-fn synapse, SynHandler-s divide by dt and send activation.
-        // See: http://www.genesis-sim.org/GENESIS/Hyperdoc/Manual-26.html#synchan
-        //          for this continuous definition of activation.
-		Vm_ += activation_ * p->dt;
-		activation_ = 0.0;
-		if ( Vm_ > threshold_ ) {
-			Vm_ = vReset_;
-			lastEvent_ = p->currTime;
-			fired_ = true;
-			spikeOut()->send( e, p->currTime );
-			VmOut()->send( e, Vm_ );
-		} else {
-            Vm_ += ( (inject_+sumInject_)
-                    + a0_*(Vm_-Em_)*(Vm_-vCritical_)/Rm_ ) * p->dt / Cm_;
-            lastIm_ = Im_;
-            Im_ = 0.0;
-            sumInject_ = 0.0;
-            // Send out Vm to channels, SpikeGens, etc.
-            VmOut()->send( e, Vm_ );
-		}
+		return false;
+	}
+	// activation can be a continous variable (graded synapse).
+	// So integrate it at every time step, thus *dt.
+	// For a delta-fn synapse, SynHandler-s divide by dt and send activation.
+	// See: http://www.genesis-sim.org/GENESIS/Hyperdoc/Manual-26.html#synchan
+	//          for this continuous definition of activation.
+	Vm_ += activation_ * p->dt;
+	activation_ = 0.0;
+	if ( Vm_ > threshold_ ) {
+		Vm_ = vReset_;
+		lastEvent_ = p->currTime;
+		fired_ = true;
+		return true;
 	}
+	// fully taking over Compartment's integration due to quadratic term
+	// in Vm: we no longer care about A and B
+	Vm_ += ( (inject_+sumInject_)
+			+ a0_*(Vm_-Em_)*(Vm_-vCritical_)/Rm_ ) * p->dt / Cm_;
+	lastIm_ = Im_;
+	Im_ = 0.0;
+	sumInject_ = 0.0;
+	return false;
+}
+
+void QIF::vProcess( const Eref& e, ProcPtr p )
+{
+	if ( advance( p ) )
+		spikeOut()->send( e, p->currTime );
+	VmOut()->send( e, Vm_ );
+}
+
+void QIF::vProcessAll( const Eref& e, unsigned int n, ProcPtr p )
+{
+	processBatch< QIF >( e, n, p );
 }
 
 void QIF::vReinit(  const Eref& e, ProcPtr p )
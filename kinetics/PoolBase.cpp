@@ -12,6 +12,7 @@
 #include "../ksolve/VoxelPoolsBase.h"
 #include "../ksolve/VoxelPools.h"
 #include "../ksolve/KsolveBase.h"
+#include "../ksolve/SparseJacobian.h"
 #include "../ksolve/Ksolve.h"
 #include "lookupVolumeFromMesh.h"
 #include "PoolBase.h"
@@ -51,6 +51,11 @@ class FuncRate: public ExternReac
             func_->setTarget( molIndex[0] );
         }
 
+        void getDerivs( const double* S,
+                vector< pair< unsigned int, double > >& d ) const {
+            funcDerivs( S, 1.0, d );
+        }
+
         const vector< unsigned int >& getFuncArgIndex()
         {
             return func_->getReactantIndex();
@@ -82,6 +87,28 @@ class FuncRate: public ExternReac
 		}
 
     protected:
+        /**
+         * The function is opaque, so it is differentiated numerically
+         * with respect to each of its arguments. Appends
+         * scale * d func / d S[arg] for each of them.
+         */
+        void funcDerivs( const double* S, double scale,
+                vector< pair< unsigned int, double > >& d ) const {
+            double t = Field< double >::get( Id(1), "currentTime" );
+            double* s = const_cast< double* >( S );
+            const vector< unsigned int >& args = func_->getReactantIndex();
+            for ( auto i = args.begin(); i != args.end(); ++i ) {
+                double orig = s[*i];
+                double h = max( fabs( orig ) * 1e-6, 1e-6 );
+                s[*i] = orig + h;
+                double up = (*func_)( s, t );
+                s[*i] = orig - h;
+                double down = (*func_)( s, t );
+                s[*i] = orig;
+                d.push_back( make_pair( *i, scale * ( up - down ) / ( 2 * h ) ) );
+            }
+        }
+
         double k_;
         shared_ptr<FuncTerm> func_;
         double funcVolPower_;
@@ -135,6 +162,24 @@ class FuncReac: public FuncRate
             v_ = molIndex;
         }
 
+        void getDerivs( const double* S,
+                vector< pair< unsigned int, double > >& d ) const
+        {
+            double t = Field< double >::get( Id(1), "currentTime" );
+            double f = (*func_)( S, t );
+            double prod = 1.0;
+            for ( auto i = v_.begin(); i != v_.end(); i++)
+                prod *= S[ *i ];
+            funcDerivs( S, prod, d );
+            for ( unsigned int i = 0; i < v_.size(); ++i ) {
+                double x = f;
+                for ( unsigned int j = 0; j < v_.size(); ++j )
+                    if ( j != i )
+                        x *= S[ v_[j] ];
+                d.push_back( make_pair( v_[i], x ) );
+            }
+        }
+
         void rescaleVolume( short comptIndex,
             const vector< short >& compartmentLookup, double ratio )
         {
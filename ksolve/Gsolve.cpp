@@ -22,12 +22,18 @@
 #include "FuncRateTerm.h"
 #include "../basecode/SparseMatrix.h"
 #include "KinSparseMatrix.h"
+#include "../mesh/Boundary.h"
+#include "../mesh/MeshEntry.h"
+#include "../mesh/ChemCompt.h"
+#include "../mesh/MeshCompt.h"
 #include "GssaSystem.h"
 #include "Stoich.h"
 #include "GssaVoxelPools.h"
 #include "Gsolve.h"
+#include "../shell/Checkpoint.h"
 
 #include <chrono>
+#include <limits>
 #include <algorithm>
 
 #ifdef USE_BOOST_ASYNC
@@ -147,6 +153,58 @@ const Cinfo* Gsolve::initCinfo()
         &Gsolve::setClockedUpdate,
         &Gsolve::getClockedUpdate
     );
+    static ValueFinfo< Gsolve, string > method (
+        "method",
+        "Stochastic integration method. Options are:\n"
+        "gssa: The default exact Gillespie Stochastic Simulation "
+        "Algorithm, firing one reaction at a time.\n"
+        "tauleap: Adaptive explicit tau-leaping with Cao-Gillespie "
+        "step selection. Many reactions may fire per leap. Reactions "
+        "close to exhausting a reactant are still fired exactly.\n"
+        "hybrid: Reactions that are fast and act on high copy number "
+        "pools (see hybridThreshold) are integrated deterministically, "
+        "the rest are fired by the exact SSA.",
+        &Gsolve::setMethod,
+        &Gsolve::getMethod
+    );
+
+    static ValueFinfo< Gsolve, double > epsilon (
+        "epsilon",
+        "Error control parameter for the tauleap and hybrid methods: "
+        "the largest relative change in any reactant allowed in a "
+        "single leap or deterministic substep.\n"
+        "Default: 0.03",
+        &Gsolve::setEpsilon,
+        &Gsolve::getEpsilon
+    );
+
+    static ValueFinfo< Gsolve, double > hybridThreshold (
+        "hybridThreshold",
+        "In hybrid method, a reaction is treated deterministically "
+        "when its expected number of firings per timestep, and the "
+        "number of molecules of each of its reactants, both exceed "
+        "this value. Reactions are repartitioned every timestep.\n"
+        "Default: 100",
+        &Gsolve::setHybridThreshold,
+        &Gsolve::getHybridThreshold
+    );
+
+    static ValueFinfo< Gsolve, bool > useJumpDiffusion (
+        "useJumpDiffusion",
+        "Flag: True to do diffusion within the compartment by stochastic "
+        "jumps of single molecules between voxels, using the "
+        "next-subvolume method. Reaction and diffusion events in all "
+        "voxels are then ordered by a single event queue, and the "
+        "deterministic diffusion step of the Dsolve is skipped. "
+        "Reactions are fired by the exact SSA whatever the method. "
+        "Diffusion across junctions to other compartments is still "
+        "handled by the Dsolve. Needs a Dsolve to provide the diffusion "
+        "constants. Motor transport is not handled.\n"
+        "Default: False. Takes effect at reinit.",
+        &Gsolve::setUseJumpDiffusion,
+        &Gsolve::getUseJumpDiffusion
+    );
+
     static ReadOnlyLookupValueFinfo<
     Gsolve, unsigned int, vector< unsigned int > > numFire(
         "numFire",
@@ -216,6 +274,10 @@ const Cinfo* Gsolve::initCinfo()
         &useRandInit,      // Value
         &useClockedUpdate, // Value
         &numFire,          // ReadOnlyLookupValue
+        &method,           // Value
+        &epsilon,          // Value
+        &hybridThreshold,  // Value
+        &useJumpDiffusion, // Value
     };
 
     static Dinfo< Gsolve > dinfo;
@@ -231,6 +293,7 @@ const Cinfo* Gsolve::initCinfo()
 }
 
 static const Cinfo* gsolveCinfo = Gsolve::initCinfo();
+static CheckpointHandler< Gsolve > gsolveCheckpoint( "Gsolve" );
 
 //////////////////////////////////////////////////////////////
 // Class definitions
@@ -243,7 +306,8 @@ Gsolve::Gsolve() :
     dsolve_(),
     dsolvePtr_(nullptr),
     useClockedUpdate_( false ),
-	rngSeedOffset_( 1031 )
+	rngSeedOffset_( 1031 ),
+    useJumpDiffusion_( false )
 {
     // Initialize with global seed.
     rng_.setSeed(moose::getGlobalSeed());
@@ -393,6 +457,74 @@ void Gsolve::setRngSeedOffset( int val )
     rngSeedOffset_ = val;
 }
 
+string Gsolve::getMethod() const
+{
+    switch ( sys_.method )
+    {
+    case GssaSystem::TAULEAP:
+        return "tauleap";
+    case GssaSystem::HYBRID:
+        return "hybrid";
+    default:
+        return "gssa";
+    }
+}
+
+void Gsolve::setMethod( string method )
+{
+    std::transform( method.begin(), method.end(), method.begin(), ::tolower );
+    if ( method == "gssa" || method == "gillespie" )
+    {
+        sys_.method = GssaSystem::GSSA;
+    }
+    else if ( method == "tauleap" )
+    {
+        sys_.method = GssaSystem::TAULEAP;
+    }
+    else if ( method == "hybrid" )
+    {
+        sys_.method = GssaSystem::HYBRID;
+    }
+    else
+    {
+        cout << "Warning: Gsolve::setMethod: '" << method <<
+             "' not known, using gssa\n";
+        sys_.method = GssaSystem::GSSA;
+    }
+}
+
+double Gsolve::getEpsilon() const
+{
+    return sys_.epsilon;
+}
+
+void Gsolve::setEpsilon( double val )
+{
+    if ( val <= 0.0 || val >= 1.0 )
+    {
+        cout << "Warning: Gsolve::setEpsilon: " << val <<
+             " out of range (0, 1), ignored\n";
+        return;
+    }
+    sys_.epsilon = val;
+}
+
+double Gsolve::getHybridThreshold() const
+{
+    return sys_.hybridThreshold;
+}
+
+void Gsolve::setHybridThreshold( double val )
+{
+    if ( val <= 0.0 )
+    {
+        cout << "Warning: Gsolve::setHybridThreshold: " << val <<
+             " must be positive, ignored\n";
+        return;
+    }
+    sys_.hybridThreshold = val;
+}
+
 bool Gsolve::getClockedUpdate() const
 {
     return useClockedUpdate_;
@@ -403,6 +535,16 @@ void Gsolve::setClockedUpdate( bool val )
     useClockedUpdate_ = val;
 }
 
+bool Gsolve::getUseJumpDiffusion() const
+{
+    return useJumpDiffusion_;
+}
+
+void Gsolve::setUseJumpDiffusion( bool val )
+{
+    useJumpDiffusion_ = val;
+}
+
 
 //////////////////////////////////////////////////////////////
 // Process operations.
@@ -415,6 +557,21 @@ void Gsolve::process( const Eref& e, ProcPtr p )
 
     // First, handle incoming diffusion values. Note potential for
     // issues with roundoff if diffusion is not integral.
+    if ( dsolvePtr_ && useJumpDiffusion_ )
+    {
+        // Only the voxels at junctions can have changed in the Dsolve,
+        // and all values elsewhere are already integral.
+        unsigned int numPools = stoichPtr_->getNumVarPools();
+        vector< double > jnValues;
+        dsolvePtr_->getVoxels( jnVoxels_, 0, numPools, jnValues );
+        dsolvePtr_->setPrev();
+        for ( auto i = jnValues.begin(); i != jnValues.end(); ++i )
+            *i = approximateWithInteger( *i, rng_ );
+        advanceNsm( p, jnValues );
+        sendJunctionVoxelsToDsolve( p->dt );
+        return;
+    }
+
     if ( dsolvePtr_ )
     {
         vector< double > dvalues( 4 );
@@ -543,20 +700,182 @@ void Gsolve::process( const Eref& e, ProcPtr p )
 
     // Finally, assemble and send the integrated values off for the Dsolve.
     if ( dsolvePtr_ )
+        sendBlockToDsolve( p->dt );
+}
+
+void Gsolve::sendBlockToDsolve( double dt )
+{
+    vector< double > kvalues( 4 );
+    kvalues[0] = 0;
+    kvalues[1] = getNumLocalVoxels();
+    kvalues[2] = 0;
+    kvalues[3] = stoichPtr_->getNumVarPools();
+    getBlock( kvalues );
+    dsolvePtr_->setBlock( kvalues );
+
+    // Now use the values in the Dsolve to update junction fluxes
+    // for diffusion, channels, and xreacs
+    dsolvePtr_->updateJunctions( dt );
+    // Here the Gsolve may need to do something to convert to integers
+}
+
+void Gsolve::sendJunctionVoxelsToDsolve( double dt )
+{
+    unsigned int numPools = stoichPtr_->getNumVarPools();
+    vector< double > values( numPools * jnVoxels_.size() );
+    auto v = values.begin();
+    for ( unsigned int j = 0; j < numPools; ++j )
+        for ( auto i = jnVoxels_.cbegin(); i != jnVoxels_.cend(); ++i )
+            *v++ = pools_[ *i ].S()[ j ];
+    dsolvePtr_->setVoxels( jnVoxels_, 0, numPools, values );
+    dsolvePtr_->updateJunctions( dt );
+}
+
+/**
+ * The incoming values from the Dsolve are what we sent last time plus
+ * any flux through junctions and channels, so only the voxels at
+ * junctions change. Those get their propensities refreshed and their
+ * pending events rescaled. All other pending events remain valid.
+ */
+void Gsolve::advanceNsm( ProcPtr p, const vector< double >& jnValues )
+{
+    double t0 = p->currTime - p->dt;
+    unsigned int numJn = jnVoxels_.size();
+    unsigned int numPools = stoichPtr_->getNumVarPools();
+    auto refresh = [&]( unsigned int v ) {
+        pools_[v].setTime( t0 );
+        pools_[v].refreshAtot( &sys_ );
+        diffAtot_[v] = calcDiffAtot( v );
+        rescheduleVoxel( v, t0 );
+    };
+    for ( unsigned int k = 0; k < numJn; ++k )
+    {
+        double* s = pools_[ jnVoxels_[k] ].varS();
+        bool changed = false;
+        for ( unsigned int j = 0; j < numPools; ++j )
+        {
+            double x = jnValues[ j * numJn + k ];
+            if ( x != s[j] )
+            {
+                s[j] = x;
+                changed = true;
+            }
+        }
+        if ( changed && !useClockedUpdate_ )
+            refresh( jnVoxels_[k] );
+    }
+    if ( useClockedUpdate_ )
+        for ( unsigned int i = 0; i < pools_.size(); ++i )
+            refresh( i );
+
+    double nextt = p->currTime;
+    while ( nsmQueue_.topTime() < nextt )
+    {
+        unsigned int v = nsmQueue_.top();
+        double t = nsmQueue_.topTime();
+        double atot = pools_[v].getAtot() + diffAtot_[v];
+        if ( rng_.uniform() * atot < diffAtot_[v] )
+            fireJump( v, t );
+        else
+            pools_[v].fireReacAt( t, &sys_ );
+        // A reaction may change diffusing pools too.
+        diffAtot_[v] = calcDiffAtot( v );
+        scheduleVoxel( v, t );
+    }
+
+    if ( stoichPtr_->getNumFuncs() > 0 )
+    {
+        for ( auto i = pools_.begin(); i != pools_.end(); ++i )
+        {
+            i->setTime( nextt );
+            stoichPtr_->updateFuncs( i->varS(), nextt );
+        }
+    }
+}
+
+void Gsolve::fireJump( unsigned int voxel, double t )
+{
+    double* s = pools_[voxel].varS();
+    double r = rng_.uniform() * diffAtot_[voxel] / jumpTotal_[voxel];
+    unsigned int pool = ~0U;
+    for ( auto i = diffPools_.begin(); i != diffPools_.end(); ++i )
+    {
+        if ( s[*i] >= 1.0 )
+        {
+            pool = *i;
+            r -= poolDiffConst_[ *i ] * s[ *i ];
+            if ( r < 0.0 )
+                break;
+        }
+    }
+    if ( pool == ~0U ) // Roundoff left us with nothing to move.
+        return;
+
+    double q = rng_.uniform() * jumpTotal_[voxel];
+    unsigned int k = jumpStart_[voxel];
+    for ( ; k + 1 < jumpStart_[voxel + 1]; ++k )
+    {
+        q -= jumpScale_[k];
+        if ( q < 0.0 )
+            break;
+    }
+    unsigned int target = jumpTarget_[k];
+
+    s[pool] -= 1.0;
+    pools_[target].varS()[pool] += 1.0;
+    pools_[voxel].updatePoolDependents( pool, t, &sys_ );
+    pools_[target].updatePoolDependents( pool, t, &sys_ );
+    diffAtot_[target] = calcDiffAtot( target );
+    rescheduleVoxel( target, t );
+}
+
+double Gsolve::calcDiffAtot( unsigned int voxel ) const
+{
+    if ( jumpTotal_[voxel] <= 0.0 )
+        return 0.0;
+    const double* s = pools_[voxel].S();
+    double ret = 0.0;
+    for ( auto i = diffPools_.begin(); i != diffPools_.end(); ++i )
+        if ( s[*i] > 0.0 )
+            ret += poolDiffConst_[ *i ] * s[ *i ];
+    return ret * jumpTotal_[voxel];
+}
+
+void Gsolve::scheduleVoxel( unsigned int voxel, double t )
+{
+    double atot = pools_[voxel].getAtot() + diffAtot_[voxel];
+    nsmAtot_[voxel] = atot;
+    if ( atot <= 0.0 )
     {
-        vector< double > kvalues( 4 );
-        kvalues[0] = 0;
-        kvalues[1] = getNumLocalVoxels();
-        kvalues[2] = 0;
-        kvalues[3] = stoichPtr_->getNumVarPools();
-        getBlock( kvalues );
-        dsolvePtr_->setBlock( kvalues );
-
-        // Now use the values in the Dsolve to update junction fluxes
-        // for diffusion, channels, and xreacs
-        dsolvePtr_->updateJunctions( p->dt );
-        // Here the Gsolve may need to do something to convert to integers
+        nsmQueue_.update( voxel, numeric_limits< double >::infinity() );
+        return;
     }
+    double r = rng_.uniform();
+    while ( r <= 0.0 )
+        r = rng_.uniform();
+    nsmQueue_.update( voxel, t - log( r ) / atot );
+}
+
+/**
+ * Reuses the pending random number of a voxel whose propensity has
+ * been changed by an event elsewhere (Gibson and Bruck 2000), so we
+ * need no new draw.
+ */
+void Gsolve::rescheduleVoxel( unsigned int voxel, double t )
+{
+    double oldAtot = nsmAtot_[voxel];
+    double oldTime = nsmQueue_.time( voxel );
+    if ( oldAtot <= 0.0 || oldTime == numeric_limits< double >::infinity() )
+    {
+        scheduleVoxel( voxel, t );
+        return;
+    }
+    double atot = pools_[voxel].getAtot() + diffAtot_[voxel];
+    nsmAtot_[voxel] = atot;
+    if ( atot <= 0.0 )
+        nsmQueue_.update( voxel, numeric_limits< double >::infinity() );
+    else
+        nsmQueue_.update( voxel, t + ( oldAtot / atot ) * ( oldTime - t ) );
 }
 
 size_t Gsolve::recalcTimeChunk( const size_t begin, const size_t end, ProcPtr p)
@@ -600,6 +919,21 @@ void Gsolve::reinit( const Eref& e, ProcPtr p )
     for ( auto i = pools_.begin(); i != pools_.end(); ++i )
         i->refreshAtot( &sys_ );
 
+    if ( dsolvePtr_ )
+        dsolvePtr_->setJumpDiffusion( useJumpDiffusion_ );
+    if ( useJumpDiffusion_ && dsolvePtr_ )
+    {
+        buildJumpTable();
+        dsolvePtr_->getJunctionVoxels( jnVoxels_ );
+        nsmQueue_.build( vector< double >( pools_.size(),
+                    numeric_limits< double >::infinity() ) );
+        for ( unsigned int i = 0; i < pools_.size(); ++i )
+        {
+            diffAtot_[i] = calcDiffAtot( i );
+            scheduleVoxel( i, p->currTime );
+        }
+    }
+
 
     // LoadBalancing. Recompute the optimal number of threads.
     size_t nvPools = pools_.size( );
@@ -614,6 +948,43 @@ void Gsolve::reinit( const Eref& e, ProcPtr p )
 
 }
 
+//////////////////////////////////////////////////////////////
+// Checkpoints
+//////////////////////////////////////////////////////////////
+/**
+ * Besides the molecule counts, each voxel keeps its reaction
+ * velocities, time of the last event and random number state, and the
+ * solver has those of jump diffusion. With all of them the run continues
+ * along the same trajectory.
+ */
+void Gsolve::saveState( CheckpointWriter& w ) const
+{
+    for ( unsigned int i = 0; i < pools_.size(); ++i )
+        pools_[i].saveState( w, "voxel" + to_string( i ) + "." );
+    w.addString( "rng", rng_.getState() );
+    if ( useJumpDiffusion_ )
+    {
+        w.add( "diffAtot", diffAtot_ );
+        w.add( "nsmAtot", nsmAtot_ );
+        nsmQueue_.saveState( w, "nsmQueue." );
+    }
+}
+
+void Gsolve::loadState( CheckpointReader& r )
+{
+    for ( unsigned int i = 0; i < pools_.size(); ++i )
+        pools_[i].loadState( r, "voxel" + to_string( i ) + "." );
+    string rng;
+    if ( r.getString( "rng", rng ) )
+        rng_.setState( rng );
+    if ( useJumpDiffusion_ )
+    {
+        r.get( "diffAtot", diffAtot_.data(), diffAtot_.size() );
+        r.get( "nsmAtot", nsmAtot_.data(), nsmAtot_.size() );
+        nsmQueue_.loadState( r, "nsmQueue." );
+    }
+}
+
 //////////////////////////////////////////////////////////////
 // init operations.
 //////////////////////////////////////////////////////////////
@@ -648,6 +1019,8 @@ void Gsolve::rebuildGssaSystem()
     fillPoolFuncDep();
     fillIncrementFuncDep();
     makeReacDepsUnique();
+    fillReactantOrders();
+    fillRatesDependentOnPool();
     for ( vector< GssaVoxelPools >::iterator
             i = pools_.begin(); i != pools_.end(); ++i )
     {
@@ -883,6 +1256,150 @@ void Gsolve::fillMathDep()
 }
 */
 
+/**
+ * Fills in the reactant lists and reaction orders used by tau-leaping.
+ * For each reaction we store the variable pools it consumes along with
+ * how many molecules of each it consumes. For each variable pool we
+ * store the highest order of any reaction in which it is a reactant,
+ * and its multiplicity in that reaction. These give the g_i term in
+ * the Cao-Gillespie-Petzold tau selection.
+ */
+void Gsolve::fillReactantOrders()
+{
+    unsigned int numRates = stoichPtr_->getNumRates();
+    unsigned int numVar = stoichPtr_->getNumVarPools() +
+                          stoichPtr_->getNumProxyPools();
+    sys_.reactants.assign( numRates,
+                           vector< pair< unsigned int, unsigned int > >() );
+    sys_.highestOrder.assign( numVar, 0 );
+    sys_.highestOrderMultiplicity.assign( numVar, 0 );
+    for ( unsigned int i = 0; i < numRates; ++i )
+    {
+        vector< unsigned int > molIndex;
+        unsigned int order = stoichPtr_->rates( i )->getReactants( molIndex );
+        map< unsigned int, unsigned int > count;
+        for ( auto j = molIndex.begin(); j != molIndex.end(); ++j )
+            count[ *j ]++;
+        for ( auto j = count.begin(); j != count.end(); ++j )
+        {
+            if ( j->first >= numVar )
+                continue; // Buffered pools are never exhausted.
+            sys_.reactants[i].push_back( *j );
+            unsigned int& hor = sys_.highestOrder[ j->first ];
+            unsigned int& mult = sys_.highestOrderMultiplicity[ j->first ];
+            if ( order > hor || ( order == hor && j->second > mult ) )
+            {
+                hor = order;
+                mult = j->second;
+            }
+        }
+    }
+}
+
+/**
+ * Fills in the reactions whose rates depend on each pool, so that a
+ * diffusion jump only has to update the rates of its pool. Pools that
+ * are arguments to Functions are flagged instead, since the function
+ * output may feed into any rate.
+ */
+void Gsolve::fillRatesDependentOnPool()
+{
+    unsigned int numAllPools = stoichPtr_->getNumAllPools();
+    sys_.ratesDependentOnPool.assign( numAllPools, vector< unsigned int >() );
+    sys_.isFuncInput.assign( numAllPools, false );
+    for ( unsigned int i = 0; i < stoichPtr_->getNumRates(); ++i )
+    {
+        const RateTerm* rt = stoichPtr_->rates( i );
+        vector< unsigned int > molIndex;
+        rt->getReactants( molIndex );
+        const FuncRate* fr = dynamic_cast< const FuncRate* >( rt );
+        if ( fr )
+        {
+            const vector< unsigned int >& args =
+                const_cast< FuncRate* >( fr )->getFuncArgIndex();
+            molIndex.insert( molIndex.end(), args.begin(), args.end() );
+        }
+        sort( molIndex.begin(), molIndex.end() );
+        molIndex.erase( unique( molIndex.begin(), molIndex.end() ),
+                        molIndex.end() );
+        for ( auto j = molIndex.begin(); j != molIndex.end(); ++j )
+            if ( *j < numAllPools )
+                sys_.ratesDependentOnPool[ *j ].push_back( i );
+    }
+    for ( unsigned int i = 0; i < stoichPtr_->getNumFuncs(); ++i )
+    {
+        vector< unsigned int > args = stoichPtr_->funcs( i )->getReactantIndex();
+        for ( auto j = args.begin(); j != args.end(); ++j )
+            if ( *j < numAllPools )
+                sys_.isFuncInput[ *j ] = true;
+    }
+}
+
+/**
+ * The rate per molecule of a jump from voxel k to its neighbour i is
+ * diffConst * ( area[i] + area[k] ) / ( length[i] + length[k] ) / vol[k],
+ * which is the same term used by the Dsolve for the implicit
+ * diffusion matrix. Neighbours are the parent and child voxels.
+ */
+void Gsolve::buildJumpTable()
+{
+    unsigned int numVoxels = pools_.size();
+    unsigned int numVarPools = stoichPtr_->getNumVarPools();
+    poolDiffConst_.assign( numVarPools, 0.0 );
+    diffPools_.clear();
+    for ( unsigned int i = 0; i < numVarPools; ++i )
+    {
+        poolDiffConst_[i] = dsolvePtr_->getPoolDiffConst( i );
+        if ( poolDiffConst_[i] > 0.0 )
+            diffPools_.push_back( i );
+    }
+    jumpStart_.assign( numVoxels + 1, 0 );
+    jumpTarget_.clear();
+    jumpScale_.clear();
+    jumpTotal_.assign( numVoxels, 0.0 );
+    diffAtot_.assign( numVoxels, 0.0 );
+    nsmAtot_.assign( numVoxels, 0.0 );
+
+    const MeshCompt* m = reinterpret_cast< const MeshCompt* >(
+            compartment_.eref().data() );
+    vector< unsigned int > parent = m->getParentVoxel();
+    vector< double > vol = m->getVoxelVolume();
+    const vector< double >& area = m->getVoxelArea();
+    const vector< double >& length = m->getVoxelLength();
+    if ( parent.size() != numVoxels || vol.size() != numVoxels ||
+            area.size() != numVoxels || length.size() != numVoxels )
+    {
+        cout << "Warning: Gsolve::buildJumpTable: mesh on '" <<
+             compartment_.path() << "' does not match the " << numVoxels <<
+             " voxels of the solver. No diffusion jumps.\n";
+        return;
+    }
+
+    vector< vector< unsigned int > > nbrs( numVoxels );
+    for ( unsigned int i = 0; i < numVoxels; ++i )
+    {
+        if ( parent[i] != ~0U && parent[i] < numVoxels )
+        {
+            nbrs[i].push_back( parent[i] );
+            nbrs[ parent[i] ].push_back( i );
+        }
+    }
+    for ( unsigned int k = 0; k < numVoxels; ++k )
+    {
+        jumpStart_[k] = jumpTarget_.size();
+        for ( auto j = nbrs[k].begin(); j != nbrs[k].end(); ++j )
+        {
+            unsigned int i = *j;
+            double scale = ( area[i] + area[k] ) /
+                           ( length[i] + length[k] ) / vol[k];
+            jumpTarget_.push_back( i );
+            jumpScale_.push_back( scale );
+            jumpTotal_[k] += scale;
+        }
+    }
+    jumpStart_[numVoxels] = jumpTarget_.size();
+}
+
 /**
  * Inserts reactions that depend on molecules modified by the
  * specified MathExpn, into the dependency list.
@@ -11,8 +11,11 @@
 #define _GSOLVE_H
 
 #include "../randnum/RNG.h"
+#include "VoxelEventQueue.h"
 
 class Stoich;
+class CheckpointWriter;
+class CheckpointReader;
 
 class Gsolve: public KsolveBase
 {
@@ -77,6 +80,43 @@ public:
     void fillIncrementFuncDep();
     void insertMathDepReacs(unsigned int mathDepIndex, unsigned int firedReac);
     void makeReacDepsUnique();
+    void fillReactantOrders();
+    void fillRatesDependentOnPool();
+
+    /**
+     * Builds the table of diffusion jumps between neighbouring voxels
+     * for the next-subvolume method. Uses the same geometry terms as
+     * the Dsolve, so the mean behaviour matches deterministic
+     * diffusion.
+     */
+    void buildJumpTable();
+
+    /// Diffusion propensity of the specified voxel.
+    double calcDiffAtot( unsigned int voxel ) const;
+
+    /// Draws a fresh event time for a voxel and puts it on the queue.
+    void scheduleVoxel( unsigned int voxel, double t );
+
+    /// Rescales the pending event time after a propensity change.
+    void rescheduleVoxel( unsigned int voxel, double t );
+
+    /// Moves one molecule of a diffusing pool out of the voxel.
+    void fireJump( unsigned int voxel, double t );
+
+    /**
+     * Next-subvolume method (Elf and Ehrenberg 2004). Reaction and
+     * diffusion events across all voxels are handled by a single
+     * priority queue of per-voxel event times, so only the voxels
+     * touched by an event are updated. jnValues come from the Dsolve,
+     * for the voxels in jnVoxels_.
+     */
+    void advanceNsm( ProcPtr p, const vector< double >& jnValues );
+
+    /// Sends values to the Dsolve and has it update the junctions.
+    void sendBlockToDsolve( double dt );
+
+    /// Like sendBlockToDsolve, but only for the voxels in jnVoxels_.
+    void sendJunctionVoxelsToDsolve( double dt );
 
     //////////////////////////////////////////////////////////////////
     // Solver interface functions
@@ -134,9 +174,30 @@ public:
     /// Flag: set true if randomized round to integers is to be done.
     void setClockedUpdate( bool val );
 
+    /// Stochastic method: "gssa", "tauleap" or "hybrid".
+    string getMethod() const;
+    void setMethod( string method );
+
+    /// Error control parameter for tauleap and hybrid methods.
+    double getEpsilon() const;
+    void setEpsilon( double val );
+
+    /// Threshold for treating a reaction as fast in hybrid method.
+    double getHybridThreshold() const;
+    void setHybridThreshold( double val );
+
+    /// Flag: true if diffusion is done by stochastic jumps.
+    bool getUseJumpDiffusion() const;
+    void setUseJumpDiffusion( bool val );
+
     unsigned int getNumThreads( ) const;
     void setNumThreads( unsigned int x );
 
+    //////////////////////////////////////////////////////////////////
+    // Checkpoint support, see shell/Checkpoint.h
+    void saveState( CheckpointWriter& w ) const;
+    void loadState( CheckpointReader& r );
+
     //////////////////////////////////////////////////////////////////
     static const Cinfo* initCinfo();
 private:
@@ -181,6 +242,44 @@ private:
 
 	/// Offset * voxIdx is added to rng seed for each voxel to get indept.
 	int rngSeedOffset_;
+
+    /// Flag: True if diffusion within the compt uses jumps, not Dsolve.
+    bool useJumpDiffusion_;
+
+    /// Diffusion constant of each variable pool, from the Dsolve.
+    vector< double > poolDiffConst_;
+
+    /// Variable pools with nonzero diffusion constant.
+    vector< unsigned int > diffPools_;
+
+    /**
+     * Jump table in compressed row form. The neighbours of voxel v
+     * are jumpTarget_[ jumpStart_[v] ] to jumpTarget_[ jumpStart_[v+1] - 1 ]
+     * and jumpScale_ holds the geometry term of each jump, such that
+     * the rate per molecule is diffConst * jumpScale.
+     */
+    vector< unsigned int > jumpStart_;
+    vector< unsigned int > jumpTarget_;
+    vector< double > jumpScale_;
+
+    /// Sum of jumpScale_ over the neighbours of each voxel.
+    vector< double > jumpTotal_;
+
+    /// Diffusion propensity of each voxel.
+    vector< double > diffAtot_;
+
+    /// Total propensity of each voxel when its event was scheduled.
+    vector< double > nsmAtot_;
+
+    /// Queue of next event times, one per voxel.
+    VoxelEventQueue nsmQueue_;
+
+    /**
+     * Voxels at junctions or ConcChans of the Dsolve. With jump
+     * diffusion only these are exchanged with the Dsolve, the others
+     * are owned by the Gsolve alone.
+     */
+    vector< unsigned int > jnVoxels_;
 };
 
 #endif	// _GSOLVE_H
@@ -24,8 +24,16 @@ public:
     {;}
     vector< vector< unsigned int > > dependency;
     vector< vector< unsigned int > > dependentMathExpn;
+    /// Reactions whose rates depend on each pool. Indexed by pool.
     vector< vector< unsigned int > > ratesDependentOnPool;
 
+    /**
+     * Flag for each pool, true if it is an argument to a Function.
+     * A change in such a pool may change any rate, so it needs a full
+     * refresh rather than an update of ratesDependentOnPool.
+     */
+    vector< bool > isFuncInput;
+
     /// Transpose of stoichiometry matrix.
     KinSparseMatrix transposeN;
     Stoich* stoich;
@@ -53,6 +61,52 @@ public:
      * the sum of molecules is does not differ more than 1.0 molecules.
      */
     bool honorMassConservation = true;
+
+    /**
+     * Integration method. GSSA is the exact Gillespie SSA,
+     * TAULEAP fires many reactions per leap using the Cao-Gillespie
+     * step selection, and HYBRID integrates fast, high copy-number
+     * reactions deterministically while the rest are fired exactly.
+     * Parsed from the method string by Gsolve::setMethod.
+     */
+    enum Method { GSSA, TAULEAP, HYBRID };
+    Method method = GSSA;
+
+    /**
+     * Error control parameter for tau-leaping: the relative change
+     * in propensities allowed during a single leap. Also bounds the
+     * relative change per substep of the deterministic part in
+     * hybrid mode.
+     */
+    double epsilon = 0.03;
+
+    /**
+     * A reaction that is fewer than this many firings away from
+     * exhausting one of its reactants is critical: it is never leaped
+     * over but fired one event at a time.
+     */
+    unsigned int numCritical = 10;
+
+    /**
+     * In hybrid mode a reaction is fast, and handled deterministically,
+     * when its expected number of firings in a timestep and the
+     * copy number of every reactant are both above this threshold.
+     */
+    double hybridThreshold = 100.0;
+
+    /**
+     * Variable pools consumed by each reaction, paired with the number
+     * of molecules consumed. Indexed by reaction.
+     */
+    vector< vector< pair< unsigned int, unsigned int > > > reactants;
+
+    /**
+     * Highest order of any reaction in which each variable pool is a
+     * reactant, and the number of molecules of the pool used in that
+     * reaction. Used for the g_i term of the tau selection.
+     */
+    vector< unsigned int > highestOrder;
+    vector< unsigned int > highestOrderMultiplicity;
 };
 
 #endif	// _GSSA_SYSTEM_H
@@ -20,6 +20,7 @@
 #include "Stoich.h"
 #include "GssaSystem.h"
 #include "GssaVoxelPools.h"
+#include "../shell/Checkpoint.h"
 
 /**
  * The SAFETY_FACTOR Protects against the total propensity exceeding
@@ -86,6 +87,9 @@ void GssaVoxelPools::updateDependentRates(
 {
     for ( auto i = deps.cbegin(); i != deps.end(); ++i )
     {
+        // Fast reacs in hybrid mode are integrated deterministically.
+        if ( !isFast_.empty() && isFast_[ *i ] )
+            continue;
         atot_ -= fabs( v_[ *i ] );
         atot_ += fabs( v_[ *i ] = getReacVelocity( *i, S() ) );
     }
@@ -131,6 +135,9 @@ bool GssaVoxelPools::refreshAtot( const GssaSystem* g )
 {
     g->stoich->updateFuncs( varS(), t_ );
     updateReacVelocities( g, S(), v_ );
+    for ( unsigned int i = 0; i < isFast_.size(); ++i )
+        if ( isFast_[i] )
+            v_[i] = 0.0;
     atot_ = 0;
     for ( auto i = v_.cbegin(); i != v_.cend(); ++i )
         atot_ += fabs(*i);
@@ -160,6 +167,89 @@ void GssaVoxelPools::recalcTime( const GssaSystem* g, double currTime )
 }
 
 void GssaVoxelPools::advance( const ProcInfo* p, const GssaSystem* g )
+{
+    switch ( g->method )
+    {
+    case GssaSystem::TAULEAP:
+        advanceTauLeap( p, g );
+        break;
+    case GssaSystem::HYBRID:
+        advanceHybrid( p, g );
+        break;
+    default:
+        advanceSSA( p, g );
+    }
+}
+
+unsigned int GssaVoxelPools::pickReacSafe( const GssaSystem* g )
+{
+    unsigned int rindex = pickReac();
+    assert( g->stoich->getNumRates() == v_.size() );
+    if ( rindex >= g->stoich->getNumRates() )
+    {
+        // probably cumulative roundoff error here.
+        // Recalculate atot to avoid, and redo.
+        if ( !refreshAtot( g ) )   // Stuck state.
+            return ~0U;
+        // We had a roundoff error, fixed it, but now need to be sure
+        // we only fire a reaction where this is permissible.
+        for ( unsigned int i = v_.size(); i > 0; --i )
+        {
+            if ( fabs( v_[i-1] ) > 0.0 )
+            {
+                rindex = i - 1;
+                break;
+            }
+        }
+        assert( rindex < v_.size() );
+    }
+    return rindex;
+}
+
+void GssaVoxelPools::fireOne( unsigned int rindex, const GssaSystem* g )
+{
+    double sign = std::copysign( 1, v_[rindex] );
+
+    g->transposeN.fireReac( rindex, Svec(), sign );
+    numFire_[rindex]++;
+
+    // Only reacs that change a Function input need the funcs updated.
+    if ( !g->dependentMathExpn[ rindex ].empty() )
+        g->stoich->updateFuncs( varS(), t_ );
+    updateDependentRates( g->dependency[ rindex ], g->stoich );
+}
+
+double GssaVoxelPools::getAtot() const
+{
+    return atot_;
+}
+
+void GssaVoxelPools::setTime( double t )
+{
+    t_ = t;
+}
+
+bool GssaVoxelPools::fireReacAt( double t, const GssaSystem* g )
+{
+    t_ = t;
+    unsigned int rindex = pickReacSafe( g );
+    if ( rindex == ~0U )
+        return false;
+    fireOne( rindex, g );
+    return true;
+}
+
+void GssaVoxelPools::updatePoolDependents( unsigned int pool, double t,
+        const GssaSystem* g )
+{
+    t_ = t;
+    if ( g->isFuncInput[ pool ] )
+        refreshAtot( g );
+    else
+        updateDependentRates( g->ratesDependentOnPool[ pool ], g->stoich );
+}
+
+void GssaVoxelPools::advanceSSA( const ProcInfo* p, const GssaSystem* g )
 {
     double nextt = p->currTime;
     while ( t_ < nextt )
@@ -170,44 +260,319 @@ void GssaVoxelPools::advance( const ProcInfo* p, const GssaSystem* g )
             g->stoich->updateFuncs( varS(), t_ );
             return;
         }
-        unsigned int rindex = pickReac();
-        assert( g->stoich->getNumRates() == v_.size() );
-        if ( rindex >= g->stoich->getNumRates() )
+        unsigned int rindex = pickReacSafe( g );
+        if ( rindex == ~0U )
         {
-            // probably cumulative roundoff error here.
-            // Recalculate atot to avoid, and redo.
-            if ( !refreshAtot( g ) )   // Stuck state.
+            t_ = nextt;
+            g->stoich->updateFuncs( varS(), t_ );
+            return;
+        }
+
+        double r = rng_.uniform();
+        while ( r <= 0.0 )
+            r = rng_.uniform();
+
+        t_ -= ( 1.0 / atot_ ) * log( r );
+        fireOne( rindex, g );
+    }
+    // Time-dependent funcs and those untouched by the fired reacs.
+    g->stoich->updateFuncs( varS(), t_ );
+}
+
+unsigned int GssaVoxelPools::fireExact( double nextt, const GssaSystem* g,
+        unsigned int maxSteps )
+{
+    unsigned int numSteps = 0;
+    while ( numSteps < maxSteps )
+    {
+        if ( atot_ <= 0.0 )
+        {
+            t_ = nextt;
+            break;
+        }
+        double r = rng_.uniform();
+        while ( r <= 0.0 )
+            r = rng_.uniform();
+        double tnext = t_ - ( 1.0 / atot_ ) * log( r );
+        // The process is memoryless, so an event beyond the end of the
+        // step can be discarded and resampled on the next step.
+        if ( tnext >= nextt )
+        {
+            t_ = nextt;
+            break;
+        }
+        t_ = tnext;
+        unsigned int rindex = pickReacSafe( g );
+        if ( rindex == ~0U )
+        {
+            t_ = nextt;
+            break;
+        }
+        fireOne( rindex, g );
+        ++numSteps;
+    }
+    return numSteps;
+}
+
+double GssaVoxelPools::maxFirings( unsigned int r, const GssaSystem* g ) const
+{
+    const double* s = S();
+    double ret = numeric_limits< double >::max();
+    for ( auto i = g->reactants[r].cbegin(); i != g->reactants[r].cend(); ++i )
+        ret = min( ret, floor( s[ i->first ] / i->second ) );
+    return ret;
+}
+
+double GssaVoxelPools::selectTau( const GssaSystem* g,
+        const vector< bool >& isCritical ) const
+{
+    const double* s = S();
+    unsigned int numVar = g->highestOrder.size();
+    vector< double > mu( numVar, 0.0 );
+    vector< double > sigma2( numVar, 0.0 );
+    for ( unsigned int j = 0; j < v_.size(); ++j )
+    {
+        if ( isCritical[j] || v_[j] == 0.0 )
+            continue;
+        const int* entry;
+        const unsigned int* colIndex;
+        unsigned int numInRow = g->transposeN.getRow( j, &entry, &colIndex );
+        for ( unsigned int k = 0; k < numInRow; ++k )
+        {
+            if ( colIndex[k] >= numVar )
+                continue;
+            double nu = entry[k] * std::copysign( 1, v_[j] );
+            mu[ colIndex[k] ] += nu * fabs( v_[j] );
+            sigma2[ colIndex[k] ] += nu * nu * fabs( v_[j] );
+        }
+    }
+
+    double tau = numeric_limits< double >::max();
+    for ( unsigned int i = 0; i < numVar; ++i )
+    {
+        unsigned int hor = g->highestOrder[i];
+        if ( hor == 0 ) // Not a reactant of any reac.
+            continue;
+        double x = s[i];
+        // g_i, as in Cao et al. 2006, eqn 27.
+        double gi = hor;
+        unsigned int mult = g->highestOrderMultiplicity[i];
+        if ( hor == 2 && mult == 2 && x > 1.0 )
+            gi = 2.0 + 1.0 / ( x - 1.0 );
+        else if ( hor == 3 && mult == 2 && x > 1.0 )
+            gi = 1.5 * ( 2.0 + 1.0 / ( x - 1.0 ) );
+        else if ( hor == 3 && mult == 3 && x > 2.0 )
+            gi = 3.0 + 1.0 / ( x - 1.0 ) + 2.0 / ( x - 2.0 );
+        double bound = max( g->epsilon * x / gi, 1.0 );
+        if ( mu[i] != 0.0 )
+            tau = min( tau, bound / fabs( mu[i] ) );
+        if ( sigma2[i] > 0.0 )
+            tau = min( tau, bound * bound / sigma2[i] );
+    }
+    return tau;
+}
+
+void GssaVoxelPools::advanceTauLeap( const ProcInfo* p, const GssaSystem* g )
+{
+    // If the leap is shorter than this many mean SSA intervals, do a
+    // batch of exact steps instead.
+    const double SSA_FALLBACK_INTERVALS = 10.0;
+    const unsigned int SSA_FALLBACK_STEPS = 100;
+
+    double nextt = p->currTime;
+    unsigned int numRates = v_.size();
+    unsigned int numVar = g->highestOrder.size();
+    vector< bool > isCritical( numRates, false );
+    vector< double > k( numRates, 0.0 );
+    vector< double > dS( numVar, 0.0 );
+    double* s = varS();
+
+    // Pending SSA event times are not used here.
+    t_ = max( t_, p->currTime - p->dt );
+    while ( t_ < nextt )
+    {
+        if ( !refreshAtot( g ) )
+        {
+            t_ = nextt;
+            break;
+        }
+        double a0c = 0.0;
+        for ( unsigned int j = 0; j < numRates; ++j )
+        {
+            isCritical[j] = ( v_[j] != 0.0 &&
+                    maxFirings( j, g ) < g->numCritical );
+            if ( isCritical[j] )
+                a0c += fabs( v_[j] );
+        }
+        double tau1 = selectTau( g, isCritical );
+        if ( tau1 < SSA_FALLBACK_INTERVALS / atot_ )
+        {
+            fireExact( nextt, g, SSA_FALLBACK_STEPS );
+            continue;
+        }
+
+        double remaining = nextt - t_;
+        double tau = 0.0;
+        while ( true )
+        {
+            double tau2 = numeric_limits< double >::max();
+            if ( a0c > 0.0 )
+            {
+                double r = rng_.uniform();
+                while ( r <= 0.0 )
+                    r = rng_.uniform();
+                tau2 = -log( r ) / a0c;
+            }
+            bool fireCritical = ( tau2 < tau1 && tau2 <= remaining );
+            tau = fireCritical ? tau2 : min( tau1, remaining );
+
+            for ( unsigned int j = 0; j < numRates; ++j )
+                k[j] = isCritical[j] ? 0.0 : rng_.poisson( fabs( v_[j] ) * tau );
+            if ( fireCritical )
+            {
+                double r = rng_.uniform() * a0c;
+                double sum = 0.0;
+                for ( unsigned int j = 0; j < numRates; ++j )
+                {
+                    if ( isCritical[j] && r < ( sum += fabs( v_[j] ) ) )
+                    {
+                        k[j] = 1.0;
+                        break;
+                    }
+                }
+            }
+
+            dS.assign( numVar, 0.0 );
+            for ( unsigned int j = 0; j < numRates; ++j )
             {
-                t_ = nextt;
-                g->stoich->updateFuncs( varS(), t_ );
-                return;
+                if ( k[j] == 0.0 )
+                    continue;
+                const int* entry;
+                const unsigned int* colIndex;
+                unsigned int numInRow =
+                    g->transposeN.getRow( j, &entry, &colIndex );
+                double signedK = k[j] * std::copysign( 1, v_[j] );
+                for ( unsigned int m = 0; m < numInRow; ++m )
+                    if ( colIndex[m] < numVar )
+                        dS[ colIndex[m] ] += entry[m] * signedK;
             }
-            // We had a roundoff error, fixed it, but now need to be sure
-            // we only fire a reaction where this is permissible.
-            for ( unsigned int i = v_.size(); i > 0; --i )
+            bool isNegative = false;
+            for ( unsigned int i = 0; i < numVar; ++i )
             {
-                if ( fabs( v_[i-1] ) > 0.0 )
+                if ( s[i] + dS[i] < 0.0 )
                 {
-                    rindex = i - 1;
+                    isNegative = true;
                     break;
                 }
             }
-            assert( rindex < v_.size() );
+            if ( !isNegative )
+                break;
+            // Leap overshot into negative counts: halve it and redraw.
+            tau1 = tau * 0.5;
         }
 
-        double sign = std::copysign( 1, v_[rindex] );
+        for ( unsigned int i = 0; i < numVar; ++i )
+            s[i] += dS[i];
+        for ( unsigned int j = 0; j < numRates; ++j )
+            numFire_[j] += static_cast< unsigned int >( k[j] );
+        t_ += tau;
+    }
+    g->stoich->updateFuncs( varS(), t_ );
+}
 
-        g->transposeN.fireReac( rindex, Svec(), sign );
-        numFire_[rindex]++;
+void GssaVoxelPools::integrateFast( const GssaSystem* g, double dt )
+{
+    const unsigned int MAX_SUBSTEPS = 10000;
+    unsigned int numVar = g->highestOrder.size();
+    unsigned int numRates = v_.size();
+
+    // Choose substeps so no fast reactant changes by more than a
+    // fraction epsilon of its value in one substep.
+    double maxRelRate = 0.0;
+    for ( unsigned int j = 0; j < numRates; ++j )
+    {
+        if ( !isFast_[j] )
+            continue;
+        double L = maxFirings( j, g );
+        if ( L > 0.0 && L < numeric_limits< double >::max() )
+            maxRelRate = max( maxRelRate, fabs( v_[j] ) / L );
+    }
+    unsigned int numSteps = static_cast< unsigned int >(
+            ceil( dt * maxRelRate / g->epsilon ) );
+    numSteps = min( max( numSteps, 1U ), MAX_SUBSTEPS );
+    double h = dt / numSteps;
+
+    vector< double > y( Svec() );
+    vector< double > tmp( y );
+    vector< double > k1( numVar ), k2( numVar ), k3( numVar ), k4( numVar );
+    auto derivs = [&]( const vector< double >& x, vector< double >& dydt ) {
+        dydt.assign( numVar, 0.0 );
+        for ( unsigned int j = 0; j < numRates; ++j )
+        {
+            if ( !isFast_[j] )
+                continue;
+            double vel = getReacVelocity( j, &x[0] );
+            const int* entry;
+            const unsigned int* colIndex;
+            unsigned int numInRow =
+                g->transposeN.getRow( j, &entry, &colIndex );
+            for ( unsigned int m = 0; m < numInRow; ++m )
+                if ( colIndex[m] < numVar )
+                    dydt[ colIndex[m] ] += entry[m] * vel;
+        }
+    };
 
-        double r = rng_.uniform();
-        while ( r <= 0.0 )
-            r = rng_.uniform();
+    for ( unsigned int step = 0; step < numSteps; ++step )
+    {
+        derivs( y, k1 );
+        for ( unsigned int i = 0; i < numVar; ++i )
+            tmp[i] = y[i] + 0.5 * h * k1[i];
+        derivs( tmp, k2 );
+        for ( unsigned int i = 0; i < numVar; ++i )
+            tmp[i] = y[i] + 0.5 * h * k2[i];
+        derivs( tmp, k3 );
+        for ( unsigned int i = 0; i < numVar; ++i )
+            tmp[i] = y[i] + h * k3[i];
+        derivs( tmp, k4 );
+        for ( unsigned int i = 0; i < numVar; ++i )
+        {
+            y[i] += h * ( k1[i] + 2.0 * k2[i] + 2.0 * k3[i] + k4[i] ) / 6.0;
+            y[i] *= ( y[i] > 0.0 );
+            tmp[i] = y[i];
+        }
+    }
+    double* s = varS();
+    for ( unsigned int i = 0; i < numVar; ++i )
+        s[i] = y[i];
+}
 
-        t_ -= ( 1.0 / atot_ ) * log( r );
-        g->stoich->updateFuncs( varS(), t_ );
-        updateDependentRates( g->dependency[ rindex ], g->stoich );
+void GssaVoxelPools::advanceHybrid( const ProcInfo* p, const GssaSystem* g )
+{
+    double nextt = p->currTime;
+    // Repartition on every step, using the full set of propensities.
+    isFast_.clear();
+    refreshAtot( g );
+    isFast_.assign( v_.size(), false );
+    bool hasFast = false;
+    for ( unsigned int j = 0; j < v_.size(); ++j )
+    {
+        if ( fabs( v_[j] ) * p->dt >= g->hybridThreshold &&
+                maxFirings( j, g ) >= g->hybridThreshold )
+        {
+            isFast_[j] = true;
+            hasFast = true;
+        }
     }
+    if ( hasFast )
+        integrateFast( g, p->dt );
+
+    // The slow reacs now see the updated fast pools.
+    t_ = p->currTime - p->dt;
+    refreshAtot( g );
+    fireExact( nextt, g, ~0U );
+    t_ = nextt;
+    isFast_.clear();
+    g->stoich->updateFuncs( varS(), t_ );
 }
 
 void GssaVoxelPools::reinit( const GssaSystem* g, int rngSeedOffset )
@@ -331,6 +696,30 @@ void GssaVoxelPools::setStoich( const Stoich* stoichPtr )
     stoichPtr_ = stoichPtr;
 }
 
+void GssaVoxelPools::saveState( CheckpointWriter& w,
+                                const string& prefix ) const
+{
+    const double* s = S();
+    w.add( prefix + "S", s, size() * sizeof( double ) );
+    w.addValue( prefix + "t", t_ );
+    w.addValue( prefix + "atot", atot_ );
+    w.add( prefix + "v", v_ );
+    w.add( prefix + "numFire", numFire_ );
+    w.addString( prefix + "rng", rng_.getState() );
+}
+
+void GssaVoxelPools::loadState( CheckpointReader& r, const string& prefix )
+{
+    r.get( prefix + "S", varS(), size() );
+    r.getValue( prefix + "t", t_ );
+    r.getValue( prefix + "atot", atot_ );
+    r.get( prefix + "v", v_.data(), v_.size() );
+    r.get( prefix + "numFire", numFire_.data(), numFire_.size() );
+    string rng;
+    if ( r.getString( prefix + "rng", rng ) )
+        rng_.setState( rng );
+}
+
 // Handle volume updates. Inherited virtual func.
 void GssaVoxelPools::setVolumeAndDependencies( double vol )
 {
@@ -13,6 +13,8 @@
 #include "../randnum/RNG.h"
 
 class Stoich;
+class CheckpointWriter;
+class CheckpointReader;
 
 class GssaVoxelPools: public VoxelPoolsBase
 {
@@ -36,8 +38,86 @@ public:
 
     void advance( const ProcInfo* p, const GssaSystem* g );
 
+    /**
+     * Exact SSA, one event per iteration, until the time of the next
+     * event passes the end of the current timestep.
+     */
+    void advanceSSA( const ProcInfo* p, const GssaSystem* g );
+
+    /**
+     * Adaptive explicit tau-leaping with Cao-Gillespie-Petzold step
+     * selection. Critical reactions, those close to exhausting a
+     * reactant, are fired one at a time. Falls back to exact SSA
+     * when the selected leap would be too short to be useful.
+     */
+    void advanceTauLeap( const ProcInfo* p, const GssaSystem* g );
+
+    /**
+     * Hybrid advance. Reactions that are both fast and act on high
+     * copy number pools are integrated deterministically over the
+     * timestep, the remaining reactions are fired by exact SSA.
+     */
+    void advanceHybrid( const ProcInfo* p, const GssaSystem* g );
+
+    /**
+     * Fires exact SSA events from the current time t_ until nextt,
+     * using memoryless time sampling, for at most maxSteps events.
+     * Returns the number of events fired.
+     */
+    unsigned int fireExact( double nextt, const GssaSystem* g,
+            unsigned int maxSteps );
+
+    /**
+     * Picks the next reaction, repairing atot after roundoff if needed.
+     * Returns ~0U if the system is stuck.
+     */
+    unsigned int pickReacSafe( const GssaSystem* g );
+
+    /// Fires reaction r once, and updates funcs and dependent rates.
+    void fireOne( unsigned int r, const GssaSystem* g );
+
+    /**
+     * Number of times reaction r can fire before one of its reactants
+     * is exhausted.
+     */
+    double maxFirings( unsigned int r, const GssaSystem* g ) const;
+
+    /**
+     * Selects the leap size for the noncritical reactions (Cao,
+     * Gillespie and Petzold, J. Chem. Phys. 124:044109, 2006).
+     */
+    double selectTau( const GssaSystem* g,
+            const vector< bool >& isCritical ) const;
+
+    /**
+     * Integrates the fast reactions deterministically over dt using
+     * fixed-step RK4, with enough substeps to keep the relative change
+     * of every fast reactant per substep below epsilon.
+     */
+    void integrateFast( const GssaSystem* g, double dt );
+
     vector< unsigned int > numFire() const;
 
+    /// Total propensity of the reactions in this voxel.
+    double getAtot() const;
+
+    /**
+     * Used by the next-subvolume method, where the solver keeps the
+     * event times. Picks a reaction by propensity and fires it at
+     * time t. Returns false if the system is stuck.
+     */
+    bool fireReacAt( double t, const GssaSystem* g );
+
+    /**
+     * Updates the rates that depend on a pool after its count was
+     * changed from outside, as by a diffusion jump, at time t.
+     */
+    void updatePoolDependents( unsigned int pool, double t,
+            const GssaSystem* g );
+
+    /// Assigns the time of the last event without firing anything.
+    void setTime( double t );
+
     /**
     * Cleans out all reac rates and recalculates atot. Needed whenever a
     * mol conc changes, or if there is a roundoff error. Returns true
@@ -74,6 +154,13 @@ public:
 
     void setStoich( const Stoich* stoichPtr );
 
+    /**
+     * Checkpoint support. The records of this voxel are named with the
+     * given prefix; the solver keeps one per voxel.
+     */
+    void saveState( CheckpointWriter& w, const string& prefix ) const;
+    void loadState( CheckpointReader& r, const string& prefix );
+
 private:
     /// Time at which next event will occur.
     double t_;
@@ -93,6 +180,13 @@ private:
     // Count how many times each reaction has fired.
     vector< unsigned int > numFire_;
 
+    /**
+     * Flag for each reaction, set only during hybrid advance: true if
+     * the reaction is being integrated deterministically, in which
+     * case its velocity is excluded from the SSA propensities.
+     */
+    vector< bool > isFast_;
+
     /**
      * @brief RNG.
      */
@@ -27,7 +27,9 @@
 #include "../basecode/SparseMatrix.h"
 #include "KinSparseMatrix.h"
 #include "Stoich.h"
+#include "SparseJacobian.h"
 #include "../shell/Shell.h"
+#include "../shell/Checkpoint.h"
 
 #include "../mesh/MeshEntry.h"
 #include "../mesh/Boundary.h"
@@ -61,7 +63,9 @@ const Cinfo* Ksolve::initCinfo()
         "rk2: The Runge-Kutta 2,3 embedded fixed dt method"
         "rkck: The Runge-Kutta Cash-Karp (4,5) method"
         "rk8: The Runge-Kutta Prince-Dormand (8,9) method"
-        "lsoda: LSODA method",
+        "lsoda: LSODA method"
+        "rosenbrock: Implicit adaptive dt Rosenbrock method (Rodas3) "
+        "using the analytic sparse Jacobian. Suits stiff models.",
         &Ksolve::setMethod,
         &Ksolve::getMethod
     );
@@ -108,6 +112,26 @@ const Cinfo* Ksolve::initCinfo()
         &Ksolve::getRateVecFromPath
     );
 
+    static LookupValueFinfo< Ksolve, string, vector< double > > r1Scale(
+        "r1Scale",
+        "Vector of scale factors, one per voxel, on the first rate "
+        "constant of specified reaction: Kf for Reacs, k1 for Enzs and "
+        "Km for MMenzs. Voxels that do not diffuse into each other "
+        "then run as an ensemble of parameter variants of the model, "
+        "which the solver advances together and across numThreads.",
+        &Ksolve::setR1Scale,
+        &Ksolve::getR1Scale
+    );
+
+    static LookupValueFinfo< Ksolve, string, vector< double > > r2Scale(
+        "r2Scale",
+        "Vector of scale factors, one per voxel, on the second rate "
+        "constant of specified reaction: Kb for Reacs, k2 for Enzs and "
+        "kcat for MMenzs.",
+        &Ksolve::setR2Scale,
+        &Ksolve::getR2Scale
+    );
+
     static ValueFinfo< Ksolve, unsigned int > numAllVoxels(
         "numAllVoxels",
         "Number of voxels in the entire reac-diff system, "
@@ -123,6 +147,25 @@ const Cinfo* Ksolve::initCinfo()
         &Ksolve::getNumThreads
     );
 
+    static ValueFinfo< Ksolve, double > quiescentTol(
+        "quiescentTol",
+        "Relative rate of change, in 1/s, below which a voxel is taken "
+        "to be at steady state. A voxel in which every pool stays below "
+        "this for a few steps is no longer integrated, until diffusion, "
+        "a junction flux or a field assignment changes its pools. "
+        "Functions of time in the reaction system are not seen as a "
+        "perturbation. Zero, the default, integrates every voxel.",
+        &Ksolve::setQuiescentTol,
+        &Ksolve::getQuiescentTol
+    );
+
+    static ReadOnlyValueFinfo< Ksolve, unsigned int > numActiveVoxels(
+        "numActiveVoxels",
+        "Number of voxels integrated on the last step. This is "
+        "numLocalVoxels unless quiescentTol is set.",
+        &Ksolve::getNumActiveVoxels
+    );
+
     static ValueFinfo< Ksolve, unsigned int > numPools(
         "numPools",
         "Number of molecular pools in the entire reac-diff system, "
@@ -204,10 +247,14 @@ const Cinfo* Ksolve::initCinfo()
         &epsAbs,                         // Value
         &epsRel ,                        // Value
         &numThreads,                     // Value
+        &quiescentTol,                   // Value
+        &numActiveVoxels,                // ReadOnlyValue
         &compartment,                    // Value
         &numLocalVoxels,                 // ReadOnlyValue
         &nVec,                           // LookupValue
         &rateVec,                        // ReadOnlyLookupValue
+        &r1Scale,                        // LookupValue
+        &r2Scale,                        // LookupValue
         &numAllVoxels,                   // ReadOnlyValue
         &numPools,                       // Value
         &estimatedDt,                    // ReadOnlyValue
@@ -230,6 +277,7 @@ const Cinfo* Ksolve::initCinfo()
 }
 
 static const Cinfo* ksolveCinfo = Ksolve::initCinfo();
+static CheckpointHandler< Ksolve > ksolveCheckpoint( "Ksolve" );
 
 //////////////////////////////////////////////////////////////
 // Class definitions
@@ -244,7 +292,8 @@ Ksolve::Ksolve()
     pools_( 1 ),
     startVoxel_( 0 ),
     dsolve_(),
-    dsolvePtr_( nullptr )
+    dsolvePtr_( nullptr ),
+    quiescentTol_( 0.0 )
 {
     numThreads_ = moose::getEnvInt("MOOSE_NUM_THREADS", 1);
 
@@ -285,7 +334,8 @@ void Ksolve::setMethod( string method )
         method_ = "rk5";
     }
     else if ( method == "rk4"  || method == "rk2" ||
-              method == "rk8" || method == "rkck" || method == "lsoda" )
+              method == "rk8" || method == "rkck" || method == "lsoda" ||
+              method == "rosenbrock" )
     {
         method_ = method;
     }
@@ -342,6 +392,24 @@ unsigned int Ksolve::getNumThreads(  ) const
     return numThreads_;
 }
 
+double Ksolve::getQuiescentTol() const
+{
+    return quiescentTol_;
+}
+
+void Ksolve::setQuiescentTol( double tol )
+{
+    quiescentTol_ = tol > 0.0 ? tol : 0.0;
+    resetActivity();
+}
+
+unsigned int Ksolve::getNumActiveVoxels() const
+{
+    if ( quiescentTol_ > 0.0 )
+        return active_.size();
+    return pools_.size();
+}
+
 Id Ksolve::getStoich() const
 {
     return stoich_;
@@ -494,6 +562,7 @@ void Ksolve::setNvec( unsigned int voxel, vector< double > nVec )
         double* s = pools_[voxel].varS();
         for ( unsigned int i = 0; i < nVec.size(); ++i )
             s[i] = nVec[i];
+        wakeVoxel( voxel );
     }
 }
 
@@ -535,6 +604,72 @@ vector< double > Ksolve::getRateVecFromPath( string reacPath ) const
 	return vector< double >( pools_.size(), 0.0 );
 }
 
+void Ksolve::setRateScale( const string& reacPath,
+                           const vector< double >& scale, bool isR1 )
+{
+    Id reacId( reacPath );
+    unsigned int idx = ~0U;
+    if ( reacId != Id() && stoichPtr_ )
+        idx = stoichPtr_->convertIdToReacIndex( reacId );
+    if ( idx == ~0U )
+    {
+        cout << "Warning: Ksolve::setRateScale: no reaction on '" <<
+             reacPath << "' in this solver\n";
+        return;
+    }
+    if ( scale.size() != pools_.size() )
+    {
+        cout << "Warning: Ksolve::setRateScale: size mismatch ( " <<
+             scale.size() << ", " << pools_.size() << ")\n";
+        return;
+    }
+    for ( unsigned int i = 0; i < pools_.size(); ++i )
+    {
+        VoxelPools& vp = pools_[i];
+        if ( isR1 )
+            vp.setRateScale( idx, scale[i], vp.getR2Scale( idx ) );
+        else
+            vp.setRateScale( idx, vp.getR1Scale( idx ), scale[i] );
+        vp.updateRateTerms( stoichPtr_->getRateTerms(),
+                            stoichPtr_->getNumCoreRates(), idx );
+    }
+}
+
+vector< double > Ksolve::getRateScale( const string& reacPath,
+                                       bool isR1 ) const
+{
+    vector< double > ret( pools_.size(), 1.0 );
+    Id reacId( reacPath );
+    if ( reacId == Id() || !stoichPtr_ )
+        return ret;
+    unsigned int idx = stoichPtr_->convertIdToReacIndex( reacId );
+    if ( idx == ~0U )
+        return ret;
+    for ( unsigned int i = 0; i < pools_.size(); ++i )
+        ret[i] = isR1 ? pools_[i].getR1Scale( idx ) :
+                 pools_[i].getR2Scale( idx );
+    return ret;
+}
+
+void Ksolve::setR1Scale( string reacPath, vector< double > scale )
+{
+    setRateScale( reacPath, scale, true );
+}
+
+vector< double > Ksolve::getR1Scale( string reacPath ) const
+{
+    return getRateScale( reacPath, true );
+}
+
+void Ksolve::setR2Scale( string reacPath, vector< double > scale )
+{
+    setRateScale( reacPath, scale, false );
+}
+
+vector< double > Ksolve::getR2Scale( string reacPath ) const
+{
+    return getRateScale( reacPath, false );
+}
 
 double Ksolve::getEstimatedDt() const
 {
@@ -581,6 +716,10 @@ void Ksolve::process( const Eref& e, ProcPtr p )
         setBlock( dvalues );
     }
 
+    if ( quiescentTol_ > 0.0 )
+        wakePerturbedVoxels( p->dt );
+    size_t numActive = getNumActiveVoxels();
+
     if( 1 == numThreads_ || 1 == pools_.size() )
     {
         if( numThreads_ > 1 )
@@ -590,15 +729,25 @@ void Ksolve::process( const Eref& e, ProcPtr p )
             numThreads_ = 1;
         }
 
-        for ( unsigned int i = 0; i < pools_.size(); i++ )
-            pools_[i].advance( p );
+        advance_chunk( 0, numActive, p );
+    }
+    else if ( numActive < numThreads_ )
+    {
+        advance_chunk( 0, numActive, p );
     }
     else
     {
         std::vector<std::future<size_t>> vecFutures;
 
+        // The active voxels change from step to step, so their
+        // partition does too.
+        vector< std::pair< size_t, size_t > > activeIntervals;
+        if ( quiescentTol_ > 0.0 )
+            moose::splitIntervalInNParts( numActive, numThreads_,
+                                          activeIntervals );
+
         // lambdas is faster than std::bind
-        for (auto interval : intervals_)
+        for (auto interval : quiescentTol_ > 0.0 ? activeIntervals : intervals_)
         {
             vecFutures.push_back( 
                     std::async( std::launch::async
@@ -612,9 +761,12 @@ void Ksolve::process( const Eref& e, ProcPtr p )
         size_t tot = 0;
         for (auto &v : vecFutures )
             tot += v.get();
-        assert(tot == pools_.size());
+        assert(tot == numActive);
     }
 
+    if ( quiescentTol_ > 0.0 )
+        dropQuiescentVoxels();
+
     // Assemble and send the integrated values off for the Dsolve.
     if ( dsolvePtr_ )
     {
@@ -635,14 +787,75 @@ void Ksolve::process( const Eref& e, ProcPtr p )
     //moose::addSolverProf( "Ksolve", duration_cast<duration<double>> (t1_ - t0_ ).count(), 1 );
 }
 
+/**
+ * A voxel is steady if no pool has moved from ref by more than tol times
+ * its size. Changes within the absolute tolerance of the integrator are
+ * noise.
+ */
+static bool isSteady( const double* s, const double* ref, unsigned int n,
+                      double tol, double epsAbs )
+{
+    for ( unsigned int i = 0; i < n; ++i )
+        if ( fabs( s[i] - ref[i] ) > tol * fabs( ref[i] ) + epsAbs )
+            return false;
+    return true;
+}
+
+/**
+ * Number of consecutive steady steps before a voxel is dropped, so that
+ * the turning point of an oscillation is not taken for steady state.
+ */
+static const unsigned int numSteadySteps = 3;
+
+/**
+ * Advances voxel i. When quiescence detection is on, it also counts the
+ * steady steps of the voxel and flags it once it has been steady for
+ * long enough. Each voxel touches only its own entries, so this is safe
+ * across threads.
+ */
 void Ksolve::advance_pool( const size_t i, ProcPtr p )
 {
-    pools_[i].advance(p);
+    if ( quiescentTol_ <= 0.0 )
+    {
+        pools_[i].advance( p );
+        return;
+    }
+    unsigned int n = pools_[i].size();
+    double* ref = &restS_[ i * n ];
+    const double* s = pools_[i].S();
+    copy( s, s + n, ref );
+    pools_[i].advance( p );
+    s = pools_[i].S();
+    if ( isSteady( s, ref, n, quiescentTol_ * p->dt, epsAbs_ ) )
+    {
+        if ( ++quietCount_[i] >= numSteadySteps )
+        {
+            isQuiet_[i] = 1;
+            copy( s, s + n, ref );
+        }
+    }
+    else
+    {
+        quietCount_[i] = 0;
+    }
 }
 
+/**
+ * Advances entries begin to end of the active list, or of all the
+ * voxels if quiescence detection is off.
+ */
 size_t Ksolve::advance_chunk( const size_t begin, const size_t end, ProcPtr p )
 {
     size_t tot = 0;
+    if ( quiescentTol_ > 0.0 )
+    {
+        for (size_t k = begin; k < std::min(end, active_.size()); k++)
+        {
+            advance_pool( active_[k], p );
+            tot += 1;
+        }
+        return tot;
+    }
     for (size_t i = begin; i < std::min(end, pools_.size()); i++)
     {
         pools_[i].advance( p );
@@ -651,6 +864,57 @@ size_t Ksolve::advance_chunk( const size_t begin, const size_t end, ProcPtr p )
     return tot;
 }
 
+void Ksolve::resetActivity()
+{
+    active_.clear();
+    isQuiet_.assign( pools_.size(), 0 );
+    quietCount_.assign( pools_.size(), 0 );
+    restS_.clear();
+    if ( quiescentTol_ <= 0.0 )
+        return;
+    for ( unsigned int i = 0; i < pools_.size(); ++i )
+        active_.push_back( i );
+    restS_.resize( pools_.size() * getNumPools(), 0.0 );
+}
+
+void Ksolve::wakeVoxel( unsigned int i )
+{
+    if ( i >= isQuiet_.size() )
+        return;
+    quietCount_[i] = 0;
+    if ( isQuiet_[i] )
+    {
+        isQuiet_[i] = 0;
+        active_.push_back( i );
+    }
+}
+
+/**
+ * Incoming diffusion and junction fluxes are written straight into the
+ * pools of a voxel, so a quiescent voxel is checked against the pool
+ * numbers it had when it stopped. Drift that builds up over many small
+ * fluxes wakes it too.
+ */
+void Ksolve::wakePerturbedVoxels( double dt )
+{
+    unsigned int n = getNumPools();
+    for ( unsigned int i = 0; i < isQuiet_.size(); ++i )
+    {
+        if ( isQuiet_[i] && !isSteady( pools_[i].S(), &restS_[ i * n ], n,
+                                       quiescentTol_ * dt, epsAbs_ ) )
+            wakeVoxel( i );
+    }
+}
+
+void Ksolve::dropQuiescentVoxels()
+{
+    size_t j = 0;
+    for ( size_t k = 0; k < active_.size(); ++k )
+        if ( !isQuiet_[ active_[k] ] )
+            active_[j++] = active_[k];
+    active_.resize( j );
+}
+
 
 void Ksolve::reinit( const Eref& e, ProcPtr p )
 {
@@ -659,8 +923,14 @@ void Ksolve::reinit( const Eref& e, ProcPtr p )
 
     if ( isBuilt_ )
     {
+        // The reaction system may have been extended since the last
+        // reinit, for example by cross-compartment reactions.
+        if ( method_ == "rosenbrock" )
+            jacobian_.setup( stoichPtr_ );
         for ( unsigned int i = 0 ; i < pools_.size(); ++i ) {
             pools_[i].setNumVoxels( pools_.size() );
+            pools_[i].setJacobian(
+                method_ == "rosenbrock" ? &jacobian_ : nullptr );
             pools_[i].reinit( p->dt );
 		}
     }
@@ -680,6 +950,64 @@ void Ksolve::reinit( const Eref& e, ProcPtr p )
     // Recompute the partition of interval.
     intervals_.clear();
     moose::splitIntervalInNParts(pools_.size(), numThreads_, intervals_);
+    resetActivity();
+}
+
+//////////////////////////////////////////////////////////////
+// Checkpoints
+//////////////////////////////////////////////////////////////
+/**
+ * The molecule counts of all voxels go into one record, so that a load
+ * is a single copy out of the mapped file.
+ */
+void Ksolve::saveState( CheckpointWriter& w ) const
+{
+    vector< double > S;
+    vector< double > steps( 2 * pools_.size() );
+    for ( unsigned int i = 0; i < pools_.size(); ++i )
+    {
+        const double* s = pools_[i].S();
+        S.insert( S.end(), s, s + pools_[i].size() );
+        pools_[i].getStepState( &steps[ 2 * i ] );
+    }
+    w.add( "S", S );
+    w.add( "steps", steps );
+    if ( quiescentTol_ > 0.0 )
+    {
+        w.add( "isQuiet", isQuiet_ );
+        w.add( "quietCount", quietCount_ );
+        w.add( "restS", restS_ );
+    }
+}
+
+void Ksolve::loadState( CheckpointReader& r )
+{
+    unsigned int tot = 0;
+    for ( unsigned int i = 0; i < pools_.size(); ++i )
+        tot += pools_[i].size();
+    vector< double > S( tot );
+    vector< double > steps( 2 * pools_.size() );
+    if ( !r.get( "S", S.data(), tot ) ||
+            !r.get( "steps", steps.data(), steps.size() ) )
+        return;
+    const double* s = S.data();
+    for ( unsigned int i = 0; i < pools_.size(); ++i )
+    {
+        vector< double >& v = pools_[i].Svec();
+        copy( s, s + v.size(), v.begin() );
+        s += v.size();
+        pools_[i].setStepState( &steps[ 2 * i ] );
+    }
+    if ( quiescentTol_ > 0.0 &&
+            r.get( "isQuiet", isQuiet_.data(), isQuiet_.size() ) &&
+            r.get( "quietCount", quietCount_.data(), quietCount_.size() ) &&
+            r.get( "restS", restS_.data(), restS_.size() ) )
+    {
+        active_.clear();
+        for ( unsigned int i = 0; i < isQuiet_.size(); ++i )
+            if ( !isQuiet_[i] )
+                active_.push_back( i );
+    }
 }
 
 //////////////////////////////////////////////////////////////
@@ -699,16 +1027,40 @@ void Ksolve::initReinit( const Eref& e, ProcPtr p )
  * updateRateTerms obtains the latest parameters for the rates_ vector,
  * and has each of the pools update its parameters including rescaling
  * for volumes.
+ * Rebuilding all the rate terms is the bulk of the setup time for big
+ * models on big meshes, so it is spread over the threads. A change to a
+ * single rate term is cheap and is done serially.
  */
 void Ksolve::updateRateTerms( unsigned int index )
 {
+    for ( unsigned int i = 0; i < isQuiet_.size(); ++i )
+        wakeVoxel( i );
     if ( index == ~0U )
     {
-        for ( unsigned int i = 0 ; i < pools_.size(); ++i )
+        const vector< RateTerm* >& rates = stoichPtr_->getRateTerms();
+        unsigned int numCoreRates = stoichPtr_->getNumCoreRates();
+        size_t nt = std::min( numThreads_, pools_.size() );
+        if ( nt <= 1 )
+        {
+            for ( unsigned int i = 0 ; i < pools_.size(); ++i )
+                pools_[i].updateAllRateTerms( rates, numCoreRates );
+            return;
+        }
+        vector< std::pair< size_t, size_t > > chunks;
+        moose::splitIntervalInNParts( pools_.size(), nt, chunks );
+        vector< std::future< void > > futures;
+        for ( auto c : chunks )
         {
-            pools_[i].updateAllRateTerms( stoichPtr_->getRateTerms(),
-                                          stoichPtr_->getNumCoreRates() );
+            futures.push_back( std::async( std::launch::async,
+                [this, c, &rates, numCoreRates]()
+                {
+                    size_t end = std::min( c.second, pools_.size() );
+                    for ( size_t i = c.first; i < end; ++i )
+                        pools_[i].updateAllRateTerms( rates, numCoreRates );
+                } ) );
         }
+        for ( auto& f : futures )
+            f.get();
     }
     else if ( index < stoichPtr_->getNumRates() )
     {
@@ -750,7 +1102,10 @@ void Ksolve::setN( const Eref& e, double v )
 {
     unsigned int vox = getVoxelIndex( e );
     if ( vox != OFFNODE )
+    {
         pools_[vox].setN( getPoolIndex( e ), v );
+        wakeVoxel( vox );
+    }
 }
 
 double Ksolve::getN( const Eref& e ) const
@@ -773,7 +1128,10 @@ void Ksolve::setConcInit( const Eref& e, double v )
 {
     unsigned int vox = getVoxelIndex( e );
     if ( vox != OFFNODE )
+    {
         pools_[vox].setConcInit( getPoolIndex( e ), v );
+        wakeVoxel( vox );
+    }
 }
 
 double Ksolve::getConcInit( const Eref& e ) const
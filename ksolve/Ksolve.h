@@ -15,6 +15,8 @@
 using namespace std::chrono;
 
 class Stoich;
+class CheckpointWriter;
+class CheckpointReader;
 
 class Ksolve: public KsolveBase
 {
@@ -65,6 +67,17 @@ public:
     unsigned int getNumThreads( ) const;
     void setNumThreads( unsigned int x );
 
+    /**
+     * Voxels in which every pool changes at a relative rate below
+     * quiescentTol (1/s) for several steps running are taken off the
+     * active list, and are not integrated until diffusion, a junction
+     * flux or a field assignment moves them. Zero, the default,
+     * integrates every voxel on every step.
+     */
+    double getQuiescentTol() const;
+    void setQuiescentTol( double tol );
+    unsigned int getNumActiveVoxels() const;
+
     size_t advance_chunk( const size_t begin, const size_t end, ProcPtr p );
 
     void advance_pool( const size_t i, ProcPtr p );
@@ -79,6 +92,16 @@ public:
     vector<double> getRateVecFromPath( string reacPath ) const; //field func
     vector<double> getR1vec( unsigned int reacIdx ) const; // Utility func
 
+    /**
+     * Per-voxel scale factors on the first and second rate constants of
+     * the reaction on reacPath. With voxels that do not diffuse into each
+     * other, this runs one parameter variant of the model per voxel.
+     */
+    void setR1Scale( string reacPath, vector< double > scale );
+    vector< double > getR1Scale( string reacPath ) const;
+    void setR2Scale( string reacPath, vector< double > scale );
+    vector< double > getR2Scale( string reacPath ) const;
+
     //////////////////////////////////////////////////////////////////
     // Dest Finfos
     //////////////////////////////////////////////////////////////////
@@ -134,6 +157,11 @@ public:
      */
     void updateRateTerms( unsigned int index );
 
+    /// Utility func for the r1Scale and r2Scale fields.
+    void setRateScale( const string& reacPath,
+                       const vector< double >& scale, bool isR1 );
+    vector< double > getRateScale( const string& reacPath, bool isR1 ) const;
+
 	///////////////////////////////////////////////////////////////////
 	// Here is a block of notify events
 	///////////////////////////////////////////////////////////////////
@@ -143,6 +171,11 @@ public:
 	void notifyAddMsgSrcPool( const Eref& e, ObjId msgId );
 	void notifyAddMsgDestPool( const Eref& e, ObjId msgId );
 
+    //////////////////////////////////////////////////////////////////
+    // Checkpoint support, see shell/Checkpoint.h
+    void saveState( CheckpointWriter& w ) const;
+    void loadState( CheckpointReader& r );
+
     //////////////////////////////////////////////////////////////////
     // for debugging
     void print() const;
@@ -151,6 +184,14 @@ public:
     static const Cinfo* initCinfo();
 
 private:
+    /// Puts every voxel on the active list.
+    void resetActivity();
+    /// Puts voxel i back on the active list, if it was quiescent.
+    void wakeVoxel( unsigned int i );
+    /// Wakes the quiescent voxels whose pools have moved since they stopped.
+    void wakePerturbedVoxels( double dt );
+    /// Removes the voxels that have just become quiescent.
+    void dropQuiescentVoxels();
 
     string method_;
     double epsAbs_;
@@ -177,6 +218,9 @@ private:
     /// Utility ptr used to help Pool Id lookups by the Ksolve.
     Stoich* stoichPtr_;
 
+    /// Jacobian structure shared by the voxels, for the rosenbrock method.
+    SparseJacobian jacobian_;
+
     /**
      * Id of diffusion solver, needed for coordinating numerics.
      */
@@ -193,6 +237,24 @@ private:
 
     vector<std::pair<size_t, size_t>> intervals_;
 
+    /// Relative rate of change below which a voxel is at steady state.
+    double quiescentTol_;
+
+    /// Voxels to integrate on this step, used when quiescentTol_ > 0.
+    vector< unsigned int > active_;
+
+    /// Flags the voxels that are off the active list.
+    vector< unsigned char > isQuiet_;
+
+    /// Number of consecutive steady steps of each voxel.
+    vector< unsigned int > quietCount_;
+
+    /**
+     * Pool numbers of each voxel at the start of its last step, and, for
+     * a quiescent voxel, when it stopped. Indexed as voxel * numPools.
+     */
+    vector< double > restS_;
+
     //high_resolution_clock::time_point t0_, t1_;
 	
 	static map< Id, unsigned int > defaultPoolLookup_;
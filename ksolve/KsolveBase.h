@@ -125,6 +125,44 @@ public:
 
     /// Used to tell Dsolver to assign 'prev' values.
     virtual void setPrev();
+
+    /**
+     * Diffusion constant by pool index rather than by Eref. Used by
+     * stochastic reac solvers that do their own diffusion jumps.
+     * Only the Dsolve has diffusion constants, so here it is a dummy.
+     */
+    virtual double getPoolDiffConst( unsigned int poolIndex ) const
+    { return 0.0; }
+
+    /**
+     * Used to tell Dsolver that the reac solver moves molecules between
+     * voxels itself, so the Dsolve should skip its own diffusion step
+     * and only handle junctions. Dummy except in Dsolve.
+     */
+    virtual void setJumpDiffusion( bool val )
+    {;}
+
+    /**
+     * Lists, in order, the voxels that updateJunctions reads or changes.
+     * A reac solver that does its own diffusion within the compartment
+     * need only exchange these with the Dsolve. Dummy except in Dsolve.
+     */
+    virtual void getJunctionVoxels( vector< unsigned int >& voxels ) const
+    { voxels.clear(); }
+
+    /**
+     * Like getBlock and setBlock, but for the listed voxels only. The
+     * values are organized as values[pool#][k] for voxels[k].
+     * Dummies except in Dsolve.
+     */
+    virtual void getVoxels( const vector< unsigned int >& voxels,
+                            unsigned int startPool, unsigned int numPools,
+                            vector< double >& values ) const
+    { values.clear(); }
+    virtual void setVoxels( const vector< unsigned int >& voxels,
+                            unsigned int startPool, unsigned int numPools,
+                            const vector< double >& values )
+    {;}
     /**
      * Informs the solver that the rate terms or volumes have changed
      * and that the parameters must be updated.
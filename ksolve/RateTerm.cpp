@@ -49,3 +49,24 @@ double StochNOrder::operator() ( const double* S ) const
     }
     return ret;
 }
+
+void StochNOrder::getDerivs( const double* S,
+                             vector< pair< unsigned int, double > >& d ) const
+{
+    // Same factors as operator(): repeated substrates are decremented.
+    vector< double > y( v_.size() );
+    unsigned int lasty = ~0U;
+    for ( unsigned int i = 0; i < v_.size(); ++i )
+    {
+        y[i] = ( lasty == v_[i] ) ? y[i-1] - 1.0 : S[ v_[i] ];
+        lasty = v_[i];
+    }
+    for ( unsigned int i = 0; i < v_.size(); ++i )
+    {
+        double x = k_;
+        for ( unsigned int j = 0; j < v_.size(); ++j )
+            if ( j != i )
+                x *= y[j];
+        d.push_back( make_pair( v_[i], x ) );
+    }
+}
@@ -49,6 +49,15 @@ public:
      */
     virtual unsigned int  getReactants(
         vector< unsigned int >& molIndex ) const = 0;
+
+    /**
+     * Appends the partial derivatives of the rate with respect to the
+     * molecules it depends on, as ( molIndex, d rate / d S[molIndex] )
+     * pairs. A molecule may turn up more than once, in which case its
+     * entries are to be summed. Used to build the Jacobian analytically.
+     */
+    virtual void getDerivs( const double* S,
+                            vector< pair< unsigned int, double > >& d ) const = 0;
     static const double EPSILON;
 
     /**
@@ -169,6 +178,15 @@ public:
         return 2;
     }
 
+    void getDerivs( const double* S,
+                    vector< pair< unsigned int, double > >& d ) const
+    {
+        double denom = Km_ + S[ sub_ ];
+        d.push_back( make_pair( enz_, kcat_ * S[ sub_ ] / denom ) );
+        d.push_back( make_pair( sub_,
+                                kcat_ * S[ enz_ ] * Km_ / ( denom * denom ) ) );
+    }
+
     RateTerm* copyWithVolScaling(
         double vol, double sub, double prd ) const
     {
@@ -207,6 +225,20 @@ public:
         return molIndex.size();
     }
 
+    void getDerivs( const double* S,
+                    vector< pair< unsigned int, double > >& d ) const
+    {
+        double sub = (*substrates_)( S );
+        double denom = Km_ + sub;
+        d.push_back( make_pair( enz_, kcat_ * sub / denom ) );
+        // Chain rule through the substrate product term.
+        double dvdsub = kcat_ * S[ enz_ ] * Km_ / ( denom * denom );
+        unsigned int start = d.size();
+        substrates_->getDerivs( S, d );
+        for ( unsigned int i = start; i < d.size(); ++i )
+            d[i].second *= dvdsub;
+    }
+
     RateTerm* copyWithVolScaling(
         double vol, double sub, double prd ) const
     {
@@ -258,6 +290,12 @@ public:
         return 0;
     }
 
+    void getDerivs( const double* S,
+                    vector< pair< unsigned int, double > >& d ) const
+    {
+        ;
+    }
+
     void rescaleVolume( short comptIndex,
                         const vector< short >& compartmentLookup, double ratio )
     {
@@ -326,6 +364,12 @@ public:
         return 0;
     }
 
+    void getDerivs( const double* S,
+                    vector< pair< unsigned int, double > >& d ) const
+    {
+        ;
+    }
+
     void rescaleVolume( short comptIndex,
                         const vector< short >& compartmentLookup, double ratio )
     {
@@ -366,6 +410,12 @@ public:
         return 0;
     }
 
+    void getDerivs( const double* S,
+                    vector< pair< unsigned int, double > >& d ) const
+    {
+        d.push_back( make_pair( y_, k_ ) );
+    }
+
     void rescaleVolume( short comptIndex,
                         const vector< short >& compartmentLookup, double ratio )
     {
@@ -402,6 +452,12 @@ public:
         return 1;
     }
 
+    void getDerivs( const double* S,
+                    vector< pair< unsigned int, double > >& d ) const
+    {
+        d.push_back( make_pair( y_, k_ ) );
+    }
+
     void rescaleVolume( short comptIndex,
                         const vector< short >& compartmentLookup, double ratio )
     {
@@ -440,6 +496,13 @@ public:
         return 2;
     }
 
+    void getDerivs( const double* S,
+                    vector< pair< unsigned int, double > >& d ) const
+    {
+        d.push_back( make_pair( y1_, k_ * S[ y2_ ] ) );
+        d.push_back( make_pair( y2_, k_ * S[ y1_ ] ) );
+    }
+
     void rescaleVolume( short comptIndex,
                         const vector< short >& compartmentLookup, double ratio )
     {
@@ -490,6 +553,12 @@ public:
         return 2;
     }
 
+    void getDerivs( const double* S,
+                    vector< pair< unsigned int, double > >& d ) const
+    {
+        d.push_back( make_pair( y_, k_ * ( 2.0 * S[ y_ ] - 1.0 ) ) );
+    }
+
     void rescaleVolume( short comptIndex,
                         const vector< short >& compartmentLookup, double ratio )
     {
@@ -533,6 +602,19 @@ public:
         return v_.size();
     }
 
+    void getDerivs( const double* S,
+                    vector< pair< unsigned int, double > >& d ) const
+    {
+        for ( unsigned int i = 0; i < v_.size(); ++i )
+        {
+            double x = k_;
+            for ( unsigned int j = 0; j < v_.size(); ++j )
+                if ( j != i )
+                    x *= S[ v_[j] ];
+            d.push_back( make_pair( v_[i], x ) );
+        }
+    }
+
     void rescaleVolume( short comptIndex,
                         const vector< short >& compartmentLookup, double ratio )
     {
@@ -569,6 +651,9 @@ public:
 
     double operator() ( const double* S ) const;
 
+    void getDerivs( const double* S,
+                    vector< pair< unsigned int, double > >& d ) const;
+
     RateTerm* copyWithVolScaling(
         double vol, double sub, double prd ) const
     {
@@ -641,6 +726,16 @@ public:
         return ret;
     }
 
+    void getDerivs( const double* S,
+                    vector< pair< unsigned int, double > >& d ) const
+    {
+        forward_->getDerivs( S, d );
+        unsigned int start = d.size();
+        backward_->getDerivs( S, d );
+        for ( unsigned int i = start; i < d.size(); ++i )
+            d[i].second = -d[i].second;
+    }
+
     void rescaleVolume( short comptIndex,
                         const vector< short >& compartmentLookup, double ratio )
     {
@@ -0,0 +1,236 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2014 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include <set>
+#include "../basecode/header.h"
+#include "../basecode/SparseMatrix.h"
+#include "KinSparseMatrix.h"
+#include "RateTerm.h"
+#include "VoxelPoolsBase.h"
+#include "XferInfo.h"
+#include "KsolveBase.h"
+#include "Stoich.h"
+#include "SparseJacobian.h"
+
+SparseJacobian::SparseJacobian()
+    : n_( 0 )
+{
+    ;
+}
+
+unsigned int SparseJacobian::size() const
+{
+    return n_;
+}
+
+unsigned int SparseJacobian::numEntries() const
+{
+    return colIndex_.size();
+}
+
+void SparseJacobian::setup( const Stoich* stoich )
+{
+    n_ = stoich->getNumVarPools() + stoich->getNumProxyPools();
+    const KinSparseMatrix& N = stoich->getStoichiometryMatrix();
+    const vector< RateTerm* >& rates = stoich->getRateTerms();
+
+    // The pools that each rate depends on. The derivatives are reported
+    // whatever their value, so probing at any state will do.
+    vector< double > probe( stoich->getNumAllPools(), 1.0 );
+    vector< vector< unsigned int > > deps( rates.size() );
+    vector< pair< unsigned int, double > > d;
+    for ( unsigned int r = 0; r < rates.size(); ++r )
+    {
+        d.clear();
+        rates[r]->getDerivs( &probe[0], d );
+        for ( auto k = d.cbegin(); k != d.cend(); ++k )
+            if ( k->first < n_ &&
+                    find( deps[r].begin(), deps[r].end(), k->first ) ==
+                    deps[r].end() )
+                deps[r].push_back( k->first );
+    }
+
+    // The pools that each rate changes, with their stoichiometry.
+    vector< vector< pair< unsigned int, int > > > targets( rates.size() );
+    for ( unsigned int i = 0; i < n_; ++i )
+    {
+        const int* entry;
+        const unsigned int* colIndex;
+        unsigned int num = N.getRow( i, &entry, &colIndex );
+        for ( unsigned int k = 0; k < num; ++k )
+            targets[ colIndex[k] ].push_back(
+                pair< unsigned int, int >( i, entry[k] ) );
+    }
+
+    // Symmetrized pattern, without the diagonal.
+    vector< set< unsigned int > > adj( n_ );
+    for ( unsigned int r = 0; r < rates.size(); ++r )
+        for ( auto t = targets[r].cbegin(); t != targets[r].cend(); ++t )
+            for ( auto m = deps[r].cbegin(); m != deps[r].cend(); ++m )
+                if ( t->first != *m )
+                {
+                    adj[ t->first ].insert( *m );
+                    adj[ *m ].insert( t->first );
+                }
+
+    // Greedy minimum degree ordering. Eliminating a pool joins up all
+    // its remaining neighbours, and those edges are the fill-in.
+    vector< set< unsigned int > > filled = adj;
+    vector< bool > done( n_, false );
+    perm_.clear();
+    for ( unsigned int k = 0; k < n_; ++k )
+    {
+        unsigned int best = ~0U;
+        for ( unsigned int i = 0; i < n_; ++i )
+            if ( !done[i] && ( best == ~0U ||
+                               adj[i].size() < adj[best].size() ) )
+                best = i;
+        perm_.push_back( best );
+        done[best] = true;
+        const set< unsigned int >& nbrs = adj[best];
+        for ( auto a = nbrs.cbegin(); a != nbrs.cend(); ++a )
+        {
+            adj[ *a ].erase( best );
+            for ( auto b = nbrs.cbegin(); b != nbrs.cend(); ++b )
+                if ( *a != *b )
+                {
+                    adj[ *a ].insert( *b );
+                    filled[ *a ].insert( *b );
+                }
+        }
+        adj[best].clear();
+    }
+    invPerm_.assign( n_, 0 );
+    for ( unsigned int k = 0; k < n_; ++k )
+        invPerm_[ perm_[k] ] = k;
+
+    rowStart_.assign( 1, 0 );
+    colIndex_.clear();
+    diag_.assign( n_, 0 );
+    for ( unsigned int k = 0; k < n_; ++k )
+    {
+        vector< unsigned int > cols( 1, k );
+        const set< unsigned int >& row = filled[ perm_[k] ];
+        for ( auto c = row.cbegin(); c != row.cend(); ++c )
+            cols.push_back( invPerm_[ *c ] );
+        sort( cols.begin(), cols.end() );
+        diag_[k] = rowStart_.back() +
+                   ( lower_bound( cols.begin(), cols.end(), k ) - cols.begin() );
+        colIndex_.insert( colIndex_.end(), cols.begin(), cols.end() );
+        rowStart_.push_back( colIndex_.size() );
+    }
+
+    rateStart_.assign( 1, 0 );
+    derivPool_.clear();
+    termStart_.assign( 1, 0 );
+    termSlot_.clear();
+    termCoeff_.clear();
+    for ( unsigned int r = 0; r < rates.size(); ++r )
+    {
+        for ( auto m = deps[r].cbegin(); m != deps[r].cend(); ++m )
+        {
+            derivPool_.push_back( *m );
+            for ( auto t = targets[r].cbegin(); t != targets[r].cend(); ++t )
+            {
+                unsigned int row = invPerm_[ t->first ];
+                unsigned int col = invPerm_[ *m ];
+                const unsigned int* begin = &colIndex_[0] + rowStart_[row];
+                const unsigned int* end = &colIndex_[0] + rowStart_[row + 1];
+                termSlot_.push_back( lower_bound( begin, end, col ) -
+                                     &colIndex_[0] );
+                termCoeff_.push_back( t->second );
+            }
+            termStart_.push_back( termSlot_.size() );
+        }
+        rateStart_.push_back( derivPool_.size() );
+    }
+}
+
+void SparseJacobian::assemble( const vector< RateTerm* >& rates,
+                               const double* s, vector< double >& J ) const
+{
+    J.assign( colIndex_.size(), 0.0 );
+    vector< pair< unsigned int, double > > d;
+    for ( unsigned int r = 0; r + 1 < rateStart_.size(); ++r )
+    {
+        d.clear();
+        rates[r]->getDerivs( s, d );
+        for ( auto k = d.cbegin(); k != d.cend(); ++k )
+        {
+            for ( unsigned int m = rateStart_[r]; m < rateStart_[r + 1]; ++m )
+            {
+                if ( derivPool_[m] != k->first )
+                    continue;
+                for ( unsigned int t = termStart_[m]; t < termStart_[m + 1];
+                        ++t )
+                    J[ termSlot_[t] ] += termCoeff_[t] * k->second;
+                break;
+            }
+        }
+    }
+}
+
+bool SparseJacobian::factorize( double diag, vector< double >& J,
+                                vector< double >& work ) const
+{
+    for ( vector< double >::iterator
+            i = J.begin(); i != J.end(); ++i )
+        *i = -*i;
+    for ( unsigned int k = 0; k < n_; ++k )
+        J[ diag_[k] ] += diag;
+
+    // Row by row Doolittle elimination. The pattern is closed under
+    // elimination, so the updates only touch stored entries.
+    work.assign( n_, 0.0 );
+    for ( unsigned int i = 0; i < n_; ++i )
+    {
+        for ( unsigned int p = rowStart_[i]; p < rowStart_[i + 1]; ++p )
+            work[ colIndex_[p] ] = J[p];
+        for ( unsigned int p = rowStart_[i]; p < diag_[i]; ++p )
+        {
+            unsigned int k = colIndex_[p];
+            double l = work[k] / J[ diag_[k] ];
+            work[k] = l;
+            for ( unsigned int q = diag_[k] + 1; q < rowStart_[k + 1]; ++q )
+                work[ colIndex_[q] ] -= l * J[q];
+        }
+        for ( unsigned int p = rowStart_[i]; p < rowStart_[i + 1]; ++p )
+        {
+            J[p] = work[ colIndex_[p] ];
+            work[ colIndex_[p] ] = 0.0;
+        }
+        if ( J[ diag_[i] ] == 0.0 )
+            return false;
+    }
+    return true;
+}
+
+void SparseJacobian::solve( const vector< double >& LU, double* x,
+                            vector< double >& work ) const
+{
+    work.resize( n_ );
+    for ( unsigned int k = 0; k < n_; ++k )
+        work[k] = x[ perm_[k] ];
+    for ( unsigned int i = 0; i < n_; ++i )
+    {
+        double sum = work[i];
+        for ( unsigned int p = rowStart_[i]; p < diag_[i]; ++p )
+            sum -= LU[p] * work[ colIndex_[p] ];
+        work[i] = sum;
+    }
+    for ( unsigned int i = n_; i-- > 0; )
+    {
+        double sum = work[i];
+        for ( unsigned int p = diag_[i] + 1; p < rowStart_[i + 1]; ++p )
+            sum -= LU[p] * work[ colIndex_[p] ];
+        work[i] = sum / LU[ diag_[i] ];
+    }
+    for ( unsigned int k = 0; k < n_; ++k )
+        x[ perm_[k] ] = work[k];
+}
@@ -0,0 +1,88 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2014 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _SPARSE_JACOBIAN_H
+#define _SPARSE_JACOBIAN_H
+
+class Stoich;
+class RateTerm;
+
+/**
+ * Holds the structure of the Jacobian of a reaction system over its
+ * integrated (variable and proxy) pools, together with the fill-in and
+ * pivot order of its LU factorization. The structure depends only on the
+ * Stoich, so it is worked out once and shared by all voxels, which each
+ * keep their own numerical values.
+ *
+ * Entries are stored row-wise in elimination order. The pivot order is
+ * a greedy minimum degree ordering of the symmetrized pattern, and the
+ * factorization does not pivot further. This suits the matrices
+ * I/(h.gamma) - J of implicit methods, whose diagonal dominates for
+ * reasonable step sizes.
+ */
+class SparseJacobian
+{
+public:
+    SparseJacobian();
+
+    /// Works out the structure from the stoichiometry and rate terms.
+    void setup( const Stoich* stoich );
+
+    /// Number of integrated pools, the order of the matrix.
+    unsigned int size() const;
+
+    /// Number of stored entries, including fill-in.
+    unsigned int numEntries() const;
+
+    /**
+     * Fills J, of numEntries(), with the Jacobian at the pool vector s.
+     * The rates must have the same structure as those of the Stoich.
+     */
+    void assemble( const vector< RateTerm* >& rates, const double* s,
+                   vector< double >& J ) const;
+
+    /**
+     * Replaces J with diag.I - J, and factorizes it in place. Returns
+     * false if a pivot vanishes. The work vector is scratch space owned
+     * by the caller, so that voxels can factorize concurrently.
+     */
+    bool factorize( double diag, vector< double >& J,
+                    vector< double >& work ) const;
+
+    /// Solves LU.x = b in place, given the factors from factorize.
+    void solve( const vector< double >& LU, double* x,
+                vector< double >& work ) const;
+
+private:
+    unsigned int n_;
+
+    /// Pool index of each row in elimination order, and the reverse.
+    vector< unsigned int > perm_;
+    vector< unsigned int > invPerm_;
+
+    /// Pattern in elimination order. Columns are sorted within rows.
+    vector< unsigned int > rowStart_;
+    vector< unsigned int > colIndex_;
+    vector< unsigned int > diag_;
+
+    /**
+     * Assembly map. Rate term r depends on the pools
+     * derivPool_[ rateStart_[r] ... rateStart_[r+1] ), and its
+     * derivative with respect to derivPool_[k] is added, times
+     * termCoeff_[t], into entry termSlot_[t] for t in
+     * [ termStart_[k], termStart_[k+1] ).
+     */
+    vector< unsigned int > rateStart_;
+    vector< unsigned int > derivPool_;
+    vector< unsigned int > termStart_;
+    vector< unsigned int > termSlot_;
+    vector< double > termCoeff_;
+};
+
+#endif // _SPARSE_JACOBIAN_H
@@ -19,6 +19,7 @@
  */
 
 #include "../basecode/header.h"
+#include "../utility/utility.h"
 
 #include "../randnum/randnum.h"
 
@@ -50,6 +51,8 @@
 #include "VoxelPools.h"
 #include "SteadyStateGsl.h"
 
+#include <future>
+
 int ss_func( const gsl_vector* x, void* params, gsl_vector* f );
 #ifdef USE_GSL
 int myGaussianDecomp( gsl_matrix* U );
@@ -202,6 +205,59 @@ const Cinfo* SteadyState::initCinfo()
         "Eigenvalues computed for steady state",
         &SteadyState::getEigenvalue
     );
+    static ValueFinfo< SteadyState, unsigned int > numThreads(
+        "numThreads",
+        "Number of threads used by multiStart. Reaction systems with "
+        "rates computed by Functions are always solved on one thread.",
+        &SteadyState::setNumThreads,
+        &SteadyState::getNumThreads
+    );
+    static ReadOnlyValueFinfo< SteadyState, unsigned int > numFixedPoints(
+        "numFixedPoints",
+        "Number of distinct fixed points found by the last multiStart.",
+        &SteadyState::getNumFixedPoints
+    );
+    static ReadOnlyLookupValueFinfo<
+    SteadyState, unsigned int, vector< double > > fixedPoint(
+        "fixedPoint",
+        "Pool numbers at the specified fixed point found by multiStart, "
+        "in the same order as Ksolve::nVec.",
+        &SteadyState::getFixedPoint
+    );
+    static ReadOnlyLookupValueFinfo<
+    SteadyState, unsigned int, unsigned int > fixedPointType(
+        "fixedPointType",
+        "State type of the specified fixed point found by multiStart. "
+        "The codes are those of stateType.",
+        &SteadyState::getFixedPointType
+    );
+    static ValueFinfo< SteadyState, double > continuationStep(
+        "continuationStep",
+        "Initial arclength step for continuation. The step adapts as "
+        "the branch is traced.",
+        &SteadyState::setContinuationStep,
+        &SteadyState::getContinuationStep
+    );
+    static ReadOnlyValueFinfo< SteadyState, vector< double > > branchScale(
+        "branchScale",
+        "Scale factors on the continuation rate constant at each point "
+        "of the branch traced by the last continuation.",
+        &SteadyState::getBranchScale
+    );
+    static ReadOnlyLookupValueFinfo<
+    SteadyState, unsigned int, vector< double > > branchPoint(
+        "branchPoint",
+        "Pool numbers at the specified point of the branch traced by "
+        "the last continuation, in the same order as Ksolve::nVec.",
+        &SteadyState::getBranchPoint
+    );
+    static ReadOnlyValueFinfo< SteadyState, vector< unsigned int > >
+    branchType(
+        "branchType",
+        "State type of each point of the branch traced by the last "
+        "continuation. The codes are those of stateType.",
+        &SteadyState::getBranchType
+    );
     ///////////////////////////////////////////////////////
     // MsgDest definitions
     ///////////////////////////////////////////////////////
@@ -234,6 +290,28 @@ const Cinfo* SteadyState::initCinfo()
             new EpFunc0< SteadyState >(
                 &SteadyState::randomizeInitialCondition )
             );
+    static DestFinfo multiStart( "multiStart",
+            "Looks for all the fixed points of the system. Solves from the "
+            "specified number of random initial conditions consistent "
+            "with the current conservation totals, spread over numThreads, "
+            "and keeps each distinct fixed point once, with its state "
+            "type. Does not change the pool values on the solver. The "
+            "results are in numFixedPoints, fixedPoint and "
+            "fixedPointType.",
+            new OpFunc1< SteadyState, unsigned int >(
+                &SteadyState::multiStart )
+            );
+    static DestFinfo continuation( "continuation",
+            "Traces the branch of fixed points through the current steady "
+            "state as the first rate constant (Kf, k1 or Km) of the "
+            "specified reaction is scaled from scaleMin to scaleMax, "
+            "using pseudo-arclength continuation so that the branch is "
+            "followed around folds. Arguments: reaction path, scaleMin, "
+            "scaleMax. The results are in branchScale, branchPoint and "
+            "branchType. The rate constant is left unscaled afterwards.",
+            new OpFunc3< SteadyState, string, double, double >(
+                &SteadyState::continuation )
+            );
 
     ///////////////////////////////////////////////////////
     // Shared definitions
@@ -260,7 +338,17 @@ const Cinfo* SteadyState::initCinfo()
         &settle,                  // DestFinfo
         &resettle,                // DestFinfo
         &showMatrices,            // DestFinfo
+        &numThreads,              // Value
+        &numFixedPoints,          // ReadOnlyValue
+        &fixedPoint,              // ReadOnlyLookupValue
+        &fixedPointType,          // ReadOnlyLookupValue
+        &continuationStep,        // Value
+        &branchScale,             // ReadOnlyValue
+        &branchPoint,             // ReadOnlyLookupValue
+        &branchType,              // ReadOnlyValue
         &randomInit,              // DestFinfo
+        &multiStart,              // DestFinfo
+        &continuation,            // DestFinfo
     };
 
     static string doc[] =
@@ -296,7 +384,13 @@ const Cinfo* SteadyState::initCinfo()
         "likely to succeed in finding solutions from a new starting point "
         "if you numerically integrate the chemical system for a short "
         "time (typically under 1 second) before asking it to find the "
-        "fixed point. "
+        "fixed point.\n "
+        "To find all the fixed points at once, *multiStart(n)* solves "
+        "from n random initial conditions in parallel and keeps the "
+        "distinct ones. *continuation* follows a branch of fixed points "
+        "as a rate constant is varied, which gives bifurcation "
+        "diagrams. Both use the Jacobian computed analytically from the "
+        "rate terms of the Stoich. "
     };
 
     static Dinfo< SteadyState > dinfo;
@@ -340,7 +434,9 @@ SteadyState::SteadyState()
     nPosEigenvalues_( 0 ),
     stateType_( 0 ),
     solutionStatus_( 0 ),
-    numFailed_( 0 )
+    numFailed_( 0 ),
+    numThreads_( moose::getEnvInt( "MOOSE_NUM_THREADS", 1 ) ),
+    continuationStep_( 0.02 )
 {
     ;
 }
@@ -484,6 +580,72 @@ void SteadyState::setTotal( const unsigned int i, double val )
          " out of range " << total_.size() << endl;
 }
 
+unsigned int SteadyState::getNumThreads() const
+{
+    return numThreads_;
+}
+
+void SteadyState::setNumThreads( unsigned int value )
+{
+    numThreads_ = value > 0 ? value : 1;
+}
+
+unsigned int SteadyState::getNumFixedPoints() const
+{
+    return fixedPoints_.size();
+}
+
+vector< double > SteadyState::getFixedPoint( unsigned int i ) const
+{
+    if ( i < fixedPoints_.size() )
+        return fixedPoints_[i];
+    cout << "Warning: SteadyState::getFixedPoint: index " << i <<
+         " out of range " << fixedPoints_.size() << endl;
+    return vector< double >();
+}
+
+unsigned int SteadyState::getFixedPointType( unsigned int i ) const
+{
+    if ( i < fixedPointTypes_.size() )
+        return fixedPointTypes_[i];
+    cout << "Warning: SteadyState::getFixedPointType: index " << i <<
+         " out of range " << fixedPointTypes_.size() << endl;
+    return 0;
+}
+
+double SteadyState::getContinuationStep() const
+{
+    return continuationStep_;
+}
+
+void SteadyState::setContinuationStep( double value )
+{
+    if ( value > 0.0 )
+        continuationStep_ = value;
+    else
+        cout << "Warning: SteadyState::setContinuationStep: value must be "
+             "positive\n";
+}
+
+vector< double > SteadyState::getBranchScale() const
+{
+    return branchScale_;
+}
+
+vector< double > SteadyState::getBranchPoint( unsigned int i ) const
+{
+    if ( i < branchPoints_.size() )
+        return branchPoints_[i];
+    cout << "Warning: SteadyState::getBranchPoint: index " << i <<
+         " out of range " << branchPoints_.size() << endl;
+    return vector< double >();
+}
+
+vector< unsigned int > SteadyState::getBranchType() const
+{
+    return branchTypes_;
+}
+
 double SteadyState::getEigenvalue( const unsigned int i ) const
 {
     if ( i < eigenvalues_.size() )
@@ -712,106 +874,91 @@ int iterate( const gsl_multiroot_fsolver_type* st, struct reac_info *ri,
 void SteadyState::classifyState( const double* T )
 {
 #ifdef USE_GSL
-    // unsigned int nConsv = numVarPools_ - rank_;
-    gsl_matrix* J = gsl_matrix_calloc ( numVarPools_, numVarPools_ );
-    // double* yprime = new double[ numVarPools_ ];
-    // vector< double > yprime( numVarPools_, 0.0 );
-    // Generate an approximation to the Jacobean by generating small
-    // increments to each of the molecules in the steady state, one
-    // at a time, and putting the resultant rate vector into a column
-    // of the J matrix.
-    // This needs a bit of heuristic to decide what is a 'small' increment.
-    // Use the CoInits for this. Stoichiometry shouldn't matter too much.
-    // I used the totals from consv rules earlier, but that can have
-    // negative values.
-    double tot = 0.0;
     Stoich* s = reinterpret_cast< Stoich* >( stoich_.eref().data() );
     vector< double > nVec = LookupField< unsigned int, vector< double > >::get(
                                 s->getKsolve(), "nVec", 0 );
     for ( unsigned int i = 0; i < numVarPools_; ++i )
     {
-        tot += nVec[i];
-    }
-    tot *= DELTA;
-
-    vector< double > yprime( nVec.size(), 0.0 );
-    // Fill up Jacobian
-    for ( unsigned int i = 0; i < numVarPools_; ++i )
-    {
-        double orig = nVec[i];
-        if ( isNaN( orig ) )
+        if ( isNaN( nVec[i] ) )
         {
             cout << "Warning: SteadyState::classifyState: orig=nan\n";
             solutionStatus_ = 2; // Steady state OK, eig failed
-            gsl_matrix_free ( J );
-            return;
-        }
-        if ( isNaN( tot ) )
-        {
-            cout << "Warning: SteadyState::classifyState: tot=nan\n";
-            solutionStatus_ = 2; // Steady state OK, eig failed
-            gsl_matrix_free ( J );
             return;
         }
-        nVec[i] = orig + tot;
-
-        pool_.updateRates( &nVec[0], &yprime[0] );
-        nVec[i] = orig;
+    }
+    unsigned int type = classify( nVec, eigenvalues_,
+                                  nNegEigenvalues_, nPosEigenvalues_ );
+    if ( type == ~0U )
+        solutionStatus_ = 2; // Steady state OK, eig classification failed
+    else
+        stateType_ = type;
+#endif
+}
 
-        // Assign the rates for each mol.
+#ifdef USE_GSL
+/**
+ * Finds the eigenvalues of the Jacobian at S, which the pools compute
+ * analytically from the rate terms, and classifies the state from them.
+ * Returns ~0U if the eigenvalues could not be found.
+ */
+unsigned int SteadyState::classify( const vector< double >& S,
+                                    vector< double >& eig, unsigned int& nNeg,
+                                    unsigned int& nPos ) const
+{
+    vector< double > jac;
+    pool_.getJacobian( &S[0], jac );
+    gsl_matrix* J = gsl_matrix_alloc( numVarPools_, numVarPools_ );
+    for ( unsigned int i = 0; i < numVarPools_; ++i )
         for ( unsigned int j = 0; j < numVarPools_; ++j )
-        {
-            gsl_matrix_set( J, i, j, yprime[j] );
-        }
-    }
+            gsl_matrix_set( J, i, j, jac[ i * numVarPools_ + j ] );
 
-    // Jacobian is now ready. Find eigenvalues.
     gsl_vector_complex* vec = gsl_vector_complex_alloc( numVarPools_ );
     gsl_eigen_nonsymm_workspace* workspace =
         gsl_eigen_nonsymm_alloc( numVarPools_ );
     int status = gsl_eigen_nonsymm( J, vec, workspace );
-    eigenvalues_.clear();
-    eigenvalues_.resize( numVarPools_, 0.0 );
+    eig.clear();
+    eig.resize( numVarPools_, 0.0 );
+    unsigned int type = ~0U;
     if ( status != GSL_SUCCESS )
     {
         cout << "Warning: SteadyState::classifyState failed to find eigenvalues. Status = " <<
              status << endl;
-        solutionStatus_ = 2; // Steady state OK, eig classification failed
     }
     else     // Eigenvalues are ready. Classify state.
     {
-        nNegEigenvalues_ = 0;
-        nPosEigenvalues_ = 0;
+        nNeg = 0;
+        nPos = 0;
         for ( unsigned int i = 0; i < numVarPools_; ++i )
         {
             gsl_complex z = gsl_vector_complex_get( vec, i );
             double r = GSL_REAL( z );
-            nNegEigenvalues_ += ( r < -EPSILON );
-            nPosEigenvalues_ += ( r > EPSILON );
-            eigenvalues_[i] = r;
+            nNeg += ( r < -EPSILON );
+            nPos += ( r > EPSILON );
+            eig[i] = r;
             // We have a problem here because numVarPools_ usually > rank
             // This means we have several zero eigenvalues.
         }
 
-        if ( nNegEigenvalues_ == rank_ )
-            stateType_ = 0; // Stable
-        else if ( nPosEigenvalues_ == rank_ ) // Never see it.
-            stateType_ = 1; // Unstable
-        else  if (nPosEigenvalues_ == 1)
-            stateType_ = 2; // Saddle
-        else if ( nPosEigenvalues_ >= 2 )
-            stateType_ = 3; // putative oscillatory
-        else if ( nNegEigenvalues_ == ( rank_ - 1) && nPosEigenvalues_ == 0 )
-            stateType_ = 4; // one zero or unclassified eigenvalue. Messy.
+        if ( nNeg == rank_ )
+            type = 0; // Stable
+        else if ( nPos == rank_ ) // Never see it.
+            type = 1; // Unstable
+        else  if (nPos == 1)
+            type = 2; // Saddle
+        else if ( nPos >= 2 )
+            type = 3; // putative oscillatory
+        else if ( nNeg == ( rank_ - 1) && nPos == 0 )
+            type = 4; // one zero or unclassified eigenvalue. Messy.
         else
-            stateType_ = 5; // Other
+            type = 5; // Other
     }
 
     gsl_vector_complex_free( vec );
     gsl_matrix_free ( J );
     gsl_eigen_nonsymm_free( workspace );
-#endif
+    return type;
 }
+#endif
 
 static bool isSolutionPositive( const vector< double >& x )
 {
@@ -1092,29 +1239,10 @@ void SteadyState::randomizeInitialCondition( const Eref& me )
     vector< double > nVec =
         LookupField< unsigned int, vector< double > >::get(
             ksolve,"nVec", 0 );
-    int numConsv = total_.size();
     recalcTotal( total_, gamma_, &nVec[0] );
-    // The reorderRows function likes to have an I matrix at the end of
-    // numVarPools_, so we provide space for it, although only its first
-    // column is used for the total vector.
-    gsl_matrix* U = gsl_matrix_calloc ( numConsv, numVarPools_ + numConsv );
-    for ( int i = 0; i < numConsv; ++i )
-    {
-        for ( unsigned int j = 0; j < numVarPools_; ++j )
-        {
-            gsl_matrix_set( U, i, j, gsl_matrix_get( gamma_, i, j ) );
-        }
-        gsl_matrix_set( U, i, numVarPools_, total_[i] );
-    }
-    // Do the forward elimination
-    int rank = myGaussianDecomp( U );
-    assert( rank = numConsv );
-
-    vector< double > eliminatedTotal( numConsv, 0.0 );
-    for ( int i = 0; i < numConsv; ++i )
-    {
-        eliminatedTotal[i] = gsl_matrix_get( U, i, numVarPools_ );
-    }
+    int numConsv = total_.size();
+    vector< double > eliminatedTotal;
+    gsl_matrix* U = eliminatedConsvMatrix( eliminatedTotal );
 
     // Put Find a vector Y that fits the consv rules.
     vector< double > y( numVarPools_, 0.0 );
@@ -1123,6 +1251,7 @@ void SteadyState::randomizeInitialCondition( const Eref& me )
         fitConservationRules( U, eliminatedTotal, y );
     }
     while ( !checkAboveZero( y ) );
+    gsl_matrix_free( U );
 
     // Sanity check. Try the new vector with the old gamma and tots
     for ( int i = 0; i < numConsv; ++i )
@@ -1193,3 +1322,558 @@ void SteadyState::fitConservationRules(
 }
 
 #endif
+
+#ifdef USE_GSL
+gsl_matrix* SteadyState::eliminatedConsvMatrix(
+    vector< double >& eliminatedTotal )
+{
+    int numConsv = total_.size();
+    // The reorderRows function likes to have an I matrix at the end of
+    // numVarPools_, so we provide space for it, although only its first
+    // column is used for the total vector.
+    gsl_matrix* U = gsl_matrix_calloc ( numConsv, numVarPools_ + numConsv );
+    for ( int i = 0; i < numConsv; ++i )
+    {
+        for ( unsigned int j = 0; j < numVarPools_; ++j )
+        {
+            gsl_matrix_set( U, i, j, gsl_matrix_get( gamma_, i, j ) );
+        }
+        gsl_matrix_set( U, i, numVarPools_, total_[i] );
+    }
+    // Do the forward elimination
+    int rank = myGaussianDecomp( U );
+    assert( rank = numConsv );
+
+    eliminatedTotal.assign( numConsv, 0.0 );
+    for ( int i = 0; i < numConsv; ++i )
+    {
+        eliminatedTotal[i] = gsl_matrix_get( U, i, numVarPools_ );
+    }
+    return U;
+}
+
+//////////////////////////////////////////////////////////////////
+// Newton solver using the analytic Jacobian
+//////////////////////////////////////////////////////////////////
+
+static double sumAbs( const vector< double >& x )
+{
+    double ret = 0.0;
+    for ( vector< double >::const_iterator
+            i = x.begin(); i != x.end(); ++i )
+        ret += fabs( *i );
+    return ret;
+}
+
+static bool isLUSingular( const gsl_matrix* LU )
+{
+    for ( size_t i = 0; i < LU->size1; ++i )
+        if ( gsl_matrix_get( LU, i, i ) == 0.0 )
+            return true;
+    return false;
+}
+
+double SteadyState::evalResidual( const vector< double >& S,
+                                  const double* T, vector< double >& F ) const
+{
+    vector< double > vels;
+    pool_.updateReacVelocities( &S[0], vels );
+    F.assign( numVarPools_, 0.0 );
+    double err = 0.0;
+    // Nr is row-echelon: diagonal and above.
+    for ( unsigned int i = 0; i < rank_; ++i )
+    {
+        double gross = 1.0;
+        for ( unsigned int j = i; j < nReacs_; ++j )
+        {
+            double flux = gsl_matrix_get( Nr_, i, j ) * vels[j];
+            F[i] += flux;
+            gross += fabs( flux );
+        }
+        err = max( err, fabs( F[i] ) / gross );
+    }
+
+    unsigned int nConsv = numVarPools_ - rank_;
+    for ( unsigned int i = 0; i < nConsv; ++i )
+    {
+        double dT = -T[i];
+        for ( unsigned int j = 0; j < numVarPools_; ++j )
+            dT += gsl_matrix_get( gamma_, i, j ) * S[j];
+        F[ i + rank_ ] = dT;
+        err = max( err, fabs( dT ) / ( 1.0 + fabs( T[i] ) ) );
+    }
+    return err;
+}
+
+void SteadyState::evalResidualJacobian( const vector< double >& S,
+                                        gsl_matrix* J ) const
+{
+    vector< double > dv;
+    pool_.getVelocityJacobian( &S[0], dv );
+    gsl_matrix_set_zero( J );
+    for ( unsigned int i = 0; i < rank_; ++i )
+    {
+        for ( unsigned int j = i; j < nReacs_; ++j )
+        {
+            double nr = gsl_matrix_get( Nr_, i, j );
+            if ( nr == 0.0 )
+                continue;
+            const double* dvRow = &dv[ j * numVarPools_ ];
+            for ( unsigned int m = 0; m < numVarPools_; ++m )
+                gsl_matrix_set( J, i, m,
+                                gsl_matrix_get( J, i, m ) + nr * dvRow[m] );
+        }
+    }
+    unsigned int nConsv = numVarPools_ - rank_;
+    for ( unsigned int i = 0; i < nConsv; ++i )
+        for ( unsigned int m = 0; m < numVarPools_; ++m )
+            gsl_matrix_set( J, i + rank_, m, gsl_matrix_get( gamma_, i, m ) );
+}
+
+bool SteadyState::newtonSolve( vector< double >& S, const double* T ) const
+{
+    unsigned int n = numVarPools_;
+    gsl_matrix* J = gsl_matrix_alloc( n, n );
+    gsl_permutation* perm = gsl_permutation_alloc( n );
+    gsl_vector* b = gsl_vector_alloc( n );
+    gsl_vector* dx = gsl_vector_alloc( n );
+    vector< double > F;
+    vector< double > trial;
+    double err = evalResidual( S, T, F );
+    double res = sumAbs( F );
+    for ( unsigned int iter = 0; iter < maxIter_; ++iter )
+    {
+        if ( err < convergenceCriterion_ )
+            break;
+        evalResidualJacobian( S, J );
+        int sign;
+        gsl_linalg_LU_decomp( J, perm, &sign );
+        if ( isLUSingular( J ) )
+            break;
+        for ( unsigned int i = 0; i < n; ++i )
+            gsl_vector_set( b, i, -F[i] );
+        gsl_linalg_LU_solve( J, perm, b, dx );
+
+        // A pool that would go negative drops to a tenth instead, and
+        // the step is halved until the residual falls.
+        double lambda = 1.0;
+        double newRes = res;
+        double newErr = err;
+        trial = S;
+        for ( unsigned int k = 0; k < 30; ++k )
+        {
+            for ( unsigned int i = 0; i < n; ++i )
+            {
+                trial[i] = S[i] + lambda * gsl_vector_get( dx, i );
+                if ( trial[i] < 0.0 )
+                    trial[i] = 0.1 * S[i];
+            }
+            newErr = evalResidual( trial, T, F );
+            newRes = sumAbs( F );
+            if ( newRes < res )
+                break;
+            lambda *= 0.5;
+        }
+        if ( !( newRes < res ) )
+            break; // No progress
+        S.swap( trial );
+        res = newRes;
+        err = newErr;
+    }
+
+    gsl_vector_free( dx );
+    gsl_vector_free( b );
+    gsl_permutation_free( perm );
+    gsl_matrix_free( J );
+    return err < convergenceCriterion_;
+}
+#endif // USE_GSL
+
+//////////////////////////////////////////////////////////////////
+// Multiple starts
+//////////////////////////////////////////////////////////////////
+
+/// Fixed points closer than this, relative to their largest pool, match.
+static const double ROOT_TOLERANCE = 1e-4;
+
+void SteadyState::multiStart( unsigned int numStarts )
+{
+#ifdef USE_GSL
+    gsl_set_error_handler_off();
+    fixedPoints_.clear();
+    fixedPointTypes_.clear();
+    if ( !isInitialized_ )
+    {
+        cout << "Error: SteadyState object has not been initialized. No calculations done\n";
+        return;
+    }
+    if ( isSetup_ == 0 )
+        setupSSmatrix();
+    if ( isSetup_ == 0 || numStarts == 0 )
+        return;
+
+    Stoich* stoichPtr = reinterpret_cast< Stoich* >( stoich_.eref().data() );
+    // Pick up rate changes made since the stoich was assigned.
+    pool_.updateAllRateTerms( stoichPtr->getRateTerms(),
+                              stoichPtr->getNumCoreRates() );
+    Id ksolve = Field< Id >::get( stoich_, "ksolve" );
+    vector< double > nVec =
+        LookupField< unsigned int, vector< double > >::get(
+            ksolve,"nVec", 0 );
+    if ( reassignTotal_ )
+        reassignTotal_ = 0;
+    else
+        recalcTotal( total_, gamma_, &nVec[0] );
+    vector< double > T = total_;
+
+    // The starts are drawn up front, as the random number generator is
+    // shared. Pools outside the conservation rules are not set by
+    // fitConservationRules, so they are spread log-uniformly over four
+    // decades around the largest of the pool numbers and totals.
+    double ref = 1.0;
+    for ( unsigned int i = 0; i < nVec.size(); ++i )
+        ref = max( ref, nVec[i] );
+    for ( unsigned int i = 0; i < T.size(); ++i )
+        ref = max( ref, fabs( T[i] ) );
+    vector< double > eliminatedTotal;
+    gsl_matrix* U = eliminatedConsvMatrix( eliminatedTotal );
+    vector< vector< double > > starts( numStarts, nVec );
+    vector< double > y( numVarPools_, 0.0 );
+    for ( unsigned int k = 0; k < numStarts; ++k )
+    {
+        do
+        {
+            for ( unsigned int i = 0; i < numVarPools_; ++i )
+                y[i] = ref * pow( 10.0, 4.0 * moose::mtrand() - 3.0 );
+            fitConservationRules( U, eliminatedTotal, y );
+        }
+        while ( !checkAboveZero( y ) );
+        copy( y.begin(), y.end(), starts[k].begin() );
+    }
+    gsl_matrix_free( U );
+
+    // Rates computed by Functions are not safe to evaluate concurrently.
+    unsigned int numThreads = min( numThreads_, numStarts );
+    const vector< RateTerm* >& rates = stoichPtr->getRateTerms();
+    for ( vector< RateTerm* >::const_iterator
+            i = rates.begin(); i != rates.end(); ++i )
+        if ( dynamic_cast< const ExternReac* >( *i ) )
+            numThreads = 1;
+
+    vector< char > converged( numStarts, 0 );
+    auto solveRange = [&]( unsigned int begin, unsigned int end )
+    {
+        for ( unsigned int k = begin; k < end; ++k )
+            converged[k] = newtonSolve( starts[k], &T[0] ) &&
+                           checkAboveZero( starts[k] );
+    };
+    if ( numThreads <= 1 )
+    {
+        solveRange( 0, numStarts );
+    }
+    else
+    {
+        unsigned int blockSize = ( numStarts + numThreads - 1 ) / numThreads;
+        vector< std::future< void > > futures;
+        for ( unsigned int begin = 0; begin < numStarts; begin += blockSize )
+            futures.push_back( std::async( std::launch::async, solveRange,
+                begin, min( begin + blockSize, numStarts ) ) );
+        for ( auto& f : futures )
+            f.get();
+    }
+
+    // Keep each distinct root once, in the order of the starts, so the
+    // result does not depend on the number of threads.
+    for ( unsigned int k = 0; k < numStarts; ++k )
+    {
+        if ( !converged[k] )
+            continue;
+        const vector< double >& x = starts[k];
+        bool isNew = true;
+        for ( unsigned int f = 0; f < fixedPoints_.size() && isNew; ++f )
+        {
+            double scale = 0.0;
+            double diff = 0.0;
+            for ( unsigned int i = 0; i < numVarPools_; ++i )
+            {
+                scale = max( scale, max( fabs( x[i] ),
+                                         fabs( fixedPoints_[f][i] ) ) );
+                diff = max( diff, fabs( x[i] - fixedPoints_[f][i] ) );
+            }
+            isNew = ( diff > ROOT_TOLERANCE * scale );
+        }
+        if ( !isNew )
+            continue;
+        fixedPoints_.push_back( x );
+        vector< double > eig;
+        unsigned int nNeg = 0;
+        unsigned int nPos = 0;
+        unsigned int type = classify( x, eig, nNeg, nPos );
+        fixedPointTypes_.push_back( type == ~0U ? 5 : type );
+    }
+#endif
+}
+
+//////////////////////////////////////////////////////////////////
+// Continuation
+//////////////////////////////////////////////////////////////////
+
+void SteadyState::continuation( string reacPath, double scaleMin,
+                                double scaleMax )
+{
+#ifdef USE_GSL
+    gsl_set_error_handler_off();
+    branchScale_.clear();
+    branchPoints_.clear();
+    branchTypes_.clear();
+    if ( !isInitialized_ )
+    {
+        cout << "Error: SteadyState object has not been initialized. No calculations done\n";
+        return;
+    }
+    if ( !( scaleMin > 0.0 && scaleMin <= 1.0 && scaleMax >= 1.0 ) )
+    {
+        cout << "Warning: SteadyState::continuation: need "
+             "0 < scaleMin <= 1 <= scaleMax\n";
+        return;
+    }
+    if ( isSetup_ == 0 )
+        setupSSmatrix();
+    if ( isSetup_ == 0 )
+        return;
+
+    Stoich* stoichPtr = reinterpret_cast< Stoich* >( stoich_.eref().data() );
+    Id reacId( reacPath );
+    unsigned int index = ~0U;
+    if ( reacId != Id() )
+        index = stoichPtr->convertIdToReacIndex( reacId );
+    if ( index == ~0U )
+    {
+        cout << "Warning: SteadyState::continuation: no reaction on '" <<
+             reacPath << "'\n";
+        return;
+    }
+    pool_.updateAllRateTerms( stoichPtr->getRateTerms(),
+                              stoichPtr->getNumCoreRates() );
+    setBranchScale( index, 1.0 );
+
+    Id ksolve = Field< Id >::get( stoich_, "ksolve" );
+    vector< double > nVec =
+        LookupField< unsigned int, vector< double > >::get(
+            ksolve,"nVec", 0 );
+    if ( reassignTotal_ )
+        reassignTotal_ = 0;
+    else
+        recalcTotal( total_, gamma_, &nVec[0] );
+    vector< double > T = total_;
+    if ( !newtonSolve( nVec, &T[0] ) )
+    {
+        cout << "Warning: SteadyState::continuation: no steady state "
+             "found to start from\n";
+        return;
+    }
+
+    vector< double > downScale, upScale;
+    vector< vector< double > > downPoints, upPoints;
+    traceBranch( index, nVec, &T[0], -1.0, scaleMin, scaleMax,
+                 downScale, downPoints );
+    traceBranch( index, nVec, &T[0], 1.0, scaleMin, scaleMax,
+                 upScale, upPoints );
+    branchScale_.assign( downScale.rbegin(), downScale.rend() );
+    branchPoints_.assign( downPoints.rbegin(), downPoints.rend() );
+    branchScale_.push_back( 1.0 );
+    branchPoints_.push_back( nVec );
+    branchScale_.insert( branchScale_.end(), upScale.begin(), upScale.end() );
+    branchPoints_.insert( branchPoints_.end(),
+                          upPoints.begin(), upPoints.end() );
+
+    for ( unsigned int i = 0; i < branchScale_.size(); ++i )
+    {
+        setBranchScale( index, branchScale_[i] );
+        vector< double > eig;
+        unsigned int nNeg = 0;
+        unsigned int nPos = 0;
+        unsigned int type = classify( branchPoints_[i], eig, nNeg, nPos );
+        branchTypes_.push_back( type == ~0U ? 5 : type );
+    }
+    setBranchScale( index, 1.0 );
+#endif
+}
+
+#ifdef USE_GSL
+void SteadyState::setBranchScale( unsigned int index, double scale )
+{
+    Stoich* stoichPtr = reinterpret_cast< Stoich* >( stoich_.eref().data() );
+    pool_.setRateScale( index, scale, pool_.getR2Scale( index ) );
+    pool_.updateRateTerms( stoichPtr->getRateTerms(),
+                           stoichPtr->getNumCoreRates(), index );
+}
+
+/**
+ * Pseudo-arclength continuation. The unknowns are the var pools and the
+ * scale p on the rate constant. Each step predicts along the unit
+ * tangent and corrects with chord iterations on the system augmented by
+ * the arclength condition. The factorization from the previous point is
+ * reused by the corrector, and only redone when it stops converging
+ * quickly, and the factorization at each new point also gives the next
+ * tangent. Pools are divided by the largest of them in the arclength, so
+ * that they weigh in comparably with p.
+ */
+void SteadyState::traceBranch( unsigned int index, vector< double > S,
+                               const double* T, double direction, double scaleMin,
+                               double scaleMax, vector< double >& scales,
+                               vector< vector< double > >& points )
+{
+    const unsigned int maxSteps = 1000;
+    const unsigned int n = numVarPools_;
+    double sc = 1.0;
+    for ( unsigned int i = 0; i < n; ++i )
+        sc = max( sc, fabs( S[i] ) );
+
+    gsl_matrix* J = gsl_matrix_alloc( n, n );
+    gsl_matrix* A = gsl_matrix_alloc( n + 1, n + 1 );
+    gsl_permutation* perm = gsl_permutation_alloc( n + 1 );
+    gsl_vector* b = gsl_vector_alloc( n + 1 );
+    gsl_vector* dz = gsl_vector_alloc( n + 1 );
+    vector< double > F, Fp;
+    // Unit tangent, in the scaled coordinates. Starting with the tangent
+    // along p makes the first solve give dS/dp.
+    vector< double > tangent( n + 1, 0.0 );
+    tangent[n] = 1.0;
+    double p = 1.0;
+
+    // Builds and factorizes [ dF/dS dF/dp ; tangent ] at ( x, q ).
+    auto factorize = [&]( const vector< double >& x, double q ) -> bool
+    {
+        double h = 1e-6 * q;
+        setBranchScale( index, q + h );
+        evalResidual( x, T, Fp );
+        setBranchScale( index, q );
+        evalResidual( x, T, F );
+        evalResidualJacobian( x, J );
+        for ( unsigned int i = 0; i < n; ++i )
+        {
+            for ( unsigned int j = 0; j < n; ++j )
+                gsl_matrix_set( A, i, j, gsl_matrix_get( J, i, j ) );
+            gsl_matrix_set( A, i, n, ( Fp[i] - F[i] ) / h );
+        }
+        for ( unsigned int j = 0; j < n; ++j )
+            gsl_matrix_set( A, n, j, tangent[j] / sc );
+        gsl_matrix_set( A, n, n, tangent[n] );
+        int sign;
+        gsl_linalg_LU_decomp( A, perm, &sign );
+        return !isLUSingular( A );
+    };
+
+    // Solves the factorized system for the next tangent, keeping its
+    // orientation.
+    auto updateTangent = [&]( double orient )
+    {
+        gsl_vector_set_zero( b );
+        gsl_vector_set( b, n, 1.0 );
+        gsl_linalg_LU_solve( A, perm, b, dz );
+        vector< double > t( n + 1 );
+        double norm = 0.0;
+        for ( unsigned int i = 0; i <= n; ++i )
+        {
+            t[i] = gsl_vector_get( dz, i ) / ( i < n ? sc : 1.0 );
+            norm += t[i] * t[i];
+        }
+        norm = sqrt( norm );
+        double dot = 0.0;
+        for ( unsigned int i = 0; i <= n; ++i )
+        {
+            t[i] /= norm;
+            dot += t[i] * tangent[i];
+        }
+        if ( dot * orient < 0.0 )
+            for ( unsigned int i = 0; i <= n; ++i )
+                t[i] = -t[i];
+        tangent = t;
+    };
+
+    bool ok = factorize( S, p );
+    if ( ok )
+        updateTangent( direction );
+    double ds = continuationStep_;
+    vector< double > x;
+    for ( unsigned int step = 0; ok && step < maxSteps; ++step )
+    {
+        // Predictor
+        x = S;
+        for ( unsigned int i = 0; i < n; ++i )
+            x[i] += ds * tangent[i] * sc;
+        double q = p + ds * tangent[n];
+        const vector< double > xPred = x;
+        const double qPred = q;
+
+        // Corrector
+        bool converged = false;
+        unsigned int numRefactor = 0;
+        unsigned int iter = 0;
+        double lastRes = 0.0;
+        for ( ; iter < maxIter_ && q > 0.0; ++iter )
+        {
+            setBranchScale( index, q );
+            double err = evalResidual( x, T, F );
+            double res = sumAbs( F );
+            double arc = tangent[n] * ( q - qPred );
+            for ( unsigned int i = 0; i < n; ++i )
+                arc += tangent[i] * ( x[i] - xPred[i] ) / sc;
+            if ( err < convergenceCriterion_ && fabs( arc ) < 1e-8 )
+            {
+                converged = true;
+                break;
+            }
+            if ( iter > 0 && res > 0.5 * lastRes )
+            {
+                if ( ++numRefactor > 3 || !factorize( x, q ) )
+                    break;
+                setBranchScale( index, q );
+            }
+            lastRes = res;
+            for ( unsigned int i = 0; i < n; ++i )
+                gsl_vector_set( b, i, -F[i] );
+            gsl_vector_set( b, n, -arc );
+            gsl_linalg_LU_solve( A, perm, b, dz );
+            for ( unsigned int i = 0; i < n; ++i )
+                x[i] += gsl_vector_get( dz, i );
+            q += gsl_vector_get( dz, n );
+        }
+        for ( unsigned int i = 0; i < n && converged; ++i )
+            converged = ( x[i] > -ROOT_TOLERANCE * sc );
+
+        if ( !converged )
+        {
+            // Retry from the last point with a shorter step.
+            ds *= 0.5;
+            if ( ds < continuationStep_ * 1e-3 )
+                break;
+            ok = factorize( S, p );
+            continue;
+        }
+        if ( q < scaleMin || q > scaleMax )
+            break;
+
+        for ( unsigned int i = 0; i < n; ++i )
+            x[i] = max( 0.0, x[i] );
+        S = x;
+        p = q;
+        scales.push_back( p );
+        points.push_back( S );
+
+        ok = factorize( S, p );
+        if ( ok )
+            updateTangent( 1.0 );
+        if ( iter <= 3 )
+            ds = min( ds * 1.5, continuationStep_ * 50.0 );
+    }
+    setBranchScale( index, 1.0 );
+
+    gsl_vector_free( dz );
+    gsl_vector_free( b );
+    gsl_permutation_free( perm );
+    gsl_matrix_free( A );
+    gsl_matrix_free( J );
+}
+#endif // USE_GSL
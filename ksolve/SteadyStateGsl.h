@@ -42,6 +42,16 @@ class SteadyState
 		unsigned int getNnegEigenvalues() const;
 		unsigned int getNposEigenvalues() const;
 		unsigned int getSolutionStatus() const;
+		unsigned int getNumThreads() const;
+		void setNumThreads( unsigned int value );
+		unsigned int getNumFixedPoints() const;
+		vector< double > getFixedPoint( unsigned int i ) const;
+		unsigned int getFixedPointType( unsigned int i ) const;
+		double getContinuationStep() const;
+		void setContinuationStep( double value );
+		vector< double > getBranchScale() const;
+		vector< double > getBranchPoint( unsigned int i ) const;
+		vector< unsigned int > getBranchType() const;
 
 		///////////////////////////////////////////////////
 		// Msg Dest function definitions
@@ -53,6 +63,9 @@ class SteadyState
 		void showMatricesFunc();
 		void showMatrices();
 		void randomizeInitialCondition( const Eref& e);
+		void multiStart( unsigned int numStarts );
+		void continuation( string reacPath, double scaleMin,
+			double scaleMax );
 		static void assignY( double* S );
 		// static void randomInitFunc();
 		// void randomInit();
@@ -87,6 +100,47 @@ class SteadyState
 
 	private:
 		void setupSSmatrix();
+#ifdef USE_GSL
+		/**
+		 * Returns the conservation matrix gamma_ in row-echelon form,
+		 * padded out for myGaussianDecomp, and the matching totals.
+		 * The caller frees the matrix.
+		 */
+		gsl_matrix* eliminatedConsvMatrix(
+			vector< double >& eliminatedTotal );
+		/**
+		 * Residual of the steady-state equations: Nr.v and gamma.S - T.
+		 * Returns the largest entry relative to the gross flux through
+		 * its row, or to its total, which is what convergenceCriterion
+		 * is compared with.
+		 */
+		double evalResidual( const vector< double >& S, const double* T,
+			vector< double >& F ) const;
+		/// Analytic Jacobian of evalResidual with respect to the var pools
+		void evalResidualJacobian( const vector< double >& S,
+			gsl_matrix* J ) const;
+		/**
+		 * Damped Newton iteration on the var pools of the full pool
+		 * vector S, using the analytic Jacobian. Does not touch the
+		 * solver state, so it can be run from several threads.
+		 */
+		bool newtonSolve( vector< double >& S, const double* T ) const;
+		/// Classifies the fixed point S from the eigenvalues at S.
+		unsigned int classify( const vector< double >& S,
+			vector< double >& eig, unsigned int& nNeg,
+			unsigned int& nPos ) const;
+		/// Sets the scale on R1 of rate term index used by continuation.
+		void setBranchScale( unsigned int index, double scale );
+		/**
+		 * Traces the branch of fixed points from S at scale 1 in the
+		 * given direction, appending points while the scale stays in
+		 * [scaleMin, scaleMax].
+		 */
+		void traceBranch( unsigned int index, vector< double > S,
+			const double* T, double direction, double scaleMin,
+			double scaleMax, vector< double >& scales,
+			vector< vector< double > >& points );
+#endif
 
 		///////////////////////////////////////////////////
 		// Internal fields.
@@ -118,6 +172,19 @@ class SteadyState
 		unsigned int solutionStatus_;
 		unsigned int numFailed_;
 		VoxelPools pool_;
+
+		/// Threads used by multiStart.
+		unsigned int numThreads_;
+		/// Distinct fixed points found by multiStart, as pool numbers.
+		vector< vector< double > > fixedPoints_;
+		vector< unsigned int > fixedPointTypes_;
+
+		/// Initial arclength step for continuation.
+		double continuationStep_;
+		/// Branch traced by continuation, ordered along the branch.
+		vector< double > branchScale_;
+		vector< vector< double > > branchPoints_;
+		vector< unsigned int > branchTypes_;
 };
 
 extern const Cinfo* initSteadyStateCinfo();
@@ -8,7 +8,9 @@
 **********************************************************************/
 class KsolveBase;
 
+#include <chrono>
 #include "../basecode/header.h"
+#include "../basecode/global.h"
 #include "../basecode/ElementValueFinfo.h"
 #include "../kinetics/PoolBase.h"
 #include "../kinetics/EnzBase.h"
@@ -282,6 +284,7 @@ static const Cinfo* stoichCinfo = Stoich::initCinfo();
 Stoich::Stoich()
     : useOneWay_(false),
       allowNegative_(false),
+      isBuilding_(false),
       wildcard_(""),
       ksolve_(),       // Must be reassigned to build stoich system.
       dsolve_(),       // Must be assigned if diffusion is planned.
@@ -415,8 +418,16 @@ void Stoich::setElist(const Eref& e, const vector<ObjId>& elist)
     }
 
     // allocateObjMap( temp );
+    auto t0 = std::chrono::high_resolution_clock::now();
+    // Reactions skip setSolver if they already have this Stoich, so
+    // release them before a rebuild or their rate terms are not made.
+    unZombifyReacs();
     deAllocateModel();
     allocateModel(temp);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    moose::addSolverProf(
+        "Stoich::allocateModel",
+        std::chrono::duration<double>(t1 - t0).count(), 1);
     if(kinterface_) {
         // kinterface_->setNumPools( n );
         kinterface_->setStoich(e.id());
@@ -428,10 +439,20 @@ void Stoich::setElist(const Eref& e, const vector<ObjId>& elist)
         // dinterface_->setNumPools( n );
         dinterface_->setStoich(e.id());
     }
+    isBuilding_ = true;
     zombifyModel(e, temp);
+    isBuilding_ = false;
+    t0 = std::chrono::high_resolution_clock::now();
+    moose::addSolverProf(
+        "Stoich::zombifyModel",
+        std::chrono::duration<double>(t0 - t1).count(), 1);
     if(kinterface_) {
         kinterface_->setDsolve(dsolve_);
         kinterface_->updateRateTerms();
+        t1 = std::chrono::high_resolution_clock::now();
+        moose::addSolverProf(
+            "Stoich::updateRateTerms",
+            std::chrono::duration<double>(t1 - t0).count(), 1);
     }
 }
 
@@ -1293,12 +1314,9 @@ void Stoich::zombifyModel(const Eref& e, const vector<Id>& elist)
             }
             double concInit = Field<double>::get(*i, "concInit");
             SetGet2<ObjId, ObjId>::set(*i, "setSolvers", ksolve_, dsolve_);
-            Field<double>::set(*i, "concInit", concInit);
             ei->resize(numVoxels_);
-            for(unsigned int j = 0; j < numVoxels_; ++j) {
-                ObjId oi(ei->id(), j);
-                Field<double>::set(oi, "concInit", concInit);
-            }
+            // One dispatch for all voxels rather than a set per voxel.
+            Field<double>::setRepeat(ei->id(), "concInit", concInit);
         }
         else if(ei->cinfo() == reacCinfo) {
             SetGet1<ObjId>::set(*i, "setSolver", e.id());
@@ -1346,7 +1364,24 @@ void Stoich::unZombifyModel()
     static const Cinfo* functionCinfo = Cinfo::find("Function");
 
     unZombifyPools();
+    unZombifyReacs();
+
+    vector<Id> temp = poolFuncVec_;
+    temp.insert(temp.end(), incrementFuncVec_.begin(), incrementFuncVec_.end());
+    for(vector<Id>::iterator i = temp.begin(); i != temp.end(); ++i) {
+        Element* e = i->element();
+        if(e != 0 && e->cinfo()->isA("Function")) {
+            SetGet1<ObjId>::set(*i, "setSolver", Id());
+        }
+        if(e != 0 && e->getTick() == -2) {
+            int t = Clock::lookupDefaultTick(e->cinfo()->name());
+            e->setTick(t);
+        }
+    }
+}
 
+void Stoich::unZombifyReacs()
+{
     vector<Id> temp = reacVec_;
     temp.insert(temp.end(), offSolverReacVec_.begin(), offSolverReacVec_.end());
     for(vector<Id>::iterator i = temp.begin(); i != temp.end(); ++i) {
@@ -1373,19 +1408,6 @@ void Stoich::unZombifyModel()
             SetGet1<ObjId>::set(*i, "setSolver", Id());  // Clear stoich
         }
     }
-
-    temp = poolFuncVec_;
-    temp.insert(temp.end(), incrementFuncVec_.begin(), incrementFuncVec_.end());
-    for(vector<Id>::iterator i = temp.begin(); i != temp.end(); ++i) {
-        Element* e = i->element();
-        if(e != 0 && e->cinfo()->isA("Function")) {
-            SetGet1<ObjId>::set(*i, "setSolver", Id());
-        }
-        if(e != 0 && e->getTick() == -2) {
-            int t = Clock::lookupDefaultTick(e->cinfo()->name());
-            e->setTick(t);
-        }
-    }
 }
 
 unsigned int Stoich::convertIdToPoolIndex(Id id) const
@@ -1741,13 +1763,19 @@ void Stoich::installEnzyme(ZeroOrder* r1, ZeroOrder* r2, ZeroOrder* r3,
  * For now assume a uniform voxel volume and hence just convert on
  * 0 meshIndex.
  */
+void Stoich::updateRateTerm(unsigned int index) const
+{
+    if(kinterface_ && !isBuilding_)
+        kinterface_->updateRateTerms(index);
+}
+
 void Stoich::setReacKf(const Eref& e, double v) const
 {
     unsigned int i = convertIdToReacIndex(e.id());
     if(i != ~0U) {
         // rates_[ i ]->setR1( v / volScale );
         rates_[i]->setR1(v);
-        kinterface_->updateRateTerms(i);
+        updateRateTerm(i);
     }
 }
 
@@ -1772,11 +1800,11 @@ void Stoich::setReacKb(const Eref& e, double v) const
 
     if(useOneWay_) {
         rates_[i + 1]->setR1(v);
-        kinterface_->updateRateTerms(i + 1);
+        updateRateTerm(i + 1);
     }
     else {
         rates_[i]->setR2(v);
-        kinterface_->updateRateTerms(i);
+        updateRateTerm(i);
     }
 }
 
@@ -1806,7 +1834,7 @@ void Stoich::setMMenzKm(const Eref& e, double v) const
     */
     // Do scaling and assignment.
     rt->setR1(v);
-    kinterface_->updateRateTerms(index);
+    updateRateTerm(index);
 }
 
 double Stoich::getMMenzNumKm(const Eref& e) const
@@ -1822,7 +1850,7 @@ void Stoich::setMMenzKcat(const Eref& e, double v) const
     // assert( enz );
 
     rt->setR2(v);
-    kinterface_->updateRateTerms(index);
+    updateRateTerm(index);
 }
 
 double Stoich::getMMenzKcat(const Eref& e) const
@@ -1836,7 +1864,7 @@ void Stoich::setEnzK1(const Eref& e, double v) const
     unsigned int index = convertIdToReacIndex(e.id());
 
     rates_[index]->setR1(v);
-    kinterface_->updateRateTerms(index);
+    updateRateTerm(index);
 }
 
 void Stoich::setEnzK2(const Eref& e, double v) const
@@ -1844,11 +1872,11 @@ void Stoich::setEnzK2(const Eref& e, double v) const
     unsigned int index = convertIdToReacIndex(e.id());
     if(useOneWay_) {
         rates_[index + 1]->setR1(v);
-        kinterface_->updateRateTerms(index + 1);
+        updateRateTerm(index + 1);
     }
     else {
         rates_[index]->setR2(v);
-        kinterface_->updateRateTerms(index);
+        updateRateTerm(index);
     }
 }
 
@@ -1857,11 +1885,11 @@ void Stoich::setEnzK3(const Eref& e, double v) const
     unsigned int index = convertIdToReacIndex(e.id());
     if(useOneWay_) {
         rates_[index + 2]->setR1(v);
-        kinterface_->updateRateTerms(index + 2);
+        updateRateTerm(index + 2);
     }
     else {
         rates_[index + 1]->setR1(v);
-        kinterface_->updateRateTerms(index + 1);
+        updateRateTerm(index + 1);
     }
 }
 
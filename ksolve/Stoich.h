@@ -197,6 +197,13 @@ public:
 	/// Removes funcTargetPools from the list of varPools and bufPools
 	void clearFuncTargetPools();
 
+    /**
+     * Passes a change in the prototype rate term at index on to the
+     * voxels of the Ksolve. Skipped while the model is being built,
+     * because setElist refreshes all the rate terms once at the end.
+     */
+    void updateRateTerm(unsigned int index) const;
+
     /// Functions to build the maps between Ids and internal indices
     void buildPoolLookup();
     void buildRateTermLookup();
@@ -239,6 +246,10 @@ public:
     /// unZombifies Pools. Helper for unZombifyModel.
     void unZombifyPools();
 
+    /// Releases Reacs and Enzymes from the Stoich. Helper for
+    /// unZombifyModel, also used before a rebuild.
+    void unZombifyReacs();
+
     void zombifyChemCompt(Id compt);
 
     /**
@@ -517,6 +528,12 @@ private:
      */
     bool allowNegative_;
 
+    /**
+     * True while setElist is zombifying the model. The parameter
+     * assignments made then only go to the prototype rate terms.
+     */
+    bool isBuilding_;
+
     string wildcard_;
 
     /// This contains the Id of the Kinetic solver.
@@ -0,0 +1,120 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2024 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include "../basecode/header.h"
+#include "../shell/Checkpoint.h"
+#include "VoxelEventQueue.h"
+
+#include <limits>
+
+VoxelEventQueue::VoxelEventQueue()
+{;}
+
+void VoxelEventQueue::build( const vector< double >& times )
+{
+    time_ = times;
+    unsigned int n = times.size();
+    heap_.resize( n );
+    pos_.resize( n );
+    for ( unsigned int i = 0; i < n; ++i )
+    {
+        heap_[i] = i;
+        pos_[i] = i;
+    }
+    for ( unsigned int i = n / 2; i > 0; --i )
+        siftDown( i - 1 );
+}
+
+unsigned int VoxelEventQueue::top() const
+{
+    assert( heap_.size() > 0 );
+    return heap_[0];
+}
+
+double VoxelEventQueue::topTime() const
+{
+    if ( heap_.size() == 0 )
+        return numeric_limits< double >::infinity();
+    return time_[ heap_[0] ];
+}
+
+double VoxelEventQueue::time( unsigned int voxel ) const
+{
+    assert( voxel < time_.size() );
+    return time_[ voxel ];
+}
+
+unsigned int VoxelEventQueue::size() const
+{
+    return heap_.size();
+}
+
+void VoxelEventQueue::saveState( CheckpointWriter& w,
+                                 const string& prefix ) const
+{
+    w.add( prefix + "time", time_ );
+    w.add( prefix + "heap", heap_ );
+    w.add( prefix + "pos", pos_ );
+}
+
+void VoxelEventQueue::loadState( CheckpointReader& r, const string& prefix )
+{
+    r.get( prefix + "time", time_ );
+    r.get( prefix + "heap", heap_ );
+    r.get( prefix + "pos", pos_ );
+}
+
+void VoxelEventQueue::update( unsigned int voxel, double t )
+{
+    assert( voxel < time_.size() );
+    double old = time_[ voxel ];
+    time_[ voxel ] = t;
+    if ( t < old )
+        siftUp( pos_[ voxel ] );
+    else
+        siftDown( pos_[ voxel ] );
+}
+
+void VoxelEventQueue::swapEntries( unsigned int a, unsigned int b )
+{
+    std::swap( heap_[a], heap_[b] );
+    pos_[ heap_[a] ] = a;
+    pos_[ heap_[b] ] = b;
+}
+
+void VoxelEventQueue::siftUp( unsigned int pos )
+{
+    while ( pos > 0 )
+    {
+        unsigned int parent = ( pos - 1 ) / 2;
+        if ( time_[ heap_[ parent ] ] <= time_[ heap_[ pos ] ] )
+            break;
+        swapEntries( pos, parent );
+        pos = parent;
+    }
+}
+
+void VoxelEventQueue::siftDown( unsigned int pos )
+{
+    unsigned int n = heap_.size();
+    while ( true )
+    {
+        unsigned int smallest = pos;
+        unsigned int left = 2 * pos + 1;
+        unsigned int right = left + 1;
+        if ( left < n && time_[ heap_[left] ] < time_[ heap_[smallest] ] )
+            smallest = left;
+        if ( right < n && time_[ heap_[right] ] < time_[ heap_[smallest] ] )
+            smallest = right;
+        if ( smallest == pos )
+            break;
+        swapEntries( pos, smallest );
+        pos = smallest;
+    }
+}
@@ -0,0 +1,65 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2024 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _VOXEL_EVENT_QUEUE_H
+#define _VOXEL_EVENT_QUEUE_H
+
+class CheckpointWriter;
+class CheckpointReader;
+
+/**
+ * Indexed binary min-heap of next event times, one entry per voxel.
+ * This is the priority queue of the next-subvolume method (Elf and
+ * Ehrenberg 2004): the voxel at the top of the heap has the earliest
+ * pending event. The index lets us change the time of any voxel in
+ * log time, which is needed because a diffusion jump changes the
+ * propensities of two voxels.
+ */
+class VoxelEventQueue
+{
+public:
+    VoxelEventQueue();
+
+    /// Builds the heap from scratch, one time entry per voxel.
+    void build( const vector< double >& times );
+
+    /// Voxel with the earliest event.
+    unsigned int top() const;
+
+    /// Time of the earliest event.
+    double topTime() const;
+
+    /// Time of the pending event for the specified voxel.
+    double time( unsigned int voxel ) const;
+
+    /// Changes the event time of a voxel and restores heap order.
+    void update( unsigned int voxel, double t );
+
+    unsigned int size() const;
+
+    /// Checkpoint support: the heap is saved as is.
+    void saveState( CheckpointWriter& w, const string& prefix ) const;
+    void loadState( CheckpointReader& r, const string& prefix );
+
+private:
+    void siftUp( unsigned int pos );
+    void siftDown( unsigned int pos );
+    void swapEntries( unsigned int a, unsigned int b );
+
+    /// Event time for each voxel, indexed by voxel.
+    vector< double > time_;
+
+    /// Heap of voxel indices, ordered by time_.
+    vector< unsigned int > heap_;
+
+    /// Position of each voxel in heap_.
+    vector< unsigned int > pos_;
+};
+
+#endif // _VOXEL_EVENT_QUEUE_H
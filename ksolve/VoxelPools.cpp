@@ -28,13 +28,15 @@ using namespace boost::numeric;
 #include "KinSparseMatrix.h"
 #include "XferInfo.h"
 #include "KsolveBase.h"
+#include "SparseJacobian.h"
 #include "Ksolve.h"
 #include "Stoich.h"
 
 //////////////////////////////////////////////////////////////
 // Class definitions
 
-VoxelPools::VoxelPools() : pLSODA(nullptr)
+VoxelPools::VoxelPools() : pLSODA(nullptr), jacobian_(nullptr),
+    rosenbrockDt_(0.0)
 {
 	lsodaState_ = 1;
 #ifdef USE_GSL
@@ -59,6 +61,7 @@ void VoxelPools::reinit( double dt )
 {
     VoxelPoolsBase::reinit();
 	lsodaState_ = 1;
+    rosenbrockDt_ = dt / 10.0;
 #ifdef USE_GSL
     if ( !driver_ )
         return;
@@ -136,6 +139,15 @@ void VoxelPools::advance( const ProcInfo* p )
             assert(0);
         }
     }
+    else if( method_ == "rosenbrock" && jacobian_ )
+    {
+        if ( !advanceRosenbrock( t, p->currTime ) )
+        {
+            cerr << "Error: VoxelPools::advance: Rosenbrock timestep has "
+                 "gotten too small at time " << t << "\n";
+            assert( 0 );
+        }
+    }
     else
     {
 
@@ -315,6 +327,141 @@ void VoxelPools::setInitDt( double dt )
 #ifdef USE_GSL
     gsl_odeiv2_driver_reset_hstart( driver_, dt );
 #endif
+    rosenbrockDt_ = dt;
+}
+
+void VoxelPools::getStepState( double* h ) const
+{
+    h[0] = rosenbrockDt_;
+    h[1] = 0.0;
+#ifdef USE_GSL
+    if ( driver_ )
+        h[1] = driver_->h;
+#endif
+}
+
+void VoxelPools::setStepState( const double* h )
+{
+    rosenbrockDt_ = h[0];
+    lsodaState_ = 1;
+#ifdef USE_GSL
+    if ( driver_ && h[1] != 0.0 )
+        gsl_odeiv2_driver_reset_hstart( driver_, h[1] );
+#endif
+}
+
+void VoxelPools::setJacobian( const SparseJacobian* jacobian )
+{
+    jacobian_ = jacobian;
+}
+
+bool VoxelPools::advanceRosenbrock( double t, double tEnd )
+{
+    // Rodas3 of Sandu et al. (1997), Atmos. Environ. 31:3459.
+    // A and C are strictly lower triangular, stored row by row.
+    static const unsigned int numStages = 4;
+    static const double gamma = 0.5;
+    static const double A[] = { 0.0, 2.0, 0.0, 2.0, 0.0, 1.0 };
+    static const double C[] = { 4.0, 1.0, -1.0, 1.0, -1.0, -8.0 / 3.0 };
+    static const double M[] = { 2.0, 0.0, 1.0, 1.0 };
+    static const double E[] = { 0.0, 0.0, 0.0, 1.0 };
+    static const double alpha[] = { 0.0, 0.0, 1.0, 1.0 };
+    static const bool newF[] = { true, false, true, true };
+
+    const unsigned int n = jacobian_->size();
+    const double hMin = 1e-10 * ( tEnd - t );
+    double* y = varS();
+    stage_.resize( numStages * n );
+    startRate_.resize( size() );
+    stageRate_.resize( size() );
+    bool lastRejected = false;
+
+    while ( t < tEnd )
+    {
+        double h = min( rosenbrockDt_, tEnd - t );
+        bool truncated = ( h < rosenbrockDt_ );
+        stageS_.assign( Svec().begin(), Svec().end() );
+        stoichPtr_->updateFuncs( &stageS_[0], t );
+        updateRates( &stageS_[0], &startRate_[0] );
+        jacobian_->assemble( rates_, &stageS_[0], jac_ );
+
+        for ( ; ; )
+        {
+            lu_ = jac_;
+            if ( !jacobian_->factorize( 1.0 / ( gamma * h ), lu_, luWork_ ) )
+            {
+                h *= 0.5;
+                truncated = false;
+                if ( h < hMin )
+                    return false;
+                continue;
+            }
+            const double* f = &startRate_[0];
+            for ( unsigned int i = 0; i < numStages; ++i )
+            {
+                const unsigned int row = i * ( i - 1 ) / 2;
+                if ( i > 0 && newF[i] )
+                {
+                    for ( unsigned int k = 0; k < n; ++k )
+                    {
+                        double yk = y[k];
+                        for ( unsigned int j = 0; j < i; ++j )
+                            yk += A[ row + j ] * stage_[ j * n + k ];
+                        stageS_[k] = yk;
+                    }
+                    stoichPtr_->updateFuncs( &stageS_[0], t + alpha[i] * h );
+                    updateRates( &stageS_[0], &stageRate_[0] );
+                    f = &stageRate_[0];
+                }
+                double* K = &stage_[ i * n ];
+                for ( unsigned int k = 0; k < n; ++k )
+                {
+                    double rhs = f[k];
+                    for ( unsigned int j = 0; j < i; ++j )
+                        rhs += C[ row + j ] / h * stage_[ j * n + k ];
+                    K[k] = rhs;
+                }
+                jacobian_->solve( lu_, K, luWork_ );
+            }
+
+            // New state goes into stageS_, and the scaled error norm
+            // decides whether to keep it.
+            double err = 0.0;
+            for ( unsigned int k = 0; k < n; ++k )
+            {
+                double yk = y[k];
+                double ek = 0.0;
+                for ( unsigned int i = 0; i < numStages; ++i )
+                {
+                    yk += M[i] * stage_[ i * n + k ];
+                    ek += E[i] * stage_[ i * n + k ];
+                }
+                stageS_[k] = yk;
+                double tol = epsAbs_ + epsRel_ * max( fabs( y[k] ), fabs( yk ) );
+                err += ( ek / tol ) * ( ek / tol );
+            }
+            err = n > 0 ? sqrt( err / n ) : 0.0;
+            double fac = min( 6.0, max( 0.2, 0.9 / cbrt( max( err, 1e-10 ) ) ) );
+            if ( err <= 1.0 )
+            {
+                copy( stageS_.begin(), stageS_.begin() + n, y );
+                t += h;
+                if ( lastRejected )
+                    fac = min( fac, 1.0 );
+                if ( !truncated || fac < 1.0 )
+                    rosenbrockDt_ = h * fac;
+                lastRejected = false;
+                break;
+            }
+            h *= fac;
+            truncated = false;
+            lastRejected = true;
+            if ( h < hMin )
+                return false;
+        }
+    }
+    stoichPtr_->updateFuncs( &Svec()[0], tEnd );
+    return true;
 }
 
 #ifdef USE_GSL
@@ -387,6 +534,8 @@ void VoxelPools::updateAllRateTerms( const vector< RateTerm* >& rates,
                 getXreacScaleProducts(i-numCoreRates) 
                 );
     }
+    for ( unsigned int i = 0; i < rates_.size(); ++i )
+        applyRateScale( i );
 }
 
 void VoxelPools::updateRateTerms( const vector< RateTerm* >& rates,
@@ -406,6 +555,7 @@ void VoxelPools::updateRateTerms( const vector< RateTerm* >& rates,
     }
     else
         rates_[index] = rates[index]->copyWithVolScaling(getVolume(), 1.0, 1.0);
+    applyRateScale( index );
 }
 
 void VoxelPools::updateRates( const double* s, double* yprime ) const
@@ -455,6 +605,44 @@ void VoxelPools::updateReacVelocities(const double* s, vector< double >& v) cons
     }
 }
 
+void VoxelPools::getVelocityJacobian( const double* s,
+                                      vector< double >& dv ) const
+{
+    unsigned int numVar = stoichPtr_->getNumVarPools();
+    dv.assign( rates_.size() * numVar, 0.0 );
+    vector< pair< unsigned int, double > > d;
+    for ( unsigned int j = 0; j < rates_.size(); ++j )
+    {
+        d.clear();
+        rates_[j]->getDerivs( s, d );
+        for ( auto k = d.cbegin(); k != d.cend(); ++k )
+            if ( k->first < numVar )
+                dv[ j * numVar + k->first ] += k->second;
+    }
+}
+
+void VoxelPools::getJacobian( const double* s, vector< double >& J ) const
+{
+    const KinSparseMatrix& N = stoichPtr_->getStoichiometryMatrix();
+    unsigned int numVar = stoichPtr_->getNumVarPools();
+    vector< double > dv;
+    getVelocityJacobian( s, dv );
+    J.assign( numVar * numVar, 0.0 );
+    for ( unsigned int i = 0; i < numVar; ++i )
+    {
+        const int* entry;
+        const unsigned int* colIndex;
+        unsigned int n = N.getRow( i, &entry, &colIndex );
+        double* row = &J[ i * numVar ];
+        for ( unsigned int k = 0; k < n; ++k )
+        {
+            const double* dvRow = &dv[ colIndex[k] * numVar ];
+            for ( unsigned int m = 0; m < numVar; ++m )
+                row[m] += entry[k] * dvRow[m];
+        }
+    }
+}
+
 /// For debugging: Print contents of voxel pool
 void VoxelPools::print() const
 {
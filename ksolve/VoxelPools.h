@@ -20,6 +20,7 @@
 
 class Stoich;
 class ProcInfo;
+class SparseJacobian;
 
 /**
  * This is the class for handling reac-diff voxels used for deterministic
@@ -53,6 +54,16 @@ public:
     /// Set initial timestep to use by the solver.
     void setInitDt( double dt );
 
+    /// Assigns the Jacobian structure used by the rosenbrock method.
+    void setJacobian( const SparseJacobian* jacobian );
+
+    /**
+     * Integrator step sizes, [ Rosenbrock, GSL ], for checkpoints. LSODA
+     * keeps a history that is not saved, so it restarts after a load.
+     */
+    void getStepState( double* h ) const;
+    void setStepState( const double* h );
+
 #ifdef USE_GSL      /* -----  not USE_BOOST  ----- */
     static int gslFunc( double t, const double* y, double *dydt, void* params);
 #elif  USE_BOOST_ODE
@@ -94,11 +105,34 @@ public:
      */
     void updateReacVelocities( const double* s, vector< double >& v ) const;
 
+    /**
+     * Computes the derivative of each reaction velocity with respect to
+     * each variable pool, analytically from the rate terms. Returns them
+     * row-major in dv, one row of numVarPools entries per rate term.
+     */
+    void getVelocityJacobian( const double* s, vector< double >& dv ) const;
+
+    /**
+     * Computes the Jacobian J[i][j] = d(dS_i/dt)/dS_j over the variable
+     * pools, row-major and numVarPools square. Buffered, proxy and
+     * function-controlled pools are held constant.
+     */
+    void getJacobian( const double* s, vector< double >& J ) const;
+
     /// Used for debugging.
     void print() const;
 
 private:
 
+    /**
+     * Advances the integrated pools from t to tEnd with an adaptive
+     * Rosenbrock method (Rodas3: four stages, third order, with an
+     * embedded second order error estimate). Each step factorizes
+     * I/(h.gamma) - J once, using the analytic sparse Jacobian.
+     * Returns false if the step size collapses.
+     */
+    bool advanceRosenbrock( double t, double tEnd );
+
     std::shared_ptr<LSODA> pLSODA;
     LSODA_ODE_SYSTEM_TYPE lsodaSystem;
     int lsodaState_;
@@ -112,6 +146,19 @@ private:
     double epsRel_;
     string method_;
 
+    /// Shared structure of the Jacobian, owned by the Ksolve.
+    const SparseJacobian* jacobian_;
+    /// Step size carried over between advances by the rosenbrock method.
+    double rosenbrockDt_;
+    /// Workspace for the rosenbrock method.
+    vector< double > jac_;
+    vector< double > lu_;
+    vector< double > luWork_;
+    vector< double > stage_;
+    vector< double > stageS_;
+    vector< double > startRate_;
+    vector< double > stageRate_;
+
 };
 
 #endif	// _VOXEL_POOLS_H
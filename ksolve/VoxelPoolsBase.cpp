@@ -137,6 +137,46 @@ void VoxelPoolsBase::scaleVolsBufsRates(double ratio, const Stoich* stoichPtr)
                     getXreacScaleSubstrates(i - numCoreRates),
                     getXreacScaleProducts(i - numCoreRates ) );
     }
+    for ( unsigned int i = 0; i < rates_.size(); ++i )
+        applyRateScale( i );
+}
+
+void VoxelPoolsBase::setRateScale( unsigned int index,
+                                   double r1Scale, double r2Scale )
+{
+    if ( r1Scale == 1.0 && r2Scale == 1.0 )
+        rateScale_.erase( index );
+    else
+        rateScale_[index] = pair< double, double >( r1Scale, r2Scale );
+}
+
+double VoxelPoolsBase::getR1Scale( unsigned int index ) const
+{
+    map< unsigned int, pair< double, double > >::const_iterator i =
+        rateScale_.find( index );
+    if ( i == rateScale_.end() )
+        return 1.0;
+    return i->second.first;
+}
+
+double VoxelPoolsBase::getR2Scale( unsigned int index ) const
+{
+    map< unsigned int, pair< double, double > >::const_iterator i =
+        rateScale_.find( index );
+    if ( i == rateScale_.end() )
+        return 1.0;
+    return i->second.second;
+}
+
+void VoxelPoolsBase::applyRateScale( unsigned int index )
+{
+    if ( rateScale_.empty() || index >= rates_.size() )
+        return;
+    map< unsigned int, pair< double, double > >::const_iterator i =
+        rateScale_.find( index );
+    if ( i != rateScale_.end() && rates_[index] )
+        rates_[index]->setRates( rates_[index]->getR1() * i->second.first,
+                                 rates_[index]->getR2() * i->second.second );
 }
 
 void VoxelPoolsBase::setNumVoxels( unsigned int n )
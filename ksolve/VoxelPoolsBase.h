@@ -205,12 +205,26 @@ public:
 
     void scaleVolsBufsRates( double ratio, const Stoich* stoichPtr );
 
+    /**
+     * Assigns scale factors for the two rate constants of the specified
+     * entry on rate terms, in this voxel only. They multiply the values
+     * obtained from the Stoich, and take effect the next time the rate
+     * terms are updated. This lets each voxel run its own parameter
+     * variant.
+     */
+    void setRateScale( unsigned int index, double r1Scale, double r2Scale );
+    double getR1Scale( unsigned int index ) const;
+    double getR2Scale( unsigned int index ) const;
+
 	void setNumVoxels( unsigned int );
 
     /// Debugging utility
     void print() const;
 
 protected:
+    /// Applies the per-voxel scale factors, if any, to rates_[index].
+    void applyRateScale( unsigned int index );
+
     const Stoich* stoichPtr_;
     vector< RateTerm* > rates_;
 	/**
@@ -274,6 +288,13 @@ private:
      */
     double volume_;
 
+    /**
+     * rateScale_[rateTermIndex] = ( r1Scale, r2Scale )
+     * Per-voxel multipliers for the rate constants. Only terms that
+     * have been assigned a scale appear here.
+     */
+    map< unsigned int, pair< double, double > > rateScale_;
+
     /**
      * xReacScaleSubstrates_[crossRateTermIndex]
      * Product of substrateVol/voxelVol for each of the substrates,
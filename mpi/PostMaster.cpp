@@ -10,6 +10,7 @@
 #include "../basecode/header.h"
 #include "PostMaster.h"
 #include "../shell/Shell.h"
+#include "../shell/Checkpoint.h"
 
 const unsigned int TgtInfo::headerSize =
 		1 + ( sizeof( TgtInfo ) - 1 )/sizeof( double );
@@ -22,6 +23,7 @@ const int PostMaster::GETTAG = 3;
 const int PostMaster::RETURNTAG = 4;
 const int PostMaster::CONTROLTAG = 5;
 const int PostMaster::DIETAG = 100;
+const int PostMaster::SPIKETAG = 6; // and 7, alternating by window.
 PostMaster::PostMaster()
 		:
 				recvBufSize_( reserveBufSize ),
@@ -35,7 +37,11 @@ PostMaster::PostMaster()
 				isSetSent_( 1 ), // Flag. Have any pending 'set' gone?
 				isSetRecv_( 0 ), // Flag. Has some data come in?
 				setSendSize_( 0 ),
-				numRecvDone_( 0 )
+				numRecvDone_( 0 ),
+				minDelay_( 0.0 ),
+				exchangeInterval_( 1 ),
+				stepsSinceExchange_( 0 ),
+				numExchanges_( 0 )
 {
 	for ( unsigned int i = 0; i < Shell::numNodes(); ++i ) {
 		sendBuf_[i].resize( reserveBufSize, 0 );
@@ -100,6 +106,25 @@ const Cinfo* PostMaster::initCinfo()
 			&PostMaster::setBufferSize,
 			&PostMaster::getBufferSize
 		);
+		static ValueFinfo< PostMaster, double > minDelay(
+			"minDelay",
+			"Minimum synaptic delay of any message between nodes. When "
+			"nonzero, outgoing messages are batched and exchanged once "
+			"per window of this length, and only with nodes that have "
+			"data waiting, with no global barrier. Only valid if all "
+			"cross-node messages are spike events that carry their time. "
+			"Default 0: exchange with every node on every tick. "
+			"Takes effect at reinit.",
+			&PostMaster::setMinDelay,
+			&PostMaster::getMinDelay
+		);
+		static ReadOnlyValueFinfo< PostMaster, unsigned int >
+			exchangeInterval(
+			"exchangeInterval",
+			"Number of ticks between exchanges, computed at reinit "
+			"from minDelay and the clock dt.",
+			&PostMaster::getExchangeInterval
+		);
 		//////////////////////////////////////////////////////////////
 		// MsgDest Definitions
 		//////////////////////////////////////////////////////////////
@@ -125,6 +150,8 @@ const Cinfo* PostMaster::initCinfo()
 		&numNodes,	// ReadOnlyValue
 		&myNode,	// ReadOnlyValue
 		&bufferSize,	// ReadOnlyValue
+		&minDelay,	// Value
+		&exchangeInterval,	// ReadOnlyValue
 		&proc		// SharedFinfo
 	};
 
@@ -140,6 +167,9 @@ const Cinfo* PostMaster::initCinfo()
 	return &postMasterCinfo;
 }
 
+// Messages in flight are exchanged within the tick that sent them.
+static CheckpointNoState postMasterCheckpoint( "PostMaster" );
+
 /**
  * Finalize all outgoing messages, clear the sendSize vector so that we
  * can handle another round of messages.
@@ -163,6 +193,14 @@ void PostMaster::finalizeSends()
  */
 void PostMaster::reinit( const Eref& e, ProcPtr p )
 {
+	exchangeInterval_ = 1;
+	if ( minDelay_ > 0.0 && p->dt > 0.0 ) {
+		unsigned int n = static_cast< unsigned int >(
+			floor( minDelay_ / p->dt + 1e-6 ) );
+		if ( n > 1 )
+			exchangeInterval_ = n;
+	}
+	stepsSinceExchange_ = 0;
 #ifdef USE_MPI
 	// MPI_Barrier( MPI_COMM_WORLD );
 	unsigned int reqIndex = 0;
@@ -190,6 +228,17 @@ void PostMaster::reinit( const Eref& e, ProcPtr p )
 void PostMaster::process( const Eref& e, ProcPtr p )
 {
 #ifdef USE_MPI
+	if ( minDelay_ > 0.0 ) {
+		// Keep serving set/get calls between exchanges.
+		if ( ++stepsSinceExchange_ < exchangeInterval_ ) {
+			if ( Shell::numNodes() > 1 )
+				clearPendingSetGet();
+			return;
+		}
+		stepsSinceExchange_ = 0;
+		exchangeSparse();
+		return;
+	}
 	unsigned int reqIndex = 0;
 	for ( unsigned int i = 0; i < Shell::numNodes(); ++i )
 	{
@@ -212,6 +261,60 @@ void PostMaster::process( const Eref& e, ProcPtr p )
 #endif
 }
 
+void PostMaster::exchangeSparse()
+{
+#ifdef USE_MPI
+	if ( Shell::numNodes() == 1 )
+		return;
+	int tag = SPIKETAG + ( numExchanges_ & 1 );
+	++numExchanges_;
+	vector< MPI_Request > reqs;
+	for ( unsigned int i = 0; i < Shell::numNodes(); ++i ) {
+		if ( i == Shell::myNode() || sendSize_[i] == 0 )
+			continue;
+		reqs.push_back( MPI_REQUEST_NULL );
+		// Synchronous send: completes only once the target has matched
+		// it, which is what lets the barrier below detect termination.
+		MPI_Issend( &sendBuf_[i][0], sendSize_[i], MPI_DOUBLE,
+			i, tag, MPI_COMM_WORLD, &reqs.back() );
+	}
+
+	MPI_Request barrierReq = MPI_REQUEST_NULL;
+	bool inBarrier = false;
+	int done = 0;
+	while ( !done ) {
+		int arrived = 0;
+		MPI_Status status;
+		MPI_Iprobe( MPI_ANY_SOURCE, tag, MPI_COMM_WORLD, &arrived, &status );
+		if ( arrived ) {
+			int recvSize = 0;
+			MPI_Get_count( &status, MPI_DOUBLE, &recvSize );
+			// Senders grow their buffers as needed, so take any size.
+			if ( spikeRecvBuf_.size() < static_cast< size_t >( recvSize ) )
+				spikeRecvBuf_.resize( recvSize );
+			MPI_Recv( &spikeRecvBuf_[0], recvSize, MPI_DOUBLE,
+				status.MPI_SOURCE, tag, MPI_COMM_WORLD, MPI_STATUS_IGNORE );
+			deliverBuffer( &spikeRecvBuf_[0], recvSize );
+		}
+		if ( inBarrier ) {
+			MPI_Test( &barrierReq, &done, MPI_STATUS_IGNORE );
+		} else {
+			int sent = 1;
+			if ( reqs.size() > 0 )
+				MPI_Testall( reqs.size(), &reqs[0], &sent,
+					MPI_STATUSES_IGNORE );
+			if ( sent ) {
+				MPI_Ibarrier( MPI_COMM_WORLD, &barrierReq );
+				inBarrier = true;
+			}
+		}
+		clearPendingSetGet();
+	}
+	for ( unsigned int i = 0; i < Shell::numNodes(); ++i )
+		sendSize_[i] = 0;
+#endif
+}
+
 void PostMaster::clearPending()
 {
 	if ( Shell::numNodes() == 1 )
@@ -396,7 +499,6 @@ void PostMaster::clearPendingRecv()
 			recvNode += 1; // Skip myNode
 		int recvSize = 0;
 		MPI_Get_count( &doneStatus_[i], MPI_DOUBLE, &recvSize );
-		int j = 0;
 		assert( recvSize <= static_cast< int >( recvBufSize_ ) );
 		double* buf = &recvBuf_[ recvNode ][0];
 		if ( report ) {
@@ -406,19 +508,7 @@ void PostMaster::clearPendingRecv()
 					   	buf[j+3] << endl;
 			}
 		}
-		while ( j < recvSize ) {
-			const TgtInfo* tgt = reinterpret_cast< const TgtInfo * >( buf );
-			const Eref& e = tgt->eref();
-			const Finfo *f =
-				e.element()->cinfo()->getSrcFinfo( tgt->bindIndex() );
-			buf += TgtInfo::headerSize;
-			const SrcFinfo* sf = dynamic_cast< const SrcFinfo* >( f );
-			assert( sf );
-			sf->sendBuffer( e, buf );
-			buf += tgt->dataSize();
-			j += TgtInfo::headerSize + tgt->dataSize();
-			assert( buf - &recvBuf_[recvNode][0] == j );
-		}
+		deliverBuffer( buf, recvSize );
 		// Post the next Irecv.
 		unsigned int k = recvNode;
 		if ( recvNode > Shell::myNode() )
@@ -435,6 +525,25 @@ void PostMaster::clearPendingRecv()
 #endif
 }
 
+void PostMaster::deliverBuffer( double* buf, int recvSize )
+{
+	double* start = buf;
+	int j = 0;
+	while ( j < recvSize ) {
+		const TgtInfo* tgt = reinterpret_cast< const TgtInfo * >( buf );
+		const Eref& e = tgt->eref();
+		const Finfo *f =
+			e.element()->cinfo()->getSrcFinfo( tgt->bindIndex() );
+		buf += TgtInfo::headerSize;
+		const SrcFinfo* sf = dynamic_cast< const SrcFinfo* >( f );
+		assert( sf );
+		sf->sendBuffer( e, buf );
+		buf += tgt->dataSize();
+		j += TgtInfo::headerSize + tgt->dataSize();
+		assert( buf - start == j );
+	}
+}
+
 ///////////////////////////////////////////////////////////////
 // Data transfer and fillup operations.
 ///////////////////////////////////////////////////////////////
@@ -444,14 +553,23 @@ double* PostMaster::addToSendBuf( const Eref& e, unsigned int bindIndex,
 {
 	unsigned int node = e.fieldIndex(); // nasty evil wicked hack
 	unsigned int end = sendSize_[node];
-	if ( end + TgtInfo::headerSize + size > recvBufSize_ ) {
-		// Here we need to activate the fallback second send which will
-		// deal with the big block. Also various routines for tracking
-		// send size so we don't get too big or small.
+	unsigned int need = end + TgtInfo::headerSize + size;
+	if ( minDelay_ > 0.0 ) {
+		// Batched exchanges are received at their probed size, so the
+		// buffer can grow to hold however much a window brings.
+		if ( need > sendBuf_[node].size() )
+			sendBuf_[node].resize( max( need,
+				static_cast< unsigned int >( 2 * sendBuf_[node].size() ) ) );
+	} else if ( need > recvBufSize_ || need > sendBuf_[node].size() ) {
+		// The per-tick exchange receives into fixed buffers, so the
+		// data cannot go. Fill a scratch buffer instead of writing past
+		// the end.
 		cerr << "Error: PostMaster::addToSendBuf on node " <<
 				Shell::myNode() <<
-				": Data size (" << size << ") goes past end of buffer\n";
-		assert( 0 );
+				": Data size (" << size << ") goes past end of buffer. "
+				"Dropped. Set a minDelay to exchange in growing batches.\n";
+		overflowBuf_.resize( size );
+		return size > 0 ? &overflowBuf_[0] : 0;
 	}
 	TgtInfo* tgt = reinterpret_cast< TgtInfo* >( &sendBuf_[node][end] );
 	tgt->set( e.objId(), bindIndex, size );
@@ -724,3 +842,23 @@ void PostMaster::setBufferSize( unsigned int size )
 	for ( unsigned int i =0; i < sendBuf_.size(); ++i )
 		sendBuf_[i].resize( size );
 }
+
+double PostMaster::getMinDelay() const
+{
+	return minDelay_;
+}
+
+void PostMaster::setMinDelay( double val )
+{
+	if ( val < 0.0 ) {
+		cout << "Warning: PostMaster::setMinDelay: " << val <<
+				" must be >= 0, ignored\n";
+		return;
+	}
+	minDelay_ = val;
+}
+
+unsigned int PostMaster::getExchangeInterval() const
+{
+	return exchangeInterval_;
+}
@@ -56,6 +56,17 @@
  * the originating object, plus using its FieldIndex to specify the target
  * node.
  *
+ * Level 3. Batched spike exchange.
+ * When minDelay is set, the buffers are not sent on every tick. They
+ * accumulate for one minimum synaptic delay window and are exchanged
+ * once per window. This is safe only if all cross-node traffic is spike
+ * events that carry their own time, as a spike sent at t cannot take
+ * effect on another node before t + minDelay. The exchange only sends
+ * to nodes that have data waiting, using synchronous sends, and ends
+ * with a nonblocking barrier rather than MPI_Barrier (the NBX algorithm
+ * of Hoefler, Siebert and Lumsdaine 2010). Nodes with no connections
+ * to each other never exchange messages.
+ *
  * Possible optimization here would be to have a sendToAll buffer
  * that was filled when the digestMessages detected that a majority of
  * target nodes received a given message. A setup time complication, not
@@ -108,6 +119,9 @@ class PostMaster {
 		unsigned int getMyNode() const;
 		unsigned int getBufferSize() const;
 		void setBufferSize( unsigned int size );
+		double getMinDelay() const;
+		void setMinDelay( double val );
+		unsigned int getExchangeInterval() const;
 		void reinit( const Eref& e, ProcPtr p );
 		void process( const Eref& e, ProcPtr p );
 
@@ -119,6 +133,14 @@ class PostMaster {
 		void clearPendingRecv();
 		/// Checks that all sends have gone out
 		void finalizeSends();
+		/// Sends out the contents of a received buffer through msgs.
+		void deliverBuffer( double* buf, int recvSize );
+		/**
+		 * Batched spike exchange for one minDelay window. Sends only
+		 * to nodes with data waiting, and completes with a nonblocking
+		 * barrier.
+		 */
+		void exchangeSparse();
 
 		/// Handles 'get' calls from another node, to an object on mynode.
 		void handleRemoteGet( const Eref& e,
@@ -127,7 +149,11 @@ class PostMaster {
 		void handleRemoteGetVec( const Eref& e,
 						const OpFunc* op, int requestingNode );
 
-		/// Returns pointer to Send buffer for filling in arguments.
+		/**
+		 * Returns pointer to Send buffer for filling in arguments.
+		 * With a minDelay the buffer grows as needed. Otherwise it is
+		 * limited to the receive size, and data past that is dropped.
+		 */
 		double* addToSendBuf( const Eref& e,
 				unsigned int bindIndex, unsigned int size );
 		/// Returns pointer to Set buffer for filling in arguments.
@@ -152,6 +178,7 @@ class PostMaster {
 		static const int RETURNTAG;
 		static const int CONTROLTAG;
 		static const int DIETAG;
+		static const int SPIKETAG;
 		static const Cinfo* initCinfo();
 	private:
 		unsigned int recvBufSize_;
@@ -177,6 +204,27 @@ class PostMaster {
 		int isSetRecv_;
 		int setSendSize_;
 		unsigned int numRecvDone_;
+
+		/// Minimum synaptic delay across nodes. Zero to send each tick.
+		double minDelay_;
+
+		/// Number of ticks in each exchange window.
+		unsigned int exchangeInterval_;
+
+		/// Ticks since the last exchange.
+		unsigned int stepsSinceExchange_;
+
+		/**
+		 * Number of windows exchanged. Its parity picks the tag so a
+		 * node that is a window ahead cannot be confused with this one.
+		 */
+		unsigned int numExchanges_;
+
+		/// Buffer for incoming batched spikes, from any node.
+		vector< double > spikeRecvBuf_;
+
+		/// Takes the arguments of a send that does not fit.
+		vector< double > overflowBuf_;
 };
 
 #endif	// _POST_MASTER_H
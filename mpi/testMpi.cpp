@@ -7,7 +7,67 @@
 ** See the file COPYING.LIB for the full notice.
 **********************************************************************/
 
+#include "../basecode/header.h"
+#include "../shell/Shell.h"
+
+/**
+ * Runs batched exchanges that carry more data in each window than the
+ * send buffers start out with. Every value sent across nodes must
+ * arrive. Needs mpirun with two or more nodes, e.g.
+ *  mpirun -np 2 moose -u
+ */
+static void testSparseExchangeOverflow()
+{
+	if ( Shell::numNodes() < 2 )
+		return;
+	Shell* shell = reinterpret_cast< Shell* >( Id().eref().data() );
+	const unsigned int n = 4 * Shell::numNodes();
+	const unsigned int numSteps = 100;
+	const double dt = 1e-3;
+	const unsigned int ticks[] = { 0, 8, 9, 31 };
+	vector< double > oldDt;
+	for ( unsigned int t : ticks ) {
+		oldDt.push_back( LookupField< unsigned int, double >::get(
+			ObjId( 1 ), "tickDt", t ) );
+		shell->doSetClock( t, dt );
+	}
+
+	Id pulse = shell->doCreate( "PulseGen", Id(), "pulse", n );
+	Id tab = shell->doCreate( "Table", Id(), "tab", n );
+	// Reversed, so that the entries on each node feed another node.
+	for ( unsigned int i = 0; i < n; ++i ) {
+		Field< double >::set( ObjId( pulse, i ), "baseLevel", i );
+		shell->doAddMsg( "Single", ObjId( pulse, i ), "output",
+			ObjId( tab, n - 1 - i ), "input" );
+	}
+
+	ObjId pm( Id( "/postmaster" ) );
+	unsigned int oldSize = Field< unsigned int >::get( pm, "bufferSize" );
+	// Ten steps a window, of n messages each, do not fit in 16 doubles.
+	Field< unsigned int >::set( pm, "bufferSize", 16 );
+	Field< double >::set( pm, "minDelay", 10 * dt );
+	shell->doReinit();
+	shell->doStart( numSteps * dt );
+
+	for ( unsigned int i = 0; i < n; ++i ) {
+		vector< double > v =
+			Field< vector< double > >::get( ObjId( tab, i ), "vector" );
+		// One more if the value sent at reinit came after the clearing.
+		assert( v.size() == numSteps || v.size() == numSteps + 1 );
+		for ( double x : v )
+			assert( doubleEq( x, n - 1 - i ) );
+	}
+
+	Field< double >::set( pm, "minDelay", 0.0 );
+	Field< unsigned int >::set( pm, "bufferSize", oldSize );
+	shell->doDelete( pulse );
+	shell->doDelete( tab );
+	for ( unsigned int i = 0; i < oldDt.size(); ++i )
+		shell->doSetClock( ticks[i], oldDt[i] );
+	cout << "." << flush;
+}
+
 void testMpi()
 {
-		;
+	testSparseExchangeOverflow();
 }
@@ -10,6 +10,8 @@
 #ifndef _MSG_H
 #define _MSG_H
 
+class TargetSpan;
+
 /**
  * Manages data flow between two elements. Is always many-to-many, with
  * assorted variants.
@@ -55,6 +57,18 @@ class Msg
 		  */
 		 virtual void targets( vector< vector< Eref > >& v ) const = 0;
 
+		 /**
+		  * Fills v[dataId in range e1.numData] with a span referencing
+		  * the targets of that entry in place, without copying them out
+		  * as Erefs. Returns false if this Msg does not store its
+		  * targets in a form that can be referenced this way, in which
+		  * case the caller should use targets().
+		  */
+		 virtual bool targetSpans( vector< TargetSpan >& v ) const
+		 {
+			 return false;
+		 }
+
 		/**
 		 * Return the first element
 		 */
@@ -10,10 +10,14 @@
 #include "../basecode/header.h"
 #include "../basecode/global.h"
 #include "../randnum/randnum.h"
+#include "../randnum/CounterRNG.h"
+#include "../utility/utility.h"
 #include "../shell/Shell.h"
 #include "../basecode/SparseMatrix.h"
 #include "SparseMsg.h"
 
+#include <future>
+
 // Initializing static variables
 Id SparseMsg::managerId_;
 vector< SparseMsg* > SparseMsg::msg_;
@@ -273,23 +277,29 @@ void SparseMsg::setEntry(
     unsigned int row, unsigned int column, unsigned int value )
 {
     matrix_.set( row, column, value );
+    e1()->markRewired( mid_ );
+    e2()->markRewired( mid_ );
 }
 
 void SparseMsg::unsetEntry( unsigned int row, unsigned int column )
 {
     matrix_.unset( row, column );
+    e1()->markRewired( mid_ );
+    e2()->markRewired( mid_ );
 }
 
 void SparseMsg::clear()
 {
     matrix_.clear();
+    e1()->markRewired( mid_ );
+    e2()->markRewired( mid_ );
 }
 
 void SparseMsg::transpose()
 {
     matrix_.transpose();
-    e1()->markRewired();
-    e2()->markRewired();
+    e1()->markRewired( mid_ );
+    e2()->markRewired( mid_ );
 }
 
 void SparseMsg::updateAfterFill()
@@ -310,8 +320,8 @@ void SparseMsg::updateAfterFill()
             e2_->resizeField( i - startData, num + 1 );
         }
     }
-    e1()->markRewired();
-    e2()->markRewired();
+    e1()->markRewired( mid_ );
+    e2()->markRewired( mid_ );
 }
 
 void SparseMsg::pairFill( vector< unsigned int > src,
@@ -448,14 +458,52 @@ Eref SparseMsg::firstTgt( const Eref& src ) const
     return Eref( 0, 0 );
 }
 
+/**
+ * Fills the list of source indices connected to one destination, for
+ * connection probability p over nSrc sources. Rather than drawing one
+ * random number per candidate pair, it draws the gap to the next
+ * connected source from the geometric distribution, so the cost is
+ * proportional to the number of synapses made rather than to nSrc.
+ * Each destination has its own counter-based stream, so rows can be
+ * generated independently and in any order.
+ */
+static void sampleSparseRow( uint32_t key, unsigned int dest,
+        unsigned int nSrc, double p, vector< unsigned int >& cols )
+{
+    cols.clear();
+    if ( p <= 0.0 || nSrc == 0 )
+        return;
+    if ( p >= 1.0 )
+    {
+        cols.resize( nSrc );
+        for ( unsigned int j = 0; j < nSrc; ++j )
+            cols[j] = j;
+        return;
+    }
+    moose::CounterRNG rng( key, dest, 0, 4 );
+    const double logq = log1p( -p );
+    cols.reserve( static_cast< size_t >( nSrc * p * 1.1 ) + 4 );
+    double j = -1.0;
+    while ( true )
+    {
+        // 1 - uniform() lies in (0, 1], so the log is finite.
+        double skip = floor( log( 1.0 - rng.uniform() ) / logq );
+        j += skip + 1.0;
+        if ( j >= nSrc )
+            break;
+        cols.push_back( static_cast< unsigned int >( j ) );
+    }
+}
+
 /**
  * Returns number of synapses formed.
  * Fills it in transpose form, because we need to count and index the
  * number of synapses on the target, so we need to iterate over the sources
  * in the inner loop. Once full, does the transpose.
- * Should really have a seed argument for the random number.
- * Later need a way to fast-forward mtrand to just the entries we
- * need to fill.
+ * Each destination row is sampled by geometric skips over the sources
+ * (see sampleSparseRow), using a counter-based stream keyed on a single
+ * draw from rng_. So the result depends only on the seed, and rows are
+ * filled in parallel when MOOSE_NUM_THREADS > 1.
  */
 unsigned int SparseMsg::randomConnect( double probability )
 {
@@ -463,61 +511,63 @@ unsigned int SparseMsg::randomConnect( double probability )
     unsigned int nCols = matrix_.nColumns();	// Destinations
     matrix_.clear();
     unsigned int totalSynapses = 0;
-    vector< unsigned int > sizes( nCols, 0 );
-    unsigned int totSynNum = 0;
     Element* syn = e2_;
     unsigned int startData = syn->localDataStart();
     unsigned int endData = startData + syn->numLocalData();
 
     assert( nCols == syn->numData() );
 
-    matrix_.transpose();
-    for ( unsigned int i = 0; i < nCols; ++i )
+    // One draw from the seeded generator picks the key for all rows.
+    uint32_t key = static_cast< uint32_t >( rng_.uniform() * 4294967296.0 );
+
+    vector< vector< unsigned int > > srcIndex( nCols );
+    unsigned int numThreads = moose::getEnvInt( "MOOSE_NUM_THREADS", 1 );
+    if ( numThreads > nCols )
+        numThreads = nCols;
+    if ( numThreads <= 1 )
+    {
+        for ( unsigned int i = 0; i < nCols; ++i )
+            sampleSparseRow( key, i, nRows, probability, srcIndex[i] );
+    }
+    else
     {
-        vector< unsigned int > synIndex;
-        // This needs to be obtained from current size of syn array.
-        // unsigned int synNum = sizes[ i ];
-        unsigned int synNum = 0;
-        for ( unsigned int j = 0; j < nRows; ++j )
+        vector< std::future< void > > vecFutures;
+        unsigned int blockSize = ( nCols + numThreads - 1 ) / numThreads;
+        for ( unsigned int t = 0; t < numThreads; ++t )
         {
-            double r = rng_.uniform(); // Want to ensure it is called each time round the loop.
-            if ( r < probability )
-            {
-                synIndex.push_back( synNum );
-                ++synNum;
-                ++totSynNum;
-            }
-            else
-            {
-                synIndex.push_back( ~0 );
-            }
+            unsigned int begin = t * blockSize;
+            unsigned int end = std::min( nCols, begin + blockSize );
+            vecFutures.push_back( std::async( std::launch::async,
+                [&, begin, end]() {
+                    for ( unsigned int i = begin; i < end; ++i )
+                        sampleSparseRow( key, i, nRows, probability,
+                                srcIndex[i] );
+                } ) );
         }
+        for ( auto& f : vecFutures )
+            f.get();
+    }
 
+    matrix_.transpose();
+    vector< unsigned int > synIndex;
+    for ( unsigned int i = 0; i < nCols; ++i )
+    {
+        unsigned int synNum = srcIndex[i].size();
+        synIndex.resize( synNum );
+        for ( unsigned int k = 0; k < synNum; ++k )
+            synIndex[k] = k;
         if ( i >= startData && i < endData )
         {
             e2_->resizeField( i - startData, synNum );
         }
         totalSynapses += synNum;
-        matrix_.addRow( i, synIndex );
-        /*
-         * This is the correct form, but I need to implement something
-         * to check up for target nodes in order to use this.
-        if ( i >= startData && i < endData ) {
-        	e2_->resizeField( i - startData, synNum );
-        	totalSynapses += synNum;
-        	matrix_.addRow( i, synIndex );
-        } else {
-        	synIndex.resize( 0 );
-        	synIndex.assign( nRows, ~0 );
-        	matrix_.addRow( i, synIndex );
-        }
-        */
+        matrix_.addRow( i, synIndex, srcIndex[i] );
+        vector< unsigned int >().swap( srcIndex[i] );
     }
 
     matrix_.transpose();
-    // cout << Shell::myNode() << ": sizes.size() = " << sizes.size() << ", ncols = " << nCols << ", startSynapse = " << startSynapse << endl;
-    e1()->markRewired();
-    e2()->markRewired();
+    e1()->markRewired( mid_ );
+    e2()->markRewired( mid_ );
     return totalSynapses;
 }
 
@@ -529,9 +579,11 @@ Id SparseMsg::managerId() const
 void SparseMsg::setMatrix( const SparseMatrix< unsigned int >& m )
 {
     matrix_ = m;
+    e1()->markRewired( mid_ );
+    e2()->markRewired( mid_ );
 }
 
-SparseMatrix< unsigned int >& SparseMsg::getMatrix( )
+const SparseMatrix< unsigned int >& SparseMsg::getMatrix( ) const
 {
     return matrix_;
 }
@@ -628,6 +680,30 @@ void SparseMsg::targets( vector< vector< Eref > >& v ) const
     fillErefsFromMatrix( matrix_, v, e1_, e2_ );
 }
 
+/**
+ * Each row of the matrix is already the list of (dataIndex, fieldIndex)
+ * targets of one source entry, so the digest refers to the colIndex and
+ * entry arrays of that row directly. Every change to matrix_ marks both
+ * Elements as rewired, so the spans are rebuilt before they go stale.
+ */
+bool SparseMsg::targetSpans( vector< TargetSpan >& v ) const
+{
+    if ( matrix_.nRows() != e1_->numData() ||
+            matrix_.nColumns() != e2_->numData() )
+        return false;
+    v.clear();
+    v.resize( e1_->numData() );
+    for ( unsigned int i = 0; i < e1_->numData(); ++i )
+    {
+        const unsigned int* entry;
+        const unsigned int* colIndex;
+        unsigned int num = matrix_.getRow( i, &entry, &colIndex );
+        if ( num > 0 )
+            v[i] = TargetSpan( e2_, colIndex, entry, num );
+    }
+    return true;
+}
+
 /// Static function for Msg access
 unsigned int SparseMsg::numMsg()
 {
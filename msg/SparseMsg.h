@@ -57,6 +57,7 @@ public:
 
     void sources( vector< vector< Eref > >& v ) const;
     void targets( vector< vector< Eref > >& v ) const;
+    bool targetSpans( vector< TargetSpan >& v ) const;
 
     unsigned int randomConnect( double probability );
 
@@ -73,9 +74,11 @@ public:
     void setMatrix( const SparseMatrix< unsigned int >& m );
 
     /**
-     * Returns the connection matrix
+     * Returns the connection matrix. Message digests refer to its
+     * storage, so it is changed only through the functions below, all
+     * of which mark the digests for rebuilding.
      */
-    SparseMatrix< unsigned int >& getMatrix();
+    const SparseMatrix< unsigned int >& getMatrix() const;
 
     // Uses default addToQ function.
 
@@ -0,0 +1,267 @@
+// FieldAccessor.cpp ---
+//
+// Filename: FieldAccessor.cpp
+// Description: Per-class tables of field getters and setters for Python
+// attribute access.
+//
+
+// Code:
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+
+#include "../basecode/header.h"
+#include "../builtins/Variable.h"
+
+#include "pymoose.h"
+#include "MooseVec.h"
+#include "Finfo.h"
+#include "FieldAccessor.h"
+
+using namespace std;
+
+namespace pymoose {
+
+namespace {
+
+// ----------------------------------------------------------------------
+// C++ to Python. These follow what getFieldValue has always returned:
+// numpy arrays for numeric vectors, Python scalars otherwise.
+// ----------------------------------------------------------------------
+template <typename T>
+nb::object toPython(const T &val)
+{
+    return nb::cast(val);
+}
+
+template <typename T>
+nb::object numpyCopy(const vector<T> &val)
+{
+    size_t size = val.size();
+    auto *data = new T[size];
+    std::copy(val.begin(), val.end(), data);
+    nb::capsule owner(data,
+                      [](void *p) noexcept { delete[] static_cast<T *>(p); });
+    return nb::cast(nb::ndarray<nb::numpy, T>(data, {size}, owner));
+}
+
+template <>
+nb::object toPython(const vector<double> &val)
+{
+    return numpyCopy(val);
+}
+
+template <>
+nb::object toPython(const vector<unsigned int> &val)
+{
+    return numpyCopy(val);
+}
+
+template <>
+nb::object toPython(const vector<int> &val)
+{
+    return numpyCopy(val);
+}
+
+template <>
+nb::object toPython(const double &val)
+{
+    return nb::float_(val);
+}
+
+template <>
+nb::object toPython(const float &val)
+{
+    return nb::float_(val);
+}
+
+template <>
+nb::object toPython(const char &val)
+{
+    return nb::int_(val);
+}
+
+template <>
+nb::object toPython(const bool &val)
+{
+    return nb::bool_(val);
+}
+
+// ----------------------------------------------------------------------
+// Python to C++, as setFieldGeneric has always converted.
+// ----------------------------------------------------------------------
+template <typename T>
+T fromPython(const nb::object &val)
+{
+    return nb::cast<T>(val);
+}
+
+// Use Python truthiness (like `bool(val)`) so that ints (0/1) and other
+// objects convert as a Python user would expect. nanobind's bool caster is
+// strict and only accepts actual True/False.
+template <>
+bool fromPython(const nb::object &val)
+{
+    return nb::cast<bool>(nb::bool_(val));
+}
+
+// An Id field takes a vec, an element or an Id.
+template <>
+Id fromPython(const nb::object &val)
+{
+    if(nb::isinstance<MooseVec>(val))
+        return nb::cast<MooseVec>(val).oid().id;
+    if(nb::isinstance<ObjId>(val))
+        return nb::cast<ObjId>(val).id;
+    return nb::cast<Id>(val);
+}
+
+/**
+ * Accessor for a value field of type T. The get and set OpFuncs are looked
+ * up once here. Fields of type Id and vector<vector<double>> have always
+ * been set on the first entry of the Id, and still are.
+ */
+template <typename T>
+FieldAccessor valueAccessor(const Cinfo *cinfo, const Finfo *finfo,
+                            bool setOnId)
+{
+    string name = finfo->name();
+    const GetOpFuncBase<T> *gof = findGetOpFunc<T>(cinfo, name);
+    const OpFunc1Base<T> *sof = findSetOpFunc<T>(cinfo, name);
+    FieldAccessor acc;
+    acc.finfo = finfo;
+    acc.get = [gof, name](const ObjId &oid) {
+        return toPython<T>(getField<T>(gof, oid, name));
+    };
+    acc.set = [sof, name, setOnId](const ObjId &oid, const nb::object &val) {
+        T v = fromPython<T>(val);
+        return setField<T>(sof, setOnId ? ObjId(oid.id) : oid, name, v);
+    };
+    return acc;
+}
+
+FieldAccessor unsupportedValueAccessor(const Finfo *finfo)
+{
+    FieldAccessor acc;
+    acc.finfo = finfo;
+    string fieldName = finfo->name();
+    string rttType = finfo->rttiType();
+    acc.get = [rttType](const ObjId &) {
+        cerr << "Warning: getValueFinfo:: Unsupported type '" + rttType + "'"
+             << endl;
+        return nb::object(nb::none());
+    };
+    acc.set = [fieldName, rttType](const ObjId &,
+                                   const nb::object &) -> bool {
+        throw runtime_error("NotImplemented::setField: '" + fieldName +
+                            "' with value type '" + rttType + "'.");
+    };
+    return acc;
+}
+
+FieldAccessor buildValueAccessor(const Cinfo *cinfo, const Finfo *finfo)
+{
+    string type = finfo->rttiType();
+    type.erase(std::remove_if(type.begin(), type.end(), ::isspace),
+               type.end());
+
+#define VALUE_ACCESSOR(TYPE, KEY, SET_ON_ID) \
+    if(type == KEY)                          \
+        return valueAccessor<TYPE>(cinfo, finfo, SET_ON_ID);
+
+    VALUE_ACCESSOR(double, "double", false)
+    VALUE_ACCESSOR(float, "float", false)
+    VALUE_ACCESSOR(int, "int", false)
+    VALUE_ACCESSOR(unsigned int, "unsignedint", false)
+    VALUE_ACCESSOR(unsigned long, "unsignedlong", false)
+    VALUE_ACCESSOR(bool, "bool", false)
+    VALUE_ACCESSOR(char, "char", false)
+    VALUE_ACCESSOR(string, "string", false)
+    VALUE_ACCESSOR(Id, "Id", true)
+    VALUE_ACCESSOR(ObjId, "ObjId", false)
+    VALUE_ACCESSOR(Variable, "Variable", false)
+    VALUE_ACCESSOR(vector<double>, "vector<double>", false)
+    VALUE_ACCESSOR(vector<int>, "vector<int>", false)
+    VALUE_ACCESSOR(vector<unsigned int>, "vector<unsignedint>", false)
+    VALUE_ACCESSOR(vector<string>, "vector<string>", false)
+    VALUE_ACCESSOR(vector<Id>, "vector<Id>", false)
+    VALUE_ACCESSOR(vector<ObjId>, "vector<ObjId>", false)
+    VALUE_ACCESSOR(vector<vector<double>>, "vector<vector<double>>", true)
+#undef VALUE_ACCESSOR
+
+    return unsupportedValueAccessor(finfo);
+}
+
+FieldAccessor buildAccessor(const Cinfo *cinfo, const Finfo *finfo)
+{
+    string finfoType = cinfo->getFinfoType(finfo);
+    if(finfoType == "ValueFinfo")
+        return buildValueAccessor(cinfo, finfo);
+
+    FieldAccessor acc;
+    acc.finfo = finfo;
+    if(finfoType == "FieldElementFinfo") {
+        acc.get = [finfo](const ObjId &oid) {
+            return nb::cast(ElementField(oid, finfo));
+        };
+    }
+    else if(finfoType == "LookupValueFinfo") {
+        acc.get = [finfo](const ObjId &oid) {
+            return nb::cast(LookupField(oid, finfo));
+        };
+    }
+    else if(finfoType == "DestFinfo") {
+        acc.get = [finfo](const ObjId &oid) {
+            return createDestFunction(oid, finfo);
+        };
+    }
+    else {
+        acc.get = [finfo, finfoType](const ObjId &) -> nb::object {
+            throw runtime_error("getFieldGeneric::NotImplemented : " +
+                                finfo->name() + " with rttType " +
+                                finfo->rttiType() + " and type: '" +
+                                finfoType + "'");
+        };
+    }
+    acc.set = [finfo, finfoType](const ObjId &oid,
+                                 const nb::object &) -> bool {
+        throw nb::attribute_error((finfo->name() + " on '" + oid.path() +
+                                   "' is a " + finfoType +
+                                   " and cannot be assigned.")
+                                      .c_str());
+    };
+    return acc;
+}
+
+}  // namespace
+
+const FieldAccessor *findAccessor(const Cinfo *cinfo, const string &name)
+{
+    typedef unordered_map<string, FieldAccessor> Table;
+    static unordered_map<const Cinfo *, Table> tables;
+    // Scripts tend to access many fields of one class in a row.
+    static const Cinfo *lastCinfo = nullptr;
+    static Table *lastTable = nullptr;
+
+    if(cinfo != lastCinfo) {
+        auto it = tables.find(cinfo);
+        if(it == tables.end()) {
+            Table table;
+            for(const auto &kv : cinfo->finfoMap())
+                table.emplace(kv.first, buildAccessor(cinfo, kv.second));
+            it = tables.emplace(cinfo, std::move(table)).first;
+        }
+        lastCinfo = cinfo;
+        lastTable = &it->second;
+    }
+    auto acc = lastTable->find(name);
+    if(acc == lastTable->end())
+        return nullptr;
+    return &acc->second;
+}
+
+}  // namespace pymoose
+
+//
+// FieldAccessor.cpp ends here
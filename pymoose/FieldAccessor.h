@@ -0,0 +1,93 @@
+/* FieldAccessor.h ---
+ *
+ * Filename: FieldAccessor.h
+ * Description: Per-class tables of field getters and setters for Python
+ * attribute access.
+ */
+
+/* Commentary:
+ *
+ * Accessing a field by name from Python used to look up the Finfo,
+ * classify it, compare its type name against a list of strings and then
+ * look up the get/set OpFunc by name again inside Field<T>. The table of
+ * a class is built once, the first time any of its fields is accessed,
+ * and maps each field name to closures that are already bound to the
+ * OpFuncs and the Python conversions for the field's type. An access is
+ * then a hash lookup followed by a direct call.
+ */
+
+/* Code: */
+
+#pragma once
+
+#include <cctype>
+#include <functional>
+#include <string>
+
+#include "pymoose.h"
+
+namespace pymoose {
+
+struct FieldAccessor {
+    const Finfo* finfo = nullptr;
+    /// Returns the field of an element as a Python object.
+    std::function<nb::object(const ObjId&)> get;
+    /// Sets the field of an element from a Python object.
+    std::function<bool(const ObjId&, const nb::object&)> set;
+};
+
+/// The accessor for field `name` of class `cinfo`, or nullptr if the class
+/// has no such field.
+const FieldAccessor* findAccessor(const Cinfo* cinfo, const std::string& name);
+
+/// The OpFunc behind `get<Field>` of a value field of type T, or nullptr.
+template <typename T>
+const GetOpFuncBase<T>* findGetOpFunc(const Cinfo* cinfo,
+                                      const std::string& field)
+{
+    std::string name = "get" + field;
+    name[3] = std::toupper(name[3]);
+    auto df = dynamic_cast<const DestFinfo*>(cinfo->findFinfo(name));
+    if(!df)
+        return nullptr;
+    return dynamic_cast<const GetOpFuncBase<T>*>(df->getOpFunc());
+}
+
+/// The OpFunc behind `set<Field>` of a value field of type T, or nullptr.
+template <typename T>
+const OpFunc1Base<T>* findSetOpFunc(const Cinfo* cinfo,
+                                    const std::string& field)
+{
+    std::string name = "set" + field;
+    name[3] = std::toupper(name[3]);
+    auto df = dynamic_cast<const DestFinfo*>(cinfo->findFinfo(name));
+    if(!df)
+        return nullptr;
+    return dynamic_cast<const OpFunc1Base<T>*>(df->getOpFunc());
+}
+
+/// Field<T>::get without the lookups, when the OpFunc is already known.
+template <typename T>
+T getField(const GetOpFuncBase<T>* gof, const ObjId& oid,
+           const std::string& field)
+{
+    if(gof && oid.isDataHere())
+        return gof->returnOp(oid.eref());
+    return Field<T>::get(oid, field);
+}
+
+/// Field<T>::set without the lookups, when the OpFunc is already known.
+template <typename T>
+bool setField(const OpFunc1Base<T>* sof, const ObjId& oid,
+              const std::string& field, const T& val)
+{
+    if(sof && !oid.isOffNode()) {
+        sof->op(oid.eref(), val);
+        return true;
+    }
+    return Field<T>::set(oid, field, val);
+}
+
+}  // namespace pymoose
+
+/* FieldAccessor.h ends here */
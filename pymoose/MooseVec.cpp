@@ -155,11 +155,12 @@ nb::object MooseVec::getAttribute(const string& name)
     if(finfoType == "FieldElementFinfo") {
         return nb::cast(VecElementField(oid_, finfo));
     }
-    cerr << "DEBUG: None of the simply handled types:  " << finfoType << endl;
     // For complex types, return list objects
+    const FieldAccessor* acc = findAccessor(cinfo, name);
+    size_t nn = size();
     nb::list result;
-    for(size_t ii = 0; ii < size(); ii++){
-        result.append(getFieldGeneric(getItem(ii), name));
+    for(size_t ii = 0; ii < nn; ii++){
+        result.append(acc->get(getItem(ii)));
     }
     return result;
 }
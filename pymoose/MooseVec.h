@@ -14,6 +14,7 @@
 #include "../basecode/header.h"
 
 #include "pymoose.h"
+#include "FieldAccessor.h"
 
 using namespace std;
 
@@ -58,8 +59,11 @@ public:
     {
         size_t nn = size();
         T* data = new T[nn];
+        auto gof = findGetOpFunc<T>(oid_.element()->cinfo(), name);
+        bool fields = oid_.element()->hasFields();
         for(size_t ii = 0; ii < nn; ++ii) {
-            data[ii] = Field<T>::get(getItem(ii), name);
+            ObjId item = fields ? getFieldItem(ii) : getDataItem(ii);
+            data[ii] = getField<T>(gof, item, name);
         }
         nb::capsule owner(data, [](void* p) noexcept {
             delete[] static_cast<T*>(p);
@@ -75,10 +79,14 @@ public:
         if(!finfo) {
             throw nb::attribute_error((name + " not found").c_str());
         }
+        auto sof = findSetOpFunc<T>(cinfo, name);
+        bool fields = oid_.element()->hasFields();
+        size_t nn = size();
         bool res = true;
-        for (size_t i = 0; i < size(); i++)
+        for (size_t i = 0; i < nn; i++)
         {
-                res &= Field<T>::set(getItem(i), name, val);
+                ObjId item = fields ? getFieldItem(i) : getDataItem(i);
+                res &= setField<T>(sof, item, name, val);
         }
         return res;
     }
@@ -97,9 +105,12 @@ public:
                     to_string(val.size())).c_str());
         }
 
+          auto sof = findSetOpFunc<T>(cinfo, name);
+          bool fields = oid_.element()->hasFields();
           bool res = true;
-          for (size_t i = 0; i < size(); i++) {
-              res &= Field<T>::set(getItem(i), name, val[i]);
+          for (size_t i = 0; i < val.size(); i++) {
+              ObjId item = fields ? getFieldItem(i) : getDataItem(i);
+              res &= setField<T>(sof, item, name, val[i]);
           }
           return res;
     }
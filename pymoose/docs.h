@@ -432,6 +432,69 @@ Cleanly stops simulation, ready to take up again from where
 the stop occurred. Waits till current operations are done.
 )";
 
+constexpr const char* saveCheckpoint = R"(Save the state of the simulation.
+
+Writes the state of every object, including the solvers, the clock and
+the random number generators, to a binary checkpoint file. The file is
+written in the background while the simulation goes on.
+
+Parameters
+----------
+filename: str
+    Checkpoint file.
+wait: bool
+    Return only once the file is written (default: false).
+
+Returns
+-------
+bool: True on success.
+)";
+
+constexpr const char* loadCheckpoint = R"(Restore the state of the simulation.
+
+Rebuild the model exactly as it was when the checkpoint was saved and
+call moose.reinit() first. A following moose.start(t) continues the
+saved run.
+
+Parameters
+----------
+filename: str
+    Checkpoint file written by moose.saveCheckpoint.
+
+Returns
+-------
+bool: True on success, False if the model does not match the file.
+)";
+
+constexpr const char* fork = R"(Fork the simulation into branches that go on from the current state.
+
+Each branch is a child process that shares the memory of the model with
+the original copy-on-write, so forking a large settled model is cheap and
+only what a branch changes gets copied. Run each branch, save its results
+to a file of its own and end it with os._exit(). File writers and
+streamers must be deleted before forking. Branches start with the same
+random number state; call moose.seed() in each if they should differ.
+
+Parameters
+----------
+branches: int
+    Number of branches to fork.
+
+Returns
+-------
+int: The branch number, 1 to branches, in each branch; 0 in the original
+process; -1 if the simulation cannot be forked.
+)";
+
+constexpr const char* waitForks = R"(Wait for the branches made by moose.fork to finish.
+
+Returns
+-------
+list of int: Exit status of each branch, in the order they were forked,
+or -1 for a branch that did not exit normally.
+)";
+
+constexpr const char* branch = "Branch number of this process: 0 in the original, else as returned by moose.fork";
 constexpr const char* isRunning = "Returns flag to indicate whether simulation is still running";
 constexpr const char* getDoc = "Get documentation as a formatted string";
 }  // namespace pymoose::docs
@@ -31,6 +31,7 @@
 #include "pymoose.h"
 #include "MooseVec.h"
 #include "Finfo.h"
+#include "FieldAccessor.h"
 
 using namespace std;
 
@@ -250,96 +251,15 @@ string getDoc(const string &query)
 bool setFieldGeneric(const ObjId &oid, const string &fieldName,
                      const nb::object &val)
 {
-    // if(fieldName == "dt") {
-    //     throw nb::attribute_error(
-    //         "Read-only property. Use `moose.setcClock(...)`");
-    // }
-    // else if(fieldName == "tick") {
-    //     throw nb::warning("Setting . Use `moose.useClock(...)`");
-    // }
-    auto cinfo = oid.element()->cinfo();
-    auto finfo = cinfo->findFinfo(fieldName);
-    if(!finfo) {
+    const FieldAccessor *acc =
+        findAccessor(oid.element()->cinfo(), fieldName);
+    if(!acc) {
         throw nb::attribute_error((__func__ + string("::") + fieldName +
                                    " is not found on path '" + oid.path() +
                                    "'.")
                                       .c_str());
-        return false;
-    }
-
-    auto fieldType = finfo->rttiType();
-
-    // Remove any space in fieldType
-    fieldType.erase(
-        std::remove_if(fieldType.begin(), fieldType.end(), ::isspace),
-        fieldType.end());
-
-    if(fieldType == "double") {
-        return Field<double>::set(oid, fieldName, nb::cast<double>(val));
-    }
-    if(fieldType == "vector<double>")
-        return Field<vector<double>>::set(oid, fieldName,
-                                          nb::cast<vector<double>>(val));
-    if(fieldType == "float")
-        return Field<float>::set(oid, fieldName, nb::cast<float>(val));
-    if(fieldType == "unsignedint")
-        return Field<unsigned int>::set(oid, fieldName,
-                                        nb::cast<unsigned int>(val));
-    if(fieldType == "unsignedlong")
-        return Field<unsigned long>::set(oid, fieldName,
-                                         nb::cast<unsigned long>(val));
-    if(fieldType == "int")
-        return Field<int>::set(oid, fieldName, nb::cast<int>(val));
-    if(fieldType == "bool")
-        // Use Python truthiness (like `bool(val)`) so that ints (0/1) and
-        // other objects convert as a Python user would expect. nanobind's
-        // bool caster is strict and only accepts actual True/False.
-        return Field<bool>::set(oid, fieldName, nb::cast<bool>(nb::bool_(val)));
-    if(fieldType == "string")
-        return Field<string>::set(oid, fieldName, nb::cast<string>(val));
-    if(fieldType == "vector<string>")
-        return Field<vector<string>>::set(oid, fieldName,
-                                          nb::cast<vector<string>>(val));
-    if(fieldType == "char")
-        return Field<char>::set(oid, fieldName, nb::cast<char>(val));
-    if(fieldType == "vector<ObjId>")
-        return Field<vector<ObjId>>::set(oid, fieldName,
-                                         nb::cast<vector<ObjId>>(val));
-    if(fieldType == "ObjId")
-        return Field<ObjId>::set(oid, fieldName, nb::cast<ObjId>(val));
-    if(fieldType == "Id") {
-        // NB: Handle MooseVec as well. Note that we send ObjId to the set
-        // function. The C++ implicit conversion takes care of the rest.
-        // Id tgt;
-        if(nb::isinstance<MooseVec>(val)) {
-            return Field<Id>::set(oid.id, fieldName,
-                                  nb::cast<MooseVec>(val).id());
-        }
-        else if(nb::isinstance<ObjId>(val)) {
-            return Field<Id>::set(oid.id, fieldName, nb::cast<ObjId>(val).id);
-        }
-        else if(nb::isinstance<Id>(val)) {
-            return Field<Id>::set(oid.id, fieldName, nb::cast<Id>(val));
-        }
-    }
-    if(fieldType == "vector<double>") {
-        // NB: Note that we cast to ObjId here and not to Id.
-        return Field<vector<double>>::set(oid.id, fieldName,
-                                          nb::cast<vector<double>>(val));
     }
-    if(fieldType == "vector<vector<double>>") {
-        // NB: Note that we cast to ObjId here and not to Id.
-        return Field<vector<vector<double>>>::set(
-            oid.id, fieldName, nb::cast<vector<vector<double>>>(val));
-    }
-    if(fieldType == "Variable")
-        if(fieldType == "Variable")
-            return Field<Variable>::set(oid, fieldName,
-                                        nb::cast<Variable>(val));
-
-    throw runtime_error("NotImplemented::setField: '" + fieldName +
-                        "' with value type '" + fieldType + "'.");
-    return false;
+    return acc->set(oid, val);
 }
 
 nb::object getFieldValue(const ObjId &oid, const Finfo *f)
@@ -482,6 +402,7 @@ nb::object createDestFunction(const ObjId &oid, const Finfo *finfo)
         DEST_FUNC_2(double, long, types)
         DEST_FUNC_2(string, string, types)
         DEST_FUNC_2(ObjId, ObjId, types)
+        DEST_FUNC_2(ObjId, double, types)
         DEST_FUNC_2(Id, double, types)
         DEST_FUNC_2(vector<double>, string, types)
     }
@@ -555,33 +476,13 @@ nb::object getFieldGeneric(const ObjId &oid, const string &fieldName)
         return nb::cast(Field<unsigned int>::get(oid, "numField"));
     }
 
-    auto cinfo = oid.element()->cinfo();
-    auto finfo = cinfo->findFinfo(fieldName);
-
-    if(!finfo) {
+    const FieldAccessor *acc =
+        findAccessor(oid.element()->cinfo(), fieldName);
+    if(!acc) {
         throw nb::attribute_error(
             (fieldName + " is not found on '" + oid.path() + "'.").c_str());
     }
-
-    string finfoType = cinfo->getFinfoType(finfo);
-
-    if(finfoType == "ValueFinfo") {
-        return getFieldValue(oid, finfo);
-    }
-    else if(finfoType == "FieldElementFinfo") {
-        return nb::cast(ElementField(oid, finfo));
-    }
-    else if(finfoType == "LookupValueFinfo") {
-        return nb::cast(LookupField(oid, finfo));
-    }
-    else if(finfoType == "DestFinfo") {
-        return createDestFunction(oid, finfo);
-    }
-
-    throw runtime_error("getFieldGeneric::NotImplemented : " + fieldName +
-                        " with rttType " + finfo->rttiType() + " and type: '" +
-                        finfoType + "'");
-    return nb::none();
+    return acc->get(oid);
 }
 
 ObjId createElementFromPath(const string &type, const string &p,
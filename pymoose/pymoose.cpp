@@ -140,6 +140,9 @@ Designed to simulate neural systems at multiple scales: From subcellular compone
              })
         .def("__repr__",
              [](const Id &id) {
+                 if(!id.element())
+                     return "<moose.Id deleted id=" + to_string(id.value()) +
+                            ">";
                  return "<moose.Id  path=" + id.path() +
                         " id=" + to_string(id.value()) +
                         " class=" + id.element()->cinfo()->name() + ">";
@@ -225,6 +228,9 @@ Designed to simulate neural systems at multiple scales: From subcellular compone
             nb::arg("msgtype") = "Single", docs::ObjId_connect)
         .def("__repr__",
              [](const ObjId &oid) {
+                 if(!oid.element())
+                     return "<moose.ObjId deleted id=" +
+                            to_string(oid.id.value()) + ">";
                  return "<moose." + oid.element()->cinfo()->name() +
                         " path=" + oid.path() +
                         " id=" + to_string(oid.id.value()) +
@@ -329,6 +335,46 @@ Designed to simulate neural systems at multiple scales: From subcellular compone
     m.def(
         "isRunning", []() { return pymoose::getShellPtr()->isRunning(); },
         docs::isRunning);
+    m.def(
+        "saveCheckpoint",
+        [](const string &filename, bool wait) {
+            return pymoose::getShellPtr()->doSaveCheckpoint(filename, wait);
+        },
+        nb::arg("filename"), nb::arg("wait") = false, docs::saveCheckpoint);
+    m.def(
+        "loadCheckpoint",
+        [](const string &filename) {
+            return pymoose::getShellPtr()->doLoadCheckpoint(filename);
+        },
+        nb::arg("filename"), docs::loadCheckpoint);
+    m.def(
+        "fork",
+        [](unsigned int branches) {
+            // Each fork goes through the interpreter's own hooks, as
+            // os.fork does, so that Python is sane in the children.
+            Shell *shell = pymoose::getShellPtr();
+            if(!shell->canFork())
+                return -1;
+            for(unsigned int i = 1; i <= branches; ++i) {
+                PyOS_BeforeFork();
+                int pid = shell->forkBranch(i);
+                if(pid == 0) {
+                    PyOS_AfterFork_Child();
+                    return static_cast<int>(i);
+                }
+                PyOS_AfterFork_Parent();
+                if(pid < 0)
+                    break;
+            }
+            return 0;
+        },
+        nb::arg("branches"), docs::fork);
+    m.def(
+        "waitForks", []() { return pymoose::getShellPtr()->doWaitForks(); },
+        docs::waitForks);
+    m.def(
+        "branch", []() { return pymoose::getShellPtr()->getBranch(); },
+        docs::branch);
 
     m.def(
         "exists",
@@ -68,6 +68,8 @@ bool setFieldGeneric(const ObjId& oid, const std::string& fieldName,
                      const nb::object& val);
 nb::object getFieldValue(const ObjId& oid, const Finfo* f);
 nb::object getFieldGeneric(const ObjId& oid, const std::string& fieldName);
+/// Python callable for DestFinfo `f` of element `oid`
+nb::object createDestFunction(const ObjId& oid, const Finfo* f);
 
 // ----------------------------------------------------------------------
 // Functions for construction and destruction of objects
@@ -18,34 +18,78 @@ import math
 import struct
 from collections import defaultdict
 
-def bytes_to_np_arr(data):
-    return np.frombuffer(data, float)
-
-def np_array_to_string(arr):
-    return np.uint8(arr).tostring()
-
-def np_array_to_data(arr):
-    # Make sure that first char of arr is 'H'
-    n = 0
-    res = defaultdict(list)
-    while n < len(arr):
-        assert chr(int(arr[n])) == 'H', 'Expected H, Got %s'%arr[n]
-        hSize = int(arr[n+1])
-        n += 1
-        colName = np_array_to_string(arr[n+1:n+1+hSize])
-        n += hSize + 1
-        assert chr(int(arr[n])) == 'V', 'Expected V'
-        n += 1
-        dataSize = int(arr[n])
-        n += 1
-        res[colName].append(arr[n:n+dataSize])
-        n += dataSize 
-    return { k : np.concatenate(v) for k, v in res.items() }
+class StreamDecoder(object):
+    """Decoder for the frames sent by moose.SocketStreamer.
+
+    Feed it the bytes read from the socket, in pieces of any size, and it
+    collects the times and values of each column. A header frame names the
+    columns; the data frames that follow carry raw float64 or float32
+    blocks of times and values for each of them.
+    """
+
+    def __init__(self):
+        self.buf = b''
+        self.columns = []
+        self.dtype = np.float64
+        self.times = defaultdict(list)
+        self.values = defaultdict(list)
+        self.numFrames = 0
+
+    def feed(self, data):
+        self.buf += data
+        while self._frame():
+            self.numFrames += 1
+
+    def _frame(self):
+        buf = self.buf
+        if len(buf) < 8:
+            return False
+        magic = buf[:4]
+        if magic == b'MSH1':
+            if len(buf) < 12:
+                return False
+            valueSize, ncols = struct.unpack_from('=II', buf, 4)
+            pos = 12
+            cols = []
+            for _ in range(ncols):
+                if len(buf) < pos + 4:
+                    return False
+                n, = struct.unpack_from('=I', buf, pos)
+                if len(buf) < pos + 4 + n:
+                    return False
+                cols.append(buf[pos+4:pos+4+n].decode())
+                pos += 4 + n
+            self.columns = cols
+            self.dtype = np.float32 if valueSize == 4 else np.float64
+        elif magic == b'MSD1':
+            ncols, = struct.unpack_from('=I', buf, 4)
+            pos = 8 + 4 * ncols
+            if len(buf) < pos:
+                return False
+            counts = struct.unpack_from('=%dI' % ncols, buf, 8)
+            size = np.dtype(self.dtype).itemsize
+            if len(buf) < pos + 2 * size * sum(counts):
+                return False
+            for col, n in zip(self.columns, counts):
+                block = np.frombuffer(buf, self.dtype, 2 * n, pos)
+                self.times[col].append(block[:n])
+                self.values[col].append(block[n:])
+                pos += 2 * n * size
+        else:
+            raise ValueError('Expected a frame, got %r' % magic)
+        self.buf = buf[pos:]
+        return True
+
+    def data(self):
+        """Returns { column : array( [times, values] ) }."""
+        return {k: np.array([np.concatenate(self.times[k]),
+                             np.concatenate(self.values[k])])
+                for k in self.times}
 
 def decode_data(data):
-    arr = bytes_to_np_arr(data)
-    assert int(arr[0]) == ord('H'), "First char must be H"
-    return np_array_to_data(arr)
+    dec = StreamDecoder()
+    dec.feed(data)
+    return dec.data()
 
 def test():
     with open(sys.argv[1], 'rb') as f:
@@ -0,0 +1,169 @@
+/***
+ *    Description:  Counter-based random number generator.
+ *
+ *        Created:  2026-10-18
+ *
+ *        License:  Same as MOOSE license.
+ */
+
+#include <cmath>
+#include <cassert>
+#include "randnum.h"
+#include "CounterRNG.h"
+
+namespace moose {
+
+static const uint32_t PHILOX_M0 = 0xD2511F53;
+static const uint32_t PHILOX_M1 = 0xCD9E8D57;
+static const uint32_t PHILOX_W0 = 0x9E3779B9;
+static const uint32_t PHILOX_W1 = 0xBB67AE85;
+
+static inline void philoxRound( uint32_t k0, uint32_t k1, uint32_t c[4] )
+{
+    uint64_t p0 = static_cast< uint64_t >( PHILOX_M0 ) * c[0];
+    uint64_t p1 = static_cast< uint64_t >( PHILOX_M1 ) * c[2];
+    uint32_t hi0 = static_cast< uint32_t >( p0 >> 32 );
+    uint32_t lo0 = static_cast< uint32_t >( p0 );
+    uint32_t hi1 = static_cast< uint32_t >( p1 >> 32 );
+    uint32_t lo1 = static_cast< uint32_t >( p1 );
+    c[0] = hi1 ^ c[1] ^ k0;
+    c[1] = lo1;
+    c[2] = hi0 ^ c[3] ^ k1;
+    c[3] = lo0;
+}
+
+void philox4x32( const uint32_t key[2], const uint32_t ctr[4],
+        uint32_t out[4] )
+{
+    uint32_t k0 = key[0];
+    uint32_t k1 = key[1];
+    for ( unsigned int i = 0; i < 4; ++i )
+        out[i] = ctr[i];
+    for ( unsigned int round = 0; round < 10; ++round )
+    {
+        philoxRound( k0, k1, out );
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+}
+
+uint32_t getCounterSeed()
+{
+    if ( __rng_seed__ != 0 )
+        return static_cast< uint32_t >( __rng_seed__ );
+    // Thread-safe one-time initialization.
+    static const uint32_t randomSeed = MOOSE_RANDOM_DEVICE()();
+    return randomSeed;
+}
+
+/// 64 bit FNV-1a hash of the path, followed by the bytes of the index.
+uint64_t pathKey( const std::string& path, unsigned int dataIndex )
+{
+    const uint64_t prime = 0x100000001B3ULL;
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for ( std::string::const_iterator
+            i = path.begin(); i != path.end(); ++i )
+    {
+        h ^= static_cast< unsigned char >( *i );
+        h *= prime;
+    }
+    for ( unsigned int i = 0; i < 4; ++i )
+    {
+        h ^= ( dataIndex >> ( 8 * i ) ) & 0xFF;
+        h *= prime;
+    }
+    return h;
+}
+
+/**
+ * @brief Converts two words to a double in (0, 1) with 53 bits of
+ * resolution. Zero and one are never returned, so it is safe to take
+ * logs.
+ */
+static inline double wordsToUniform( uint32_t hi, uint32_t lo )
+{
+    uint64_t x = ( static_cast< uint64_t >( hi >> 5 ) << 26 ) | ( lo >> 6 );
+    return ( x + 0.5 ) * ( 1.0 / 9007199254740992.0 );
+}
+
+/// Box-Muller transform of two uniforms in (0, 1).
+static inline void boxMuller( double u1, double u2, double& n1, double& n2 )
+{
+    double r = std::sqrt( -2.0 * std::log( u1 ) );
+    double theta = 2.0 * M_PI * u2;
+    n1 = r * std::cos( theta );
+    n2 = r * std::sin( theta );
+}
+
+CounterRNG::CounterRNG( uint64_t object, uint64_t step, uint32_t stream )
+    : CounterRNG( getCounterSeed(), object, step, stream )
+{;}
+
+/**
+ * The key holds the seed and the high half of the step. The counter
+ * holds the stream in the top 8 bits of its first word, with the block
+ * index below it, then the low half of the step and the object.
+ */
+CounterRNG::CounterRNG( uint32_t seed, uint64_t object, uint64_t step,
+        uint32_t stream )
+    : pos_( 4 ), spareNormal_( 0.0 ), hasSpareNormal_( false )
+{
+    assert( stream < 256 );
+    key_[0] = seed;
+    key_[1] = static_cast< uint32_t >( step >> 32 );
+    ctr_[0] = stream << 24;
+    ctr_[1] = static_cast< uint32_t >( step );
+    ctr_[2] = static_cast< uint32_t >( object );
+    ctr_[3] = static_cast< uint32_t >( object >> 32 );
+}
+
+void CounterRNG::nextBlock()
+{
+    philox4x32( key_, ctr_, block_ );
+    ++ctr_[0];
+    assert( ( ctr_[0] & 0xFFFFFF ) != 0 ); // Ran into the next stream.
+    pos_ = 0;
+}
+
+double CounterRNG::uniform()
+{
+    if ( pos_ > 2 )
+        nextBlock();
+    double ret = wordsToUniform( block_[pos_], block_[pos_ + 1] );
+    pos_ += 2;
+    return ret;
+}
+
+double CounterRNG::uniform( double a, double b )
+{
+    return ( b - a ) * uniform() + a;
+}
+
+double CounterRNG::normal()
+{
+    if ( hasSpareNormal_ )
+    {
+        hasSpareNormal_ = false;
+        return spareNormal_;
+    }
+    double u1 = uniform();
+    double u2 = uniform();
+    double ret;
+    boxMuller( u1, u2, ret, spareNormal_ );
+    hasSpareNormal_ = true;
+    return ret;
+}
+
+void CounterRNG::fillUniform( double* buf, size_t n )
+{
+    for ( size_t i = 0; i < n; ++i )
+        buf[i] = uniform();
+}
+
+void CounterRNG::fillNormal( double* buf, size_t n )
+{
+    for ( size_t i = 0; i < n; ++i )
+        buf[i] = normal();
+}
+
+}  // namespace moose.
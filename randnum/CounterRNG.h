@@ -0,0 +1,100 @@
+/***
+ *    Description:  Counter-based random number generator.
+ *
+ *        Created:  2026-10-18
+ *
+ *        License:  Same as MOOSE license.
+ */
+
+#ifndef  __COUNTER_RNG_INC
+#define  __COUNTER_RNG_INC
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace moose
+{
+
+/**
+ * @brief Philox4x32-10 block function (Salmon, Moraes, Dror and Shaw,
+ * SC11, 2011). Maps a 128 bit counter and a 64 bit key to 128 random
+ * bits. Has no state, so it can be called from any thread.
+ */
+void philox4x32( const uint32_t key[2], const uint32_t ctr[4],
+        uint32_t out[4] );
+
+/**
+ * @brief Seed used by all counter-based generators. This is the global
+ * seed set by moose.seed(). If that is zero (unseeded) a random seed is
+ * drawn once, so unseeded runs still differ from each other.
+ */
+uint32_t getCounterSeed();
+
+/// Packs an Id value and a data index into an object key.
+inline uint64_t objectKey( unsigned int idValue, unsigned int dataIndex )
+{
+    return ( static_cast< uint64_t >( idValue ) << 32 ) | dataIndex;
+}
+
+/**
+ * @brief Object key made by hashing an Element path and a data index.
+ * Unlike the Id value this is the same whenever the model is rebuilt,
+ * so a seeded model draws the same numbers every time it is built.
+ */
+uint64_t pathKey( const std::string& path, unsigned int dataIndex );
+
+/*
+ * =====================================================================================
+ *        Class:  CounterRNG
+ *  Description:  A stream of random numbers addressed by
+ *                (seed, object, step, stream). The numbers drawn for a
+ *                given address are the same whatever the thread or the
+ *                order in which objects are visited, so parallel runs
+ *                are bit-identical to serial ones. The object is cheap to
+ *                construct and is meant to live on the stack, one per
+ *                object per timestep.
+ *                There can be up to 256 streams, and each address gives
+ *                up to 2^25 uniforms.
+ * =====================================================================================
+ */
+class CounterRNG
+{
+    public:
+        /// Uses the global seed.
+        CounterRNG( uint64_t object, uint64_t step, uint32_t stream = 0 );
+        CounterRNG( uint32_t seed, uint64_t object, uint64_t step,
+                uint32_t stream );
+
+        /// Uniform random number in (0, 1), both ends excluded.
+        double uniform();
+
+        /// Uniform random number in (a, b).
+        double uniform( double a, double b );
+
+        /// Normally distributed number with zero mean and unit variance.
+        double normal();
+
+        /// Fills buf with n uniforms in (0, 1).
+        void fillUniform( double* buf, size_t n );
+
+        /// Fills buf with n standard normals.
+        void fillNormal( double* buf, size_t n );
+
+    private:
+        /// Computes the next block of 4 words and resets the read position.
+        void nextBlock();
+
+        uint32_t key_[2];
+        uint32_t ctr_[4];
+        uint32_t block_[4];
+        unsigned int pos_;
+
+        /// Second value of the last Box-Muller pair.
+        double spareNormal_;
+        bool hasSpareNormal_;
+};
+
+}                                               /* namespace moose ends  */
+
+#endif   /* ----- #ifndef __COUNTER_RNG_INC  ----- */
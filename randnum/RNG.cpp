@@ -8,6 +8,7 @@
  *        License:  MIT License
  */
 
+#include <sstream>
 #include "RNG.h"
 
 namespace moose {
@@ -71,4 +72,35 @@ double RNG::uniform( void )
     return dist_( rng_ );
 }
 
+/**
+ * @brief Return a Poisson distributed random number with the given mean.
+ * Used by the tau-leaping stochastic solver.
+ *
+ * @param mean Expected value. Returns 0 when mean <= 0.
+ */
+double RNG::poisson( const double mean )
+{
+    if ( mean <= 0.0 )
+        return 0.0;
+    std::poisson_distribution<unsigned long> dist( mean );
+    return static_cast<double>( dist( rng_ ) );
+}
+
+/**
+ * @brief The state of the engine and of the distribution, as the standard
+ * library streams them. Restoring it continues the same sequence.
+ */
+string RNG::getState( void ) const
+{
+    ostringstream ss;
+    ss << rng_ << ' ' << dist_;
+    return ss.str();
+}
+
+void RNG::setState( const string& state )
+{
+    istringstream ss( state );
+    ss >> rng_ >> dist_;
+}
+
 }
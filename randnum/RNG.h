@@ -23,6 +23,7 @@
 #include <iostream>
 #include <random>
 #include <cassert>
+#include <string>
 
 #include "Definitions.h"
 #include "Distributions.h"
@@ -56,6 +57,13 @@ class RNG
 
         double uniform( void );
 
+        /// Poisson distributed integer (returned as double) with given mean.
+        double poisson( const double mean );
+
+        /// Engine state as text, for checkpoints.
+        string getState( void ) const;
+        void setState( const string& state );
+
 
     private:
         /* ====================  DATA MEMBERS  ======================================= */
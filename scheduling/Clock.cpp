@@ -33,8 +33,11 @@
  *         value is used for the integral multiple. Zero means the tick is not
  *         scheduled.
  * 2. The process call goes through all active ticks in order every
- *         timestep. Each Tick increments its counter and decides if it is
- *         time to fire.
+ *         timestep at which one of them is due. Each active tick is a
+ *         periodic timer on a TimingWheel, which also holds the timers of
+ *         Elements that have been put on the Clock with their own period
+ *         (schedule), and one-shot wakeups of event-driven Elements. Steps
+ *         at which no timer is due are skipped.
  * 4. The Reinit call goes through all active ticks in order, just once.
  * 5. We connect up the Ticks to their target objects.
  * 6. We begin the simulation by calling 'start' or 'step' on the Clock.
@@ -50,6 +53,7 @@
 
 #include "../basecode/header.h"
 #include "../utility/print_function.hpp"
+#include "../shell/Checkpoint.h"
 #include "Clock.h"
 
 #if PARALLELIZE_CLOCK_USING_CPP11_ASYNC
@@ -181,6 +185,13 @@ const Cinfo* Clock::initCinfo()
         &Clock::getDts
     );
 
+    static ReadOnlyValueFinfo< Clock, unsigned int > numTimers(
+        "numTimers",
+        "Number of timers pending on the timing wheel: one for each "
+        "active tick and scheduled Element, and any wakeups.",
+        &Clock::getNumTimers
+    );
+
     static ReadOnlyValueFinfo< Clock, bool > isRunning(
         "isRunning",
         "Utility function to report if simulation is in progress.",
@@ -243,6 +254,23 @@ const Cinfo* Clock::initCinfo()
             , new EpFunc0< Clock >(&Clock::handleReinit )
             );
 
+    static DestFinfo schedule( "schedule"
+            , "schedule( element, period ). "
+            "Takes the element off its tick and has the Clock call its "
+            "process every period seconds, rounded to a whole number of "
+            "base steps. It is still reinited with the tick it was on, "
+            "and within a step goes just after that tick. "
+            "A period of zero makes it event driven: classes such as "
+            "TimeTable then ask to be woken only when they have work. "
+            "Classes with an init action cannot be scheduled this way."
+            , new OpFunc2< Clock, ObjId, double >(&Clock::schedule )
+            );
+
+    static DestFinfo unschedule( "unschedule"
+            , "Puts a scheduled element back on the tick it was on."
+            , new OpFunc1< Clock, ObjId >(&Clock::unschedule )
+            );
+
     static Finfo* clockControlFinfos[] =
     {
         &start, &step, &stop, &reinit,
@@ -268,10 +296,13 @@ const Cinfo* Clock::initCinfo()
         &currentStep,           // ReadOnlyValue
         &dts,                   // ReadOnlyValue
         &isRunning,             // ReadOnlyValue
+        &numTimers,             // ReadOnlyValue
         &tickStep,              // LookupValue
         &tickDt,                // LookupValue
         &defaultTick,           // ReadOnlyLookupValue
         &clockControl,          // Shared
+        &schedule,              // Dest
+        &unschedule,            // Dest
         finished(),             // Src
         procs[0],               // Src
         procs[1],               // Src
@@ -332,7 +363,9 @@ const Cinfo* Clock::initCinfo()
         "The clock also starts up with some default timesteps for each "
         "of these ticks, and this can be overridden using the shell "
         "command setClock, or by directly assigning tickStep values on the "
-        "clock object."
+        "clock object. "
+        "An element can also be taken off the ticks and given a period "
+        "of its own, or made event driven, with the schedule function.\n"
         "Which objects use which tick? As a rule of thumb, try this: \n"
         "Electrical/compartmental model calculations: Ticks 0-7 \n"
         "Tables and output objects for electrical output: Tick 8 \n"
@@ -367,9 +400,11 @@ const Cinfo* Clock::initCinfo()
         "    MMPump              1       50e-6\n"
         "    DifBuffer           1       50e-6\n"
         "    DifBufferBase       1       50e-6\n"
+        "    DifShellSolver      1       50e-6\n"
         "    MgBlock             1       50e-6\n"
         "    Nernst              1       50e-6\n"
         "    RandSpike           1       50e-6\n"
+        "    PoissonSource       1       50e-6\n"
         "    IntFire             2       50e-6\n"
         "    IntFireBase         2       50e-6\n"
         "    LIF                 2       50e-6\n"
@@ -446,6 +481,7 @@ const Cinfo* Clock::initCinfo()
 }
 
 static const Cinfo* clockCinfo = Clock::initCinfo();
+static CheckpointHandler< Clock > clockCheckpoint( "Clock" );
 
 ///////////////////////////////////////////////////
 // Constructor
@@ -539,6 +575,11 @@ vector< double > Clock::getDts() const
     return ret;
 }
 
+unsigned int Clock::getNumTimers() const
+{
+    return wheel_.size();
+}
+
 bool Clock::isRunning() const
 {
     return isRunning_;
@@ -663,6 +704,179 @@ void Clock::innerReportClock() const
     cout << endl;
 }
 
+/////////////////////////////////////////////////////////////////////
+// Elements scheduled with their own period.
+/////////////////////////////////////////////////////////////////////
+
+/// Rounds a period to base steps. Nonzero periods take at least one.
+static unsigned long periodSteps( double period, double dt )
+{
+    if ( period <= 0.0 )
+        return 0;
+    return max( 1UL, static_cast< unsigned long >( round( period / dt ) ) );
+}
+
+static const OpFunc1Base< ProcPtr >* procFunc( const Cinfo* c,
+        const string& name )
+{
+    const DestFinfo* df = dynamic_cast< const DestFinfo* >(
+            c->findFinfo( name ) );
+    if ( !df )
+        return 0;
+    return dynamic_cast< const OpFunc1Base< ProcPtr >* >( df->getOpFunc() );
+}
+
+int Clock::findScheduled( Id id ) const
+{
+    unordered_map< Id, unsigned int >::const_iterator i =
+        scheduledIndex_.find( id );
+    if ( i == scheduledIndex_.end() )
+        return -1;
+    return i->second;
+}
+
+void Clock::schedule( ObjId oid, double period )
+{
+    if ( isRunning_ || doingReinit_ )
+    {
+        cout << "Warning: Clock::schedule: Cannot schedule while simulation is running\n";
+        return;
+    }
+    Element* elm = oid.element();
+    if ( !elm )
+        return;
+    const Cinfo* c = elm->cinfo();
+    if ( period < 0.0 )
+    {
+        cout << "Warning: Clock::schedule: period " << period <<
+             " for '" << oid.path() << "' is negative\n";
+        return;
+    }
+    if ( c->findFinfo( "init" ) )
+    {
+        cout << "Warning: Clock::schedule: '" << oid.path() <<
+             "' has an init action and has to stay on its tick\n";
+        return;
+    }
+    const OpFunc1Base< ProcPtr >* proc = procFunc( c, "process" );
+    const OpFunc1Base< ProcPtr >* reinit = procFunc( c, "reinit" );
+    if ( !proc || !reinit )
+    {
+        cout << "Warning: Clock::schedule: '" << oid.path() <<
+             "' does not support process actions\n";
+        return;
+    }
+
+    int i = findScheduled( elm->id() );
+    if ( i < 0 )
+    {
+        int tick = elm->getTick();
+        unsigned int t = ( tick >= 0 ) ? tick : lookupDefaultTick( c->name() );
+        Scheduled s = { elm->id(), 2 * min( t, numTicks ) + 1, period,
+            proc, reinit };
+        elm->setTick( -1 );
+        scheduled_.push_back( s );
+        i = scheduled_.size() - 1;
+        scheduledIndex_[ s.id ] = i;
+    }
+    else
+    {
+        scheduled_[i].period = period;
+        unsigned int target = numTicks + i;
+        wheel_.removeIf( [target]( const TimingWheel::Timer& t ) {
+                    return t.target == target && t.period > 0;
+                } );
+    }
+    // Until the next reinit the period runs from here.
+    unsigned long steps = periodSteps( period, dt_ );
+    if ( steps > 0 )
+    {
+        TimingWheel::Timer t = { wheel_.now() + steps, steps,
+            scheduled_[i].order, 0, numTicks + i, ALLDATA };
+        wheel_.insert( t );
+    }
+}
+
+void Clock::unschedule( ObjId oid )
+{
+    if ( isRunning_ || doingReinit_ )
+    {
+        cout << "Warning: Clock::unschedule: Cannot unschedule while simulation is running\n";
+        return;
+    }
+    int i = findScheduled( oid.id );
+    if ( i < 0 )
+    {
+        cout << "Warning: Clock::unschedule: '" << oid.path() <<
+             "' is not scheduled on the clock\n";
+        return;
+    }
+    unsigned int target = numTicks + i;
+    wheel_.removeIf( [target]( const TimingWheel::Timer& t ) {
+                return t.target == target;
+            } );
+    Scheduled& s = scheduled_[i];
+    // The slot stays, so that the targets of other timers still hold.
+    s.proc = s.reinit = 0;
+    scheduledIndex_.erase( s.id );
+    Element* elm = s.id.element();
+    if ( elm && elm->getTick() == -1 )
+    {
+        unsigned int tick = ( s.order - 1 ) / 2;
+        elm->setTick( tick < numTicks ? tick : -1 );
+    }
+}
+
+bool Clock::wake( const Eref& e, double t )
+{
+    Clock* c = reinterpret_cast< Clock* >( Id( 1 ).eref().data() );
+    return c->innerWake( e, t );
+}
+
+bool Clock::innerWake( const Eref& e, double t )
+{
+    int i = findScheduled( e.id() );
+    if ( i < 0 )
+        return false;
+    // The first step whose end time is at least t, as a tick would have
+    // found it.
+    unsigned long step = t > 0.0 ?
+        static_cast< unsigned long >( ceil( t / dt_ ) ) : 0;
+    while ( step > 0 && dt_ * ( step - 1 ) >= t )
+        --step;
+    while ( dt_ * step < t )
+        ++step;
+    step = max( step, wheel_.now() + 1 );
+    TimingWheel::Timer timer = { step, 0, scheduled_[i].order, 0,
+        numTicks + i, e.dataIndex() };
+    wheel_.insert( timer );
+    return true;
+}
+
+void Clock::fire( const Eref& e, const TimingWheel::Timer& t )
+{
+    if ( t.target < numTicks )
+    {
+        info_.dt = t.period * dt_;
+        processVec()[ t.target ]->send( e, &info_ );
+        return;
+    }
+    const Scheduled& s = scheduled_[ t.target - numTicks ];
+    Element* elm = s.id.element();
+    if ( !s.proc || !elm )
+        return;
+    info_.dt = ( t.period > 0 ? t.period : 1 ) * dt_;
+    if ( t.index == ALLDATA )
+    {
+        unsigned int start = elm->localDataStart();
+        s.proc->opAll( elm, start, start + elm->numLocalData(), &info_ );
+    }
+    else if ( t.index < elm->numData() )
+    {
+        s.proc->op( Eref( elm, t.index ), &info_ );
+    }
+}
+
 /////////////////////////////////////////////////////////////////////
 // Core scheduling functions.
 /////////////////////////////////////////////////////////////////////
@@ -686,6 +900,20 @@ void Clock::buildTicks( const Eref& e )
     // Should really do the HCF of N numbers here to get the stride.
 }
 
+void Clock::buildTimers()
+{
+    wheel_.removeIf( []( const TimingWheel::Timer& t ) {
+                return t.target < Clock::numTicks;
+            } );
+    for ( unsigned int i = 0; i < activeTicks_.size(); ++i )
+    {
+        unsigned long step = activeTicks_[i];
+        TimingWheel::Timer t = { ( currentStep_ / step + 1 ) * step, step,
+            2 * activeTicksMap_[i], 0, activeTicksMap_[i], 0 };
+        wheel_.insert( t );
+    }
+}
+
 /**
  * Start has to happen gracefully: If the simulation was stopped for any
  * reason, it has to pick up where it left off.
@@ -714,6 +942,7 @@ void Clock::handleStep( const Eref& e, unsigned long numSteps )
     char now[80];
 
     buildTicks( e );
+    buildTimers();
 	if (nSteps_ == 0 )
 		info_.setFirstStep();
 	else
@@ -722,60 +951,27 @@ void Clock::handleStep( const Eref& e, unsigned long numSteps )
     assert( activeTicks_.size() == activeTicksMap_.size() );
     nSteps_ += numSteps;
     runTime_ = nSteps_ * dt_;
-    for ( isRunning_ = (activeTicks_.size() > 0 );
-            isRunning_ && currentStep_ < nSteps_; currentStep_ += stride_ )
+    for ( isRunning_ = ( wheel_.size() > 0 );
+            isRunning_ && currentStep_ < nSteps_; )
     {
-        // Curr time is end of current step.
-        unsigned long endStep = currentStep_ + stride_;
+        // Curr time is end of current step. Steps with nothing due are
+        // skipped.
+        unsigned long endStep = min( wheel_.nextDue(), nSteps_ );
         currentTime_ = info_.currTime = dt_ * endStep;
-
-#if 0
-
-//#if PARALLELIZE_CLOCK_USING_CPP11_ASYNC
-
-        // NOTE: It does not produce very promising results. The challenge here
-        // is doing load-balancing.
-        // TODO: To start with, we can put one solver on one thread and everything
-        // else onto 1 thread. Each Hsove, Ksolve, and Gsolve can take its own
-        // thread and rest are on different threads.
-
-        unsigned int nTasks = activeTicks_.size( );
-        unsigned int numThreads_ = 3;
-        unsigned int blockSize = 1 + (nTasks / numThreads_);
-
-        for( unsigned int i = 0; i < numThreads_; ++i  )
-        {
-            std::async( std::launch::async, [this,blockSize,i,nTasks,endStep,e]
-            {
-                unsigned int mapI = i * blockSize;
-                // Get the block we want to run in paralle.
-                for( unsigned int ii = i * blockSize; ii < min((i+1) * blockSize, nTasks); ii++ )
-                {
-                    unsigned int j = activeTicks_[ ii ];
-                    if( endStep % j == 0  )
-                    {
-                        info_.dt = j * dt_;
-                        processVec( )[ activeTicksMap_[mapI] ]->send( e, &info_ );
-                    }
-                    mapI++;
-                }
-            }
-          );
-        }
-#else
-        vector< unsigned int >::const_iterator k = activeTicksMap_.begin();
-        for ( vector< unsigned int>::iterator j =
-                    activeTicks_.begin(); j != activeTicks_.end(); ++j )
+        wheel_.advance( endStep, due_ );
+        currentStep_ = endStep;
+        for ( vector< TimingWheel::Timer >::iterator
+                t = due_.begin(); t != due_.end(); ++t )
         {
-            if ( endStep % *j == 0 )
+            fire( e, *t );
+            if ( t->period > 0 )
             {
-                info_.dt = *j * dt_;
-                processVec()[*k]->send( e, &info_ );
+                t->due += t->period;
+                wheel_.insert( *t );
             }
-            ++k;
         }
-#endif
-		info_.setRunning();
+        if ( due_.size() > 0 )
+            info_.setRunning();
 
         // When 10% of simulation is over, notify user when notify_ is set to
         // true.
@@ -790,9 +986,12 @@ void Clock::handleStep( const Eref& e, unsigned long numSteps )
                      << "% of total " << runTime_ << " seconds is over." << endl;
             }
         }
-
-        if ( activeTicks_.size() == 0 )
-            currentTime_ = runTime_;
+    }
+    if ( wheel_.size() == 0 )
+    {
+        wheel_.reset( nSteps_ );
+        currentStep_ = nSteps_;
+        currentTime_ = runTime_;
     }
 
     info_.dt = dt_;
@@ -814,16 +1013,58 @@ void Clock::handleReinit( const Eref& e )
     currentStep_ = 0;
     nSteps_ = 0;
     buildTicks( e );
+    wheel_.reset( 0 );
+
+    // Drop scheduled Elements that have gone, or been put back on a tick.
+    vector< Scheduled > keep;
+    for ( vector< Scheduled >::const_iterator
+            i = scheduled_.begin(); i != scheduled_.end(); ++i )
+    {
+        if ( i->proc && i->id.element() && i->id.element()->getTick() == -1 )
+            keep.push_back( *i );
+    }
+    stable_sort( keep.begin(), keep.end(),
+            []( const Scheduled& a, const Scheduled& b ) {
+                return a.order < b.order;
+            } );
+    scheduled_.swap( keep );
+    scheduledIndex_.clear();
+    for ( unsigned int i = 0; i < scheduled_.size(); ++i )
+        scheduledIndex_[ scheduled_[i].id ] = i;
+
     doingReinit_ = true;
     // Curr time is end of current step.
     info_.currTime = 0.0;
 	info_.setReinit();
+    // Scheduled Elements are reinited just after the tick they were on.
+    unsigned int s = 0;
     vector< unsigned int >::const_iterator k = activeTicksMap_.begin();
-    for ( vector< unsigned int>::iterator j =
-                activeTicks_.begin(); j != activeTicks_.end(); ++j )
+    for ( unsigned int j = 0; j <= activeTicks_.size(); ++j )
     {
-        info_.dt = *j * dt_;
-        reinitVec()[*k++]->send( e, &info_ );
+        unsigned int order = ( j < activeTicks_.size() ) ?
+            2 * ( *k ) : ~0U;
+        for ( ; s < scheduled_.size() && scheduled_[s].order < order; ++s )
+        {
+            const Scheduled& sc = scheduled_[s];
+            unsigned long period = periodSteps( sc.period, dt_ );
+            info_.dt = ( period > 0 ? period : 1 ) * dt_;
+            Element* elm = sc.id.element();
+            unsigned int start = elm->localDataStart();
+            unsigned int end = start + elm->numLocalData();
+            for ( unsigned int i = start; i < end; ++i )
+                sc.reinit->op( Eref( elm, i ), &info_ );
+            if ( period > 0 )
+            {
+                TimingWheel::Timer t = { period, period, sc.order, 0,
+                    numTicks + s, ALLDATA };
+                wheel_.insert( t );
+            }
+        }
+        if ( j < activeTicks_.size() )
+        {
+            info_.dt = activeTicks_[j] * dt_;
+            reinitVec()[*k++]->send( e, &info_ );
+        }
     }
 
     info_.dt = dt_;
@@ -831,6 +1072,80 @@ void Clock::handleReinit( const Eref& e )
     doingReinit_ = false;
 }
 
+void Clock::saveState( CheckpointWriter& w ) const
+{
+    w.addValue( "dt", dt_ );
+    w.addValue( "currentTime", currentTime_ );
+    w.addValue( "nSteps", nSteps_ );
+    w.addValue( "currentStep", currentStep_ );
+
+    // Tick timers follow from currentStep_. Those of scheduled Elements
+    // are kept by path, as the Ids may differ when the model is rebuilt.
+    vector< TimingWheel::Timer > timers;
+    wheel_.timers( timers );
+    string paths;
+    vector< unsigned long > due;
+    vector< unsigned long > period;
+    vector< unsigned int > index;
+    for ( vector< TimingWheel::Timer >::const_iterator
+            i = timers.begin(); i != timers.end(); ++i )
+    {
+        if ( i->target < numTicks )
+            continue;
+        paths += scheduled_[ i->target - numTicks ].id.path() + "\n";
+        due.push_back( i->due );
+        period.push_back( i->period );
+        index.push_back( i->index );
+    }
+    w.addString( "timerPaths", paths );
+    w.add( "timerDue", due );
+    w.add( "timerPeriod", period );
+    w.add( "timerIndex", index );
+}
+
+/**
+ * Puts the clock where it was, so the next start continues the run with
+ * the same tick phases. Expects to be called after reinit.
+ */
+void Clock::loadState( CheckpointReader& r )
+{
+    double dt = dt_;
+    r.getValue( "dt", dt );
+    if ( !doubleEq( dt, dt_ ) )
+        cout << "Warning: Clock::loadState: checkpoint has dt = " << dt <<
+             ", but the clock has " << dt_ << ".\n";
+    r.getValue( "currentTime", currentTime_ );
+    r.getValue( "nSteps", nSteps_ );
+    r.getValue( "currentStep", currentStep_ );
+    info_.currTime = currentTime_;
+
+    wheel_.reset( currentStep_ );
+    string paths;
+    vector< unsigned long > due;
+    vector< unsigned long > period;
+    vector< unsigned int > index;
+    r.getString( "timerPaths", paths );
+    r.get( "timerDue", due );
+    r.get( "timerPeriod", period );
+    r.get( "timerIndex", index );
+    stringstream ss( paths );
+    string path;
+    for ( unsigned int i = 0; getline( ss, path ) && i < due.size() &&
+            i < period.size() && i < index.size(); ++i )
+    {
+        int s = findScheduled( Id( path ) );
+        if ( s < 0 || due[i] <= currentStep_ )
+        {
+            cout << "Warning: Clock::loadState: timer for '" << path <<
+                 "' is not scheduled here, dropped.\n";
+            continue;
+        }
+        TimingWheel::Timer t = { due[i], period[i], scheduled_[s].order, 0,
+            numTicks + s, index[i] };
+        wheel_.insert( t );
+    }
+}
+
 /*
  * Useful function, only I don't need it yet. Was implemented for Dsolve
 double Dsolve::findDt( const Eref& e )
@@ -889,9 +1204,11 @@ void Clock::buildDefaultTick()
     defaultTick_["MMPump"] =  1;
     defaultTick_["DifBuffer"] = 1;
     defaultTick_["DifBufferBase"] = 1;
+    defaultTick_["DifShellSolver"] = 1;
     defaultTick_["MgBlock"] = 1;
     defaultTick_["Nernst"] = 1;
     defaultTick_["RandSpike"] = 1;
+    defaultTick_["PoissonSource"] = 1;
     defaultTick_["IntFire"] = 2;
     defaultTick_["IntFireBase"] = 2;
     defaultTick_["LIF"] = 2;
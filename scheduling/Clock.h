@@ -10,6 +10,11 @@
 #ifndef _CLOCK_H
 #define _CLOCK_H
 
+#include "TimingWheel.h"
+
+class CheckpointWriter;
+class CheckpointReader;
+
 /**
  * Clock now uses integral scheduling. The Clock has an array of child
  * Ticks, each of which controls the process and reinit calls of its
@@ -20,6 +25,11 @@
  * of execution of target objects is undefined.
  *
  * The Reinit call goes through all Ticks in order.
+ *
+ * Ticks, and Elements that have been taken off the Ticks to run at a
+ * period of their own, are held as timers on a TimingWheel. The run loop
+ * goes from one step at which a timer is due to the next, skipping the
+ * steps at which nothing happens.
  */
 
 class Clock
@@ -47,6 +57,7 @@ class Clock
     unsigned int getDefaultTick( string className ) const;
 
     vector< double > getDts() const;
+    unsigned int getNumTimers() const;
 
     //////////////////////////////////////////////////////////
     //  Dest functions
@@ -66,6 +77,26 @@ class Clock
     /// dest function for message to trigger reinit.
     void handleReinit( const Eref& e );
 
+    /**
+     * Takes the Element of oid off its Tick and has the Clock call its
+     * process every 'period' seconds, rounded to a whole number of base
+     * steps, and its reinit along with the Tick it was on. A period of
+     * zero makes it event driven: it is only processed when it asks to
+     * be woken, see wake().
+     */
+    void schedule( ObjId oid, double period );
+
+    /// Puts a scheduled Element back on the Tick it was on.
+    void unschedule( ObjId oid );
+
+    /**
+     * Asks the Clock to call process on e at the first step ending at or
+     * after time t, and no earlier than the next step. Only Elements put
+     * on the Clock with schedule() can be woken; for others this returns
+     * false and does nothing, as their Tick calls them anyway.
+     */
+    static bool wake( const Eref& e, double t );
+
     ///////////////////////////////////////////////////////////////
     // Stuff for new scheduling.
     ///////////////////////////////////////////////////////////////
@@ -91,6 +122,10 @@ class Clock
     static void reportClock();
     void innerReportClock() const;
 
+    /// Checkpoint support: the step counters. See shell/Checkpoint.h
+    void saveState( CheckpointWriter& w ) const;
+    void loadState( CheckpointReader& r );
+
     // static void* threadStartFunc( void* threadInfo );
     static const Cinfo* initCinfo();
 
@@ -122,6 +157,13 @@ class Clock
 
     private:
     void buildTicks( const Eref& e );
+    /// Puts the active ticks onto the wheel, due after currentStep_.
+    void buildTimers();
+    /// Calls process on the targets of a timer that is due.
+    void fire( const Eref& e, const TimingWheel::Timer& t );
+    int findScheduled( Id id ) const;
+    bool innerWake( const Eref& e, double t );
+
     double runTime_;
     double currentTime_;
     unsigned long nSteps_;
@@ -170,6 +212,25 @@ class Clock
 
     static vector< double > defaultDt_;
 
+    /**
+     * Elements run by the Clock at their own period rather than by a
+     * Tick. Timer targets from numTicks onwards index into this.
+     */
+    struct Scheduled
+    {
+        Id id;
+        unsigned int order;     /// Goes off just after this Tick.
+        double period;          /// 0 for event driven.
+        const OpFunc1Base< ProcPtr >* proc;
+        const OpFunc1Base< ProcPtr >* reinit;
+    };
+    vector< Scheduled > scheduled_;
+    /// Index in scheduled_ of each Element that is still scheduled.
+    unordered_map< Id, unsigned int > scheduledIndex_;
+
+    TimingWheel wheel_;
+    vector< TimingWheel::Timer > due_;
+
     /**
      * @brief When set to true, notify user about the status of
      * simulation by emitting message whenever 10\% of simultion is
@@ -0,0 +1,168 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2014 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include <algorithm>
+#include "../basecode/header.h"
+#include "TimingWheel.h"
+
+static bool timerBefore( const TimingWheel::Timer& a,
+        const TimingWheel::Timer& b )
+{
+    if ( a.order != b.order )
+        return a.order < b.order;
+    return a.seq < b.seq;
+}
+
+TimingWheel::TimingWheel()
+    : now_( 0 ), seq_( 0 ), nextDue_( 0 )
+{
+    for ( unsigned int l = 0; l < numLevels; ++l )
+        occupied_[l] = 0;
+}
+
+void TimingWheel::reset( unsigned long now )
+{
+    for ( unsigned int l = 0; l < numLevels; ++l ) {
+        for ( unsigned int s = 0; s < numSlots; ++s )
+            slots_[l][s].clear();
+        occupied_[l] = 0;
+    }
+    overflow_.clear();
+    now_ = now;
+    seq_ = 0;
+    nextDue_ = 0;
+}
+
+unsigned long TimingWheel::now() const
+{
+    return now_;
+}
+
+/**
+ * A timer goes on the lowest level at which its due step shares the
+ * current block with now_, in the slot its due step falls in there.
+ */
+void TimingWheel::place( const Timer& t )
+{
+    for ( unsigned int l = 0; l < numLevels; ++l ) {
+        unsigned int shift = bitsPerLevel * ( l + 1 );
+        if ( ( t.due >> shift ) == ( now_ >> shift ) ) {
+            unsigned int s = ( t.due >> ( bitsPerLevel * l ) ) &
+                ( numSlots - 1 );
+            slots_[l][s].push_back( t );
+            occupied_[l] |= 1ULL << s;
+            return;
+        }
+    }
+    overflow_.push_back( t );
+}
+
+void TimingWheel::insert( Timer t )
+{
+    assert( t.due > now_ );
+    if ( t.seq == 0 )
+        t.seq = ++seq_;
+    place( t );
+    if ( nextDue_ != 0 && t.due < nextDue_ )
+        nextDue_ = t.due;
+}
+
+unsigned long TimingWheel::nextDue() const
+{
+    if ( nextDue_ == 0 )
+        nextDue_ = findNextDue();
+    return nextDue_;
+}
+
+/**
+ * The first occupied slot after the current one on the lowest level that
+ * has any holds the earliest timers. On level 0 a slot is a single step;
+ * higher up the timers in the slot have to be looked at.
+ */
+unsigned long TimingWheel::findNextDue() const
+{
+    for ( unsigned int l = 0; l < numLevels; ++l ) {
+        unsigned int cur = ( now_ >> ( bitsPerLevel * l ) ) &
+            ( numSlots - 1 );
+        unsigned long long mask = occupied_[l] & ~( ( 2ULL << cur ) - 1 );
+        if ( mask == 0 )
+            continue;
+        unsigned int s = __builtin_ctzll( mask );
+        if ( l == 0 )
+            return ( now_ & ~static_cast< unsigned long >( numSlots - 1 ) )
+                | s;
+        unsigned long ret = ~0UL;
+        for ( const Timer& t : slots_[l][s] )
+            ret = min( ret, t.due );
+        return ret;
+    }
+    unsigned long ret = ~0UL;
+    for ( const Timer& t : overflow_ )
+        ret = min( ret, t.due );
+    return ret;
+}
+
+void TimingWheel::advance( unsigned long to, vector< Timer >& due )
+{
+    assert( to >= now_ );
+    assert( to <= nextDue() );
+    due.clear();
+    unsigned long old = now_;
+    now_ = to;
+    if ( to != old ) {
+        // Going top down, timers cascaded out of a slot may land in the
+        // slot one level below that is about to be cascaded in turn.
+        unsigned int top = bitsPerLevel * numLevels;
+        if ( ( to >> top ) != ( old >> top ) ) {
+            vector< Timer > far;
+            far.swap( overflow_ );
+            for ( const Timer& t : far )
+                place( t );
+        }
+        for ( unsigned int l = numLevels - 1; l > 0; --l ) {
+            unsigned int shift = bitsPerLevel * l;
+            if ( ( to >> shift ) == ( old >> shift ) )
+                continue;
+            unsigned int s = ( to >> shift ) & ( numSlots - 1 );
+            if ( !( occupied_[l] & ( 1ULL << s ) ) )
+                continue;
+            vector< Timer > down;
+            down.swap( slots_[l][s] );
+            occupied_[l] &= ~( 1ULL << s );
+            for ( const Timer& t : down )
+                place( t );
+        }
+    }
+    unsigned int s = to & ( numSlots - 1 );
+    if ( occupied_[0] & ( 1ULL << s ) ) {
+        due.swap( slots_[0][s] );
+        occupied_[0] &= ~( 1ULL << s );
+        sort( due.begin(), due.end(), timerBefore );
+    }
+    nextDue_ = 0;
+}
+
+void TimingWheel::timers( vector< Timer >& ret ) const
+{
+    ret.clear();
+    for ( unsigned int l = 0; l < numLevels; ++l )
+        for ( unsigned int s = 0; s < numSlots; ++s )
+            ret.insert( ret.end(), slots_[l][s].begin(),
+                    slots_[l][s].end() );
+    ret.insert( ret.end(), overflow_.begin(), overflow_.end() );
+}
+
+unsigned int TimingWheel::size() const
+{
+    unsigned int ret = overflow_.size();
+    for ( unsigned int l = 0; l < numLevels; ++l )
+        for ( unsigned int s = 0; s < numSlots; ++s )
+            ret += slots_[l][s].size();
+    return ret;
+}
@@ -0,0 +1,106 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2014 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _TIMING_WHEEL_H
+#define _TIMING_WHEEL_H
+
+/**
+ * A hierarchical timing wheel holding timers that fall due on integral
+ * steps of the Clock. Level l has 64 slots, each covering 64^l steps,
+ * so the four levels span 2^24 steps ahead of the current one; timers
+ * further out wait in an overflow list.
+ * The wheel can report the step of the earliest timer without visiting
+ * the empty steps before it, which lets the Clock jump straight to the
+ * next step at which anything happens. Timers are moved down a level
+ * when the wheel advances into the slot holding them, so the cost of a
+ * timer is independent of how far ahead it is set.
+ */
+class TimingWheel
+{
+    public:
+        struct Timer
+        {
+            unsigned long due;      /// Step at which the timer goes off.
+            unsigned long period;   /// Steps to the next firing. 0: one-shot.
+            unsigned int order;     /// Timers due together go in this order
+            unsigned long seq;      /// and then in order of creation.
+            unsigned int target;    /// Interpreted by the owner of the wheel
+            unsigned int index;     /// likewise.
+        };
+
+        TimingWheel();
+
+        /// Drops all timers and sets the current step.
+        void reset( unsigned long now );
+
+        /// The step the wheel is at. Timers due here have been taken.
+        unsigned long now() const;
+
+        /**
+         * Adds a timer. Its due step must be later than now(). A zero
+         * seq is replaced by a fresh one; periodic timers keep theirs
+         * when they are put back so that their order stays the same.
+         */
+        void insert( Timer t );
+
+        /**
+         * The step of the earliest timer, or ~0UL if there are none.
+         * Cheap when nothing has been inserted or taken since the last
+         * call.
+         */
+        unsigned long nextDue() const;
+
+        /**
+         * Moves the wheel to step 'to', which must not be later than
+         * nextDue(), and hands back the timers due at 'to' in order.
+         * Periodic timers are not put back; that is up to the caller,
+         * as it may have changed its mind in the meantime.
+         */
+        void advance( unsigned long to, vector< Timer >& due );
+
+        /// Removes the timers for which pred returns true.
+        template< class P > void removeIf( P pred )
+        {
+            for ( unsigned int l = 0; l < numLevels; ++l ) {
+                for ( unsigned int s = 0; s < numSlots; ++s ) {
+                    vector< Timer >& slot = slots_[l][s];
+                    slot.erase( remove_if( slot.begin(), slot.end(), pred ),
+                            slot.end() );
+                    if ( slot.empty() )
+                        occupied_[l] &= ~( 1ULL << s );
+                }
+            }
+            overflow_.erase( remove_if( overflow_.begin(), overflow_.end(),
+                        pred ), overflow_.end() );
+            nextDue_ = 0;
+        }
+
+        /// Copies out all pending timers, in no particular order.
+        void timers( vector< Timer >& ret ) const;
+
+        unsigned int size() const;
+
+    private:
+        static const unsigned int bitsPerLevel = 6;
+        static const unsigned int numSlots = 1 << bitsPerLevel;
+        static const unsigned int numLevels = 4;
+
+        void place( const Timer& t );
+        unsigned long findNextDue() const;
+
+        unsigned long now_;
+        unsigned long seq_;
+        vector< Timer > slots_[ numLevels ][ numSlots ];
+        unsigned long long occupied_[ numLevels ];
+        vector< Timer > overflow_;
+        /// Cached result of nextDue(). 0 means it must be recomputed.
+        mutable unsigned long nextDue_;
+};
+
+#endif // _TIMING_WHEEL_H
@@ -0,0 +1,505 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2024 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <chrono>
+#include <set>
+#include "../basecode/header.h"
+#include "../basecode/global.h"
+#include "../randnum/randnum.h"
+#include "Neutral.h"
+#include "Checkpoint.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+static const char checkpointMagic[8] = { 'M', 'O', 'O', 'S', 'E', 'C', 'K', 'P' };
+static const unsigned int checkpointVersion = 1;
+
+static size_t alignUp( size_t n )
+{
+    return ( n + 7 ) & ~size_t( 7 );
+}
+
+//////////////////////////////////////////////////////////////
+// CheckpointWriter
+//////////////////////////////////////////////////////////////
+
+CheckpointWriter::CheckpointWriter()
+{
+    // Leave room for the header.
+    data_.resize( 24 );
+}
+
+void CheckpointWriter::setObject( ObjId oid )
+{
+    prefix_ = oid.path() + ".";
+}
+
+void CheckpointWriter::add( const string& name, const void* data,
+                            size_t bytes )
+{
+    Record r;
+    r.name = prefix_ + name;
+    r.offset = data_.size();
+    r.bytes = bytes;
+    data_.resize( alignUp( r.offset + bytes ) );
+    if ( bytes > 0 )
+        memcpy( &data_[ r.offset ], data, bytes );
+    index_.push_back( r );
+}
+
+void CheckpointWriter::addString( const string& name, const string& s )
+{
+    add( name, s.data(), s.size() );
+}
+
+unsigned int CheckpointWriter::numRecords() const
+{
+    return index_.size();
+}
+
+bool CheckpointWriter::write( const string& fileName ) const
+{
+    string tmpName = fileName + ".tmp";
+    ofstream fout( tmpName.c_str(), ios::binary );
+    if ( !fout )
+    {
+        cout << "Warning: CheckpointWriter::write: cannot open '" <<
+             tmpName << "'.\n";
+        return false;
+    }
+    unsigned int version = checkpointVersion;
+    unsigned int num = index_.size();
+    unsigned long long indexOffset = data_.size();
+    fout.write( checkpointMagic, 8 );
+    fout.write( reinterpret_cast< const char* >( &version ), 4 );
+    fout.write( reinterpret_cast< const char* >( &num ), 4 );
+    fout.write( reinterpret_cast< const char* >( &indexOffset ), 8 );
+    fout.write( &data_[24], data_.size() - 24 );
+    for ( auto i = index_.cbegin(); i != index_.cend(); ++i )
+    {
+        unsigned int len = i->name.size();
+        unsigned long long offset = i->offset;
+        unsigned long long bytes = i->bytes;
+        fout.write( reinterpret_cast< const char* >( &len ), 4 );
+        fout.write( i->name.data(), len );
+        fout.write( reinterpret_cast< const char* >( &offset ), 8 );
+        fout.write( reinterpret_cast< const char* >( &bytes ), 8 );
+    }
+    fout.close();
+    if ( !fout || rename( tmpName.c_str(), fileName.c_str() ) != 0 )
+    {
+        cout << "Warning: CheckpointWriter::write: failed to write '" <<
+             fileName << "'.\n";
+        remove( tmpName.c_str() );
+        return false;
+    }
+    return true;
+}
+
+//////////////////////////////////////////////////////////////
+// CheckpointReader
+//////////////////////////////////////////////////////////////
+
+CheckpointReader::CheckpointReader()
+    : base_( nullptr ), size_( 0 ), numMissing_( 0 ), numMismatched_( 0 )
+{
+    ;
+}
+
+CheckpointReader::~CheckpointReader()
+{
+    close();
+}
+
+void CheckpointReader::close()
+{
+#ifndef _WIN32
+    if ( base_ && buf_.empty() )
+        munmap( const_cast< char* >( base_ ), size_ );
+#endif
+    base_ = nullptr;
+    size_ = 0;
+    buf_.clear();
+    index_.clear();
+}
+
+bool CheckpointReader::open( const string& fileName )
+{
+    close();
+#ifndef _WIN32
+    int fd = ::open( fileName.c_str(), O_RDONLY );
+    if ( fd >= 0 )
+    {
+        struct stat st;
+        if ( fstat( fd, &st ) == 0 && st.st_size > 0 )
+        {
+            void* p = mmap( 0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+            if ( p != MAP_FAILED )
+            {
+                base_ = static_cast< const char* >( p );
+                size_ = st.st_size;
+            }
+        }
+        ::close( fd );
+    }
+#endif
+    if ( !base_ )
+    {
+        ifstream fin( fileName.c_str(), ios::binary );
+        if ( !fin )
+        {
+            cout << "Warning: CheckpointReader::open: cannot open '" <<
+                 fileName << "'.\n";
+            return false;
+        }
+        buf_.assign( istreambuf_iterator< char >( fin ),
+                     istreambuf_iterator< char >() );
+        base_ = buf_.data();
+        size_ = buf_.size();
+    }
+
+    unsigned int version = 0;
+    unsigned int num = 0;
+    unsigned long long pos = 0;
+    if ( size_ >= 24 )
+    {
+        memcpy( &version, base_ + 8, 4 );
+        memcpy( &num, base_ + 12, 4 );
+        memcpy( &pos, base_ + 16, 8 );
+    }
+    if ( size_ < 24 || memcmp( base_, checkpointMagic, 8 ) != 0 ||
+            version != checkpointVersion || pos > size_ )
+    {
+        cout << "Warning: CheckpointReader::open: '" << fileName <<
+             "' is not a MOOSE checkpoint of version " <<
+             checkpointVersion << ".\n";
+        close();
+        return false;
+    }
+    index_.reserve( num );
+    for ( unsigned int i = 0; i < num; ++i )
+    {
+        unsigned int len;
+        unsigned long long offset;
+        unsigned long long bytes;
+        if ( pos + 4 > size_ )
+            break;
+        memcpy( &len, base_ + pos, 4 );
+        if ( pos + 4 + len + 16 > size_ )
+            break;
+        string name( base_ + pos + 4, len );
+        pos += 4 + len;
+        memcpy( &offset, base_ + pos, 8 );
+        memcpy( &bytes, base_ + pos + 8, 8 );
+        pos += 16;
+        if ( offset + bytes > size_ )
+            break;
+        index_[ name ] = pair< size_t, size_t >( offset, bytes );
+    }
+    if ( index_.size() != num )
+    {
+        cout << "Warning: CheckpointReader::open: '" << fileName <<
+             "' is truncated.\n";
+        close();
+        return false;
+    }
+    numMissing_ = 0;
+    numMismatched_ = 0;
+    return true;
+}
+
+bool CheckpointReader::open( const CheckpointWriter& w )
+{
+    close();
+    buf_ = w.data_;
+    base_ = buf_.data();
+    size_ = buf_.size();
+    index_.reserve( w.index_.size() );
+    for ( auto i = w.index_.cbegin(); i != w.index_.cend(); ++i )
+        index_[ i->name ] = pair< size_t, size_t >( i->offset, i->bytes );
+    numMissing_ = 0;
+    numMismatched_ = 0;
+    return true;
+}
+
+void CheckpointReader::setObject( ObjId oid )
+{
+    prefix_ = oid.path() + ".";
+}
+
+bool CheckpointReader::find( const string& name, const char** data,
+                             size_t* bytes )
+{
+    auto i = index_.find( prefix_ + name );
+    if ( i == index_.end() )
+    {
+        ++numMissing_;
+        return false;
+    }
+    *data = base_ + i->second.first;
+    *bytes = i->second.second;
+    return true;
+}
+
+bool CheckpointReader::getString( const string& name, string& s )
+{
+    const char* data;
+    size_t bytes;
+    if ( !find( name, &data, &bytes ) )
+        return false;
+    s.assign( data, bytes );
+    return true;
+}
+
+unsigned int CheckpointReader::numMissing() const
+{
+    return numMissing_;
+}
+
+unsigned int CheckpointReader::numMismatched() const
+{
+    return numMismatched_;
+}
+
+//////////////////////////////////////////////////////////////
+// Checkpoint
+//////////////////////////////////////////////////////////////
+
+typedef pair< Checkpoint::SaveFunc, Checkpoint::LoadFunc > CheckpointFuncs;
+
+static map< string, CheckpointFuncs >& handlers()
+{
+    static map< string, CheckpointFuncs > h;
+    return h;
+}
+
+static std::future< bool >& pendingWrite()
+{
+    static std::future< bool > f;
+    return f;
+}
+
+void Checkpoint::addHandler( const string& className,
+                             SaveFunc save, LoadFunc load )
+{
+    handlers()[ className ] = CheckpointFuncs( save, load );
+}
+
+/// Handler of the class or of its nearest base class that has one.
+static const CheckpointFuncs* findHandler( const Cinfo* c )
+{
+    for ( ; c; c = c->baseCinfo() )
+    {
+        auto i = handlers().find( c->name() );
+        if ( i != handlers().end() )
+            return &i->second;
+    }
+    return nullptr;
+}
+
+/**
+ * All the elements of the model, depth first, in child order. The class
+ * definitions under /classes are fixed, and the Msg managers under /Msgs
+ * keep the slots of deleted Msgs, so both are left out.
+ */
+static void modelElements( Id id, vector< Id >& ret, Id skip )
+{
+    ret.push_back( id );
+    vector< Id > kids;
+    Neutral::children( id.eref(), kids );
+    for ( auto i = kids.cbegin(); i != kids.cend(); ++i )
+        if ( *i != Id( 2 ) && *i != skip )
+            modelElements( *i, ret, skip );
+}
+
+static void modelElements( vector< Id >& ret )
+{
+    modelElements( Id(), ret, Id( "/Msgs" ) );
+}
+
+/// One line per element: path, class, number of entries and of Msgs.
+static string manifest( const vector< Id >& elms )
+{
+    stringstream ss;
+    for ( auto i = elms.cbegin(); i != elms.cend(); ++i )
+    {
+        const Element* e = i->element();
+        ss << i->path() << "\t" << e->cinfo()->name() << "\t" <<
+           e->numData() << "\t" << e->msgIn().size() << "\n";
+    }
+    return ss.str();
+}
+
+/**
+ * Classes of the scheduled elements that have no handler, and so whose
+ * run-time state is not in the checkpoint. Empty if there are none.
+ */
+static string unhandledClasses( const vector< Id >& elms )
+{
+    set< string > names;
+    for ( auto i = elms.cbegin(); i != elms.cend(); ++i )
+    {
+        const Element* e = i->element();
+        if ( e->getTick() >= 0 && e->cinfo()->findFinfo( "proc" ) &&
+                !findHandler( e->cinfo() ) )
+            names.insert( e->cinfo()->name() );
+    }
+    string ret;
+    for ( auto i = names.cbegin(); i != names.cend(); ++i )
+        ret += ( ret.empty() ? "" : ", " ) + *i;
+    return ret;
+}
+
+/// Adds the state of every entry of elms that has a handler.
+static void saveElements( const vector< Id >& elms, CheckpointWriter& w )
+{
+    for ( auto i = elms.cbegin(); i != elms.cend(); ++i )
+    {
+        Element* e = i->element();
+        const CheckpointFuncs* h = findHandler( e->cinfo() );
+        if ( !h || !h->first )
+            continue;
+        for ( unsigned int j = 0; j < e->numData(); ++j )
+        {
+            w.setObject( ObjId( *i, j ) );
+            h->first( Eref( e, j ).data(), w );
+        }
+    }
+}
+
+static void loadElements( const vector< Id >& elms, CheckpointReader& r )
+{
+    for ( auto i = elms.cbegin(); i != elms.cend(); ++i )
+    {
+        Element* e = i->element();
+        const CheckpointFuncs* h = findHandler( e->cinfo() );
+        if ( !h || !h->second )
+            continue;
+        for ( unsigned int j = 0; j < e->numData(); ++j )
+        {
+            r.setObject( ObjId( *i, j ) );
+            h->second( Eref( e, j ).data(), r );
+        }
+    }
+}
+
+bool Checkpoint::wait()
+{
+    std::future< bool >& f = pendingWrite();
+    if ( !f.valid() )
+        return true;
+    return f.get();
+}
+
+bool Checkpoint::save( const string& fileName, bool waitForWrite )
+{
+    // Capture first, then hand the buffer to the writer thread so that the
+    // simulation can go on while the file is written.
+    wait();
+    auto t0 = std::chrono::steady_clock::now();
+    shared_ptr< CheckpointWriter > w = make_shared< CheckpointWriter >();
+    vector< Id > elms;
+    modelElements( elms );
+    w->addString( "@tree", manifest( elms ) );
+    w->addString( "@rng", moose::rng.getState() );
+    w->addValue( "@seed", moose::__rng_seed__ );
+    string unhandled = unhandledClasses( elms );
+    if ( !unhandled.empty() )
+        cout << "Warning: Checkpoint::save: the state of these classes is "
+             "not saved: " << unhandled << ".\nA run continued from '" <<
+             fileName << "' will differ.\n";
+
+    saveElements( elms, *w );
+    moose::addSolverProf( "Checkpoint::capture",
+                          std::chrono::duration< double >(
+                              std::chrono::steady_clock::now() - t0 ).count(),
+                          w->numRecords() );
+
+    pendingWrite() = std::async( std::launch::async,
+                                 [w, fileName]()
+    {
+        return w->write( fileName );
+    } );
+    if ( waitForWrite )
+        return wait();
+    return true;
+}
+
+bool Checkpoint::load( const string& fileName )
+{
+    wait();
+    CheckpointReader r;
+    if ( !r.open( fileName ) )
+        return false;
+
+    vector< Id > elms;
+    modelElements( elms );
+    string saved;
+    r.getString( "@tree", saved );
+    string now = manifest( elms );
+    if ( saved != now )
+    {
+        // Report the first element that differs.
+        istringstream a( saved );
+        istringstream b( now );
+        string la, lb;
+        while ( getline( a, la ) && getline( b, lb ) && la == lb )
+            ;
+        cout << "Warning: Checkpoint::load: model does not match '" <<
+             fileName << "'.\n   saved:   " << la << "\n   current: " <<
+             lb << "\nRebuild and reinit the model as it was saved, "
+             "then load the checkpoint.\n";
+        return false;
+    }
+
+    string unhandled = unhandledClasses( elms );
+    if ( !unhandled.empty() )
+    {
+        cout << "Warning: Checkpoint::load: the state of these classes "
+             "cannot be restored: " << unhandled << ".\nNothing was "
+             "loaded from '" << fileName << "'.\n";
+        return false;
+    }
+
+    string rngState;
+    bool hasRng = r.getString( "@rng", rngState );
+    unsigned long seed = moose::__rng_seed__;
+    r.getValue( "@seed", seed );
+
+    // Which records a class needs, and of what size, only its loader
+    // knows. So the current state is kept, and put back if any record
+    // turns out to be missing or of the wrong size.
+    CheckpointWriter before;
+    saveElements( elms, before );
+    loadElements( elms, r );
+    if ( r.numMissing() > 0 || r.numMismatched() > 0 )
+    {
+        cout << "Warning: Checkpoint::load: " << r.numMissing() <<
+             " records missing and " << r.numMismatched() <<
+             " of the wrong size in '" << fileName << "'. Nothing was "
+             "loaded.\n";
+        CheckpointReader undo;
+        undo.open( before );
+        loadElements( elms, undo );
+        return false;
+    }
+    if ( hasRng )
+        moose::rng.setState( rngState );
+    moose::__rng_seed__ = seed;
+    return true;
+}
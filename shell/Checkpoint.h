@@ -0,0 +1,238 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2024 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+#ifndef _CHECKPOINT_H
+#define _CHECKPOINT_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstring>
+#include <type_traits>
+using namespace std;
+
+class ObjId;
+
+/**
+ * Binary simulation checkpoints.
+ *
+ * A checkpoint is a set of named records of raw bytes. Each object
+ * class that has run-time state registers a CheckpointHandler, and its
+ * saveState/loadState functions put and get their arrays by name.
+ * Names are prefixed with the path of the object, so every data entry
+ * has its own namespace.
+ *
+ * File layout, all in native byte order:
+ *  header: "MOOSECKP", u32 version, u32 numRecords, u64 indexOffset
+ *  records: the data, each starting on an 8 byte boundary
+ *  index: per record ( u32 nameLength, name, u64 offset, u64 bytes )
+ * The reader maps the file, so large solver arrays are copied straight
+ * from the page cache into the solver.
+ */
+class CheckpointWriter
+{
+public:
+    CheckpointWriter();
+
+    /// Subsequent records belong to this object.
+    void setObject( ObjId oid );
+
+    void add( const string& name, const void* data, size_t bytes );
+
+    template< class T > void add( const string& name, const vector< T >& v )
+    {
+        static_assert( is_trivially_copyable< T >::value,
+                       "Checkpoint records must be plain data" );
+        add( name, v.data(), v.size() * sizeof( T ) );
+    }
+
+    template< class T > void addValue( const string& name, const T& v )
+    {
+        static_assert( is_trivially_copyable< T >::value,
+                       "Checkpoint records must be plain data" );
+        add( name, &v, sizeof( T ) );
+    }
+
+    void addString( const string& name, const string& s );
+
+    unsigned int numRecords() const;
+
+    /// Writes the file, via a temporary so that a crash leaves the old one.
+    bool write( const string& fileName ) const;
+
+private:
+    friend class CheckpointReader;
+    struct Record
+    {
+        string name;
+        size_t offset;
+        size_t bytes;
+    };
+    string prefix_;
+    vector< char > data_;
+    vector< Record > index_;
+};
+
+class CheckpointReader
+{
+public:
+    CheckpointReader();
+    ~CheckpointReader();
+
+    bool open( const string& fileName );
+    /// Reads the records of w, as if it had been written and opened.
+    bool open( const CheckpointWriter& w );
+    void close();
+
+    /// Subsequent lookups are for this object.
+    void setObject( ObjId oid );
+
+    /// Looks up a record. Returns false, and counts it, if it is absent.
+    bool find( const string& name, const char** data, size_t* bytes );
+
+    template< class T > bool get( const string& name, vector< T >& v )
+    {
+        const char* data;
+        size_t bytes;
+        if ( !find( name, &data, &bytes ) || bytes % sizeof( T ) != 0 )
+            return false;
+        v.resize( bytes / sizeof( T ) );
+        if ( bytes > 0 )
+            memcpy( v.data(), data, bytes );
+        return true;
+    }
+
+    /// Fills exactly n entries. A record of another size is an error.
+    template< class T > bool get( const string& name, T* v, size_t n )
+    {
+        const char* data;
+        size_t bytes;
+        if ( !find( name, &data, &bytes ) )
+            return false;
+        if ( bytes != n * sizeof( T ) )
+        {
+            ++numMismatched_;
+            return false;
+        }
+        if ( bytes > 0 )
+            memcpy( v, data, bytes );
+        return true;
+    }
+
+    template< class T > bool getValue( const string& name, T& v )
+    {
+        return get( name, &v, 1 );
+    }
+
+    bool getString( const string& name, string& s );
+
+    unsigned int numMissing() const;
+    unsigned int numMismatched() const;
+
+private:
+    string prefix_;
+    const char* base_;
+    size_t size_;
+    vector< char > buf_; /// Used where the file cannot be mapped.
+    unordered_map< string, pair< size_t, size_t > > index_;
+    unsigned int numMissing_;
+    unsigned int numMismatched_;
+};
+
+/**
+ * Registry of the classes with checkpointed state, and the top level
+ * save and load.
+ */
+class Checkpoint
+{
+public:
+    typedef void ( *SaveFunc )( const char* data, CheckpointWriter& w );
+    typedef void ( *LoadFunc )( char* data, CheckpointReader& r );
+
+    static void addHandler( const string& className,
+                            SaveFunc save, LoadFunc load );
+
+    /**
+     * Captures the state of every object and writes it in the background.
+     * If wait is true, returns only once the file is complete.
+     */
+    static bool save( const string& fileName, bool wait );
+
+    /**
+     * Restores the state saved in fileName. The model must have been
+     * rebuilt and reinited exactly as it was when the checkpoint was
+     * taken; the object tree and message counts are checked first.
+     * If the load fails, the model is left as it was.
+     */
+    static bool load( const string& fileName );
+
+    /// Blocks until any background write is done. Returns its status.
+    static bool wait();
+};
+
+/**
+ * Registers T for checkpoints. T provides
+ *  void saveState( CheckpointWriter& w ) const;
+ *  void loadState( CheckpointReader& r );
+ * Put a static instance next to T::initCinfo.
+ */
+template< class T > class CheckpointHandler
+{
+public:
+    CheckpointHandler( const string& className )
+    {
+        Checkpoint::addHandler( className, &save, &load );
+    }
+private:
+    static void save( const char* data, CheckpointWriter& w )
+    {
+        reinterpret_cast< const T* >( data )->saveState( w );
+    }
+    static void load( char* data, CheckpointReader& r )
+    {
+        reinterpret_cast< T* >( data )->loadState( r );
+    }
+};
+
+/**
+ * Registers a scheduled class that has no run-time state of its own, so
+ * that checkpoints do not warn about it.
+ */
+class CheckpointNoState
+{
+public:
+    CheckpointNoState( const string& className )
+    {
+        Checkpoint::addHandler( className, nullptr, nullptr );
+    }
+};
+
+/**
+ * The container of a std::priority_queue, in heap order. Saving and
+ * restoring it reproduces the queue exactly, ties included.
+ */
+template< class Q > typename Q::container_type& heapContainer( Q& q )
+{
+    struct Access: public Q
+    {
+        static typename Q::container_type& get( Q& q )
+        {
+            return q.*( &Access::c );
+        }
+    };
+    return Access::get( q );
+}
+
+template< class Q > const typename Q::container_type& heapContainer(
+    const Q& q )
+{
+    return heapContainer( const_cast< Q& >( q ) );
+}
+
+#endif // _CHECKPOINT_H
@@ -10,6 +10,7 @@
 #include <fstream>
 #include "../basecode/header.h"
 #include "Shell.h"
+#include "Checkpoint.h"
 
 // Defined in kinetics/WriteKkit.cpp
 extern void writeKkit( Id model, const string& fname );
@@ -52,3 +53,23 @@ void Shell::doSaveModel( Id model, const string& fileName, bool qFlag )
 				"model of file type '" << fileType << "'.\n";
 	}
 }
+
+bool Shell::doSaveCheckpoint( const string& fileName, bool wait ) const
+{
+	if ( isRunning() ) {
+		cout << "Warning: Shell::doSaveCheckpoint: Cannot save while the "
+				"simulation is running.\n";
+		return false;
+	}
+	return Checkpoint::save( fileName, wait );
+}
+
+bool Shell::doLoadCheckpoint( const string& fileName )
+{
+	if ( isRunning() ) {
+		cout << "Warning: Shell::doLoadCheckpoint: Cannot load while the "
+				"simulation is running.\n";
+		return false;
+	}
+	return Checkpoint::load( fileName );
+}
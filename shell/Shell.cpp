@@ -141,7 +141,8 @@ const Cinfo* Shell::initCinfo()
 
 static const Cinfo* shellCinfo = Shell::initCinfo();
 
-Shell::Shell() : gettingVector_(0), numGetVecReturns_(0), cwe_(ObjId())
+Shell::Shell()
+    : gettingVector_(0), numGetVecReturns_(0), cwe_(ObjId()), branch_(0)
 {
     getBuf_.resize(1, 0);
 }
@@ -205,7 +206,9 @@ Id Shell::doCreate(string type, ObjId parent, string name, unsigned int numData,
             throw runtime_error(msg);
             return Id();
         }
-        // Get the new Id ahead of time and pass to all nodes.
+        // Get the new Id ahead of time and pass to all nodes. The
+        // FieldElements made along with it take the following ids.
+        Id::reserveIds(1 + c->numPostCreationFinfos());
         Id ret = Id::nextId();
         NodeBalance nb(numData, nodePolicy, preferredNode);
         // Get the parent MsgIndex ahead of time and pass to all nodes.
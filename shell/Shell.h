@@ -208,6 +208,51 @@ public:
      */
     void doSaveModel( Id model, const string& fileName, bool qflag = 0 ) const;
 
+    /**
+     * Writes a checkpoint of the state of the whole simulation, including
+     * the solvers, clock and random number generators. The file is written
+     * in the background unless wait is true. See Checkpoint.h.
+     */
+    bool doSaveCheckpoint( const string& fileName, bool wait = false ) const;
+
+    /**
+     * Restores a checkpoint. The model must first be rebuilt and reinited
+     * as it was when the checkpoint was saved.
+     */
+    bool doLoadCheckpoint( const string& fileName );
+
+    /**
+     * Forks the whole simulation into numBranches child processes. The
+     * branches share the memory of the model, solvers and messages
+     * copy-on-write, so only what a branch changes gets copied.
+     * Returns the branch number, from 1 to numBranches, in each child
+     * and 0 in the original process, or -1 if nothing was forked.
+     * See ShellFork.cpp.
+     */
+    int doFork( unsigned int numBranches );
+
+    /**
+     * Checks that the simulation can be forked, and finishes pending
+     * checkpoint writes so that they are not done twice.
+     */
+    bool canFork() const;
+
+    /**
+     * Forks one branch, numbered branch. Returns the pid of the child in
+     * the original process, 0 in the child and -1 on failure.
+     * Callers must check canFork() first.
+     */
+    int forkBranch( unsigned int branch );
+
+    /**
+     * Waits for all branches forked from this process to finish, and
+     * returns their exit statuses in the order they were forked.
+     */
+    vector< int > doWaitForks();
+
+    /// The branch this process runs. Zero in the original process.
+    unsigned int getBranch() const;
+
     /**
      * This function synchronizes fieldDimension on the DataHandler
      * across nodes. Used after function calls that might alter the
@@ -302,6 +347,13 @@ public:
     bool innerCopy( const vector< ObjId >& args, const string& newName,
                     unsigned int n, bool toGlobal, bool copyExtMsgs );
 
+    /**
+     * Sets aside enough ids for a copy of orig, so that the copied tree
+     * gets consecutive ids just as the original did. Call just before
+     * getting the Id of the new root from Id::nextId.
+     */
+    static void reserveCopyIds( Id orig );
+
     /**
      * Connects src to dest on appropriate fields, with specified
      * msgType.
@@ -605,6 +657,12 @@ private:
 
     /// Current working Element
     ObjId cwe_;
+
+    /// Branch number of this process, set in the child by forkBranch.
+    unsigned int branch_;
+
+    /// Pids of the branches forked from this process.
+    vector< int > forks_;
 };
 
 /*
@@ -40,6 +40,7 @@ Id Shell::doCopy(Id orig, ObjId newParent, string newName, unsigned int n,
     }
 
     Eref sheller(shelle_, 0);
+    reserveCopyIds(orig);
     Id newElm = Id::nextId();
     vector<ObjId> args;
     args.push_back(orig);
@@ -56,6 +57,22 @@ Id Shell::doCopy(Id orig, ObjId newParent, string newName, unsigned int n,
     return newElm;
 }
 
+/// Number of ids taken by innerCopyElements for the tree under orig.
+static unsigned int numCopyIds(Id orig)
+{
+    vector<Id> kids;
+    Neutral::children(orig.eref(), kids);
+    unsigned int ret = 1;
+    for (vector<Id>::iterator i = kids.begin(); i != kids.end(); ++i)
+        ret += numCopyIds(*i);
+    return ret;
+}
+
+void Shell::reserveCopyIds(Id orig)
+{
+    Id::reserveIds(numCopyIds(orig));
+}
+
 /** Runs in parallel on all nodes.
  * Note that 'n' is the number of complete duplicates. If there were
  * 10 dataEntries in the original, there will now be 10 x n.
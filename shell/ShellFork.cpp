@@ -0,0 +1,126 @@
+/**********************************************************************
+** This program is part of 'MOOSE', the
+** Messaging Object Oriented Simulation Environment.
+**           Copyright (C) 2003-2014 Upinder S. Bhalla. and NCBS
+** It is made available under the terms of the
+** GNU Lesser General Public License version 2.1
+** See the file COPYING.LIB for the full notice.
+**********************************************************************/
+
+/**
+ * Forking a simulation into branches that go on from the same state.
+ *
+ * Copying a model with doCopy duplicates every data entry and message
+ * up front. A fork instead makes child processes with fork(2), so the
+ * branches start out sharing every page of the model, its solvers and
+ * messages with the original, and the OS copies a page only when one
+ * side writes to it. Parameters, message tables and solver matrices that
+ * a branch does not change are never copied, and each branch runs on its
+ * own core with no locking.
+ *
+ * Only the forking thread goes on in a child. Objects that keep a thread
+ * or an open file cannot be forked safely, as both processes would write
+ * to the same file: file writers and streamers have to be deleted before
+ * the fork, and can be made afresh in each branch. Branches share the
+ * random number state too; seed them if they are to differ.
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../basecode/header.h"
+#include "Shell.h"
+#include "Checkpoint.h"
+#include "Wildcard.h"
+
+bool Shell::canFork() const
+{
+	if ( isRunning() ) {
+		cout << "Warning: Shell::doFork: Cannot fork while the "
+				"simulation is running.\n";
+		return false;
+	}
+	if ( numNodes() > 1 ) {
+		cout << "Warning: Shell::doFork: Cannot fork an MPI run.\n";
+		return false;
+	}
+	static const char* threaded[] = {
+		"HDF5WriterBase", "Streamer", "SocketStreamer"
+	};
+	bool ret = true;
+	for ( unsigned int i = 0; i < sizeof( threaded ) / sizeof( char* ); ++i )
+	{
+		if ( !Cinfo::find( threaded[i] ) )
+			continue;
+		vector< ObjId > found;
+		wildcardFind( string( "/##[ISA=" ) + threaded[i] + "]", found );
+		for ( vector< ObjId >::const_iterator
+				j = found.begin(); j != found.end(); ++j ) {
+			cout << "Warning: Shell::doFork: '" << j->path() <<
+				"' writes to a file or socket. Delete it before forking "
+				"and make one in each branch.\n";
+			ret = false;
+		}
+	}
+	if ( ret )
+		ret = Checkpoint::wait();
+	return ret;
+}
+
+int Shell::forkBranch( unsigned int branch )
+{
+	cout << flush;
+	cerr << flush;
+	pid_t pid = fork();
+	if ( pid < 0 ) {
+		cout << "Error: Shell::doFork: fork failed for branch " <<
+			branch << ": " << strerror( errno ) << endl;
+		return -1;
+	}
+	if ( pid == 0 ) {
+		branch_ = branch;
+		forks_.clear();
+		return 0;
+	}
+	forks_.push_back( pid );
+	return pid;
+}
+
+int Shell::doFork( unsigned int numBranches )
+{
+	if ( !canFork() )
+		return -1;
+	for ( unsigned int i = 1; i <= numBranches; ++i ) {
+		int pid = forkBranch( i );
+		if ( pid == 0 )
+			return i;
+		if ( pid < 0 )
+			break;
+	}
+	return 0;
+}
+
+vector< int > Shell::doWaitForks()
+{
+	vector< int > ret;
+	for ( vector< int >::const_iterator
+			i = forks_.begin(); i != forks_.end(); ++i ) {
+		int status = 0;
+		if ( waitpid( *i, &status, 0 ) < 0 )
+			ret.push_back( -1 );
+		else if ( WIFEXITED( status ) )
+			ret.push_back( WEXITSTATUS( status ) );
+		else
+			ret.push_back( -1 );
+	}
+	forks_.clear();
+	return ret;
+}
+
+unsigned int Shell::getBranch() const
+{
+	return branch_;
+}
@@ -13,6 +13,7 @@
 #include "SynEvent.h"
 #include "SynHandlerBase.h"
 #include "SimpleSynHandler.h"
+#include "../shell/Checkpoint.h"
 
 const Cinfo* SimpleSynHandler::initCinfo()
 {
@@ -39,6 +40,8 @@ const Cinfo* SimpleSynHandler::initCinfo()
 }
 
 static const Cinfo* synHandlerCinfo = SimpleSynHandler::initCinfo();
+static CheckpointHandler< SimpleSynHandler > synHandlerCheckpoint(
+    "SimpleSynHandler" );
 
 SimpleSynHandler::SimpleSynHandler()
 {
@@ -131,3 +134,13 @@ void SimpleSynHandler::dropSynapse(unsigned int msgLookup)
     assert(msgLookup < synapses_.size());
     synapses_[msgLookup].setWeight(-1.0);
 }
+
+void SimpleSynHandler::saveState(CheckpointWriter& w) const
+{
+    w.add("events", heapContainer(events_));
+}
+
+void SimpleSynHandler::loadState(CheckpointReader& r)
+{
+    r.get("events", heapContainer(events_));
+}
@@ -44,6 +44,9 @@ struct CompareSynEvent
  * queue to manage them. This gets inefficient for large numbers of
  * synapses but is pretty robust.
  */
+class CheckpointWriter;
+class CheckpointReader;
+
 class SimpleSynHandler: public SynHandlerBase
 {
 	public:
@@ -65,6 +68,10 @@ class SimpleSynHandler: public SynHandlerBase
 		void addSpike( unsigned int index, double time, double weight );
 		double getTopSpike( unsigned int index ) const;
 		////////////////////////////////////////////////////////////////
+		/// Checkpoint support: the pending events, in heap order.
+		void saveState( CheckpointWriter& w ) const;
+		void loadState( CheckpointReader& r );
+		////////////////////////////////////////////////////////////////
 		static const Cinfo* initCinfo();
 	private:
 		vector< Synapse > synapses_;
@@ -0,0 +1,42 @@
+# -*- coding: utf-8 -*-
+# Compartments, channels and point neurons keep their data in a per-class
+# arena. Check that creating, copying and deleting many small
+# elements keeps their fields intact.
+
+import numpy as np
+import moose
+
+
+def test_arena_elements():
+    model = moose.Neutral('/model')
+    for i in range(200):
+        moose.Compartment('/model/c%d' % i).Rm = 1e8 + i
+        moose.LIF('/model/c%d/lif' % i).thresh = -0.05 - i * 1e-4
+    for i in (0, 99, 199):
+        assert moose.element('/model/c%d' % i).Rm == 1e8 + i
+        assert np.isclose(moose.element('/model/c%d/lif' % i).thresh,
+                          -0.05 - i * 1e-4)
+
+    # Freed blocks are reused by the next elements.
+    for i in range(0, 200, 2):
+        moose.delete('/model/c%d' % i)
+    for i in range(100):
+        moose.Compartment('/model/d%d' % i).Cm = 1e-12 * (i + 1)
+    assert moose.element('/model/c101').Rm == 1e8 + 101
+    assert moose.element('/model/d42').Cm == 1e-12 * 43
+
+    copy = moose.copy(model, '/', 'copy')
+    assert moose.element('/copy/c151').Rm == 1e8 + 151
+    assert moose.element('/copy/d7').Cm == 1e-12 * 8
+
+    # Blocks of many entries get their own memory.
+    many = moose.vec('/model/many', 5000, dtype='Compartment')
+    for i in (0, 2500, 4999):
+        many[i].Rm = 1.0 + i
+    assert many[2500].Rm == 2501.0
+    moose.delete(copy)
+    moose.delete(model)
+
+
+if __name__ == '__main__':
+    test_arena_elements()
@@ -0,0 +1,232 @@
+# -*- coding: utf-8 -*-
+# Save a checkpoint part way through a run, rebuild the model, load the
+# checkpoint and check that the rest of the run is reproduced exactly,
+# for a compartment with an HH channel and synaptic input, for
+# deterministic and stochastic chemistry, and for point neurons driven by
+# Poisson input and read by a Function.
+
+import os
+import tempfile
+import numpy as np
+import moose
+
+
+def build(extra=False):
+    model = moose.Neutral('/model')
+    kin = moose.CylMesh('/model/kin')
+    kin.r0 = kin.r1 = 1e-6
+    kin.diffLength = 1e-6
+    kin.x1 = 3e-6
+    a = moose.Pool('/model/kin/a')
+    b = moose.Pool('/model/kin/b')
+    a.concInit = 1e-3
+    a.diffConst = 1e-12
+    r = moose.Reac('/model/kin/r')
+    moose.connect(r, 'sub', a, 'reac')
+    moose.connect(r, 'prd', b, 'reac')
+    r.Kf, r.Kb = 2.0, 0.5
+    ksolve = moose.Ksolve('/model/kin/ksolve')
+    dsolve = moose.Dsolve('/model/kin/dsolve')
+    stoich = moose.Stoich('/model/kin/stoich')
+    stoich.compartment = kin
+    stoich.ksolve = ksolve
+    stoich.dsolve = dsolve
+    stoich.reacSystemPath = '/model/kin/##'
+
+    gss = moose.CubeMesh('/model/gss')
+    gss.volume = 1e-19
+    ga = moose.Pool('/model/gss/a')
+    gb = moose.Pool('/model/gss/b')
+    ga.nInit = 200
+    gr = moose.Reac('/model/gss/r')
+    moose.connect(gr, 'sub', ga, 'reac')
+    moose.connect(gr, 'prd', gb, 'reac')
+    gr.Kf, gr.Kb = 2.0, 1.0
+    gsolve = moose.Gsolve('/model/gss/gsolve')
+    gstoich = moose.Stoich('/model/gss/stoich')
+    gstoich.compartment = gss
+    gstoich.ksolve = gsolve
+    gstoich.reacSystemPath = '/model/gss/##'
+
+    soma = moose.Compartment('/model/soma')
+    soma.Cm, soma.Rm = 1e-11, 1e8
+    soma.Em = soma.initVm = -0.065
+    pulse = moose.PulseGen('/model/pulse')
+    pulse.firstLevel = 2e-10
+    pulse.firstDelay = 0.01
+    pulse.firstWidth = 0.02
+    moose.connect(pulse, 'output', soma, 'injectMsg')
+    k = moose.HHChannel('/model/soma/K')
+    k.Xpower = 4
+    k.Ek = -0.08
+    k.Gbar = 3.6e-7
+    moose.element('/model/soma/K/gateX').alphaParms = [
+        1e2, -1e4, -1, -0.075, -0.01, 125, 0, 0, 0.065, 0.08, 3000, -0.1, 0.05]
+    moose.connect(soma, 'channel', k, 'channel')
+    syn = moose.SynChan('/model/soma/syn')
+    syn.tau1, syn.tau2 = 2e-3, 5e-3
+    syn.Gbar, syn.Ek = 1e-9, 0.0
+    moose.connect(soma, 'channel', syn, 'channel')
+    sh = moose.SimpleSynHandler('/model/soma/syn/sh')
+    sh.numSynapse = 1
+    sh.synapse[0].delay = 3e-3
+    sh.synapse[0].weight = 1.0
+    moose.connect(sh, 'activationOut', syn, 'activation')
+    rs = moose.RandSpike('/model/rs')
+    rs.rate = 200
+    moose.connect(rs, 'spikeOut', sh.synapse[0], 'addSpike')
+
+    tabs = []
+    for i, (obj, field) in enumerate([(soma, 'getVm'), (syn, 'getGk'),
+                                      (a, 'getN'), (gb, 'getN')]):
+        t = moose.Table('/model/t%d' % i)
+        moose.connect(t, 'requestOut', obj, field)
+        tabs.append(t)
+    if extra:
+        moose.Neutral('/model/extra')
+    for tick in range(10):
+        moose.setClock(tick, 5e-5)
+    for tick in range(10, 20):
+        moose.setClock(tick, 1e-3)
+    moose.setClock(8, 1e-3)
+    moose.reinit()
+    return tabs
+
+
+def test_checkpoint():
+    fname = os.path.join(tempfile.mkdtemp(), 'run.ckp')
+    moose.seed(7)
+    tabs = build()
+    moose.start(0.03)
+    assert moose.saveCheckpoint(fname)
+    moose.start(0.04)
+    full = [t.vector.copy() for t in tabs]
+    assert full[0].max() > -0.06
+    moose.delete('/model')
+
+    # A different model is refused.
+    build(extra=True)
+    assert not moose.loadCheckpoint(fname)
+    moose.delete('/model')
+
+    moose.seed(99)
+    tabs = build()
+    assert moose.loadCheckpoint(fname)
+    moose.start(0.04)
+    for f, t in zip(full, tabs):
+        assert np.array_equal(f, t.vector), (f, t.vector)
+    moose.delete('/model')
+
+
+def build_point_neurons(unhandled=False):
+    model = moose.Neutral('/model')
+    src = moose.PoissonSource('/model/src')
+    src.rate = 300.0
+    cells = []
+    for i, cls in enumerate(('LIF', 'AdExIF', 'IzhIF')):
+        c = getattr(moose, cls)('/model/%s' % cls)
+        c.Rm, c.Cm = 1e8, 1e-10
+        c.Em = c.initVm = c.vReset = -0.07
+        c.thresh = -0.05
+        c.refractoryPeriod = 2e-3
+        c.inject = 1.5e-10
+        if cls == 'AdExIF':
+            c.vPeak, c.deltaThresh, c.tauW = -0.03, 2e-3, 0.1
+        if cls == 'IzhIF':
+            c.Cm = 1e-11
+            c.a, c.b, c.d = 20.0, 200.0, 8.0
+            c.vPeak, c.vReset, c.uInit = 0.03, -0.065, -14.0
+        sh = moose.SimpleSynHandler('/model/%s/sh' % cls)
+        sh.numSynapses = 1
+        sh.synapse[0].weight = 2e-3
+        moose.connect(sh, 'activationOut', c, 'activation')
+        moose.connect(src, 'spikeOut', sh.synapse[0], 'addSpike')
+        cells.append(c)
+    # The rate of the Function depends on its value in the step before.
+    func = moose.Function('/model/func')
+    func.expr = 'x0 + x1 + x2'
+    for i, c in enumerate(cells):
+        moose.connect(c, 'VmOut', func.x[i], 'input')
+    if unhandled:
+        # Its position in the event list is not checkpointed.
+        tt = moose.TimeTable('/model/tt')
+        tt.vector = [0.01, 0.02]
+
+    tabs = []
+    for i, (obj, field) in enumerate([(c, 'getVm') for c in cells] +
+                                     [(func, 'getRate')]):
+        t = moose.Table('/model/t%d' % i)
+        moose.connect(t, 'requestOut', obj, field)
+        tabs.append(t)
+    for tick in range(32):
+        moose.setClock(tick, 1e-4)
+    moose.reinit()
+    return tabs
+
+
+def test_checkpoint_point_neurons():
+    fname = os.path.join(tempfile.mkdtemp(), 'run.ckp')
+    moose.seed(3)
+    tabs = build_point_neurons()
+    moose.start(0.05)
+    assert moose.saveCheckpoint(fname)
+    moose.start(0.05)
+    full = [t.vector.copy() for t in tabs]
+    assert (full[0] == -0.07).sum() > 2  # The LIF fired.
+    moose.delete('/model')
+
+    moose.seed(11)
+    tabs = build_point_neurons()
+    assert moose.loadCheckpoint(fname)
+    moose.start(0.05)
+    for f, t in zip(full, tabs):
+        assert np.array_equal(f, t.vector), (f, t.vector)
+    moose.delete('/model')
+
+    # A scheduled class without checkpoint support is reported, and the
+    # load does not claim success.
+    build_point_neurons(unhandled=True)
+    assert moose.saveCheckpoint(fname)
+    assert not moose.loadCheckpoint(fname)
+    moose.delete('/model')
+
+
+def run_point_neurons(badFile=None):
+    moose.seed(5)
+    tabs = build_point_neurons()
+    moose.start(0.02)
+    if badFile:
+        assert not moose.loadCheckpoint(badFile)
+    moose.start(0.03)
+    ret = [t.vector.copy() for t in tabs]
+    moose.delete('/model')
+    return ret
+
+
+def test_checkpoint_failed_load():
+    # A load that fails part way leaves the model as it was.
+    fname = os.path.join(tempfile.mkdtemp(), 'run.ckp')
+    moose.seed(3)
+    build_point_neurons()
+    moose.start(0.05)
+    assert moose.saveCheckpoint(fname)
+    moose.delete('/model')
+    with open(fname, 'rb') as f:
+        data = f.read()
+    # This record is read after the other cells have been loaded.
+    name = b'/model[0]/IzhIF[0].u'
+    assert data.count(name) == 1
+    badFile = fname + '.bad'
+    with open(badFile, 'wb') as f:
+        f.write(data.replace(name, name[:-1] + b'x'))
+
+    ref = run_point_neurons()
+    got = run_point_neurons(badFile)
+    for r, g in zip(ref, got):
+        assert np.array_equal(r, g), (r, g)
+
+
+if __name__ == '__main__':
+    test_checkpoint()
+    test_checkpoint_point_neurons()
+    test_checkpoint_failed_load()
@@ -0,0 +1,110 @@
+# -*- coding: utf-8 -*-
+# Compare DifShellSolver at an electrical timestep against the explicit
+# DifShell/DifBuffer integration at a much finer one.
+
+import numpy as np
+import moose
+
+nshells = 5
+diameter = 2.2627398e-6
+length = 1.131369936e-6
+thickness = diameter / 2.0 / nshells
+
+
+def make_model(path):
+    model = moose.Neutral(path)
+    shells, bufs = [], []
+    for i in range(nshells):
+        shell = moose.DifShell('%s/shell%d' % (path, i))
+        shell.Ceq = 0.0
+        shell.D = 200e-12
+        shell.valence = 2
+        shell.shapeMode = 0
+        shell.length = length
+        shell.diameter = diameter - 2 * i * thickness
+        shell.thickness = thickness
+        buf = moose.DifBuffer('%s/buf%d' % (path, i))
+        buf.bTot = 80e-3
+        buf.kf = 0.028e6
+        buf.kb = 19.6
+        buf.D = 66e-12
+        buf.shapeMode = 0
+        buf.length = length
+        buf.diameter = shell.diameter
+        buf.thickness = thickness
+        moose.connect(shell, 'concentrationOut', buf, 'concentration')
+        moose.connect(buf, 'reactionOut', shell, 'reaction')
+        if i > 0:
+            moose.connect(shells[-1], 'outerDifSourceOut', shell, 'fluxFromOut')
+            moose.connect(shell, 'innerDifSourceOut', shells[-1], 'fluxFromIn')
+            moose.connect(bufs[-1], 'outerDifSourceOut', buf, 'fluxFromOut')
+            moose.connect(buf, 'innerDifSourceOut', bufs[-1], 'fluxFromIn')
+        shells.append(shell)
+        bufs.append(buf)
+
+    pump = moose.MMPump('%s/pump' % path)
+    pump.Vmax = 85e-22
+    pump.Kd = 0.3e-3
+    moose.connect(pump, 'PumpOut', shells[0], 'mmPump')
+
+    pulse = moose.PulseGen('%s/pulse' % path)
+    pulse.firstDelay = 0.01
+    pulse.firstWidth = 0.02
+    pulse.firstLevel = 2e-12
+    pulse.secondDelay = 1e9
+    moose.connect(pulse, 'output', shells[0], 'influx')
+    return model, shells
+
+
+def run(dt, solve):
+    model, shells = make_model('/model')
+    if solve:
+        solver = moose.DifShellSolver('/model/solver')
+        solver.path = '/model/shell#'
+        assert solver.numShells == nshells
+        assert solver.numChains == 1
+        assert solver.numBuffers == nshells
+        assert solver.numPumps == 1
+    for tick in range(8):
+        moose.setClock(tick, dt)
+    moose.reinit()
+    moose.start(0.025)
+    conc = np.array([s.C for s in shells])
+    moose.delete(model)
+    return conc
+
+
+def test_difshell_solver():
+    ref = run(1e-6, False)
+    fine = run(1e-6, True)
+    coarse = run(50e-6, True)
+    assert ref[0] > 1e-3, ref
+    assert np.allclose(fine, ref, rtol=1e-3), (fine, ref)
+    assert np.allclose(coarse, ref, rtol=5e-3), (coarse, ref)
+    # Calcium enters at the outer shell and diffuses inwards.
+    assert np.all(np.diff(coarse) < 0), coarse
+
+
+def test_difshell_solver_partial_path():
+    # Only whole Elements can be taken off the clock, so a path that picks
+    # out some entries of an array of shells is refused.
+    model = moose.Neutral('/model')
+    shells = moose.vec('/model/shells', 3, dtype='DifShell')
+    solver = moose.DifShellSolver('/model/solver')
+    solver.path = '/model/shells[1]'
+    assert solver.numShells == 0
+    assert moose.element('/model/shells').tick >= 0
+    solver.path = '/model/shells[]'
+    assert solver.numShells == 3
+    assert solver.numChains == 3
+    # Deleting solved objects stops the solver rather than crashing it.
+    moose.delete(shells)
+    moose.reinit()
+    moose.start(1e-3)
+    assert solver.numShells == 0
+    moose.delete(model)
+
+
+if __name__ == '__main__':
+    test_difshell_solver()
+    test_difshell_solver_partial_path()
@@ -0,0 +1,86 @@
+# -*- coding: utf-8 -*-
+# Field access from Python goes through per-class tables of getters and
+# setters. Check that fields of each kind and type still read and write
+# as before, on single elements, on vecs and on pools handed to a solver.
+
+import numpy as np
+import moose
+
+
+def test_value_fields():
+    model = moose.Neutral('/model')
+    comp = moose.Compartment('/model/c')
+    comp.Rm = 2e8
+    assert comp.Rm == 2e8
+    comp.initVm = -0.07
+    assert isinstance(comp.initVm, float)
+    pulse = moose.PulseGen('/model/p')
+    pulse.firstLevel = 2.0
+    assert pulse.firstLevel == 2.0
+    table = moose.Table('/model/t')
+    table.vector = [1.0, 2.0, 3.0]
+    assert isinstance(table.vector, np.ndarray)
+    assert np.array_equal(table.vector, [1.0, 2.0, 3.0])
+    assert moose.element('/model/c').className == 'Compartment'
+    hh = moose.HHChannel('/model/c/hh')
+    hh.Xpower = 3
+    assert hh.Xpower == 3
+    hh.useConcentration = 1
+    assert hh.useConcentration == 1
+    moose.delete(model)
+
+
+def test_other_fields():
+    model = moose.Neutral('/model')
+    sh = moose.SimpleSynHandler('/model/sh')
+    sh.synapse.num = 3
+    assert len(sh.synapse) == 3
+    sh.synapse[1].weight = 0.5
+    assert sh.synapse[1].weight == 0.5
+    comp = moose.Compartment('/model/c')
+    comp.inject = 0
+    comp.setInject(1e-10)
+    assert comp.inject == 1e-10
+    try:
+        comp.noSuchField
+    except AttributeError:
+        pass
+    else:
+        assert False, 'missing field did not raise AttributeError'
+    moose.delete(model)
+
+
+def test_vec_fields():
+    model = moose.Neutral('/model')
+    comps = moose.vec('/model/c', 5, dtype='Compartment')
+    comps.Rm = 1e9
+    assert np.all(comps.Rm == 1e9)
+    comps.Cm = np.arange(1, 6) * 1e-12
+    assert np.allclose(comps.Cm, np.arange(1, 6) * 1e-12)
+    assert comps.name == 'c'
+    paths = comps.path
+    assert paths.startswith('/model/c')
+    moose.delete(model)
+
+
+def test_solved_fields():
+    model = moose.Neutral('/model')
+    kin = moose.CubeMesh('/model/kin')
+    a = moose.Pool('/model/kin/a')
+    a.nInit = 100
+    stoich = moose.Stoich('/model/kin/stoich')
+    ksolve = moose.Ksolve('/model/kin/ksolve')
+    stoich.compartment = kin
+    stoich.ksolve = ksolve
+    stoich.reacSystemPath = '/model/kin/##'
+    moose.reinit()
+    a.n = 42
+    assert a.n == 42
+    moose.delete(model)
+
+
+if __name__ == '__main__':
+    test_value_fields()
+    test_other_fields()
+    test_vec_fields()
+    test_solved_fields()
@@ -0,0 +1,72 @@
+# -*- coding: utf-8 -*-
+# Fork a settled model into branches that each get their own stimulus,
+# and check that every branch gives what the same stimulus gives when
+# applied to the original after restoring the settled state.
+
+import os
+import tempfile
+import numpy as np
+import moose
+
+
+def build():
+    model = moose.Neutral('/model')
+    comps = moose.Compartment('/model/c', 10)
+    for c in comps:
+        c.Rm, c.Cm = 1e8, 1e-11
+        c.Em = c.initVm = -0.065
+    tab = moose.Table('/model/tab')
+    moose.connect(tab, 'requestOut', comps[3], 'getVm')
+    for tick in range(32):
+        moose.setClock(tick, 1e-4)
+    moose.reinit()
+    return comps, tab
+
+
+def stimulate(comps, tab, branch):
+    comps[3].inject = 1e-11 * branch
+    moose.start(0.02)
+    return tab.vector[-200:].copy()
+
+
+def test_fork():
+    tmp = tempfile.mkdtemp()
+    comps, tab = build()
+    moose.start(0.05)
+    settled = os.path.join(tmp, 'settled.chk')
+    assert moose.saveCheckpoint(settled, True)
+
+    branch = moose.fork(3)
+    if branch > 0:
+        # A branch must never return into the test runner, and a failure
+        # in it shows up as its exit status.
+        try:
+            assert moose.branch() == branch
+            vm = stimulate(comps, tab, branch)
+            np.save(os.path.join(tmp, 'branch%d.npy' % branch), vm)
+            os._exit(0)
+        except BaseException:
+            os._exit(1)
+    assert branch == 0
+    status = moose.waitForks()
+    assert status == [0, 0, 0], status
+
+    for b in range(1, 4):
+        moose.reinit()
+        assert moose.loadCheckpoint(settled)
+        expected = stimulate(comps, tab, b)
+        forked = np.load(os.path.join(tmp, 'branch%d.npy' % b))
+        assert np.array_equal(forked, expected)
+    moose.delete('/model')
+
+
+def test_fork_refuses_writers():
+    moose.Neutral('/model')
+    moose.Streamer('/model/streamer')
+    assert moose.fork(2) == -1
+    moose.delete('/model')
+
+
+if __name__ == '__main__':
+    test_fork()
+    test_fork_refuses_writers()
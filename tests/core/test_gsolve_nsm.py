@@ -0,0 +1,105 @@
+# -*- coding: utf-8 -*-
+# Compare stochastic diffusion by the next-subvolume method in the
+# Gsolve against deterministic reaction-diffusion with Ksolve and Dsolve,
+# for a pool that diffuses along a cylinder while it decays.
+
+import numpy as np
+import moose
+
+print('[INFO] Using moose from %s' % moose.__file__)
+
+numVoxels = 20
+
+def run(solver, seed, jump=False, runtime=2.0):
+    if moose.exists('/kin'):
+        moose.delete('/kin')
+    moose.seed(seed)
+    kin = moose.CylMesh('/kin')
+    kin.x1 = 20e-6
+    kin.r0 = kin.r1 = 1e-6
+    kin.diffLength = 1e-6
+    a = moose.Pool('/kin/A')
+    b = moose.Pool('/kin/B')
+    r1 = moose.Reac('/kin/r1')
+    moose.connect(r1, 'sub', a, 'reac')
+    moose.connect(r1, 'prd', b, 'reac')
+    r1.Kf = 0.1
+    r1.Kb = 0
+    a.diffConst = 1e-12
+    ksolve = solver('/kin/ksolve')
+    if jump:
+        ksolve.useJumpDiffusion = True
+    dsolve = moose.Dsolve('/kin/dsolve')
+    stoich = moose.Stoich('/kin/stoich')
+    stoich.compartment = kin
+    stoich.ksolve = ksolve
+    stoich.dsolve = dsolve
+    stoich.reacSystemPath = '/kin/##'
+    moose.element('/kin/A[0]').nInit = 2000
+    moose.reinit()
+    moose.start(runtime)
+    return np.array(moose.vec('/kin/A').n), sum(moose.vec('/kin/B').n)
+
+def test_nsm_diffusion():
+    refA, refB = run(moose.Ksolve, 1)
+    numTrials = 20
+    res = [run(moose.Gsolve, 100 + i, jump=True) for i in range(numTrials)]
+    meanA = np.mean([r[0] for r in res], axis=0)
+    meanB = np.mean([r[1] for r in res])
+    print(refA[:8], meanA[:8], refB, meanB)
+    assert abs(sum(meanA) + meanB - 2000) < 1e-6, 'Mass not conserved'
+    assert np.allclose(meanA[:6], refA[:6], rtol=0.1, atol=5), (meanA, refA)
+    assert abs(meanB - refB) < 0.1 * refB, (meanB, refB)
+
+def run_junction(solver, seed, jump=False, runtime=5.0):
+    # Two abutting cubes, A starts next to the junction in the first.
+    if moose.exists('/jn'):
+        moose.delete('/jn')
+    moose.seed(seed)
+    moose.Neutral('/jn')
+    dsolves = []
+    for k in range(2):
+        c = moose.CubeMesh('/jn/c%d' % k)
+        c.preserveNumEntries = False
+        c.coords = [k * 10e-6, 0, 0, (k + 1) * 10e-6, 1e-6, 1e-6,
+                    1e-6, 1e-6, 1e-6]
+        moose.Pool(c.path + '/A').diffConst = 1e-12
+        ksolve = solver(c.path + '/ksolve')
+        if jump:
+            ksolve.useJumpDiffusion = True
+        dsolve = moose.Dsolve(c.path + '/dsolve')
+        stoich = moose.Stoich(c.path + '/stoich')
+        stoich.compartment = c
+        stoich.ksolve = ksolve
+        stoich.dsolve = dsolve
+        stoich.reacSystemPath = c.path + '/##'
+        dsolves.append(dsolve)
+    dsolves[1].buildMeshJunctions(dsolves[0])
+    moose.element('/jn/c0/A[9]').nInit = 2000
+    moose.reinit()
+    moose.start(runtime)
+    return [np.array(moose.vec('/jn/c%d/A' % k).n) for k in range(2)]
+
+def test_nsm_across_junction():
+    # Only the voxels at the junction go between Gsolve and Dsolve.
+    ref = run_junction(moose.Ksolve, 1)
+    numTrials = 20
+    res = [run_junction(moose.Gsolve, 200 + i, jump=True)
+            for i in range(numTrials)]
+    for k in range(2):
+        mean = np.mean([r[k] for r in res], axis=0)
+        print(ref[k], mean)
+        assert abs(sum(mean) - sum(ref[k])) < 0.05 * sum(ref[k]), k
+        assert np.allclose(mean, ref[k], rtol=0.2, atol=5), (k, mean, ref[k])
+
+def test_use_jump_diffusion_field():
+    gsolve = moose.Gsolve('/gsolveJumpTest')
+    assert not gsolve.useJumpDiffusion
+    gsolve.useJumpDiffusion = True
+    assert gsolve.useJumpDiffusion
+    moose.delete(gsolve)
+
+if __name__ == '__main__':
+    test_use_jump_diffusion_field()
+    test_nsm_diffusion()
+    test_nsm_across_junction()
@@ -0,0 +1,64 @@
+# -*- coding: utf-8 -*-
+# Compare the approximate Gsolve methods (tauleap, hybrid) against the
+# exact SSA on a system with one fast, high copy number reaction and one
+# slow reaction producing a low copy number product.
+
+import numpy as np
+import moose
+
+print('[INFO] Using moose from %s' % moose.__file__)
+
+def run(method, seed, runtime=5.0):
+    if moose.exists('/kin'):
+        moose.delete('/kin')
+    moose.seed(seed)
+    kin = moose.CubeMesh('/kin')
+    kin.volume = 1e-18
+    a = moose.Pool('/kin/A')
+    b = moose.Pool('/kin/B')
+    c = moose.Pool('/kin/C')
+    r1 = moose.Reac('/kin/r1')
+    r2 = moose.Reac('/kin/r2')
+    moose.connect(r1, 'sub', a, 'reac')
+    moose.connect(r1, 'prd', b, 'reac')
+    moose.connect(r2, 'sub', b, 'reac')
+    moose.connect(r2, 'prd', c, 'reac')
+    a.nInit = 20000
+    r1.Kf = r1.Kb = 50
+    r2.Kf = 0.001
+    r2.Kb = 0
+    gsolve = moose.Gsolve('/kin/gsolve')
+    gsolve.method = method
+    stoich = moose.Stoich('/kin/stoich')
+    stoich.compartment = kin
+    stoich.ksolve = gsolve
+    stoich.reacSystemPath = '/kin/##'
+    moose.reinit()
+    moose.start(runtime)
+    return a.n, b.n, c.n
+
+def test_gsolve_methods():
+    numTrials = 10
+    res = {}
+    for method in ['gssa', 'tauleap', 'hybrid']:
+        res[method] = np.mean([run(method, 100 + i) for i in range(numTrials)], axis=0)
+        print(method, res[method])
+    for method in ['tauleap', 'hybrid']:
+        # A and B equilibrate at about 1e4 each; C grows to about 50.
+        assert np.allclose(res[method][:2], res['gssa'][:2], rtol=0.05), res
+        assert abs(res[method][2] - res['gssa'][2]) < 20, res
+
+def test_method_field():
+    gsolve = moose.Gsolve('/gsolveMethodTest')
+    assert gsolve.method == 'gssa'
+    gsolve.method = 'TauLeap'
+    assert gsolve.method == 'tauleap'
+    gsolve.epsilon = 0.01
+    assert np.isclose(gsolve.epsilon, 0.01)
+    gsolve.hybridThreshold = 50
+    assert np.isclose(gsolve.hybridThreshold, 50)
+    moose.delete(gsolve)
+
+if __name__ == '__main__':
+    test_method_field()
+    test_gsolve_methods()
@@ -0,0 +1,40 @@
+# -*- coding: utf-8 -*-
+# Ids of deleted elements are recycled, and stale handles do not pick up
+# the elements that reuse their slots.
+
+import moose
+
+
+def build():
+    model = moose.Neutral('/model')
+    for i in range(10):
+        moose.Compartment('/model/c%d' % i)
+    chan = moose.HHChannel('/model/chan')
+    chan.Xpower = 1
+    moose.Function('/model/func')
+    return model
+
+
+def test_id_recycling():
+    build()
+    ids = sorted(hash(x.id) for x in moose.wildcardFind('/model/##'))
+    stale = moose.element('/model/c0')
+    for _ in range(50):
+        moose.delete('/model')
+        build()
+    # The same slots are used over and over.
+    assert sorted(hash(x.id) for x in moose.wildcardFind('/model/##')) == ids
+
+    fresh = moose.element('/model/c0')
+    assert hash(fresh.id) == hash(stale.id)
+    assert fresh.id != stale.id
+    assert 'deleted' in repr(stale)
+
+    # FieldElements still take the ids right after their parent.
+    chan = moose.element('/model/chan')
+    assert hash(moose.element('/model/chan/gateX').id) == hash(chan.id) + 1
+    moose.delete('/model')
+
+
+if __name__ == '__main__':
+    test_id_recycling()
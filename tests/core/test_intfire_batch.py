@@ -0,0 +1,66 @@
+# -*- coding: utf-8 -*-
+# Point neurons in one array Element are updated together. Check that they
+# fire and send Vm as the same neurons do when each is an Element of its
+# own, for every integrate-and-fire class.
+
+import numpy as np
+import moose
+
+N = 20
+
+
+def run(cls, batched):
+    model = moose.Neutral('/model')
+    if batched:
+        cells = list(moose.vec('/model/cells', N, dtype=cls))
+    else:
+        cells = [moose.element(moose.vec('/model/c%d' % i, 1, dtype=cls))
+                 for i in range(N)]
+    spikes = moose.Table('/model/spikes')
+    vm = moose.Table('/model/vm')
+    for i, c in enumerate(cells):
+        c.Rm, c.Cm = 1e8, 1e-10
+        c.Em = c.initVm = c.vReset = -0.07
+        c.thresh = -0.05
+        c.refractoryPeriod = 2e-3
+        c.inject = 2e-10 + i * 5e-12
+        if cls in ('ExIF', 'AdExIF'):
+            c.vPeak, c.deltaThresh = -0.03, 2e-3
+        if cls == 'AdExIF':
+            c.tauW = 0.1
+        if cls == 'AdThreshIF':
+            c.tauThresh = 0.1
+        if cls == 'QIF':
+            c.a0, c.vCritical = 0.3, -0.055
+        if cls == 'IzhIF':
+            # Regular spiking, in SI units.
+            c.Cm = 1e-11
+            c.a, c.b, c.d = 20.0, 200.0, 8.0
+            c.vPeak, c.vReset, c.uInit = 0.03, -0.065, -14.0
+    moose.connect(cells[7], 'spikeOut', spikes, 'spike')
+    moose.connect(cells[11], 'VmOut', vm, 'input')
+    for tick in range(32):
+        moose.setClock(tick, 1e-4)
+    moose.reinit()
+    moose.start(0.05)
+    ret = (np.array([c.Vm for c in cells]),
+           np.array([c.lastEventTime for c in cells]),
+           spikes.vector.copy(), vm.vector.copy())
+    moose.delete(model)
+    return ret
+
+
+def test_batched_process():
+    for cls in ('LIF', 'QIF', 'ExIF', 'AdExIF', 'AdThreshIF', 'IzhIF'):
+        batched = run(cls, True)
+        single = run(cls, False)
+        for b, s in zip(batched, single):
+            assert np.array_equal(b, s), cls
+        # Neurons fired, and both spikes and Vm reached their targets.
+        assert (batched[1] > 0).all(), cls
+        assert len(batched[2]) > 0, cls
+        assert len(batched[3]) > 0, cls
+
+
+if __name__ == '__main__':
+    test_batched_process()
@@ -0,0 +1,71 @@
+# -*- coding: utf-8 -*-
+# Run an ensemble of parameter variants of one model as the voxels of a
+# single Ksolve, and gather the results from one Table per voxel.
+
+import numpy as np
+import moose
+
+nvariants = 8
+kf = 0.1
+
+
+def test_ksolve_ensemble():
+    # Voxels without a Dsolve do not exchange molecules, so each one is an
+    # independent copy of the model.
+    compt = moose.CylMesh('/model')
+    compt.r0 = compt.r1 = 1e-6
+    compt.diffLength = 1e-6
+    compt.x1 = nvariants * compt.diffLength
+    assert compt.numDiffCompts == nvariants
+
+    a = moose.Pool('/model/a')
+    b = moose.Pool('/model/b')
+    reac = moose.Reac('/model/reac')
+    reac.Kf = kf
+    reac.Kb = 0.0
+    moose.connect(reac, 'sub', a, 'reac')
+    moose.connect(reac, 'prd', b, 'reac')
+
+    ksolve = moose.Ksolve('/model/ksolve')
+    ksolve.numThreads = 2
+    stoich = moose.Stoich('/model/stoich')
+    stoich.compartment = compt
+    stoich.ksolve = ksolve
+    stoich.reacSystemPath = '/model/##'
+
+    # One parameter set per voxel.
+    concInit = np.linspace(1.0, 2.0, nvariants)
+    scale = np.linspace(0.5, 4.0, nvariants)
+    a.vec.concInit = concInit
+    ksolve.r1Scale['/model/reac'] = scale
+    assert np.allclose(ksolve.r1Scale['/model/reac'], scale)
+    assert np.allclose(ksolve.r2Scale['/model/reac'], 1.0)
+    assert np.allclose(ksolve.rateVec['/model/reac'], kf * scale)
+
+    tabs = []
+    for i in range(nvariants):
+        tab = moose.Table2('/model/tab%d' % i)
+        moose.connect(tab, 'requestOut', a.vec[i], 'getConc')
+        tabs.append(tab)
+    for tick in range(10, 20):
+        moose.setClock(tick, 0.1)
+    moose.reinit()
+    moose.start(10.0)
+
+    expected = concInit * np.exp(-kf * scale * 10.0)
+    assert np.allclose(a.vec.conc, expected, rtol=1e-4), (a.vec.conc, expected)
+
+    res = np.array([t.vector for t in tabs])
+    assert res.shape[0] == nvariants
+    assert np.allclose(res[:, 0], concInit, rtol=0.05), res[:, 0]
+    assert np.allclose(res[:, -1], expected, rtol=0.05), res[:, -1]
+    assert np.all(np.diff(res, axis=1) <= 0.0)
+
+    # Changing the base rate keeps the per-voxel scale.
+    reac.Kf = 2 * kf
+    assert np.allclose(ksolve.rateVec['/model/reac'], 2 * kf * scale)
+    moose.delete('/model')
+
+
+if __name__ == '__main__':
+    test_ksolve_ensemble()
@@ -0,0 +1,68 @@
+# -*- coding: utf-8 -*-
+# The implicit rosenbrock method of Ksolve should agree with lsoda on a
+# stiff chain of fast binding steps driven round by slow enzymes.
+
+import numpy as np
+import moose
+
+nchain = 50
+
+
+def make_model(path, method):
+    compt = moose.CubeMesh(path)
+    compt.volume = 1e-18
+    pools = [moose.Pool('%s/p%d' % (path, i)) for i in range(nchain)]
+    pools[0].concInit = 1.0
+    lig = moose.Pool('%s/lig' % path)
+    lig.concInit = 0.5
+    E = moose.Pool('%s/E' % path)
+    E.concInit = 0.01
+    for i in range(nchain - 1):
+        r = moose.Reac('%s/r%d' % (path, i))
+        moose.connect(r, 'sub', pools[i], 'reac')
+        moose.connect(r, 'sub', lig, 'reac')
+        moose.connect(r, 'prd', pools[i + 1], 'reac')
+        r.Kf = 1e5 * (1 + i % 3)
+        r.Kb = 1e4 * (1 + i % 2)
+    enz = moose.Enz('%s/enz' % E.path)
+    cplx = moose.Pool('%s/cplx' % enz.path)
+    moose.connect(enz, 'sub', pools[-1], 'reac')
+    moose.connect(enz, 'prd', pools[0], 'reac')
+    moose.connect(enz, 'prd', lig, 'reac')
+    moose.connect(enz, 'enz', E, 'reac')
+    moose.connect(enz, 'cplx', cplx, 'reac')
+    enz.Km = 0.1
+    enz.kcat = 5
+    mm = moose.MMenz('%s/mm' % E.path)
+    moose.connect(mm, 'sub', lig, 'reac')
+    moose.connect(mm, 'prd', pools[1], 'reac')
+    moose.connect(E, 'nOut', mm, 'enzDest')
+    mm.Km = 1
+    mm.kcat = 0.5
+
+    ksolve = moose.Ksolve('%s/ksolve' % path)
+    ksolve.method = method
+    stoich = moose.Stoich('%s/stoich' % path)
+    stoich.compartment = compt
+    stoich.ksolve = ksolve
+    stoich.reacSystemPath = '%s/##' % path
+    assert ksolve.method == method
+    return pools + [lig, E, cplx]
+
+
+def test_ksolve_rosenbrock():
+    ref = make_model('/ref', 'lsoda')
+    ros = make_model('/ros', 'rosenbrock')
+    for tick in range(20):
+        moose.setClock(tick, 0.1)
+    moose.reinit()
+    moose.start(20.0)
+    a = np.array([p.conc for p in ref])
+    b = np.array([p.conc for p in ros])
+    assert np.allclose(a, b, rtol=1e-3, atol=1e-8), (a, b)
+    moose.delete('/ref')
+    moose.delete('/ros')
+
+
+if __name__ == '__main__':
+    test_ksolve_rosenbrock()
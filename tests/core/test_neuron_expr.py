@@ -0,0 +1,53 @@
+# -*- coding: utf-8 -*-
+# Channel distribution expressions read length and diameter from the
+# compartments through getters cached per class. Check the result
+# against the same expression evaluated on the compartment fields, on a
+# cell that mixes compartment classes.
+
+import numpy as np
+import moose
+
+
+def make_cell():
+    moose.Neutral('/library')
+    moose.HHChannel('/library/Na')
+    cell = moose.Neuron('/model/cell')
+    comps = []
+    x = 0.0
+    for i in range(8):
+        cls = moose.SymCompartment if i % 3 == 2 else moose.Compartment
+        c = cls('/model/cell/c%d' % i)
+        c.length = (5 + 3 * i) * 1e-6
+        c.diameter = (4 - 0.3 * i) * 1e-6
+        c.x0, c.x = x, x + c.length
+        x = c.x
+        if comps:
+            moose.connect(comps[-1], 'axial', c, 'raxial')
+        comps.append(c)
+    cell.buildSegmentTree()
+    return cell, comps
+
+
+def test_channel_distribution_expr():
+    cell, comps = make_cell()
+    expr = '10 * (dia * 1e6) + (len * 1e6) * (len * 1e6)'
+    cell.channelDistribution = ['Na', '#', 'Gbar', expr, '']
+    for c in comps:
+        dia, length = c.diameter, c.length
+        val = 10 * (dia * 1e6) + (length * 1e6) ** 2
+        gbar = moose.element(c.path + '/Na').Gbar
+        assert np.isclose(gbar, val * length * dia * np.pi, rtol=1e-12), c
+
+    # The argument columns carry the fields read from each compartment.
+    vals = np.array(cell.valuesFromExpression['# ' + expr])
+    vals = vals.reshape(len(comps), -1)
+    for row, c in zip(vals, comps):
+        assert row[4] == c.length and row[5] == c.diameter
+        assert np.isclose(row[0], 10 * (c.diameter * 1e6) +
+                          (c.length * 1e6) ** 2, rtol=1e-12)
+    moose.delete('/model')
+    moose.delete('/library')
+
+
+if __name__ == '__main__':
+    test_channel_distribution_expr()
@@ -0,0 +1,119 @@
+# -*- coding: utf-8 -*-
+# Channel distributions copy their protos onto dendrites and spines in one
+# pass. Check that this gives the same channels, fields and messages as
+# copying each proto onto each compartment and connecting it by hand, as
+# was done before.
+
+import numpy as np
+import moose
+
+CHAN_FIELDS = ('Gbar', 'Ek', 'Xpower', 'Ypower', 'Zpower', 'instant')
+CONC_FIELDS = ('tau', 'B', 'CaBasal', 'thick', 'length', 'diameter')
+NA_EXPR = '100 + 10 * (dia * 1e6)'
+CA_EXPR = '5'
+
+
+def make_library():
+    lib = moose.Neutral('/library')
+    na = moose.HHChannel('/library/Na')
+    na.Xpower, na.Ypower, na.Ek = 3, 1, 0.055
+    ca = moose.HHChannel('/library/Ca')
+    ca.Xpower, ca.Ek = 2, 0.08
+    moose.CaConc('/library/Ca_conc').thick = 1e-7
+    spine = moose.Neutral('/library/spine')
+    shaft = moose.Compartment('/library/spine/shaft')
+    head = moose.Compartment('/library/spine/head')
+    shaft.length, shaft.diameter = 1e-6, 0.2e-6
+    shaft.x0, shaft.x = 0, 1e-6
+    head.length, head.diameter = 0.5e-6, 0.5e-6
+    head.x0, head.x = 1e-6, 1.5e-6
+    moose.connect(shaft, 'axial', head, 'raxial')
+    return lib
+
+
+def make_cell(root):
+    moose.Neutral(root)
+    cell = moose.Neuron(root + '/cell')
+    prev = None
+    x = 0.0
+    for i in range(5):
+        c = moose.Compartment('%s/cell/dend%d' % (root, i))
+        c.length, c.diameter = 10e-6, (3 - 0.4 * i) * 1e-6
+        c.x0, c.x = x, x + c.length
+        x = c.x
+        if prev:
+            moose.connect(prev, 'axial', c, 'raxial')
+        prev = c
+    cell.buildSegmentTree()
+    cell.spineDistribution = [
+        'spine', '#dend#', 'spacing', '4e-6', 'spacingDistrib', '0',
+        'size', '1', 'sizeDistrib', '0', 'angle', '0', 'angleDistrib', '0',
+        '']
+    return cell
+
+
+def build_by_distribution(root):
+    cell = make_cell(root)
+    cell.channelDistribution = [
+        'Ca_conc', '#', 'tau', '0.02', '',
+        'Na', '#dend#', 'Gbar', NA_EXPR, '',
+        'Ca', '#head#', 'Gbar', CA_EXPR, '']
+
+
+def build_by_hand(root):
+    make_cell(root)
+    area = lambda c: c.length * c.diameter * np.pi
+    for c in moose.wildcardFind(root + '/cell/#[ISA=CompartmentBase]'):
+        conc = moose.element(moose.copy('/library/Ca_conc', c, 'Ca_conc'))
+        conc.length, conc.diameter = c.length, c.diameter
+        conc.tau = 0.02
+        if 'dend' in c.name:
+            na = moose.element(moose.copy('/library/Na', c, 'Na'))
+            moose.connect(c, 'channel', na, 'channel')
+            na.Gbar = (100 + 10 * (c.diameter * 1e6)) * area(c)
+        if 'head' in c.name:
+            ca = moose.element(moose.copy('/library/Ca', c, 'Ca'))
+            moose.connect(c, 'channel', ca, 'channel')
+            moose.connect(ca, 'IkOut', conc, 'current', 'single')
+            ca.Gbar = 5 * area(c)
+
+
+def messages(obj, root):
+    ret = []
+    for m in list(obj.msgIn) + list(obj.msgOut):
+        ret.append((m.className, m.e1.path.replace(root, ''),
+                    tuple(m.srcFieldsOnE1), m.e2.path.replace(root, ''),
+                    tuple(m.destFieldsOnE2)))
+    return sorted(ret)
+
+
+def mechanisms(root):
+    ret = {}
+    for obj in moose.wildcardFind(root + '/cell/#/#[ISA=ChanBase]') + \
+            moose.wildcardFind(root + '/cell/#/#[ISA=CaConcBase]'):
+        fields = CHAN_FIELDS if obj.className == 'HHChannel' else CONC_FIELDS
+        ret[obj.path.replace(root, '')] = (
+            obj.className, [obj.getField(f) for f in fields],
+            messages(obj, root))
+    return ret
+
+
+def test_spine_channels_match_hand_built():
+    make_library()
+    build_by_distribution('/a')
+    build_by_hand('/b')
+    a = mechanisms('/a')
+    b = mechanisms('/b')
+    assert sorted(a) == sorted(b)
+    assert sum('head' in k and k.endswith('/Ca') for k in a) > 5
+    for k in a:
+        assert a[k][0] == b[k][0], k
+        assert np.allclose(a[k][1], b[k][1], rtol=1e-12, atol=0), \
+            (k, a[k][1], b[k][1])
+        assert a[k][2] == b[k][2], (k, a[k][2], b[k][2])
+    for p in ('/a', '/b', '/library'):
+        moose.delete(p)
+
+
+if __name__ == '__main__':
+    test_spine_channels_match_hand_built()
@@ -0,0 +1,92 @@
+# -*- coding: utf-8 -*-
+# PoissonSource samples the next spike time ahead and thins candidates
+# drawn at maxRate when the rate changes during a run.
+
+import os
+import tempfile
+import numpy as np
+import moose
+
+print('[INFO] Using moose from %s' % moose.__file__)
+
+def make(num, rate, maxRate=0.0, refractT=0.0, numPad=0):
+    if moose.exists('/ps'):
+        moose.delete('/ps')
+    moose.Neutral('/ps')
+    # Objects made first shift the Ids of the sources.
+    for i in range(numPad):
+        moose.Neutral('/ps/pad%d' % i)
+    src = moose.PoissonSource('/ps/src', num)
+    src.vec.maxRate = maxRate
+    src.vec.rate = rate
+    src.vec.refractT = refractT
+    moose.setClock(src.tick, 1e-4)
+    return src
+
+def test_constant_rate():
+    moose.seed(5)
+    src = make(1000, 20.0, refractT=0.005)
+    moose.reinit()
+    moose.start(2.0)
+    n = np.array(src.vec.numSpikes)
+    assert abs(n.mean() - 40.0) < 1.5, n.mean()
+    # Fano factor is below 1 with refractoriness, but not by much here.
+    assert 0.6 < n.var() / n.mean() < 1.1, n.var() / n.mean()
+
+def test_thinning():
+    moose.seed(6)
+    src = make(1000, 10.0, maxRate=100.0)
+    moose.reinit()
+    moose.start(1.0)
+    src.vec.rate = 60.0
+    moose.start(1.0)
+    # Above maxRate the envelope is raised.
+    src.vec.rate = 150.0
+    moose.start(1.0)
+    n = np.array(src.vec.numSpikes)
+    assert abs(n.mean() - 220.0) < 3.0, n.mean()
+
+def test_reproducible():
+    res = []
+    for i in range(2):
+        moose.seed(7)
+        src = make(10, 30.0, numPad=i)
+        tab = moose.Table('/ps/tab')
+        moose.connect(moose.element(src.vec[3]), 'spikeOut', tab, 'spike')
+        moose.reinit()
+        moose.start(1.0)
+        res.append(np.array(tab.vector))
+    assert len(res[0]) > 0
+    assert np.array_equal(res[0], res[1])
+
+def run_modulated(src, tab, t0, t1):
+    # The rate changes during the run, as it would by message.
+    for t in np.arange(t0, t1, 0.1):
+        src.vec.rate = 20.0 + 60.0 * (int(round(t * 10)) % 3)
+        moose.start(0.1)
+    return np.array(tab.vector)
+
+def test_checkpoint():
+    chk = os.path.join(tempfile.mkdtemp(), 'ps.chk')
+    res = []
+    for i in range(2):
+        moose.seed(8)
+        src = make(10, 30.0, maxRate=100.0, refractT=0.002)
+        tab = moose.Table('/ps/tab')
+        moose.connect(moose.element(src.vec[3]), 'spikeOut', tab, 'spike')
+        moose.reinit()
+        if i == 0:
+            run_modulated(src, tab, 0.0, 1.0)
+            assert moose.saveCheckpoint(chk, True)
+            res.append(run_modulated(src, tab, 1.0, 2.0))
+        else:
+            assert moose.loadCheckpoint(chk)
+            res.append(run_modulated(src, tab, 1.0, 2.0))
+    assert (res[0] > 1.0).sum() > 0
+    assert np.array_equal(res[0], res[1])
+
+if __name__ == '__main__':
+    test_constant_rate()
+    test_thinning()
+    test_reproducible()
+    test_checkpoint()
@@ -0,0 +1,97 @@
+# -*- coding: utf-8 -*-
+# Voxels and cells at steady state are taken off the active list, and are
+# woken by field assignments, diffusion and injected current. The results
+# stay close to those of a run that integrates everything.
+
+import numpy as np
+import moose
+
+
+def chem(tol, nv=100):
+    model = moose.Neutral('/model')
+    kin = moose.CylMesh('/model/kin')
+    kin.r0 = kin.r1 = 1e-6
+    kin.diffLength = 1e-6
+    kin.x1 = nv * 1e-6
+    a = moose.Pool('/model/kin/a')
+    b = moose.Pool('/model/kin/b')
+    a.concInit = b.concInit = 1e-3
+    a.diffConst = 1e-12
+    r = moose.Reac('/model/kin/r')
+    moose.connect(r, 'sub', a, 'reac')
+    moose.connect(r, 'prd', b, 'reac')
+    r.Kf = r.Kb = 2.0
+    ksolve = moose.Ksolve('/model/kin/ksolve')
+    dsolve = moose.Dsolve('/model/kin/dsolve')
+    ksolve.quiescentTol = tol
+    dsolve.quiescentTol = tol
+    stoich = moose.Stoich('/model/kin/stoich')
+    stoich.compartment = kin
+    stoich.ksolve = ksolve
+    stoich.dsolve = dsolve
+    stoich.reacSystemPath = '/model/kin/##'
+    for tick in range(20):
+        moose.setClock(tick, 0.01)
+    moose.reinit()
+    moose.start(1.0)
+    atRest = ksolve.numActiveVoxels, dsolve.numActivePools
+    moose.element('/model/kin/a').vec[0].n *= 3
+    moose.start(0.05)
+    kicked = ksolve.numActiveVoxels
+    moose.start(2.0)
+    n = moose.element('/model/kin/a').vec.n.copy()
+    moose.delete(model)
+    return n, atRest, kicked
+
+
+def cell(tol):
+    model = moose.Neutral('/model')
+    soma = moose.Compartment('/model/soma')
+    soma.Cm, soma.Rm = 1e-11, 1e8
+    soma.Em = soma.initVm = -0.065
+    pulse = moose.PulseGen('/model/pulse')
+    pulse.firstLevel = 1e-10
+    pulse.firstDelay = 0.1
+    pulse.firstWidth = 0.02
+    pulse.secondDelay = 1e9
+    moose.connect(pulse, 'output', soma, 'injectMsg')
+    hsolve = moose.HSolve('/model/hsolve')
+    hsolve.dt = 5e-5
+    hsolve.quiescentTol = tol
+    hsolve.target = '/model/soma'
+    tab = moose.Table('/model/tab')
+    moose.connect(tab, 'requestOut', soma, 'getVm')
+    for tick in range(20):
+        moose.setClock(tick, 5e-5)
+    moose.reinit()
+    moose.start(0.08)
+    quiet = hsolve.isQuiescent
+    moose.start(0.03)
+    woken = not hsolve.isQuiescent
+    moose.start(0.1)
+    vm = tab.vector.copy()
+    moose.delete(model)
+    return vm, quiet, woken
+
+
+def test_quiescent_voxels():
+    full, atRest, kicked = chem(0.0)
+    assert atRest[0] == 100
+    gated, atRest, kicked = chem(1e-4)
+    assert atRest == (0, 0)
+    assert 0 < kicked < 20
+    assert np.allclose(full, gated, rtol=1e-5)
+
+
+def test_quiescent_cell():
+    full, quiet, woken = cell(0.0)
+    assert not quiet
+    gated, quiet, woken = cell(1e-3)
+    assert quiet and woken
+    assert full.max() > -0.06
+    assert np.allclose(full, gated, atol=1e-6)
+
+
+if __name__ == '__main__':
+    test_quiescent_voxels()
+    test_quiescent_cell()
@@ -0,0 +1,177 @@
+# -*- coding: utf-8 -*-
+# Several subscribers, over Unix domain and TCP sockets, each get all the
+# table data from one SocketStreamer.
+
+import os
+import socket
+import tempfile
+import time
+import numpy as np
+import moose
+from moose.streamer_utils import StreamDecoder
+
+
+def free_port():
+    s = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    s.bind(('127.0.0.1', 0))
+    port = s.getsockname()[1]
+    s.close()
+    return port
+
+
+def read_all(socks, decoders, timeout=2.0):
+    for s in socks:
+        s.settimeout(0.05)
+    idle = time.time()
+    while time.time() - idle < timeout:
+        for s, d in zip(socks, decoders):
+            try:
+                data = s.recv(65536)
+            except socket.timeout:
+                continue
+            if data:
+                d.feed(data)
+                idle = time.time()
+
+
+def test_socket_streamer():
+    sockPath = os.path.join(tempfile.mkdtemp(), 'moose.sock')
+    port = free_port()
+
+    model = moose.Neutral('/model')
+    pulse = moose.PulseGen('/model/pulse')
+    pulse.firstLevel = 1.0
+    pulse.firstDelay = 0.2
+    pulse.firstWidth = 0.5
+    tabs = []
+    for i in range(2):
+        tab = moose.Table('/model/tab%d' % i)
+        moose.connect(tab, 'requestOut', pulse, 'getOutputValue')
+        tabs.append(tab)
+
+    st = moose.SocketStreamer('/model/streamer')
+    st.address = 'file://%s,http://127.0.0.1:%d' % (sockPath, port)
+    st.dataType = 'float32'
+    st.addTables(tabs)
+    assert st.numTables == 2
+
+    for tick in range(20):
+        moose.setClock(tick, 0.01)
+    moose.reinit()
+
+    socks = []
+    for i in range(2):
+        s = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        s.connect(sockPath)
+        socks.append(s)
+    s = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    s.connect(('127.0.0.1', port))
+    socks.append(s)
+    for _ in range(100):
+        if st.numClients == 3:
+            break
+        time.sleep(0.01)
+    assert st.numClients == 3
+
+    moose.start(2.0)
+    decoders = [StreamDecoder() for s in socks]
+    read_all(socks, decoders)
+    assert st.numDroppedFrames == 0
+
+    names = ['/model/tab0', '/model/tab1']
+    for d in decoders:
+        assert d.columns == names
+        res = d.data()
+        for name, t in zip(names, tabs):
+            t_, v = res[name]
+            assert np.allclose(v, t.vector), (v, t.vector)
+            assert np.allclose(t_, np.arange(len(v)) * 0.01, atol=1e-5)
+
+    # A subscriber that leaves does not disturb the others.
+    socks.pop().close()
+    moose.start(1.0)
+    read_all(socks, decoders[:2])
+    assert st.numClients == 2
+    for d in decoders[:2]:
+        assert np.allclose(d.data()[names[0]][1], tabs[0].vector)
+
+    for s in socks:
+        s.close()
+    moose.delete(model)
+
+
+def test_socket_header_kept_when_full():
+    # A subscriber too slow to take the new header misses frames, but
+    # never gets frames in a layout it has not been told about.
+    sockPath = os.path.join(tempfile.mkdtemp(), 'moose.sock')
+    model = moose.Neutral('/model')
+    pulse = moose.PulseGen('/model/pulse')
+    pulse.baseLevel = 1.0
+    tabs = []
+    for i in range(8):
+        # Long names make the header bigger than a data frame, so it
+        # does not fit where a dropped frame leaves room.
+        tab = moose.Table('/model/tab%d_%s' % (i, 'x' * 100))
+        moose.connect(tab, 'requestOut', pulse, 'getOutputValue')
+        tabs.append(tab)
+    st = moose.SocketStreamer('/model/streamer')
+    st.address = 'file://%s' % sockPath
+    st.bufferSize = 4096
+    st.addTables(tabs)
+    for tick in range(20):
+        moose.setClock(tick, 1e-3)
+    moose.reinit()
+    s = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    s.connect(sockPath)
+    for _ in range(100):
+        if st.numClients == 1:
+            break
+        time.sleep(0.01)
+    assert st.numClients == 1
+
+    # Without reading, the socket and then the ring fill up.
+    for _ in range(20):
+        if st.numDroppedFrames > 0:
+            break
+        moose.start(1.0)
+    assert st.numDroppedFrames > 0
+    st.dataType = 'float32'
+    moose.start(1.0)
+
+    # Once the subscriber catches up, the frames after the new header
+    # are float32.
+    d = StreamDecoder()
+    read_all([s], [d])
+    moose.start(0.5)
+    read_all([s], [d])
+    assert d.dtype == np.float32
+    for name in d.columns:
+        t, v = d.data()[name]
+        assert (v == 1.0).all()
+        assert (np.diff(t) > 0).all()
+    s.close()
+    moose.delete(model)
+
+
+def test_socket_path_not_a_socket():
+    # A regular file at the socket path is not removed to make way.
+    path = os.path.join(tempfile.mkdtemp(), 'moose.sock')
+    with open(path, 'w') as f:
+        f.write('keep me')
+    model = moose.Neutral('/model')
+    tab = moose.Table('/model/tab')
+    st = moose.SocketStreamer('/model/streamer')
+    # With no tables, reinit disables the streamer before serving.
+    st.addTables([tab])
+    st.address = 'file://%s' % path
+    moose.reinit()
+    moose.start(0.1)
+    with open(path) as f:
+        assert f.read() == 'keep me'
+    moose.delete(model)
+
+
+if __name__ == '__main__':
+    test_socket_streamer()
+    test_socket_header_kept_when_full()
+    test_socket_path_not_a_socket()
@@ -0,0 +1,52 @@
+# -*- coding: utf-8 -*-
+# Spikes sent over a SparseMsg are dispatched from spans over the
+# connection matrix. Check that delivery follows the matrix, including
+# after single entries are edited.
+
+import numpy as np
+import moose
+
+print('[INFO] Using moose from %s' % moose.__file__)
+
+def build(numSrc=4, numTgt=3):
+    if moose.exists('/sd'):
+        moose.delete('/sd')
+    moose.seed(7)
+    moose.Neutral('/sd')
+    src = moose.RandSpike('/sd/src', numSrc)
+    src.vec.rate = 100.0
+    srcTab = moose.Table('/sd/srcTab', numSrc)
+    moose.connect(src, 'spikeOut', srcTab, 'input', 'OneToOne')
+    tgtTab = moose.Table('/sd/tgtTab', numTgt)
+    m = moose.connect(src, 'spikeOut', tgtTab, 'input', 'Sparse')
+    return src, srcTab, tgtTab, m
+
+def run(src, srcTab, tgtTab):
+    moose.setClock(src.tick, 1e-4)
+    moose.reinit()
+    moose.start(0.5)
+    srcN = [len(moose.element(t).vector) for t in srcTab.vec]
+    tgtN = [len(moose.element(t).vector) for t in tgtTab.vec]
+    return srcN, tgtN
+
+def test_sparse_digest():
+    src, srcTab, tgtTab, m = build()
+    conn = {(0, 0), (1, 0), (2, 1), (3, 2), (0, 2)}
+    for s, t in sorted(conn):
+        m.setEntry(s, t, 0)
+    srcN, tgtN = run(src, srcTab, tgtTab)
+    assert min(srcN) > 10, srcN
+    for t in range(3):
+        assert tgtN[t] == sum(srcN[s] for s, tt in conn if tt == t), (t, tgtN)
+
+    # Edit one entry; only the changed Msg is redigested.
+    m.unsetEntry(0, 2)
+    conn.remove((0, 2))
+    m.setEntry(3, 0, 0)
+    conn.add((3, 0))
+    srcN, tgtN = run(src, srcTab, tgtTab)
+    for t in range(3):
+        assert tgtN[t] == sum(srcN[s] for s, tt in conn if tt == t), (t, tgtN)
+
+if __name__ == '__main__':
+    test_sparse_digest()
@@ -0,0 +1,55 @@
+# -*- coding: utf-8 -*-
+# Find all the fixed points of a bistable system from multiple starts, and
+# trace its steady state across the fold by continuation in a rate.
+
+import numpy as np
+import moose
+from test_steady_state_solver import makeModel
+
+
+def test_multistart_continuation():
+    compartment = makeModel()
+    ksolve = moose.Ksolve('/model/compartment/ksolve')
+    stoich = moose.Stoich('/model/compartment/stoich')
+    stoich.compartment = compartment
+    stoich.ksolve = ksolve
+    stoich.reacSystemPath = '/model/compartment/##'
+    state = moose.SteadyState('/model/compartment/state')
+    moose.reinit()
+    state.stoich = stoich
+    state.convergenceCriterion = 1e-9
+    state.numThreads = 4
+    moose.seed(111)
+
+    a = moose.element('/model/compartment/a')
+    b = moose.element('/model/compartment/b')
+    a.concInit = 0.25
+    moose.reinit()
+    moose.start(2000.0)
+    bLow = b.n
+
+    state.multiStart(50)
+    assert state.numFixedPoints == 3
+    fp = [state.fixedPoint[i] for i in range(state.numFixedPoints)]
+    types = sorted(state.fixedPointType[i] for i in range(3))
+    # Two stable states separated by a saddle.
+    assert types == [0, 0, 2], types
+    bs = sorted(x[0] for x in fp)
+    assert np.isclose(bs[0], bLow, rtol=1e-4), (bs, bLow)
+    # The solver state is left alone.
+    assert np.isclose(b.n, bLow)
+
+    # Speeding up the a -> 2b conversion eventually loses the low state:
+    # the branch folds back onto the saddle.
+    state.continuation('/model/compartment/reac', 0.01, 100.0)
+    scale = np.array(state.branchScale)
+    assert len(scale) > 10
+    assert np.sum(np.diff(np.sign(np.diff(scale))) != 0) == 1, scale
+    assert 1.0 < scale.max() < 100.0, scale
+    btypes = state.branchType
+    assert btypes[0] == 0 and btypes[-1] == 2, btypes
+    moose.delete('/model')
+
+
+if __name__ == '__main__':
+    test_multistart_continuation()
@@ -0,0 +1,69 @@
+# -*- coding: utf-8 -*-
+# Build a reaction system on a multi-voxel mesh, using several threads for
+# the setup, and check that every voxel gets the initial concentrations
+# and rate terms, and that later parameter changes reach all voxels.
+
+import numpy as np
+import moose
+
+nvoxels = 20
+nreacs = 30
+
+
+def test_stoich_setup():
+    compt = moose.CylMesh('/model')
+    compt.r0 = compt.r1 = 1e-6
+    compt.diffLength = 1e-6
+    compt.x1 = nvoxels * compt.diffLength
+    assert compt.numDiffCompts == nvoxels
+
+    npools = nreacs // 2 + 2
+    pools = []
+    for i in range(npools):
+        p = moose.Pool('/model/p%d' % i)
+        p.concInit = 0.01 * (i + 1)
+        pools.append(p)
+    reacs = []
+    for i in range(nreacs):
+        r = moose.Reac('/model/r%d' % i)
+        moose.connect(r, 'sub', pools[i % npools], 'reac')
+        moose.connect(r, 'prd', pools[(i * 7 + 3) % npools], 'reac')
+        r.Kf = 0.1 * (i + 1)
+        r.Kb = 0.05
+        reacs.append(r)
+
+    ksolve = moose.Ksolve('/model/ksolve')
+    ksolve.numThreads = 4
+    stoich = moose.Stoich('/model/stoich')
+    stoich.compartment = compt
+    stoich.ksolve = ksolve
+    stoich.reacSystemPath = '/model/##'
+
+    for i, p in enumerate(pools):
+        assert len(p.vec) == nvoxels
+        assert np.allclose(p.vec.concInit, 0.01 * (i + 1))
+    for i, r in enumerate(reacs):
+        assert np.allclose(ksolve.rateVec[r.path], 0.1 * (i + 1))
+
+    # A change to one reaction goes to all voxels, and leaves the others.
+    reacs[3].Kf = 7.0
+    assert np.allclose(ksolve.rateVec[reacs[3].path], 7.0)
+    assert np.allclose(ksolve.rateVec[reacs[4].path], 0.5)
+
+    # Rebuilding gives the same system.
+    stoich.reacSystemPath = '/model/##'
+    assert np.allclose(ksolve.rateVec[reacs[3].path], 7.0)
+    assert np.allclose(pools[2].vec.concInit, 0.03)
+
+    for tick in range(10, 20):
+        moose.setClock(tick, 0.1)
+    moose.reinit()
+    moose.start(1.0)
+    conc = np.array([p.vec.conc for p in pools])
+    # Without diffusion all voxels stay identical.
+    assert np.allclose(conc, conc[:, :1]), conc
+    moose.delete('/model')
+
+
+if __name__ == '__main__':
+    test_stoich_setup()
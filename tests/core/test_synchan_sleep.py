@@ -0,0 +1,105 @@
+# -*- coding: utf-8 -*-
+# SynChans without input sleep and are brought up to date when activation
+# arrives. With the default gkThreshold of zero this must not change the
+# result; a small threshold lets decayed channels sleep too.
+
+import numpy as np
+import moose
+
+
+def run(threshold, modulate=False):
+    model = moose.Neutral('/model')
+    comp = moose.Compartment('/model/comp')
+    comp.Rm, comp.Cm = 1e9, 1e-11
+    comp.Em = comp.initVm = -0.07
+    syn = moose.SynChan('/model/comp/syn')
+    syn.tau1, syn.tau2 = 5e-3, 1e-3
+    syn.Gbar, syn.Ek = 1e-9, 0.0
+    syn.gkThreshold = threshold
+    moose.connect(comp, 'channel', syn, 'channel')
+    sh = moose.SimpleSynHandler('/model/comp/syn/sh')
+    sh.numSynapses = 1
+    sh.synapse[0].weight = 1.0
+    moose.connect(sh, 'activationOut', syn, 'activation')
+    tt = moose.TimeTable('/model/tt')
+    tt.vector = [0.01, 0.012, 0.1, 0.3]
+    moose.connect(tt, 'eventOut', sh.synapse[0], 'addSpike')
+    vm = moose.Table('/model/vm')
+    moose.connect(vm, 'requestOut', comp, 'getVm')
+    gk = moose.Table('/model/gk')
+    moose.connect(gk, 'requestOut', syn, 'getGk')
+    # Outputs pushed by the channel, which keep coming while it sleeps.
+    ikOut = moose.Table('/model/ikOut')
+    moose.connect(syn, 'IkOut', ikOut, 'input')
+    gkOut = moose.Table('/model/gkOut')
+    moose.connect(syn, 'permeability', gkOut, 'input')
+    for tick in range(32):
+        moose.setClock(tick, 1e-4)
+    moose.reinit()
+    moose.start(0.005)
+    # Nothing has arrived yet, so the channel sleeps.
+    assert not syn.isActive
+    if modulate:
+        # The first spikes arrive while the channel is shut off.
+        syn.modulation = 0.0
+        moose.start(0.01)
+        syn.modulation = 1.0
+        moose.start(0.485)
+    else:
+        moose.start(0.495)
+    ret = (vm.vector.copy(), gk.vector.copy(), syn.isActive,
+           ikOut.vector.copy(), gkOut.vector.copy())
+    moose.delete(model)
+    return ret
+
+
+def test_synchan_sleep():
+    vmAwake, gkAwake, _, _, _ = run(-1.0)
+    vm, gk, _, _, _ = run(0.0)
+    assert np.array_equal(vm, vmAwake)
+    assert np.array_equal(gk, gkAwake)
+
+    vm, gk, active, _, _ = run(1e-13)
+    assert not active
+    # Asleep steps count as zero; awake ones match to rounding, as the
+    # decay over the sleep is caught up exactly.
+    awake = gk > 0
+    assert 0 < awake.sum() < 0.6 * len(gk)
+    assert np.allclose(gk[awake], gkAwake[awake], rtol=1e-12, atol=0)
+    assert np.allclose(vm, vmAwake, rtol=0, atol=1e-6)
+
+
+def test_synchan_sleep_outputs():
+    _, _, _, ikAwake, gkAwake = run(-1.0)
+    assert len(ikAwake) == len(gkAwake) > 0
+    # Across the sleep transitions the pushed outputs are unchanged.
+    _, _, _, ik, gk = run(0.0)
+    assert np.array_equal(ik, ikAwake)
+    assert np.array_equal(gk, gkAwake)
+    # Decayed channels send zeros on every step they sleep.
+    _, _, active, ik, gk = run(1e-13)
+    assert not active
+    assert len(ik) == len(ikAwake) and len(gk) == len(gkAwake)
+    asleep = gk == 0
+    assert asleep.sum() > 0 and (ik[asleep] == 0).all()
+    assert np.allclose(gk[~asleep], gkAwake[~asleep], rtol=1e-12, atol=0)
+    assert np.allclose(ik, ikAwake, rtol=0, atol=1e-3 * abs(ikAwake).max())
+
+
+def test_synchan_sleep_modulation():
+    # Input that comes in at zero modulation still counts once it is
+    # restored; a channel sleeping meanwhile must not lose it.
+    vmAwake, gkAwake, _, _, _ = run(-1.0, True)
+    assert gkAwake.max() > 1e-10
+    vm, gk, _, _, _ = run(0.0, True)
+    assert np.array_equal(vm, vmAwake)
+    assert np.array_equal(gk, gkAwake)
+    vm, gk, _, _, _ = run(1e-13, True)
+    assert np.allclose(gk, gkAwake, rtol=1e-12, atol=1e-13)
+    assert np.allclose(vm, vmAwake, rtol=0, atol=1e-6)
+
+
+if __name__ == '__main__':
+    test_synchan_sleep()
+    test_synchan_sleep_outputs()
+    test_synchan_sleep_modulation()
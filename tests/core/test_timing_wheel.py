@@ -0,0 +1,73 @@
+# -*- coding: utf-8 -*-
+# Elements taken off their tick with clock.schedule run at a period of
+# their own, or event driven in the case of TimeTable, and give the same
+# output as they do on a tick.
+
+import os
+import tempfile
+import numpy as np
+import moose
+
+
+def pulse(scheduled):
+    model = moose.Neutral('/model')
+    pulse = moose.PulseGen('/model/pulse')
+    pulse.firstLevel = 1.0
+    pulse.firstDelay = 1.3e-3
+    pulse.firstWidth = 2e-3
+    tab = moose.Table('/model/tab')
+    moose.connect(tab, 'requestOut', pulse, 'getOutputValue')
+    for tick in range(32):
+        moose.setClock(tick, 1e-4)
+    clock = moose.element('/clock')
+    if scheduled:
+        clock.schedule(pulse, 5e-4)
+    else:
+        moose.setClock(0, 5e-4)
+    moose.reinit()
+    moose.start(0.01)
+    moose.start(0.005)
+    vec = tab.vector.copy()
+    moose.delete(model)
+    return vec
+
+
+def spikes(fname, scheduled):
+    model = moose.Neutral('/model')
+    tt = moose.TimeTable('/model/tt')
+    tt.filename = fname
+    tab = moose.Table('/model/tab')
+    moose.connect(tab, 'requestOut', tt, 'getState')
+    for tick in range(32):
+        moose.setClock(tick, 5e-5)
+    clock = moose.element('/clock')
+    if scheduled:
+        clock.schedule(tt, 0.0)
+    moose.reinit()
+    moose.start(0.03)
+    vec = tab.vector.copy()
+    numTimers = clock.numTimers
+    moose.delete(model)
+    return vec, numTimers
+
+
+def test_scheduled_period():
+    assert np.array_equal(pulse(False), pulse(True))
+
+
+def test_event_driven_timetable():
+    fname = os.path.join(tempfile.mkdtemp(), 'spikes.txt')
+    with open(fname, 'w') as f:
+        for t in (0.00123, 0.0014, 0.00141, 0.005, 0.02, 0.5):
+            f.write('%g\n' % t)
+    ticked, _ = spikes(fname, False)
+    woken, numTimers = spikes(fname, True)
+    assert np.array_equal(ticked, woken)
+    assert ticked.sum() == 5
+    # The table's tick and the wakeup for the spike at 0.5 s.
+    assert numTimers == 2
+
+
+if __name__ == '__main__':
+    test_scheduled_period()
+    test_event_driven_timetable()
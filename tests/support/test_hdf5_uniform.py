@@ -0,0 +1,54 @@
+# -*- coding: utf-8 -*-
+# Record the same sources with HDF5DataWriter in the perSource layout and
+# in the uniform2D layout, which puts them all in one 2-D dataset, and
+# check that both files hold the same data.
+
+import os
+import tempfile
+import numpy as np
+import pytest
+import moose
+
+h5py = pytest.importorskip('h5py')
+
+
+def record(fname, layout, ioQueueLength, n=50):
+    model = moose.Neutral('/model')
+    comps = moose.Compartment('/model/c', n)
+    for i, c in enumerate(comps):
+        c.Rm, c.Cm = 1e8, 1e-11
+        c.inject = 1e-10 * (i + 1)
+    writer = moose.HDF5DataWriter('/model/writer')
+    writer.filename = fname
+    writer.mode = 2
+    writer.flushLimit = 300
+    writer.layout = layout
+    writer.ioQueueLength = ioQueueLength
+    for c in comps:
+        moose.connect(writer, 'requestOut', c, 'getVm')
+    for tick in range(32):
+        moose.setClock(tick, 1e-4)
+    moose.reinit()
+    moose.start(0.1)
+    writer.close()
+    moose.delete(model)
+
+
+def test_hdf5_uniform():
+    tmp = tempfile.mkdtemp()
+    perSource = os.path.join(tmp, 'perSource.h5')
+    uniform = os.path.join(tmp, 'uniform.h5')
+    record(perSource, 'perSource', 0)
+    record(uniform, 'uniform2D', 4)
+    with h5py.File(perSource, 'r') as a, h5py.File(uniform, 'r') as b:
+        data = b['data']
+        assert data.shape == (50, 1000)
+        assert np.isclose(data.attrs['dt'], 1e-4)
+        for i, src in enumerate(b['sources']):
+            if isinstance(src, bytes):
+                src = src.decode()
+            assert np.array_equal(a[src][()], data[i])
+
+
+if __name__ == '__main__':
+    test_hdf5_uniform()